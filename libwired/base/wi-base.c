@@ -28,6 +28,8 @@
 
 #include "config.h"
 
+#include <sys/time.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -40,13 +42,21 @@
 #include <wired/wi-runtime.h>
 #include <wired/wi-string.h>
 
-#define _WI_ELF_STEP(byte, hash)				\
-	WI_STMT_START								\
-		(hash) = ((hash) << 4) + (byte);		\
-		(hash) ^= ((hash) >> 24) & 0xF0;		\
-	WI_STMT_END
+#define _WI_HASH_P0						0xa0761d6478bd642fULL
+#define _WI_HASH_P1						0xe7037ed1a0b428dbULL
+#define _WI_HASH_P2						0x8ebc6af09c88c6e3ULL
+#define _WI_HASH_P3						0x589965cc75374cc3ULL
 
 
+static void								_wi_hash_initialize_seed(void);
+static inline void						_wi_hash_mum(uint64_t *, uint64_t *);
+static inline uint64_t					_wi_hash_mix(uint64_t, uint64_t);
+static inline uint64_t					_wi_hash_read64(const unsigned char *);
+static inline uint64_t					_wi_hash_read32(const unsigned char *);
+
+
+static uint64_t							_wi_hash_seed = 0;
+
 wi_string_t					*wi_root_path = NULL;
 
 wi_boolean_t				wi_chrooted = false;
@@ -54,10 +64,13 @@ wi_boolean_t				wi_chrooted = false;
 
 
 void wi_initialize(void) {
+	_wi_hash_initialize_seed();
+	
 	wi_runtime_register();
 
 	wi_address_register();
 	wi_array_register();
+	wi_concurrent_dictionary_register();
 	wi_config_register();
 	
 #ifdef WI_CIPHERS
@@ -65,15 +78,18 @@ void wi_initialize(void) {
 #endif
 	
 	wi_data_register();
+	wi_data_chain_register();
 	wi_date_register();
 	wi_dictionary_register();
 	wi_digest_register();
 	wi_enumerator_register();
 	wi_error_register();
+	wi_event_loop_register();
 	wi_file_register();
 	wi_fsenumerator_register();
 	wi_fsevents_register();
 	wi_host_register();
+	wi_integer_set_register();
 	wi_lock_register();
 	wi_log_register();
 	wi_null_register();
@@ -85,6 +101,8 @@ void wi_initialize(void) {
 	wi_p7_spec_register();
 #endif
 	
+	wi_persistent_dictionary_register();
+	wi_persistent_set_register();
 	wi_pool_register();
 	wi_process_register();
 	wi_random_register();
@@ -114,6 +132,7 @@ void wi_initialize(void) {
 	wi_thread_register();
 
 #if WI_PTHREADS
+	wi_thread_pool_register();
 	wi_timer_register();
 #endif
 
@@ -135,6 +154,7 @@ void wi_initialize(void) {
 	wi_string_initialize();
 
 	wi_address_initialize();
+	wi_concurrent_dictionary_initialize();
 	wi_config_initialize();
 
 #ifdef WI_CIPHERS
@@ -142,17 +162,22 @@ void wi_initialize(void) {
 #endif
 	
 	wi_data_initialize();
+	wi_data_chain_initialize();
 	wi_date_initialize();
 	wi_digest_initialize();
 	wi_enumerator_initialize();
 	wi_error_initialize();
+	wi_event_loop_initialize();
 	wi_file_initialize();
 	wi_fsenumerator_initialize();
 	wi_fsevents_initialize();
 	wi_host_initialize();
+	wi_integer_set_initialize();
 	wi_log_initialize();
 	wi_null_initialize();
 	wi_number_initialize();
+	wi_persistent_dictionary_initialize();
+	wi_persistent_set_initialize();
 	wi_pool_initialize();
 	wi_process_initialize();
 	wi_random_initialize();
@@ -186,6 +211,7 @@ void wi_initialize(void) {
 	wi_thread_initialize();
 
 #if WI_PTHREADS
+	wi_thread_pool_initialize();
 	wi_timer_initialize();
 #endif
 
@@ -228,40 +254,171 @@ void wi_crash(void) {
 
 #pragma mark -
 
-wi_hash_code_t wi_hash_cstring(const char *s, wi_uinteger_t length) {
-	wi_hash_code_t	hash = length;
-	const char		*end, *end4;
+static void _wi_hash_initialize_seed(void) {
+	struct timeval		tv;
+	uint64_t			seed;
+	int					fd;
+	
+	/* must run before anything is hashed, hashes are never stored across processes */
+	seed = 0;
+	fd = open("/dev/urandom", O_RDONLY);
+	
+	if(fd >= 0) {
+		if(read(fd, &seed, sizeof(seed)) != sizeof(seed))
+			seed = 0;
+		
+		close(fd);
+	}
+	
+	if(seed == 0) {
+		gettimeofday(&tv, NULL);
+		
+		seed = _wi_hash_mix(((uint64_t) getpid() << 32) ^ (uint64_t) tv.tv_sec ^ _WI_HASH_P2,
+							(uint64_t) tv.tv_usec ^ (uint64_t) (uintptr_t) &tv ^ _WI_HASH_P3);
+	}
+	
+	_wi_hash_seed = seed;
+}
+
+
+
+static inline void _wi_hash_mum(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+	__uint128_t		r;
+	
+	r = *a;
+	r *= *b;
+	
+	*a = (uint64_t) r;
+	*b = (uint64_t) (r >> 64);
+#else
+	uint64_t		ha, hb, la, lb, hi, lo;
+	uint64_t		rh, rm0, rm1, rl, t;
+	int				c;
+	
+	ha = *a >> 32;
+	hb = *b >> 32;
+	la = (uint32_t) *a;
+	lb = (uint32_t) *b;
+	
+	rh = ha * hb;
+	rm0 = ha * lb;
+	rm1 = hb * la;
+	rl = la * lb;
+	
+	t = rl + (rm0 << 32);
+	c = t < rl;
+	lo = t + (rm1 << 32);
+	c += lo < t;
+	hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	
+	*a = lo;
+	*b = hi;
+#endif
+}
+
+
+
+static inline uint64_t _wi_hash_mix(uint64_t a, uint64_t b) {
+	_wi_hash_mum(&a, &b);
+	
+	return a ^ b;
+}
+
+
+
+static inline uint64_t _wi_hash_read64(const unsigned char *p) {
+	uint64_t		v;
+	
+	memcpy(&v, p, sizeof(v));
+	
+	return v;
+}
 
-	if(length < 16) {
-		end = s + length;
-		end4 = s + (length & ~3);
+
+
+static inline uint64_t _wi_hash_read32(const unsigned char *p) {
+	uint32_t		v;
+	
+	memcpy(&v, p, sizeof(v));
+	
+	return v;
+}
+
+
+
+uint64_t wi_hash_seed(void) {
+	return _wi_hash_seed;
+}
+
+
+
+wi_hash_code_t wi_hash_bytes_with_seed(const void *bytes, wi_uinteger_t length, uint64_t seed) {
+	const unsigned char		*p = bytes;
+	uint64_t				a, b, see1, see2;
+	wi_uinteger_t			i;
+	
+	seed ^= _wi_hash_mix(seed ^ _WI_HASH_P0, _WI_HASH_P1);
+	
+	if(length <= 16) {
+		if(length >= 4) {
+			a = (_wi_hash_read32(p) << 32) | _wi_hash_read32(p + ((length >> 3) << 2));
+			b = (_wi_hash_read32(p + length - 4) << 32) | _wi_hash_read32(p + length - 4 - ((length >> 3) << 2));
+		}
+		else if(length > 0) {
+			a = ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+			b = 0;
+		}
+		else {
+			a = b = 0;
+		}
+	} else {
+		i = length;
 		
-		while(s < end4) {
-			hash = (hash * 67503105) + (s[0] * 16974593) + (s[1] * 66049) + (s[2] * 257) + s[3];
-			s += 4;
+		if(i > 48) {
+			see1 = see2 = seed;
+			
+			do {
+				seed = _wi_hash_mix(_wi_hash_read64(p) ^ _WI_HASH_P1, _wi_hash_read64(p + 8) ^ seed);
+				see1 = _wi_hash_mix(_wi_hash_read64(p + 16) ^ _WI_HASH_P2, _wi_hash_read64(p + 24) ^ see1);
+				see2 = _wi_hash_mix(_wi_hash_read64(p + 32) ^ _WI_HASH_P3, _wi_hash_read64(p + 40) ^ see2);
+				
+				p += 48;
+				i -= 48;
+			} while(i > 48);
+			
+			seed ^= see1 ^ see2;
 		}
 		
-		while(s < end)
-			hash = (hash * 257) + *s++;
-	} else {
-		hash = (hash * 67503105) + (s[0] * 16974593) + (s[1] * 66049) + (s[2] * 257) + s[3];
-		hash = (hash * 67503105) + (s[4] * 16974593) + (s[5] * 66049) + (s[6] * 257) + s[7];
-		s += length - 8;
-		hash = (hash * 67503105) + (s[0] * 16974593) + (s[1] * 66049) + (s[2] * 257) + s[3];
-		hash = (hash * 67503105) + (s[4] * 16974593) + (s[5] * 66049) + (s[6] * 257) + s[7];
+		while(i > 16) {
+			seed = _wi_hash_mix(_wi_hash_read64(p) ^ _WI_HASH_P1, _wi_hash_read64(p + 8) ^ seed);
+			
+			p += 16;
+			i -= 16;
+		}
+		
+		a = _wi_hash_read64(p + i - 16);
+		b = _wi_hash_read64(p + i - 8);
 	}
+	
+	a ^= _WI_HASH_P1;
+	b ^= seed;
+	
+	_wi_hash_mum(&a, &b);
+	
+	return (wi_hash_code_t) _wi_hash_mix(a ^ _WI_HASH_P0 ^ length, b ^ _WI_HASH_P1);
+}
+
+
 
-	return hash + (hash << (length & 31));
+wi_hash_code_t wi_hash_cstring(const char *s, wi_uinteger_t length) {
+	return wi_hash_bytes_with_seed(s, length, _wi_hash_seed);
 }
 
 
 
 wi_hash_code_t wi_hash_pointer(const void *p) {
-#ifdef WI_32
-	return (wi_hash_code_t) ((((uint32_t) p) >> 16) ^ ((uint32_t) p));
-#else
-	return (wi_hash_code_t) ((((uint64_t) p) >> 32) ^ ((uint64_t) p));
-#endif
+	return (wi_hash_code_t) _wi_hash_mix((uint64_t) (uintptr_t) p ^ _WI_HASH_P0, _WI_HASH_P1);
 }
 
 
@@ -283,24 +440,5 @@ wi_hash_code_t wi_hash_double(double d) {
 
 
 wi_hash_code_t wi_hash_data(const unsigned char *bytes, wi_uinteger_t length) {
-	wi_hash_code_t	hash = 0;
-	wi_uinteger_t	i;
-	
-	i = length;
-	
-	while(i > 3) {
-		_WI_ELF_STEP(bytes[length - i    ], hash);
-		_WI_ELF_STEP(bytes[length - i + 1], hash);
-		_WI_ELF_STEP(bytes[length - i + 2], hash);
-		_WI_ELF_STEP(bytes[length - i + 3], hash);
-		i -= 4;
-	}
-
-	switch(i) {
-		case 3: _WI_ELF_STEP(bytes[length - 3], hash);
-		case 2: _WI_ELF_STEP(bytes[length - 2], hash);
-		case 1: _WI_ELF_STEP(bytes[length - 1], hash);
-	}
-	
-	return hash;
+	return wi_hash_bytes_with_seed(bytes, length, _wi_hash_seed);
 }
@@ -37,9 +37,11 @@
 #include <wired/wi-base.h>
 #include <wired/wi-enumerator.h>
 #include <wired/wi-error.h>
+#include <wired/wi-event-loop.h>
 #include <wired/wi-fsenumerator.h>
 #include <wired/wi-set.h>
 #include <wired/wi-thread.h>
+#include <wired/wi-timer.h>
 
 #define WI_RUNTIME_MAGIC				0xAC1DFEED
 
@@ -50,6 +52,38 @@
 	WI_ASSERT(wi_runtime_options((instance)) & WI_RUNTIME_OPTION_MUTABLE,	\
 		"%@ is not mutable", (instance))
 
+#ifdef __GNUC__
+#define WI_ATOMIC_INCREMENT(value)											\
+	__sync_add_and_fetch(&(value), 1)
+
+#define WI_ATOMIC_DECREMENT(value)											\
+	__sync_sub_and_fetch(&(value), 1)
+
+#define WI_ATOMIC_COMPARE_AND_SWAP(value, oldvalue, newvalue)				\
+	__sync_bool_compare_and_swap(&(value), (oldvalue), (newvalue))
+
+#define WI_ATOMIC_LOAD_ACQUIRE(value)										\
+	__atomic_load_n(&(value), __ATOMIC_ACQUIRE)
+
+#define WI_ATOMIC_STORE_RELEASE(value, newvalue)							\
+	__atomic_store_n(&(value), (newvalue), __ATOMIC_RELEASE)
+#else
+#define WI_ATOMIC_INCREMENT(value)											\
+	(++(value))
+
+#define WI_ATOMIC_DECREMENT(value)											\
+	(--(value))
+
+#define WI_ATOMIC_COMPARE_AND_SWAP(value, oldvalue, newvalue)				\
+	((value) == (oldvalue) ? ((value) = (newvalue), 1) : 0)
+
+#define WI_ATOMIC_LOAD_ACQUIRE(value)										\
+	(value)
+
+#define WI_ATOMIC_STORE_RELEASE(value, newvalue)							\
+	((value) = (newvalue))
+#endif
+
 
 struct _wi_enumerator_context {
 	wi_uinteger_t						index;
@@ -64,17 +98,21 @@ typedef void *							wi_enumerator_func_t(wi_runtime_instance_t *, wi_enumerator
 WI_EXPORT void							wi_address_register(void);
 WI_EXPORT void							wi_array_register(void);
 WI_EXPORT void							wi_cipher_register(void);
+WI_EXPORT void							wi_concurrent_dictionary_register(void);
 WI_EXPORT void							wi_config_register(void);
 WI_EXPORT void							wi_data_register(void);
+WI_EXPORT void							wi_data_chain_register(void);
 WI_EXPORT void							wi_date_register(void);
 WI_EXPORT void							wi_dictionary_register(void);
 WI_EXPORT void							wi_digest_register(void);
 WI_EXPORT void							wi_enumerator_register(void);
 WI_EXPORT void							wi_error_register(void);
+WI_EXPORT void							wi_event_loop_register(void);
 WI_EXPORT void							wi_file_register(void);
 WI_EXPORT void							wi_fsenumerator_register(void);
 WI_EXPORT void							wi_fsevents_register(void);
 WI_EXPORT void							wi_host_register(void);
+WI_EXPORT void							wi_integer_set_register(void);
 WI_EXPORT void							wi_lock_register(void);
 WI_EXPORT void							wi_log_register(void);
 WI_EXPORT void							wi_null_register(void);
@@ -82,6 +120,8 @@ WI_EXPORT void							wi_number_register(void);
 WI_EXPORT void							wi_p7_message_register(void);
 WI_EXPORT void							wi_p7_socket_register(void);
 WI_EXPORT void							wi_p7_spec_register(void);
+WI_EXPORT void							wi_persistent_dictionary_register(void);
+WI_EXPORT void							wi_persistent_set_register(void);
 WI_EXPORT void							wi_pool_register(void);
 WI_EXPORT void							wi_process_register(void);
 WI_EXPORT void							wi_random_register(void);
@@ -99,6 +139,7 @@ WI_EXPORT void							wi_terminal_register(void);
 WI_EXPORT void							wi_test_register(void);
 WI_EXPORT void							wi_timer_register(void);
 WI_EXPORT void							wi_thread_register(void);
+WI_EXPORT void							wi_thread_pool_register(void);
 WI_EXPORT void							wi_url_register(void);
 WI_EXPORT void							wi_uuid_register(void);
 WI_EXPORT void							wi_version_register(void);
@@ -107,17 +148,21 @@ WI_EXPORT void							wi_x509_register(void);
 WI_EXPORT void							wi_address_initialize(void);
 WI_EXPORT void							wi_array_initialize(void);
 WI_EXPORT void							wi_cipher_initialize(void);
+WI_EXPORT void							wi_concurrent_dictionary_initialize(void);
 WI_EXPORT void							wi_config_initialize(void);
 WI_EXPORT void							wi_data_initialize(void);
+WI_EXPORT void							wi_data_chain_initialize(void);
 WI_EXPORT void							wi_date_initialize(void);
 WI_EXPORT void							wi_dictionary_initialize(void);
 WI_EXPORT void							wi_digest_initialize(void);
 WI_EXPORT void							wi_enumerator_initialize(void);
 WI_EXPORT void							wi_error_initialize(void);
+WI_EXPORT void							wi_event_loop_initialize(void);
 WI_EXPORT void							wi_file_initialize(void);
 WI_EXPORT void							wi_fsenumerator_initialize(void);
 WI_EXPORT void							wi_fsevents_initialize(void);
 WI_EXPORT void							wi_host_initialize(void);
+WI_EXPORT void							wi_integer_set_initialize(void);
 WI_EXPORT void							wi_lock_initialize(void);
 WI_EXPORT void							wi_log_initialize(void);
 WI_EXPORT void							wi_null_initialize(void);
@@ -125,6 +170,8 @@ WI_EXPORT void							wi_number_initialize(void);
 WI_EXPORT void							wi_p7_message_initialize(void);
 WI_EXPORT void							wi_p7_socket_initialize(void);
 WI_EXPORT void							wi_p7_spec_initialize(void);
+WI_EXPORT void							wi_persistent_dictionary_initialize(void);
+WI_EXPORT void							wi_persistent_set_initialize(void);
 WI_EXPORT void							wi_pool_initialize(void);
 WI_EXPORT void							wi_process_initialize(void);
 WI_EXPORT void							wi_random_initialize(void);
@@ -142,6 +189,7 @@ WI_EXPORT void							wi_terminal_initialize(void);
 WI_EXPORT void							wi_test_initialize(void);
 WI_EXPORT void							wi_timer_initialize(void);
 WI_EXPORT void							wi_thread_initialize(void);
+WI_EXPORT void							wi_thread_pool_initialize(void);
 WI_EXPORT void							wi_url_initialize(void);
 WI_EXPORT void							wi_uuid_initialize(void);
 WI_EXPORT void							wi_version_initialize(void);
@@ -149,12 +197,20 @@ WI_EXPORT void							wi_x509_initialize(void);
 
 WI_EXPORT void							wi_process_load(int, const char **);
 
+WI_EXPORT uint64_t						wi_hash_seed(void);
+WI_EXPORT wi_hash_code_t				wi_hash_bytes_with_seed(const void *, wi_uinteger_t, uint64_t);
 WI_EXPORT wi_hash_code_t				wi_hash_cstring(const char *, wi_uinteger_t);
 WI_EXPORT wi_hash_code_t				wi_hash_pointer(const void *);
 WI_EXPORT wi_hash_code_t				wi_hash_int(int);
 WI_EXPORT wi_hash_code_t				wi_hash_double(double);
 WI_EXPORT wi_hash_code_t				wi_hash_data(const unsigned char *, wi_uinteger_t);
 
+WI_EXPORT wi_dictionary_t *				wi_dictionary_init_without_lock_with_capacity_and_callbacks(wi_dictionary_t *, wi_uinteger_t, wi_dictionary_key_callbacks_t, wi_dictionary_value_callbacks_t);
+WI_EXPORT void *						wi_dictionary_data_for_key_with_hash(wi_dictionary_t *, void *, wi_hash_code_t);
+WI_EXPORT wi_boolean_t					wi_dictionary_contains_key_with_hash(wi_dictionary_t *, void *, wi_hash_code_t);
+WI_EXPORT void							wi_mutable_dictionary_set_data_for_key_with_hash(wi_mutable_dictionary_t *, void *, void *, wi_hash_code_t);
+WI_EXPORT void							wi_mutable_dictionary_remove_data_for_key_with_hash(wi_mutable_dictionary_t *, void *, wi_hash_code_t);
+
 WI_EXPORT wi_enumerator_t *				wi_enumerator_alloc(void);
 WI_EXPORT wi_enumerator_t *				wi_enumerator_init_with_collection(wi_enumerator_t *, wi_runtime_instance_t *, wi_enumerator_func_t *);
 
@@ -203,14 +259,28 @@ WI_EXPORT void							wi_error_set_libwired_error(int);
 WI_EXPORT void							wi_error_set_libwired_error_with_string(int, wi_string_t *);
 WI_EXPORT void							wi_error_set_libwired_error_with_format(int, wi_string_t *, ...);
 
+#ifdef WI_PTHREADS
+WI_EXPORT void							wi_event_loop_schedule_timer(wi_event_loop_t *, wi_timer_t *, wi_time_interval_t, wi_boolean_t, wi_boolean_t);
+WI_EXPORT void							wi_event_loop_invalidate_timer(wi_event_loop_t *, wi_timer_t *);
+WI_EXPORT void							wi_timer_set_scheduled(wi_timer_t *, wi_boolean_t);
+#endif
+
 WI_EXPORT wi_fsenumerator_t *			wi_fsenumerator_alloc(void);
 WI_EXPORT wi_fsenumerator_t *			wi_fsenumerator_init_with_path(wi_fsenumerator_t *, wi_string_t *);
 
+WI_EXPORT void *						wi_memmem_with_anchors(const void *, size_t, const void *, size_t, size_t, size_t, wi_boolean_t, wi_boolean_t);
+
 WI_EXPORT void							wi_runtime_make_immutable(wi_runtime_instance_t *);
+WI_EXPORT void							wi_runtime_make_immortal(wi_runtime_instance_t *);
+WI_EXPORT wi_runtime_instance_t *		wi_runtime_load_instance(wi_runtime_instance_t **);
+WI_EXPORT void							wi_runtime_store_instance(wi_runtime_instance_t **, wi_runtime_instance_t *);
+WI_EXPORT wi_boolean_t					wi_runtime_compare_and_store_instance(wi_runtime_instance_t **, wi_runtime_instance_t *, wi_runtime_instance_t *);
 
 WI_EXPORT void							wi_socket_exit_thread(void);
 
 WI_EXPORT void							wi_thread_set_poolstack(wi_thread_t *, void *);
 WI_EXPORT void *						wi_thread_poolstack(wi_thread_t *);
+WI_EXPORT void							wi_thread_set_error(wi_thread_t *, void *);
+WI_EXPORT void *						wi_thread_error(wi_thread_t *);
 
 #endif /* WI_PRIVATE_H */
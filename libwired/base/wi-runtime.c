@@ -35,6 +35,7 @@
 #include <wired/wi-assert.h>
 #include <wired/wi-file.h>
 #include <wired/wi-lock.h>
+#include <wired/wi-pool.h>
 #include <wired/wi-private.h>
 #include <wired/wi-runtime.h>
 #include <wired/wi-socket.h>
@@ -230,6 +231,13 @@ void wi_runtime_make_immutable(wi_runtime_instance_t *instance) {
 
 
 
+void wi_runtime_make_immortal(wi_runtime_instance_t *instance) {
+	if(instance)
+		WI_RUNTIME_BASE(instance)->options |= WI_RUNTIME_OPTION_IMMORTAL;
+}
+
+
+
 #pragma mark -
 
 static void _wi_runtime_null_abort(wi_runtime_instance_t *instance) {
@@ -263,6 +271,9 @@ wi_runtime_instance_t * wi_retain(wi_runtime_instance_t *instance) {
 
 	_WI_RUNTIME_ASSERT_MAGIC(instance);
 	_WI_RUNTIME_ASSERT_ZOMBIE(instance);
+	
+	if(WI_RUNTIME_BASE(instance)->options & WI_RUNTIME_OPTION_IMMORTAL)
+		return instance;
 
 	wi_recursive_lock_lock(_wi_runtime_retain_count_lock);
 	
@@ -296,6 +307,9 @@ void wi_release(wi_runtime_instance_t *instance) {
 	_WI_RUNTIME_ASSERT_MAGIC(instance);
 	_WI_RUNTIME_ASSERT_ZOMBIE(instance);
 	
+	if(WI_RUNTIME_BASE(instance)->options & WI_RUNTIME_OPTION_IMMORTAL)
+		return;
+	
 	wi_recursive_lock_lock(_wi_runtime_retain_count_lock);
 	
 	if(--WI_RUNTIME_BASE(instance)->retain_count == 0) {
@@ -329,6 +343,63 @@ void wi_release(wi_runtime_instance_t *instance) {
 
 
 
+#pragma mark -
+
+wi_runtime_instance_t * wi_runtime_load_instance(wi_runtime_instance_t **pointer) {
+	wi_runtime_instance_t	*instance;
+	
+	wi_recursive_lock_lock(_wi_runtime_retain_count_lock);
+	
+	instance = wi_retain(*pointer);
+	
+	wi_recursive_lock_unlock(_wi_runtime_retain_count_lock);
+	
+	return wi_autorelease(instance);
+}
+
+
+
+void wi_runtime_store_instance(wi_runtime_instance_t **pointer, wi_runtime_instance_t *instance) {
+	wi_runtime_instance_t	*old_instance;
+	
+	wi_retain(instance);
+	
+	wi_recursive_lock_lock(_wi_runtime_retain_count_lock);
+	
+	old_instance = *pointer;
+	*pointer = instance;
+	
+	wi_recursive_lock_unlock(_wi_runtime_retain_count_lock);
+	
+	wi_release(old_instance);
+}
+
+
+
+wi_boolean_t wi_runtime_compare_and_store_instance(wi_runtime_instance_t **pointer, wi_runtime_instance_t *expected_instance, wi_runtime_instance_t *instance) {
+	wi_boolean_t			stored;
+	
+	wi_retain(instance);
+	
+	wi_recursive_lock_lock(_wi_runtime_retain_count_lock);
+	
+	stored = (*pointer == expected_instance);
+	
+	if(stored)
+		*pointer = instance;
+	
+	wi_recursive_lock_unlock(_wi_runtime_retain_count_lock);
+	
+	if(stored)
+		wi_release(expected_instance);
+	else
+		wi_release(instance);
+	
+	return stored;
+}
+
+
+
 #pragma mark -
 
 wi_runtime_instance_t * wi_copy(wi_runtime_instance_t *instance) {
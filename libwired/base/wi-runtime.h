@@ -41,7 +41,8 @@ typedef uint16_t						wi_runtime_id_t;
 enum {
 	WI_RUNTIME_OPTION_ZOMBIE			= (1 << 0),
 	WI_RUNTIME_OPTION_IMMUTABLE			= (1 << 1),
-	WI_RUNTIME_OPTION_MUTABLE			= (1 << 2)
+	WI_RUNTIME_OPTION_MUTABLE			= (1 << 2),
+	WI_RUNTIME_OPTION_IMMORTAL			= (1 << 3)
 };
 
 
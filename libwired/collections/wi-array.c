@@ -34,16 +34,22 @@
 #include <string.h>
 #include <ctype.h>
 
+#ifdef WI_PTHREADS
+#include <pthread.h>
+#endif
+
 #include <wired/wi-array.h>
 #include <wired/wi-assert.h>
 #include <wired/wi-compat.h>
 #include <wired/wi-lock.h>
 #include <wired/wi-log.h>
 #include <wired/wi-plist.h>
+#include <wired/wi-pool.h>
 #include <wired/wi-private.h>
 #include <wired/wi-runtime.h>
 #include <wired/wi-string.h>
 #include <wired/wi-system.h>
+#include <wired/wi-thread.h>
 
 #if defined(HAVE_QSORT_R) && !defined(HAVE_GLIBC)
 #define _WI_ARRAY_USE_QSORT_R
@@ -52,6 +58,10 @@
 #define _WI_ARRAY_MIN_COUNT				10
 #define _WI_ARRAY_MAX_COUNT				16777213
 
+#define _WI_ARRAY_INSERTION_SORT_COUNT	16
+#define _WI_ARRAY_PARALLEL_SORT_COUNT	8192
+#define _WI_ARRAY_PARALLEL_SORT_THREADS	8
+
 #define _WI_ARRAY_CHECK_OPTIMIZE(array)									\
 	WI_STMT_START														\
 		if((array->items_count >= 3 * array->data_count &&				\
@@ -61,6 +71,12 @@
 			_wi_array_optimize(array);									\
     WI_STMT_END
 
+#define _WI_ARRAY_UNSHARE(array)										\
+	WI_STMT_START														\
+		if((array)->storage->references > 1)							\
+			_wi_array_unshare((array));									\
+	WI_STMT_END
+
 #define _WI_ARRAY_RETAIN(array, data)									\
 	((array)->callbacks.retain											\
 		? (*(array)->callbacks.retain)((data))							\
@@ -89,12 +105,43 @@
 		(array))
 
 
-struct _wi_array_item {
+enum _wi_array_sort_type {
+	_WI_ARRAY_SORT_DATA,
+	_WI_ARRAY_SORT_KEY,
+	_WI_ARRAY_SORT_INTEGER_KEY
+};
+typedef enum _wi_array_sort_type		_wi_array_sort_type_t;
+
+
+struct _wi_array_sort_context {
+	_wi_array_sort_type_t				type;
+	wi_compare_func_t					*compare;
+};
+typedef struct _wi_array_sort_context	_wi_array_sort_context_t;
+
+
+struct _wi_array_sort_entry {
 	void								*data;
+	void								*key;
+	wi_integer_t						integer;
+};
+typedef struct _wi_array_sort_entry		_wi_array_sort_entry_t;
 
-	struct _wi_array_item				*link;
+
+struct _wi_array_sort_job {
+	_wi_array_sort_context_t			*context;
+	void								**items;
+	void								**buffer;
+	wi_uinteger_t						count;
 };
-typedef struct _wi_array_item			_wi_array_item_t;
+typedef struct _wi_array_sort_job		_wi_array_sort_job_t;
+
+
+struct _wi_array_storage {
+	wi_uinteger_t						references;
+	void								*items[];
+};
+typedef struct _wi_array_storage		_wi_array_storage_t;
 
 
 struct _wi_array {
@@ -102,18 +149,13 @@ struct _wi_array {
 	
 	wi_array_callbacks_t				callbacks;
 	
-	_wi_array_item_t					**items;
+	_wi_array_storage_t					*storage;
+	void								**items;
 	wi_uinteger_t						items_count;
 	wi_uinteger_t						min_count;
 	wi_uinteger_t						data_count;
 
 	wi_rwlock_t							*lock;
-
-	_wi_array_item_t					**item_chunks;
-	wi_uinteger_t						item_chunks_count;
-	wi_uinteger_t						item_chunks_offset;
-
-	_wi_array_item_t					*item_free_list;
 };
 
 
@@ -123,15 +165,14 @@ static wi_boolean_t						_wi_array_is_equal(wi_runtime_instance_t *, wi_runtime_
 static wi_string_t *					_wi_array_description(wi_runtime_instance_t *);
 static wi_hash_code_t					_wi_array_hash(wi_runtime_instance_t *);
 
+static void								_wi_array_release_storage(wi_array_t *, _wi_array_storage_t *, wi_uinteger_t);
+static void								_wi_array_resize(wi_array_t *, wi_uinteger_t);
+static void								_wi_array_unshare(wi_array_t *);
 static void								_wi_array_grow(wi_array_t *, wi_uinteger_t);
 static void								_wi_array_optimize(wi_array_t *);
 
-static _wi_array_item_t *				_wi_array_create_item(wi_array_t *);
-static void								_wi_array_remove_item(wi_array_t *, _wi_array_item_t *);
-static void								_wi_array_add_item(wi_array_t *, _wi_array_item_t *);
-static void								_wi_array_add_item_sorted(wi_array_t *, _wi_array_item_t *, wi_compare_func_t *);
-static void								_wi_array_insert_item_at_index(wi_array_t *, _wi_array_item_t *, wi_uinteger_t);
 static void								_wi_array_add_data(wi_array_t *, void *);
+static void								_wi_array_insert_data_at_index(wi_array_t *, void *, wi_uinteger_t);
 static void								_wi_array_remove_all_data(wi_array_t *);
 
 #ifdef _WI_ARRAY_USE_QSORT_R
@@ -140,6 +181,17 @@ static int								_wi_array_compare_data(void *, const void *, const void *);
 static int								_wi_array_compare_data(const void *, const void *);
 #endif
 
+static wi_integer_t						_wi_array_sort_compare(_wi_array_sort_context_t *, void *, void *);
+static void								_wi_array_insertion_sort(_wi_array_sort_context_t *, void **, wi_uinteger_t);
+static void								_wi_array_merge(_wi_array_sort_context_t *, void **, void **, wi_uinteger_t, wi_uinteger_t);
+static void								_wi_array_merge_sort(_wi_array_sort_context_t *, void **, void **, wi_uinteger_t);
+static void								_wi_array_stable_sort(_wi_array_sort_context_t *, void **, wi_uinteger_t);
+static void								_wi_array_parallel_sort(_wi_array_sort_context_t *, void **, wi_uinteger_t);
+#ifdef WI_PTHREADS
+static void *							_wi_array_parallel_sort_thread(void *);
+#endif
+static void								_wi_array_sort_entries(wi_array_t *, _wi_array_sort_context_t *, wi_array_key_func_t *, wi_array_integer_key_func_t *);
+
 
 const wi_array_callbacks_t				wi_array_default_callbacks = {
 	wi_retain,
@@ -155,10 +207,8 @@ const wi_array_callbacks_t				wi_array_null_callbacks = {
 	NULL
 };
 
-static wi_uinteger_t					_wi_array_items_per_page;
-
 #ifndef _WI_ARRAY_USE_QSORT_R
-static wi_lock_t						*_wi_array_sort_lock;
+static wi_fast_lock_t					_wi_array_sort_lock = WI_FAST_LOCK_INITIALIZER;
 static wi_compare_func_t				*_wi_array_sort_function;
 #endif
 
@@ -181,11 +231,6 @@ void wi_array_register(void) {
 
 
 void wi_array_initialize(void) {
-	_wi_array_items_per_page = wi_page_size() / sizeof(_wi_array_item_t);
-	
-#ifndef _WI_ARRAY_USE_QSORT_R
-	_wi_array_sort_lock = wi_lock_init(wi_lock_alloc());
-#endif
 }
 
 
@@ -277,11 +322,10 @@ wi_array_t * wi_array_init_with_capacity(wi_array_t *array, wi_uinteger_t capaci
 
 wi_array_t * wi_array_init_with_capacity_and_callbacks(wi_array_t *array, wi_uinteger_t capacity, wi_array_callbacks_t callbacks) {
 	array->callbacks			= callbacks;
-	array->item_chunks_offset	= _wi_array_items_per_page;
-	array->items_count			= WI_MAX(wi_exp2m1(wi_log2(capacity) + 1), _WI_ARRAY_MIN_COUNT);
-	array->min_count			= array->items_count;
-	array->items				= wi_malloc(array->items_count * sizeof(_wi_array_item_t *));
+	array->min_count			= WI_MAX(wi_exp2m1(wi_log2(capacity) + 1), _WI_ARRAY_MIN_COUNT);
 	array->lock					= wi_rwlock_init(wi_rwlock_alloc());
+
+	_wi_array_resize(array, array->min_count);
 	
 	return array;
 }
@@ -454,37 +498,27 @@ wi_array_t * wi_array_init_with_plist_file(wi_array_t *array, wi_string_t *path)
 
 static void _wi_array_dealloc(wi_runtime_instance_t *instance) {
 	wi_array_t			*array = instance;
-	_wi_array_item_t	*item;
-	wi_uinteger_t		i;
 	
-	for(i = 0; i < array->data_count; i++) {
-		item = array->items[i];
-
-		_WI_ARRAY_RELEASE(array, item->data);
-	}
-	
-	if(array->item_chunks) {
-		for(i = 0; i < array->item_chunks_count; i++)
-			wi_free(array->item_chunks[i]);
-
-		wi_free(array->item_chunks);
-	}
+	_wi_array_release_storage(array, array->storage, array->data_count);
 
 	wi_release(array->lock);
-
-	wi_free(array->items);
 }
 
 
 
 static wi_runtime_instance_t * _wi_array_copy(wi_runtime_instance_t *instance) {
 	wi_array_t		*array = instance, *array_copy;
-	wi_uinteger_t	i;
-
-	array_copy = wi_array_init_with_capacity_and_callbacks(wi_array_alloc(), array->data_count, array->callbacks);
 
-	for(i = 0; i < array->data_count; i++)
-		_wi_array_add_data(array_copy, array->items[i]->data);
+	array_copy = wi_array_alloc();
+	array_copy->callbacks	= array->callbacks;
+	array_copy->storage		= array->storage;
+	array_copy->items		= array->items;
+	array_copy->items_count	= array->items_count;
+	array_copy->min_count	= array->min_count;
+	array_copy->data_count	= array->data_count;
+	array_copy->lock		= wi_rwlock_init(wi_rwlock_alloc());
+	
+	WI_ATOMIC_INCREMENT(array->storage->references);
 
 	return array_copy;
 }
@@ -600,7 +634,7 @@ wi_uinteger_t wi_array_count(wi_array_t *array) {
 void * wi_array_data_at_index(wi_array_t *array, wi_uinteger_t index) {
 	_WI_ARRAY_ASSERT_INDEX(array, index);
 
-	return array->items[index]->data;
+	return array->items[index];
 }
 
 
@@ -608,13 +642,13 @@ void * wi_array_data_at_index(wi_array_t *array, wi_uinteger_t index) {
 #pragma mark -
 
 void * wi_array_first_data(wi_array_t *array) {
-	return array->data_count > 0 ? array->items[0]->data : NULL;
+	return array->data_count > 0 ? array->items[0] : NULL;
 }
 
 
 
 void * wi_array_last_data(wi_array_t *array) {
-	return array->data_count > 0 ? array->items[array->data_count - 1]->data : NULL;
+	return array->data_count > 0 ? array->items[array->data_count - 1] : NULL;
 }
 
 
@@ -629,7 +663,7 @@ wi_uinteger_t wi_array_index_of_data(wi_array_t *array, void *data) {
 	wi_uinteger_t	i;
 
 	for(i = 0; i < array->data_count; i++) {
-		if(_WI_ARRAY_IS_EQUAL(array, array->items[i]->data, data))
+		if(_WI_ARRAY_IS_EQUAL(array, array->items[i], data))
 			return i;
 	}
 
@@ -639,22 +673,19 @@ wi_uinteger_t wi_array_index_of_data(wi_array_t *array, void *data) {
 
 
 void wi_array_get_data(wi_array_t *array, void **data) {
-	wi_uinteger_t	i;
-	
-	for(i = 0; i < array->data_count; i++)
-		data[i] = array->items[i]->data;
+	memcpy(data, array->items, array->data_count * sizeof(void *));
 }
 
 
 
 void wi_array_get_data_in_range(wi_array_t *array, void **data, wi_range_t range) {
-	wi_uinteger_t	i;
+	if(range.length == 0)
+		return;
 	
 	_WI_ARRAY_ASSERT_INDEX(array, range.location);
 	_WI_ARRAY_ASSERT_INDEX(array, range.location + range.length - 1);
 	
-	for(i = range.location; i < range.location + range.length; i++)
-		data[i] = array->items[i]->data;
+	memcpy(data, array->items + range.location, range.length * sizeof(void *));
 }
 
 
@@ -739,6 +770,22 @@ wi_enumerator_t * wi_array_reverse_data_enumerator(wi_array_t *array) {
 
 
 
+wi_uinteger_t wi_array_enumerate_data(wi_array_t *array, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count) {
+	if(state->state >= array->data_count)
+		return 0;
+	
+	count = WI_MIN(count, array->data_count - state->state);
+	
+	memcpy(buffer, array->items + state->state, count * sizeof(void *));
+	
+	state->items = buffer;
+	state->state += count;
+	
+	return count;
+}
+
+
+
 void * wi_enumerator_array_data_enumerator(wi_runtime_instance_t *instance, wi_enumerator_context_t *context) {
 	wi_array_t		*array = instance;
 	void			*data;
@@ -783,7 +830,7 @@ wi_array_t * wi_array_subarray_with_range(wi_array_t *array, wi_range_t range) {
 	newarray = wi_array_init_with_capacity(wi_array_alloc(), range.length);
 	
 	for(i = range.location; i < range.location + range.length; i++)
-		_wi_array_add_data(newarray, WI_ARRAY(array, i));
+		_wi_array_add_data(newarray, array->items[i]);
 
 	return wi_autorelease(newarray);
 }
@@ -794,7 +841,7 @@ wi_array_t * wi_array_by_adding_data(wi_array_t *array, void *data) {
 	wi_mutable_array_t		*newarray;
 	
 	newarray = wi_mutable_copy(array);
-	wi_mutable_array_add_data(array, data);
+	wi_mutable_array_add_data(newarray, data);
 	
 	wi_runtime_make_immutable(newarray);
 	
@@ -807,7 +854,7 @@ wi_array_t * wi_array_by_adding_data_from_array(wi_array_t *array, wi_array_t *o
 	wi_mutable_array_t		*newarray;
 	
 	newarray = wi_mutable_copy(array);
-	wi_mutable_array_add_data_from_array(array, otherarray);
+	wi_mutable_array_add_data_from_array(newarray, otherarray);
 	
 	wi_runtime_make_immutable(newarray);
 	
@@ -845,143 +892,111 @@ wi_array_t * wi_array_by_sorting(wi_array_t *array, wi_compare_func_t *compare)
 
 #pragma mark -
 
-static void _wi_array_grow(wi_array_t *array, wi_uinteger_t index) {
-	wi_uinteger_t		items_count;
+static void _wi_array_release_storage(wi_array_t *array, _wi_array_storage_t *storage, wi_uinteger_t count) {
+	wi_uinteger_t		i;
+	
+	if(WI_ATOMIC_DECREMENT(storage->references) > 0)
+		return;
+	
+	for(i = 0; i < count; i++)
+		_WI_ARRAY_RELEASE(array, storage->items[i]);
 	
-	items_count			= (wi_uinteger_t) ((double) ((index + 1) * 3) / 2.0);
-	array->items		= wi_realloc(array->items, items_count * sizeof(_wi_array_item_t *));
-	array->items_count	= items_count;
+	wi_free(storage);
 }
 
 
 
-static void _wi_array_optimize(wi_array_t *array) {
-	wi_uinteger_t		items_count;
-
-	items_count			= WI_CLAMP(array->data_count, array->min_count, _WI_ARRAY_MAX_COUNT);
-	array->items		= wi_realloc(array->items, items_count * sizeof(_wi_array_item_t *));
-	array->items_count	= items_count;
+static void _wi_array_resize(wi_array_t *array, wi_uinteger_t items_count) {
+	array->storage				= wi_realloc(array->storage, sizeof(_wi_array_storage_t) + (items_count * sizeof(void *)));
+	array->storage->references	= 1;
+	array->items				= array->storage->items;
+	array->items_count			= items_count;
 }
 
 
 
-#pragma mark -
-
-static _wi_array_item_t * _wi_array_create_item(wi_array_t *array) {
-	_wi_array_item_t	*item, *item_block;
-	size_t				size;
-
-	if(!array->item_free_list) {
-		if(array->item_chunks_offset == _wi_array_items_per_page) {
-			array->item_chunks_count++;
-
-			size = array->item_chunks_count * sizeof(_wi_array_item_t *);
-			array->item_chunks = wi_realloc(array->item_chunks, size);
-
-			size = _wi_array_items_per_page * sizeof(_wi_array_item_t);
-			array->item_chunks[array->item_chunks_count - 1] = wi_malloc(size);
-
-			array->item_chunks_offset = 0;
-		}
+static void _wi_array_unshare(wi_array_t *array) {
+	_wi_array_storage_t		*storage;
+	wi_uinteger_t			i;
+	
+	storage = array->storage;
+	
+	array->storage = NULL;
+	
+	_wi_array_resize(array, array->items_count);
+	
+	for(i = 0; i < array->data_count; i++)
+		array->items[i] = _WI_ARRAY_RETAIN(array, storage->items[i]);
+	
+	_wi_array_release_storage(array, storage, array->data_count);
+}
 
-		item_block = array->item_chunks[array->item_chunks_count - 1];
-		array->item_free_list = &item_block[array->item_chunks_offset++];
-		array->item_free_list->link = NULL;
-	}
 
-	item = array->item_free_list;
-	array->item_free_list = item->link;
 
-	return item;
+static void _wi_array_grow(wi_array_t *array, wi_uinteger_t index) {
+	_wi_array_resize(array, WI_MAX(index + 1, array->items_count + (array->items_count / 2)));
 }
 
 
 
-static void _wi_array_remove_item(wi_array_t *array, _wi_array_item_t *item) {
-	_WI_ARRAY_RELEASE(array, item->data);
-	item->data = NULL;
-	
-	item->link = array->item_free_list;
-	array->item_free_list = item;
+static void _wi_array_optimize(wi_array_t *array) {
+	_wi_array_resize(array, WI_CLAMP(array->data_count, array->min_count, _WI_ARRAY_MAX_COUNT));
 }
 
 
 
-static void _wi_array_add_item(wi_array_t *array, _wi_array_item_t *item) {
+#pragma mark -
+
+static void _wi_array_add_data(wi_array_t *array, void *data) {
+	_WI_ARRAY_UNSHARE(array);
+	
 	if(array->data_count >= array->items_count)
 		_wi_array_grow(array, array->data_count);
 
-	array->items[array->data_count] = item;
+	array->items[array->data_count] = _WI_ARRAY_RETAIN(array, data);
 	array->data_count++;
 }
 
 
 
-static void _wi_array_add_item_sorted(wi_array_t *array, _wi_array_item_t *item, wi_compare_func_t *compare) {
-	wi_uinteger_t		i;
+static void _wi_array_insert_data_at_index(wi_array_t *array, void *data, wi_uinteger_t index) {
+	_WI_ARRAY_UNSHARE(array);
 	
-	if(array->data_count == 0) {
-		_wi_array_add_item(array, item);
-	} else {
-		for(i = 0; i < array->data_count; i++) {
-			if((*compare)(item->data, array->items[i]->data) < 0) {
-				_wi_array_insert_item_at_index(array, item, i);
-				
-				return;
-			}
-		}
-		
-		_wi_array_add_item(array, item);
-	}
-}
-
-
-
-static void _wi_array_insert_item_at_index(wi_array_t *array, _wi_array_item_t *item, wi_uinteger_t index) {
 	if(array->data_count >= array->items_count)
-		_wi_array_grow(array, array->data_count + 1);
+		_wi_array_grow(array, array->data_count);
 	
 	memmove(array->items + index + 1,
 			array->items + index,
-			(array->data_count - index) * sizeof(_wi_array_item_t *));
+			(array->data_count - index) * sizeof(void *));
 	
-	array->items[index] = item;
+	array->items[index] = _WI_ARRAY_RETAIN(array, data);
 	array->data_count++;
 }
 
 
 
-static void _wi_array_add_data(wi_array_t *array, void *data) {
-	_wi_array_item_t	*item;
-	
-	item = _wi_array_create_item(array);
-	item->data = _WI_ARRAY_RETAIN(array, data);
-
-	_wi_array_add_item(array, item);
-}
-
-
-
 static void _wi_array_remove_all_data(wi_array_t *array) {
-	wi_uinteger_t		i, count;
-	_wi_array_item_t	*item;
+	_wi_array_storage_t		*storage;
+	wi_uinteger_t			i, count;
 	
 	count = array->data_count;
 	
-	if(count > 0) {
-		for(i = 0; i < count; i++) {
-			item = array->items[i];
-			
-			WI_ASSERT(item != NULL, "NULL item at index %lu (count %lu) in array %p",
-				i, count, array);
-
-			_wi_array_remove_item(array, item);
-		}
+	if(array->storage->references > 1) {
+		storage = array->storage;
+		
+		array->storage		= NULL;
+		array->data_count	= 0;
+		
+		_wi_array_resize(array, array->min_count);
+		_wi_array_release_storage(array, storage, count);
+	} else {
+		for(i = 0; i < count; i++)
+			_WI_ARRAY_RELEASE(array, array->items[i]);
 		
 		array->data_count = 0;
+		
+		_WI_ARRAY_CHECK_OPTIMIZE(array);
 	}
-
-	_WI_ARRAY_CHECK_OPTIMIZE(array);
 }
 
 
@@ -998,7 +1013,7 @@ void wi_mutable_array_add_data(wi_mutable_array_t *array, void *data) {
 
 
 void wi_mutable_array_add_data_sorted(wi_mutable_array_t *array, void *data, wi_compare_func_t *compare) {
-	_wi_array_item_t	*item;
+	wi_uinteger_t		low, high, middle;
 
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 	
@@ -1008,10 +1023,19 @@ void wi_mutable_array_add_data_sorted(wi_mutable_array_t *array, void *data, wi_
 			array);
 	}
 
-	item = _wi_array_create_item(array);
-	item->data = _WI_ARRAY_RETAIN(array, data);
+	low = 0;
+	high = array->data_count;
+	
+	while(low < high) {
+		middle = low + ((high - low) / 2);
+		
+		if((*compare)(data, array->items[middle]) < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
 
-	_wi_array_add_item_sorted(array, item, compare);
+	_wi_array_insert_data_at_index(array, data, low);
 }
 
 
@@ -1021,17 +1045,20 @@ void wi_mutable_array_add_data_from_array(wi_mutable_array_t *array, wi_array_t
 	
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 
-	count = wi_array_count(otherarray);
+	count = otherarray->data_count;
+	
+	_WI_ARRAY_UNSHARE(array);
+	
+	if(array->data_count + count > array->items_count)
+		_wi_array_grow(array, array->data_count + count - 1);
 	
 	for(i = 0; i < count; i++)
-		_wi_array_add_data(array, wi_array_data_at_index(otherarray, i));
+		_wi_array_add_data(array, otherarray->items[i]);
 }
 
 
 
 void wi_mutable_array_insert_data_at_index(wi_mutable_array_t *array, void *data, wi_uinteger_t index) {
-	_wi_array_item_t	*item;
-	
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 	_WI_ARRAY_ASSERT_INDEX(array, index);
 	
@@ -1041,16 +1068,13 @@ void wi_mutable_array_insert_data_at_index(wi_mutable_array_t *array, void *data
 			array);
 	}
 
-	item = _wi_array_create_item(array);
-	item->data = _WI_ARRAY_RETAIN(array, data);
-
-	_wi_array_insert_item_at_index(array, item, index);
+	_wi_array_insert_data_at_index(array, data, index);
 }
 
 
 
 void wi_mutable_array_replace_data_at_index(wi_mutable_array_t *array, void *data, wi_uinteger_t index) {
-	_wi_array_item_t	*item;
+	void		*olddata;
 	
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 	_WI_ARRAY_ASSERT_INDEX(array, index);
@@ -1061,11 +1085,12 @@ void wi_mutable_array_replace_data_at_index(wi_mutable_array_t *array, void *dat
 			array);
 	}
 
-	item = _wi_array_create_item(array);
-	item->data = _WI_ARRAY_RETAIN(array, data);
+	_WI_ARRAY_UNSHARE(array);
+	
+	olddata = array->items[index];
+	array->items[index] = _WI_ARRAY_RETAIN(array, data);
 	
-	_wi_array_remove_item(array, array->items[index]);
-	array->items[index] = item;
+	_WI_ARRAY_RELEASE(array, olddata);
 }
 
 
@@ -1073,8 +1098,22 @@ void wi_mutable_array_replace_data_at_index(wi_mutable_array_t *array, void *dat
 void wi_mutable_array_set_array(wi_mutable_array_t *array, wi_array_t *otherarray) {
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 
-	_wi_array_remove_all_data(array);
-	wi_mutable_array_add_data_from_array(array, otherarray);
+	if(array->storage == otherarray->storage)
+		return;
+	
+	if(memcmp(&array->callbacks, &otherarray->callbacks, sizeof(array->callbacks)) == 0) {
+		WI_ATOMIC_INCREMENT(otherarray->storage->references);
+		
+		_wi_array_release_storage(array, array->storage, array->data_count);
+		
+		array->storage		= otherarray->storage;
+		array->items		= otherarray->items;
+		array->items_count	= otherarray->items_count;
+		array->data_count	= otherarray->data_count;
+	} else {
+		_wi_array_remove_all_data(array);
+		wi_mutable_array_add_data_from_array(array, otherarray);
+	}
 }
 
 
@@ -1104,37 +1143,34 @@ void wi_mutable_array_remove_data_at_index(wi_mutable_array_t *array, wi_uintege
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 	_WI_ARRAY_ASSERT_INDEX(array, index);
 	
-	_wi_array_remove_item(array, array->items[index]);
-
-	array->items[index] = NULL;
-	
-	if(index != array->data_count - 1) {
-		memmove(array->items + index,
-				array->items + index + 1,
-				(array->data_count - index - 1) * sizeof(_wi_array_item_t *));
-
-		array->items[array->data_count - 1] = NULL;
-	}
-	
-	array->data_count--;
-
-	_WI_ARRAY_CHECK_OPTIMIZE(array);
+	wi_mutable_array_remove_data_in_range(array, wi_make_range(index, 1));
 }
 
 
 
 void wi_mutable_array_remove_data_in_range(wi_mutable_array_t *array, wi_range_t range) {
-	wi_uinteger_t	count;
+	wi_uinteger_t	i;
 	
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 
-	count = range.length;
+	if(range.length == 0)
+		return;
 	
-	while(count > 0) {
-		wi_mutable_array_remove_data_at_index(array, range.location);
-		
-		count--;
-	}
+	_WI_ARRAY_ASSERT_INDEX(array, range.location);
+	_WI_ARRAY_ASSERT_INDEX(array, range.location + range.length - 1);
+	
+	_WI_ARRAY_UNSHARE(array);
+	
+	for(i = range.location; i < range.location + range.length; i++)
+		_WI_ARRAY_RELEASE(array, array->items[i]);
+	
+	memmove(array->items + range.location,
+			array->items + range.location + range.length,
+			(array->data_count - range.location - range.length) * sizeof(void *));
+	
+	array->data_count -= range.length;
+
+	_WI_ARRAY_CHECK_OPTIMIZE(array);
 }
 
 
@@ -1183,46 +1219,324 @@ static int _wi_array_compare_data(const void *p1, const void *p2) {
 
 
 void wi_mutable_array_sort(wi_array_t *array, wi_compare_func_t *compare) {
-	void			**data;
-	wi_uinteger_t	i;
-	
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 
 	if(array->data_count == 0)
 		return;
 	
-	data = wi_malloc(sizeof(void *) * array->data_count);
-	wi_array_get_data(array, data);
-
+	_WI_ARRAY_UNSHARE(array);
+	
 #ifdef _WI_ARRAY_USE_QSORT_R
-	qsort_r(data, array->data_count, sizeof(void *), compare, _wi_array_compare_data);
+	qsort_r(array->items, array->data_count, sizeof(void *), compare, _wi_array_compare_data);
 #else
-	wi_lock_lock(_wi_array_sort_lock);
+	wi_fast_lock_lock(&_wi_array_sort_lock);
 	_wi_array_sort_function = compare;
-	qsort(data, array->data_count, sizeof(void *), _wi_array_compare_data);
-	wi_lock_unlock(_wi_array_sort_lock);
+	qsort(array->items, array->data_count, sizeof(void *), _wi_array_compare_data);
+	wi_fast_lock_unlock(&_wi_array_sort_lock);
 #endif
-	
-	for(i = 0; i < array->data_count; i++)
-		array->items[i]->data = data[i];
-	
-	wi_free(data);
 }
 
 
 
 void wi_mutable_array_reverse(wi_array_t *array) {
-	_wi_array_item_t	*item;
+	void				*data;
 	wi_uinteger_t		i, max, count;
 	
 	WI_RUNTIME_ASSERT_MUTABLE(array);
 
+	_WI_ARRAY_UNSHARE(array);
+	
 	count = array->data_count;
 	max = count / 2;
 
 	for(i = 0; i < max; i++) {
-		item = array->items[i];
+		data = array->items[i];
 		array->items[i] = array->items[count - i - 1];
-		array->items[count - i - 1] = item;
+		array->items[count - i - 1] = data;
+	}
+}
+
+
+
+#pragma mark -
+
+static wi_integer_t _wi_array_sort_compare(_wi_array_sort_context_t *context, void *data1, void *data2) {
+	_wi_array_sort_entry_t		*entry1, *entry2;
+	
+	switch(context->type) {
+		case _WI_ARRAY_SORT_DATA:
+			return (*context->compare)(data1, data2);
+		
+		case _WI_ARRAY_SORT_KEY:
+			entry1 = data1;
+			entry2 = data2;
+			
+			return (*context->compare)(entry1->key, entry2->key);
+		
+		case _WI_ARRAY_SORT_INTEGER_KEY:
+			entry1 = data1;
+			entry2 = data2;
+			
+			if(entry1->integer < entry2->integer)
+				return -1;
+			else if(entry1->integer > entry2->integer)
+				return 1;
+			
+			return 0;
+	}
+	
+	return 0;
+}
+
+
+
+static void _wi_array_insertion_sort(_wi_array_sort_context_t *context, void **items, wi_uinteger_t count) {
+	void				*data;
+	wi_uinteger_t		i, j;
+	
+	for(i = 1; i < count; i++) {
+		data = items[i];
+		
+		for(j = i; j > 0 && _wi_array_sort_compare(context, data, items[j - 1]) < 0; j--)
+			items[j] = items[j - 1];
+		
+		items[j] = data;
+	}
+}
+
+
+
+static void _wi_array_merge(_wi_array_sort_context_t *context, void **items, void **buffer, wi_uinteger_t middle, wi_uinteger_t count) {
+	wi_uinteger_t		i, j, k;
+	
+	if(middle == 0 || middle == count)
+		return;
+	
+	if(_wi_array_sort_compare(context, items[middle - 1], items[middle]) <= 0)
+		return;
+	
+	memcpy(buffer, items, middle * sizeof(void *));
+	
+	i = 0;
+	j = middle;
+	k = 0;
+	
+	while(i < middle && j < count) {
+		if(_wi_array_sort_compare(context, items[j], buffer[i]) < 0)
+			items[k++] = items[j++];
+		else
+			items[k++] = buffer[i++];
+	}
+	
+	while(i < middle)
+		items[k++] = buffer[i++];
+}
+
+
+
+static void _wi_array_merge_sort(_wi_array_sort_context_t *context, void **items, void **buffer, wi_uinteger_t count) {
+	wi_uinteger_t		middle;
+	
+	if(count <= _WI_ARRAY_INSERTION_SORT_COUNT) {
+		_wi_array_insertion_sort(context, items, count);
+		
+		return;
+	}
+	
+	middle = count / 2;
+	
+	_wi_array_merge_sort(context, items, buffer, middle);
+	_wi_array_merge_sort(context, items + middle, buffer + middle, count - middle);
+	_wi_array_merge(context, items, buffer, middle, count);
+}
+
+
+
+static void _wi_array_stable_sort(_wi_array_sort_context_t *context, void **items, wi_uinteger_t count) {
+	void		**buffer;
+	
+	if(count <= _WI_ARRAY_INSERTION_SORT_COUNT) {
+		_wi_array_insertion_sort(context, items, count);
+		
+		return;
+	}
+	
+	buffer = wi_malloc(count * sizeof(void *));
+	
+	_wi_array_merge_sort(context, items, buffer, count);
+	
+	wi_free(buffer);
+}
+
+
+
+static void _wi_array_parallel_sort(_wi_array_sort_context_t *context, void **items, wi_uinteger_t count) {
+#ifdef WI_PTHREADS
+	_wi_array_sort_job_t	jobs[_WI_ARRAY_PARALLEL_SORT_THREADS];
+	pthread_t				threads[_WI_ARRAY_PARALLEL_SORT_THREADS];
+	wi_boolean_t			started[_WI_ARRAY_PARALLEL_SORT_THREADS];
+	wi_uinteger_t			offsets[_WI_ARRAY_PARALLEL_SORT_THREADS + 1];
+	void					**buffer;
+	wi_uinteger_t			i, jobs_count, width;
+	
+	jobs_count = WI_MIN(wi_processor_count(), _WI_ARRAY_PARALLEL_SORT_THREADS);
+	jobs_count = WI_MIN(jobs_count, count / _WI_ARRAY_PARALLEL_SORT_COUNT);
+	
+	if(jobs_count < 2) {
+		_wi_array_stable_sort(context, items, count);
+		
+		return;
+	}
+	
+	buffer = wi_malloc(count * sizeof(void *));
+	
+	for(i = 0; i <= jobs_count; i++)
+		offsets[i] = (count * i) / jobs_count;
+	
+	for(i = 0; i < jobs_count; i++) {
+		jobs[i].context		= context;
+		jobs[i].items		= items + offsets[i];
+		jobs[i].buffer		= buffer + offsets[i];
+		jobs[i].count		= offsets[i + 1] - offsets[i];
+		started[i]			= false;
 	}
+	
+	for(i = 1; i < jobs_count; i++)
+		started[i] = (pthread_create(&threads[i], NULL, _wi_array_parallel_sort_thread, &jobs[i]) == 0);
+	
+	_wi_array_merge_sort(context, jobs[0].items, jobs[0].buffer, jobs[0].count);
+	
+	for(i = 1; i < jobs_count; i++) {
+		if(started[i])
+			pthread_join(threads[i], NULL);
+		else
+			_wi_array_merge_sort(context, jobs[i].items, jobs[i].buffer, jobs[i].count);
+	}
+	
+	for(width = 1; width < jobs_count; width *= 2) {
+		for(i = 0; i + width < jobs_count; i += 2 * width) {
+			_wi_array_merge(context,
+							items + offsets[i],
+							buffer,
+							offsets[i + width] - offsets[i],
+							offsets[WI_MIN(i + 2 * width, jobs_count)] - offsets[i]);
+		}
+	}
+	
+	wi_free(buffer);
+#else
+	_wi_array_stable_sort(context, items, count);
+#endif
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void * _wi_array_parallel_sort_thread(void *arg) {
+	_wi_array_sort_job_t	*job = arg;
+	wi_pool_t				*pool;
+	
+	wi_thread_enter_thread();
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	_wi_array_merge_sort(job->context, job->items, job->buffer, job->count);
+	wi_release(pool);
+	
+	wi_thread_exit_thread();
+	
+	return NULL;
+}
+
+#endif
+
+
+
+static void _wi_array_sort_entries(wi_array_t *array, _wi_array_sort_context_t *context, wi_array_key_func_t *key, wi_array_integer_key_func_t *integer) {
+	_wi_array_sort_entry_t		*entries;
+	void						**items;
+	wi_uinteger_t				i, count;
+	
+	count = array->data_count;
+	
+	if(count < 2)
+		return;
+	
+	_WI_ARRAY_UNSHARE(array);
+	
+	entries		= wi_malloc(count * sizeof(_wi_array_sort_entry_t));
+	items		= wi_malloc(count * sizeof(void *));
+	
+	for(i = 0; i < count; i++) {
+		entries[i].data = array->items[i];
+		
+		if(key)
+			entries[i].key = (*key)(array->items[i]);
+		else
+			entries[i].integer = (*integer)(array->items[i]);
+		
+		items[i] = &entries[i];
+	}
+	
+	_wi_array_stable_sort(context, items, count);
+	
+	for(i = 0; i < count; i++)
+		array->items[i] = ((_wi_array_sort_entry_t *) items[i])->data;
+	
+	wi_free(items);
+	wi_free(entries);
+}
+
+
+
+void wi_mutable_array_stable_sort(wi_mutable_array_t *array, wi_compare_func_t *compare) {
+	_wi_array_sort_context_t	context;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(array);
+	
+	context.type		= _WI_ARRAY_SORT_DATA;
+	context.compare		= compare;
+	
+	_WI_ARRAY_UNSHARE(array);
+	_wi_array_stable_sort(&context, array->items, array->data_count);
+}
+
+
+
+void wi_mutable_array_parallel_sort(wi_mutable_array_t *array, wi_compare_func_t *compare) {
+	_wi_array_sort_context_t	context;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(array);
+	
+	context.type		= _WI_ARRAY_SORT_DATA;
+	context.compare		= compare;
+	
+	_WI_ARRAY_UNSHARE(array);
+	_wi_array_parallel_sort(&context, array->items, array->data_count);
+}
+
+
+
+void wi_mutable_array_sort_by_key(wi_mutable_array_t *array, wi_array_key_func_t *key, wi_compare_func_t *compare) {
+	_wi_array_sort_context_t	context;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(array);
+	
+	context.type		= _WI_ARRAY_SORT_KEY;
+	context.compare		= compare;
+	
+	_wi_array_sort_entries(array, &context, key, NULL);
+}
+
+
+
+void wi_mutable_array_sort_by_integer_key(wi_mutable_array_t *array, wi_array_integer_key_func_t *integer) {
+	_wi_array_sort_context_t	context;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(array);
+	
+	context.type		= _WI_ARRAY_SORT_INTEGER_KEY;
+	context.compare		= NULL;
+	
+	_wi_array_sort_entries(array, &context, NULL, integer);
 }
@@ -45,6 +45,9 @@ struct _wi_array_callbacks {
 };
 typedef struct _wi_array_callbacks		wi_array_callbacks_t;
 
+typedef void *							wi_array_key_func_t(void *);
+typedef wi_integer_t					wi_array_integer_key_func_t(void *);
+
 
 WI_EXPORT wi_runtime_id_t				wi_array_runtime_id(void);
 
@@ -87,6 +90,7 @@ WI_EXPORT void							wi_array_destroy_argv(wi_uinteger_t, const char **);
 
 WI_EXPORT wi_enumerator_t *				wi_array_data_enumerator(wi_array_t *);
 WI_EXPORT wi_enumerator_t *				wi_array_reverse_data_enumerator(wi_array_t *);
+WI_EXPORT wi_uinteger_t					wi_array_enumerate_data(wi_array_t *, wi_enumeration_state_t *, void **, wi_uinteger_t);
 
 WI_EXPORT wi_array_t *					wi_array_subarray_with_range(wi_array_t *, wi_range_t);
 WI_EXPORT wi_array_t *					wi_array_by_adding_data(wi_array_t *, void *);
@@ -110,6 +114,10 @@ WI_EXPORT void							wi_mutable_array_remove_data_in_array(wi_mutable_array_t *,
 WI_EXPORT void							wi_mutable_array_remove_all_data(wi_mutable_array_t *);
 
 WI_EXPORT void							wi_mutable_array_sort(wi_mutable_array_t *, wi_compare_func_t *);
+WI_EXPORT void							wi_mutable_array_stable_sort(wi_mutable_array_t *, wi_compare_func_t *);
+WI_EXPORT void							wi_mutable_array_parallel_sort(wi_mutable_array_t *, wi_compare_func_t *);
+WI_EXPORT void							wi_mutable_array_sort_by_key(wi_mutable_array_t *, wi_array_key_func_t *, wi_compare_func_t *);
+WI_EXPORT void							wi_mutable_array_sort_by_integer_key(wi_mutable_array_t *, wi_array_integer_key_func_t *);
 WI_EXPORT void							wi_mutable_array_reverse(wi_mutable_array_t *);
 
 
@@ -0,0 +1,372 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wired/wi-concurrent-dictionary.h>
+#include <wired/wi-dictionary.h>
+#include <wired/wi-lock.h>
+#include <wired/wi-pool.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-string.h>
+#include <wired/wi-system.h>
+
+#define _WI_CONCURRENT_DICTIONARY_STRIPE_BITS	5
+#define _WI_CONCURRENT_DICTIONARY_STRIPES		(1 << _WI_CONCURRENT_DICTIONARY_STRIPE_BITS)
+
+#define _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key)							\
+	((dictionary)->key_callbacks.hash													\
+		? (*(dictionary)->key_callbacks.hash)((key))									\
+		: (wi_hash_code_t) (uintptr_t) (key))
+
+/* the stripe takes the top bits of a different multiplier than the inner tables, so both stay spread */
+#define _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash)								\
+	(&(dictionary)->stripes[((uint64_t) (hash) * 0xff51afd7ed558ccdULL) >>				\
+		(64 - _WI_CONCURRENT_DICTIONARY_STRIPE_BITS)])
+
+#define _WI_CONCURRENT_DICTIONARY_RETURN_DATA(dictionary, data)						\
+	(((dictionary)->value_callbacks.retain == wi_retain)								\
+		? wi_autorelease(wi_retain((data)))												\
+		: (data))
+
+
+struct _wi_concurrent_dictionary_stripe {
+	wi_rwlock_t								*lock;
+	wi_mutable_dictionary_t					*dictionary;
+};
+typedef struct _wi_concurrent_dictionary_stripe	_wi_concurrent_dictionary_stripe_t;
+
+
+struct _wi_concurrent_dictionary {
+	wi_runtime_base_t						base;
+	
+	wi_dictionary_key_callbacks_t			key_callbacks;
+	wi_dictionary_value_callbacks_t			value_callbacks;
+	
+	_wi_concurrent_dictionary_stripe_t		stripes[_WI_CONCURRENT_DICTIONARY_STRIPES];
+};
+
+
+static void									_wi_concurrent_dictionary_dealloc(wi_runtime_instance_t *);
+static wi_string_t *						_wi_concurrent_dictionary_description(wi_runtime_instance_t *);
+
+
+static wi_runtime_id_t						_wi_concurrent_dictionary_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t					_wi_concurrent_dictionary_runtime_class = {
+	"wi_concurrent_dictionary_t",
+	_wi_concurrent_dictionary_dealloc,
+	NULL,
+	NULL,
+	_wi_concurrent_dictionary_description,
+	NULL
+};
+
+
+
+void wi_concurrent_dictionary_register(void) {
+	_wi_concurrent_dictionary_runtime_id = wi_runtime_register_class(&_wi_concurrent_dictionary_runtime_class);
+}
+
+
+
+void wi_concurrent_dictionary_initialize(void) {
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_concurrent_dictionary_runtime_id(void) {
+	return _wi_concurrent_dictionary_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_concurrent_dictionary_t * wi_concurrent_dictionary(void) {
+	return wi_autorelease(wi_concurrent_dictionary_init(wi_concurrent_dictionary_alloc()));
+}
+
+
+
+#pragma mark -
+
+wi_concurrent_dictionary_t * wi_concurrent_dictionary_alloc(void) {
+	return wi_runtime_create_instance(_wi_concurrent_dictionary_runtime_id, sizeof(wi_concurrent_dictionary_t));
+}
+
+
+
+wi_concurrent_dictionary_t * wi_concurrent_dictionary_init(wi_concurrent_dictionary_t *dictionary) {
+	return wi_concurrent_dictionary_init_with_capacity(dictionary, 0);
+}
+
+
+
+wi_concurrent_dictionary_t * wi_concurrent_dictionary_init_with_capacity(wi_concurrent_dictionary_t *dictionary, wi_uinteger_t capacity) {
+	return wi_concurrent_dictionary_init_with_capacity_and_callbacks(dictionary, capacity,
+		wi_dictionary_default_key_callbacks, wi_dictionary_default_value_callbacks);
+}
+
+
+
+wi_concurrent_dictionary_t * wi_concurrent_dictionary_init_with_capacity_and_callbacks(wi_concurrent_dictionary_t *dictionary, wi_uinteger_t capacity, wi_dictionary_key_callbacks_t key_callbacks, wi_dictionary_value_callbacks_t value_callbacks) {
+	wi_uinteger_t		i;
+	
+	dictionary->key_callbacks		= key_callbacks;
+	dictionary->value_callbacks		= value_callbacks;
+	
+	for(i = 0; i < _WI_CONCURRENT_DICTIONARY_STRIPES; i++) {
+		dictionary->stripes[i].lock			= wi_rwlock_init(wi_rwlock_alloc());
+		dictionary->stripes[i].dictionary	= wi_dictionary_init_without_lock_with_capacity_and_callbacks(wi_mutable_dictionary_alloc(),
+			capacity / _WI_CONCURRENT_DICTIONARY_STRIPES, key_callbacks, value_callbacks);
+	}
+	
+	return dictionary;
+}
+
+
+
+static void _wi_concurrent_dictionary_dealloc(wi_runtime_instance_t *instance) {
+	wi_concurrent_dictionary_t		*dictionary = instance;
+	wi_uinteger_t					i;
+	
+	for(i = 0; i < _WI_CONCURRENT_DICTIONARY_STRIPES; i++) {
+		wi_release(dictionary->stripes[i].dictionary);
+		wi_release(dictionary->stripes[i].lock);
+	}
+}
+
+
+
+static wi_string_t * _wi_concurrent_dictionary_description(wi_runtime_instance_t *instance) {
+	wi_concurrent_dictionary_t		*dictionary = instance;
+	
+	return wi_string_with_format(WI_STR("<%@ %p>{dictionary = %@}"),
+		wi_runtime_class_name(dictionary),
+		dictionary,
+		wi_concurrent_dictionary_dictionary(dictionary));
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_concurrent_dictionary_count(wi_concurrent_dictionary_t *dictionary) {
+	wi_uinteger_t		i, count;
+	
+	count = 0;
+	
+	for(i = 0; i < _WI_CONCURRENT_DICTIONARY_STRIPES; i++) {
+		wi_rwlock_rdlock(dictionary->stripes[i].lock);
+		count += wi_dictionary_count(dictionary->stripes[i].dictionary);
+		wi_rwlock_unlock(dictionary->stripes[i].lock);
+	}
+	
+	return count;
+}
+
+
+
+void * wi_concurrent_dictionary_data_for_key(wi_concurrent_dictionary_t *dictionary, void *key) {
+	_wi_concurrent_dictionary_stripe_t		*stripe;
+	void									*data;
+	wi_hash_code_t							hash;
+	
+	hash = _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key);
+	stripe = _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash);
+	
+	wi_rwlock_rdlock(stripe->lock);
+	
+	data = wi_dictionary_data_for_key_with_hash(stripe->dictionary, key, hash);
+	
+	if(data)
+		data = _WI_CONCURRENT_DICTIONARY_RETURN_DATA(dictionary, data);
+	
+	wi_rwlock_unlock(stripe->lock);
+	
+	return data;
+}
+
+
+
+wi_boolean_t wi_concurrent_dictionary_contains_key(wi_concurrent_dictionary_t *dictionary, void *key) {
+	_wi_concurrent_dictionary_stripe_t		*stripe;
+	wi_boolean_t							contains;
+	wi_hash_code_t							hash;
+	
+	hash = _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key);
+	stripe = _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash);
+	
+	wi_rwlock_rdlock(stripe->lock);
+	contains = wi_dictionary_contains_key_with_hash(stripe->dictionary, key, hash);
+	wi_rwlock_unlock(stripe->lock);
+	
+	return contains;
+}
+
+
+
+wi_dictionary_t * wi_concurrent_dictionary_dictionary(wi_concurrent_dictionary_t *dictionary) {
+	wi_mutable_dictionary_t		*snapshot;
+	wi_uinteger_t				i;
+	
+	snapshot = wi_dictionary_init_with_capacity_and_callbacks(wi_mutable_dictionary_alloc(), 0,
+		dictionary->key_callbacks, dictionary->value_callbacks);
+	
+	for(i = 0; i < _WI_CONCURRENT_DICTIONARY_STRIPES; i++) {
+		wi_rwlock_rdlock(dictionary->stripes[i].lock);
+		wi_mutable_dictionary_add_entries_from_dictionary(snapshot, dictionary->stripes[i].dictionary);
+		wi_rwlock_unlock(dictionary->stripes[i].lock);
+	}
+	
+	wi_runtime_make_immutable(snapshot);
+	
+	return wi_autorelease(snapshot);
+}
+
+
+
+#pragma mark -
+
+void wi_concurrent_dictionary_set_data_for_key(wi_concurrent_dictionary_t *dictionary, void *data, void *key) {
+	_wi_concurrent_dictionary_stripe_t		*stripe;
+	wi_hash_code_t							hash;
+	
+	hash = _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key);
+	stripe = _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash);
+	
+	wi_rwlock_wrlock(stripe->lock);
+	wi_mutable_dictionary_set_data_for_key_with_hash(stripe->dictionary, data, key, hash);
+	wi_rwlock_unlock(stripe->lock);
+}
+
+
+
+void * wi_concurrent_dictionary_set_data_for_key_if_absent(wi_concurrent_dictionary_t *dictionary, void *data, void *key) {
+	_wi_concurrent_dictionary_stripe_t		*stripe;
+	void									*existing_data;
+	wi_hash_code_t							hash;
+	
+	hash = _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key);
+	stripe = _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash);
+	
+	wi_rwlock_rdlock(stripe->lock);
+	existing_data = wi_dictionary_data_for_key_with_hash(stripe->dictionary, key, hash);
+	
+	if(existing_data)
+		existing_data = _WI_CONCURRENT_DICTIONARY_RETURN_DATA(dictionary, existing_data);
+	
+	wi_rwlock_unlock(stripe->lock);
+	
+	if(existing_data)
+		return existing_data;
+	
+	wi_rwlock_wrlock(stripe->lock);
+	existing_data = wi_dictionary_data_for_key_with_hash(stripe->dictionary, key, hash);
+	
+	if(existing_data)
+		data = existing_data;
+	else
+		wi_mutable_dictionary_set_data_for_key_with_hash(stripe->dictionary, data, key, hash);
+	
+	data = _WI_CONCURRENT_DICTIONARY_RETURN_DATA(dictionary, data);
+	
+	wi_rwlock_unlock(stripe->lock);
+	
+	return data;
+}
+
+
+
+void * wi_concurrent_dictionary_compute_data_for_key_if_absent(wi_concurrent_dictionary_t *dictionary, void *key, wi_concurrent_dictionary_compute_func_t *function, void *context) {
+	_wi_concurrent_dictionary_stripe_t		*stripe;
+	void									*data;
+	wi_hash_code_t							hash;
+	
+	hash = _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key);
+	stripe = _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash);
+	
+	wi_rwlock_rdlock(stripe->lock);
+	data = wi_dictionary_data_for_key_with_hash(stripe->dictionary, key, hash);
+	
+	if(data)
+		data = _WI_CONCURRENT_DICTIONARY_RETURN_DATA(dictionary, data);
+	
+	wi_rwlock_unlock(stripe->lock);
+	
+	if(data)
+		return data;
+	
+	wi_rwlock_wrlock(stripe->lock);
+	data = wi_dictionary_data_for_key_with_hash(stripe->dictionary, key, hash);
+	
+	if(!data) {
+		data = (*function)(key, context);
+		
+		if(data)
+			wi_mutable_dictionary_set_data_for_key_with_hash(stripe->dictionary, data, key, hash);
+	}
+	
+	if(data)
+		data = _WI_CONCURRENT_DICTIONARY_RETURN_DATA(dictionary, data);
+	
+	wi_rwlock_unlock(stripe->lock);
+	
+	return data;
+}
+
+
+
+#pragma mark -
+
+void wi_concurrent_dictionary_remove_data_for_key(wi_concurrent_dictionary_t *dictionary, void *key) {
+	_wi_concurrent_dictionary_stripe_t		*stripe;
+	wi_hash_code_t							hash;
+	
+	hash = _WI_CONCURRENT_DICTIONARY_KEY_HASH(dictionary, key);
+	stripe = _WI_CONCURRENT_DICTIONARY_STRIPE(dictionary, hash);
+	
+	wi_rwlock_wrlock(stripe->lock);
+	wi_mutable_dictionary_remove_data_for_key_with_hash(stripe->dictionary, key, hash);
+	wi_rwlock_unlock(stripe->lock);
+}
+
+
+
+void wi_concurrent_dictionary_remove_all_data(wi_concurrent_dictionary_t *dictionary) {
+	wi_uinteger_t		i;
+	
+	for(i = 0; i < _WI_CONCURRENT_DICTIONARY_STRIPES; i++) {
+		wi_rwlock_wrlock(dictionary->stripes[i].lock);
+		wi_mutable_dictionary_remove_all_data(dictionary->stripes[i].dictionary);
+		wi_rwlock_unlock(dictionary->stripes[i].lock);
+	}
+}
@@ -0,0 +1,62 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_CONCURRENT_DICTIONARY_H
+#define WI_CONCURRENT_DICTIONARY_H 1
+
+#include <wired/wi-base.h>
+#include <wired/wi-dictionary.h>
+#include <wired/wi-runtime.h>
+
+typedef struct _wi_concurrent_dictionary				wi_concurrent_dictionary_t;
+
+typedef void * wi_concurrent_dictionary_compute_func_t(void *, void *);
+
+
+WI_EXPORT wi_runtime_id_t								wi_concurrent_dictionary_runtime_id(void);
+
+WI_EXPORT wi_concurrent_dictionary_t *					wi_concurrent_dictionary(void);
+
+WI_EXPORT wi_concurrent_dictionary_t *					wi_concurrent_dictionary_alloc(void);
+WI_EXPORT wi_concurrent_dictionary_t *					wi_concurrent_dictionary_init(wi_concurrent_dictionary_t *);
+WI_EXPORT wi_concurrent_dictionary_t *					wi_concurrent_dictionary_init_with_capacity(wi_concurrent_dictionary_t *, wi_uinteger_t);
+WI_EXPORT wi_concurrent_dictionary_t *					wi_concurrent_dictionary_init_with_capacity_and_callbacks(wi_concurrent_dictionary_t *, wi_uinteger_t, wi_dictionary_key_callbacks_t, wi_dictionary_value_callbacks_t);
+
+WI_EXPORT wi_uinteger_t									wi_concurrent_dictionary_count(wi_concurrent_dictionary_t *);
+WI_EXPORT void *										wi_concurrent_dictionary_data_for_key(wi_concurrent_dictionary_t *, void *);
+WI_EXPORT wi_boolean_t									wi_concurrent_dictionary_contains_key(wi_concurrent_dictionary_t *, void *);
+WI_EXPORT wi_dictionary_t *								wi_concurrent_dictionary_dictionary(wi_concurrent_dictionary_t *);
+
+WI_EXPORT void											wi_concurrent_dictionary_set_data_for_key(wi_concurrent_dictionary_t *, void *, void *);
+WI_EXPORT void *										wi_concurrent_dictionary_set_data_for_key_if_absent(wi_concurrent_dictionary_t *, void *, void *);
+WI_EXPORT void *										wi_concurrent_dictionary_compute_data_for_key_if_absent(wi_concurrent_dictionary_t *, void *, wi_concurrent_dictionary_compute_func_t *, void *);
+
+WI_EXPORT void											wi_concurrent_dictionary_remove_data_for_key(wi_concurrent_dictionary_t *, void *);
+WI_EXPORT void											wi_concurrent_dictionary_remove_all_data(wi_concurrent_dictionary_t *);
+
+#endif /* WI_CONCURRENT_DICTIONARY_H */
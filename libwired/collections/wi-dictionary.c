@@ -48,16 +48,29 @@
 #define _WI_DICTIONARY_USE_QSORT_R
 #endif
 
-#define _WI_DICTIONARY_MIN_COUNT				11
-#define _WI_DICTIONARY_MAX_COUNT				16777213
+#define _WI_DICTIONARY_MIN_CAPACITY				16
 
-#define _WI_DICTIONARY_CHECK_RESIZE(dictionary)								\
+#define _WI_DICTIONARY_CONTROL_EMPTY			0x00
+#define _WI_DICTIONARY_CONTROL_DELETED			0x01
+#define _WI_DICTIONARY_CONTROL_FULL				0x80
+
+#define _WI_DICTIONARY_IS_FULL(dictionary, i)								\
+	((dictionary)->controls[(i)] & _WI_DICTIONARY_CONTROL_FULL)
+
+#define _WI_DICTIONARY_HASH_MIX(hash)										\
+	((uint64_t) (hash) * 0x9e3779b97f4a7c15ULL)
+
+/* the control byte is the top 7 bits of the mixed hash and the index the bits right below them */
+#define _WI_DICTIONARY_HASH_INDEX(dictionary, hash)							\
+	((wi_uinteger_t) ((_WI_DICTIONARY_HASH_MIX(hash) << 7) >> (dictionary)->shift))
+
+#define _WI_DICTIONARY_HASH_CONTROL(hash)									\
+	((uint8_t) (_WI_DICTIONARY_CONTROL_FULL | (_WI_DICTIONARY_HASH_MIX(hash) >> 57)))
+
+#define _WI_DICTIONARY_UNSHARE(dictionary)									\
 	WI_STMT_START															\
-		if((dictionary->buckets_count >= 3 * dictionary->key_count &&		\
-		    dictionary->buckets_count >  dictionary->min_count) ||			\
-		   (dictionary->key_count     >= 3 * dictionary->buckets_count &&	\
-			dictionary->buckets_count <  _WI_DICTIONARY_MAX_COUNT))			\
-			_wi_dictionary_resize(dictionary);								\
+		if((dictionary)->storage->references > 1)							\
+			_wi_dictionary_unshare((dictionary));							\
 	WI_STMT_END
 
 #define _WI_DICTIONARY_KEY_RETAIN(dictionary, key)							\
@@ -74,13 +87,12 @@
 #define _WI_DICTIONARY_KEY_HASH(dictionary, key)							\
 	((dictionary)->key_callbacks.hash										\
 		? (*(dictionary)->key_callbacks.hash)((key))						\
-		: wi_hash_pointer((key)))
+		: (wi_hash_code_t) (uintptr_t) (key))
 
 #define _WI_DICTIONARY_KEY_IS_EQUAL(dictionary, key1, key2)					\
-	(((dictionary)->key_callbacks.is_equal &&								\
-	  (*(dictionary)->key_callbacks.is_equal)((key1), (key2))) ||			\
-	 (!(dictionary)->key_callbacks.is_equal &&								\
-	  (key1) == (key2)))
+	((key1) == (key2) ||													\
+	 ((dictionary)->key_callbacks.is_equal &&								\
+	  (*(dictionary)->key_callbacks.is_equal)((key1), (key2))))
 
 #define _WI_DICTIONARY_VALUE_RETAIN(dictionary, value)						\
 	((dictionary)->value_callbacks.retain									\
@@ -100,13 +112,19 @@
 	  (value1) == (value2)))
 
 
-struct _wi_dictionary_bucket {
+struct _wi_dictionary_entry {
 	void								*key;
 	void								*data;
+	wi_hash_code_t						hash;
+};
+typedef struct _wi_dictionary_entry		_wi_dictionary_entry_t;
+
 
-	struct _wi_dictionary_bucket		*next, *link;
+struct _wi_dictionary_storage {
+	wi_uinteger_t						references;
+	_wi_dictionary_entry_t				entries[];
 };
-typedef struct _wi_dictionary_bucket	_wi_dictionary_bucket_t;
+typedef struct _wi_dictionary_storage	_wi_dictionary_storage_t;
 
 
 struct _wi_dictionary {
@@ -115,18 +133,16 @@ struct _wi_dictionary {
 	wi_dictionary_key_callbacks_t		key_callbacks;
 	wi_dictionary_value_callbacks_t		value_callbacks;
 
-	_wi_dictionary_bucket_t				**buckets;
-	wi_uinteger_t						buckets_count;
-	wi_uinteger_t						min_count;
+	_wi_dictionary_storage_t			*storage;
+	uint8_t								*controls;
+	_wi_dictionary_entry_t				*entries;
+	wi_uinteger_t						capacity;
+	wi_uinteger_t						min_capacity;
+	wi_uinteger_t						shift;
 	wi_uinteger_t						key_count;
+	wi_uinteger_t						deleted_count;
 	
 	wi_rwlock_t							*lock;
-	
-	_wi_dictionary_bucket_t				**bucket_chunks;
-	wi_uinteger_t						bucket_chunks_count;
-	wi_uinteger_t						bucket_chunks_offset;
-
-	_wi_dictionary_bucket_t				*bucket_free_list;
 };
 
 
@@ -136,21 +152,25 @@ static wi_boolean_t						_wi_dictionary_is_equal(wi_runtime_instance_t *, wi_run
 static wi_string_t *					_wi_dictionary_description(wi_runtime_instance_t *);
 static wi_hash_code_t					_wi_dictionary_hash(wi_runtime_instance_t *);
 
-static _wi_dictionary_bucket_t *		_wi_enumerator_dictionary_enumerator(wi_runtime_instance_t *, wi_enumerator_context_t *);
+static wi_uinteger_t					_wi_dictionary_enumerate(wi_dictionary_t *, wi_enumeration_state_t *, void **, wi_uinteger_t, wi_boolean_t);
+static _wi_dictionary_entry_t *			_wi_enumerator_dictionary_enumerator(wi_runtime_instance_t *, wi_enumerator_context_t *);
 
-static void								_wi_dictionary_resize(wi_dictionary_t *);
+static wi_uinteger_t					_wi_dictionary_capacity_for_count(wi_uinteger_t);
+static void								_wi_dictionary_allocate(wi_dictionary_t *, wi_uinteger_t);
+static void								_wi_dictionary_resize(wi_dictionary_t *, wi_uinteger_t);
+static void								_wi_dictionary_release_storage(wi_dictionary_t *, _wi_dictionary_storage_t *, uint8_t *, wi_uinteger_t);
+static void								_wi_dictionary_unshare(wi_dictionary_t *);
 
-static _wi_dictionary_bucket_t *		_wi_dictionary_bucket_create(wi_dictionary_t *);
-static _wi_dictionary_bucket_t *		_wi_dictionary_bucket_for_key(wi_dictionary_t *, void *, wi_uinteger_t);
-static void								_wi_dictionary_bucket_remove(wi_dictionary_t *, _wi_dictionary_bucket_t *);
-static void								_wi_dictionary_set_data_for_key(wi_mutable_dictionary_t *, void *, void *);
-static void								_wi_dictionary_remove_data_for_key(wi_mutable_dictionary_t *, void *);
+static wi_uinteger_t					_wi_dictionary_index_for_key(wi_dictionary_t *, void *, wi_hash_code_t);
+static wi_uinteger_t					_wi_dictionary_index_for_insert(wi_dictionary_t *, wi_hash_code_t);
+static void								_wi_dictionary_set_data_for_key(wi_mutable_dictionary_t *, void *, void *, wi_hash_code_t);
+static void								_wi_dictionary_remove_data_for_key(wi_mutable_dictionary_t *, void *, wi_hash_code_t);
 static void								_wi_dictionary_remove_all_data(wi_mutable_dictionary_t *);
 
 #ifdef _WI_DICTIONARY_USE_QSORT_R
-static int								_wi_dictionary_compare_buckets(void *, const void *, const void *);
+static int								_wi_dictionary_compare_entries(void *, const void *, const void *);
 #else
-static int								_wi_dictionary_compare_buckets(const void *, const void *);
+static int								_wi_dictionary_compare_entries(const void *, const void *);
 #endif
 
 
@@ -186,10 +206,8 @@ const wi_dictionary_value_callbacks_t	wi_dictionary_null_value_callbacks = {
 
 static wi_dictionary_t					*_wi_dictionary0;
 
-static wi_uinteger_t					_wi_dictionary_buckets_per_page;
-
 #ifndef _WI_DICTIONARY_USE_QSORT_R
-static wi_lock_t						*_wi_dictionary_sort_lock;
+static wi_fast_lock_t					_wi_dictionary_sort_lock = WI_FAST_LOCK_INITIALIZER;
 static wi_compare_func_t				*_wi_dictionary_sort_function;
 #endif
 
@@ -212,12 +230,6 @@ void wi_dictionary_register(void) {
 
 
 void wi_dictionary_initialize(void) {
-	_wi_dictionary_buckets_per_page = wi_page_size() / sizeof(_wi_dictionary_bucket_t);
-
-#ifndef _WI_DICTIONARY_USE_QSORT_R
-	_wi_dictionary_sort_lock = wi_lock_init(wi_lock_alloc());
-#endif
-	
 	_wi_dictionary0 = wi_dictionary_init(wi_dictionary_alloc());
 }
 
@@ -246,13 +258,13 @@ wi_dictionary_t * wi_dictionary_with_data_and_keys(void *data0, void *key0, ...)
 
 	dictionary = wi_dictionary_init(wi_dictionary_alloc());
 	
-	_wi_dictionary_set_data_for_key(dictionary, data0, key0);
+	_wi_dictionary_set_data_for_key(dictionary, data0, key0, _WI_DICTIONARY_KEY_HASH(dictionary, key0));
 
 	va_start(ap, key0);
 	while((data = va_arg(ap, void *))) {
 		key = va_arg(ap, void *);
 		
-		_wi_dictionary_set_data_for_key(dictionary, data, key);   
+		_wi_dictionary_set_data_for_key(dictionary, data, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));   
 	}
 	va_end(ap);
 	
@@ -284,13 +296,13 @@ wi_mutable_dictionary_t * wi_mutable_dictionary_with_data_and_keys(void *data0,
 
 	dictionary = wi_dictionary_init(wi_mutable_dictionary_alloc());
 	
-	_wi_dictionary_set_data_for_key(dictionary, data0, key0);
+	_wi_dictionary_set_data_for_key(dictionary, data0, key0, _WI_DICTIONARY_KEY_HASH(dictionary, key0));
 
 	va_start(ap, key0);
 	while((data = va_arg(ap, void *))) {
 		key = va_arg(ap, void *);
 		
-		_wi_dictionary_set_data_for_key(dictionary, data, key);   
+		_wi_dictionary_set_data_for_key(dictionary, data, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));   
 	}
 	va_end(ap);
 	
@@ -327,13 +339,20 @@ wi_dictionary_t * wi_dictionary_init_with_capacity(wi_dictionary_t *dictionary,
 
 
 wi_dictionary_t * wi_dictionary_init_with_capacity_and_callbacks(wi_dictionary_t *dictionary, wi_uinteger_t capacity, wi_dictionary_key_callbacks_t key_callbacks, wi_dictionary_value_callbacks_t value_callbacks) {
+	dictionary = wi_dictionary_init_without_lock_with_capacity_and_callbacks(dictionary, capacity, key_callbacks, value_callbacks);
+	dictionary->lock = wi_rwlock_init(wi_rwlock_alloc());
+	
+	return dictionary;
+}
+
+
+
+wi_dictionary_t * wi_dictionary_init_without_lock_with_capacity_and_callbacks(wi_dictionary_t *dictionary, wi_uinteger_t capacity, wi_dictionary_key_callbacks_t key_callbacks, wi_dictionary_value_callbacks_t value_callbacks) {
 	dictionary->key_callbacks			= key_callbacks;
 	dictionary->value_callbacks			= value_callbacks;
-	dictionary->bucket_chunks_offset	= _wi_dictionary_buckets_per_page;
-	dictionary->min_count				= WI_MAX(wi_exp2m1(wi_log2(capacity) + 1), _WI_DICTIONARY_MIN_COUNT);
-	dictionary->buckets_count			= dictionary->min_count;
-	dictionary->buckets					= wi_malloc(dictionary->buckets_count * sizeof(_wi_dictionary_bucket_t *));
-	dictionary->lock					= wi_rwlock_init(wi_rwlock_alloc());
+	dictionary->min_capacity			= _wi_dictionary_capacity_for_count(capacity);
+	
+	_wi_dictionary_allocate(dictionary, dictionary->min_capacity);
 	
 	return dictionary;
 }
@@ -350,7 +369,7 @@ wi_dictionary_t * wi_dictionary_init_with_data_and_keys(wi_dictionary_t *diction
 	while((data = va_arg(ap, void *))) {
 		key = va_arg(ap, void *);
 		
-		_wi_dictionary_set_data_for_key(dictionary, data, key);   
+		_wi_dictionary_set_data_for_key(dictionary, data, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));   
 	}
 	va_end(ap);
 	
@@ -383,16 +402,21 @@ wi_dictionary_t * wi_dictionary_init_with_plist_file(wi_dictionary_t *dictionary
 
 static wi_runtime_instance_t * _wi_dictionary_copy(wi_runtime_instance_t *instance) {
 	wi_dictionary_t				*dictionary = instance, *dictionary_copy;
-	_wi_dictionary_bucket_t		*bucket;
-	wi_uinteger_t				i;
 	
-	dictionary_copy = wi_dictionary_init_with_capacity_and_callbacks(wi_dictionary_alloc(), dictionary->key_count,
-		dictionary->key_callbacks, dictionary->value_callbacks);
+	dictionary_copy = wi_dictionary_alloc();
+	dictionary_copy->key_callbacks		= dictionary->key_callbacks;
+	dictionary_copy->value_callbacks	= dictionary->value_callbacks;
+	dictionary_copy->storage			= dictionary->storage;
+	dictionary_copy->controls			= dictionary->controls;
+	dictionary_copy->entries			= dictionary->entries;
+	dictionary_copy->capacity			= dictionary->capacity;
+	dictionary_copy->min_capacity		= dictionary->min_capacity;
+	dictionary_copy->shift				= dictionary->shift;
+	dictionary_copy->key_count			= dictionary->key_count;
+	dictionary_copy->deleted_count		= dictionary->deleted_count;
+	dictionary_copy->lock				= wi_rwlock_init(wi_rwlock_alloc());
 	
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next)
-			_wi_dictionary_set_data_for_key(dictionary_copy, bucket->data, bucket->key);
-	}
+	WI_ATOMIC_INCREMENT(dictionary->storage->references);
 	
 	return dictionary_copy;
 }
@@ -401,24 +425,8 @@ static wi_runtime_instance_t * _wi_dictionary_copy(wi_runtime_instance_t *instan
 
 static void _wi_dictionary_dealloc(wi_runtime_instance_t *instance) {
 	wi_dictionary_t				*dictionary = instance;
-	_wi_dictionary_bucket_t		*bucket;
-	wi_uinteger_t				i;
-	
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next) {
-			_WI_DICTIONARY_VALUE_RELEASE(dictionary, bucket->data);
-			_WI_DICTIONARY_KEY_RELEASE(dictionary, bucket->key);
-		}
-	}
-
-	if(dictionary->bucket_chunks) {
-		for(i = 0; i < dictionary->bucket_chunks_count; i++)
-			wi_free(dictionary->bucket_chunks[i]);
-
-		wi_free(dictionary->bucket_chunks);
-	}
 	
-	wi_free(dictionary->buckets);
+	_wi_dictionary_release_storage(dictionary, dictionary->storage, dictionary->controls, dictionary->capacity);
 
 	wi_release(dictionary->lock);
 }
@@ -428,7 +436,7 @@ static void _wi_dictionary_dealloc(wi_runtime_instance_t *instance) {
 static wi_boolean_t _wi_dictionary_is_equal(wi_runtime_instance_t *instance1, wi_runtime_instance_t *instance2) {
 	wi_dictionary_t				*dictionary1 = instance1;
 	wi_dictionary_t				*dictionary2 = instance2;
-	_wi_dictionary_bucket_t		*bucket;
+	_wi_dictionary_entry_t		*entry;
 	wi_uinteger_t				i;
 
 	if(dictionary1->key_count != dictionary2->key_count)
@@ -437,9 +445,11 @@ static wi_boolean_t _wi_dictionary_is_equal(wi_runtime_instance_t *instance1, wi
 	if(dictionary1->value_callbacks.is_equal != dictionary2->value_callbacks.is_equal)
 		return false;
 	
-	for(i = 0; i < dictionary1->buckets_count; i++) {
-		for(bucket = dictionary1->buckets[i]; bucket; bucket = bucket->next) {
-			if(!_WI_DICTIONARY_VALUE_IS_EQUAL(dictionary1, bucket->data, wi_dictionary_data_for_key(dictionary2, bucket->key)))
+	for(i = 0; i < dictionary1->capacity; i++) {
+		if(_WI_DICTIONARY_IS_FULL(dictionary1, i)) {
+			entry = &dictionary1->entries[i];
+			
+			if(!_WI_DICTIONARY_VALUE_IS_EQUAL(dictionary1, entry->data, wi_dictionary_data_for_key(dictionary2, entry->key)))
 				return false;
 		}
 	}
@@ -451,7 +461,7 @@ static wi_boolean_t _wi_dictionary_is_equal(wi_runtime_instance_t *instance1, wi
 
 static wi_string_t * _wi_dictionary_description(wi_runtime_instance_t *instance) {
 	wi_dictionary_t				*dictionary = instance;
-	_wi_dictionary_bucket_t		*bucket;
+	_wi_dictionary_entry_t		*entry;
 	wi_mutable_string_t			*string;
 	wi_string_t					*key_description, *value_description;
 	wi_uinteger_t				i;
@@ -462,17 +472,19 @@ static wi_string_t * _wi_dictionary_description(wi_runtime_instance_t *instance)
 		dictionary->key_count,
 		wi_runtime_options(dictionary) & WI_RUNTIME_OPTION_MUTABLE ? 1 : 0);
 
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next) {
+	for(i = 0; i < dictionary->capacity; i++) {
+		if(_WI_DICTIONARY_IS_FULL(dictionary, i)) {
+			entry = &dictionary->entries[i];
+			
 			if(dictionary->key_callbacks.description)
-				key_description = (*dictionary->key_callbacks.description)(bucket->key);
+				key_description = (*dictionary->key_callbacks.description)(entry->key);
 			else
-				key_description = wi_string_with_format(WI_STR("%p"), bucket->key);
+				key_description = wi_string_with_format(WI_STR("%p"), entry->key);
 
 			if(dictionary->value_callbacks.description)
-				value_description = (*dictionary->value_callbacks.description)(bucket->data);
+				value_description = (*dictionary->value_callbacks.description)(entry->data);
 			else
-				value_description = wi_string_with_format(WI_STR("%p"), bucket->data);
+				value_description = wi_string_with_format(WI_STR("%p"), entry->data);
 			
 			wi_mutable_string_append_format(string, WI_STR("    %@: %@\n"), key_description, value_description);
 		}
@@ -539,14 +551,18 @@ wi_uinteger_t wi_dictionary_count(wi_dictionary_t *dictionary) {
 
 
 void * wi_dictionary_data_for_key(wi_dictionary_t *dictionary, void *key) {
-	_wi_dictionary_bucket_t		*bucket;
-	wi_uinteger_t				index;
+	return wi_dictionary_data_for_key_with_hash(dictionary, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));
+}
+
 
-	index = _WI_DICTIONARY_KEY_HASH(dictionary, key) % dictionary->buckets_count;
-	bucket = _wi_dictionary_bucket_for_key(dictionary, key, index);
+
+void * wi_dictionary_data_for_key_with_hash(wi_dictionary_t *dictionary, void *key, wi_hash_code_t hash) {
+	wi_uinteger_t		index;
+
+	index = _wi_dictionary_index_for_key(dictionary, key, hash);
 	
-	if(bucket)
-		return bucket->data;
+	if(index != WI_NOT_FOUND)
+		return dictionary->entries[index].data;
 	
 	return NULL;
 }
@@ -556,20 +572,19 @@ void * wi_dictionary_data_for_key(wi_dictionary_t *dictionary, void *key) {
 #pragma mark -
 
 wi_boolean_t wi_dictionary_contains_key(wi_dictionary_t *dictionary, void *key) {
-	_wi_dictionary_bucket_t		*bucket;
-	wi_uinteger_t				index;
+	return wi_dictionary_contains_key_with_hash(dictionary, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));
+}
 
-	index = _WI_DICTIONARY_KEY_HASH(dictionary, key) % dictionary->buckets_count;
-	bucket = _wi_dictionary_bucket_for_key(dictionary, key, index);
-	
-	return (bucket != NULL);
+
+
+wi_boolean_t wi_dictionary_contains_key_with_hash(wi_dictionary_t *dictionary, void *key, wi_hash_code_t hash) {
+	return (_wi_dictionary_index_for_key(dictionary, key, hash) != WI_NOT_FOUND);
 }
 
 
 
 wi_array_t * wi_dictionary_all_keys(wi_dictionary_t *dictionary) {
 	wi_mutable_array_t			*array;
-	_wi_dictionary_bucket_t		*bucket;
 	wi_array_callbacks_t		callbacks;
 	wi_uinteger_t				i;
 	
@@ -579,9 +594,9 @@ wi_array_t * wi_dictionary_all_keys(wi_dictionary_t *dictionary) {
 	callbacks.description		= dictionary->key_callbacks.description;
 	array						= wi_array_init_with_capacity_and_callbacks(wi_mutable_array_alloc(), dictionary->key_count, callbacks);
 
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next)
-			wi_mutable_array_add_data(array, bucket->key);
+	for(i = 0; i < dictionary->capacity; i++) {
+		if(_WI_DICTIONARY_IS_FULL(dictionary, i))
+			wi_mutable_array_add_data(array, dictionary->entries[i].key);
 	}
 	
 	wi_runtime_make_immutable(array);
@@ -593,7 +608,6 @@ wi_array_t * wi_dictionary_all_keys(wi_dictionary_t *dictionary) {
 
 wi_array_t * wi_dictionary_all_values(wi_dictionary_t *dictionary) {
 	wi_array_t					*array;
-	_wi_dictionary_bucket_t		*bucket;
 	wi_array_callbacks_t		callbacks;
 	wi_uinteger_t				i;
 	
@@ -603,9 +617,9 @@ wi_array_t * wi_dictionary_all_values(wi_dictionary_t *dictionary) {
 	callbacks.description		= dictionary->value_callbacks.description;
 	array						= wi_array_init_with_capacity_and_callbacks(wi_mutable_array_alloc(), dictionary->key_count, callbacks);
 
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next)
-			wi_mutable_array_add_data(array, bucket->data);
+	for(i = 0; i < dictionary->capacity; i++) {
+		if(_WI_DICTIONARY_IS_FULL(dictionary, i))
+			wi_mutable_array_add_data(array, dictionary->entries[i].data);
 	}
 	
 	wi_runtime_make_immutable(array);
@@ -617,14 +631,14 @@ wi_array_t * wi_dictionary_all_values(wi_dictionary_t *dictionary) {
 
 #ifdef _WI_DICTIONARY_USE_QSORT_R
 
-static int _wi_dictionary_compare_buckets(void *context, const void *p1, const void *p2) {
-	return (*(wi_compare_func_t *) context)((*(_wi_dictionary_bucket_t **) p1)->data, (*(_wi_dictionary_bucket_t **) p2)->data);
+static int _wi_dictionary_compare_entries(void *context, const void *p1, const void *p2) {
+	return (*(wi_compare_func_t *) context)((*(_wi_dictionary_entry_t **) p1)->data, (*(_wi_dictionary_entry_t **) p2)->data);
 }
 
 #else
 
-static int _wi_dictionary_compare_buckets(const void *p1, const void *p2) {
-	return (*_wi_dictionary_sort_function)((*(_wi_dictionary_bucket_t **) p1)->data, (*(_wi_dictionary_bucket_t **) p2)->data);
+static int _wi_dictionary_compare_entries(const void *p1, const void *p2) {
+	return (*_wi_dictionary_sort_function)((*(_wi_dictionary_entry_t **) p1)->data, (*(_wi_dictionary_entry_t **) p2)->data);
 }
 
 #endif
@@ -632,36 +646,28 @@ static int _wi_dictionary_compare_buckets(const void *p1, const void *p2) {
 
 
 wi_array_t * wi_dictionary_keys_sorted_by_value(wi_dictionary_t *dictionary, wi_compare_func_t *compare) {
-	wi_mutable_array_t			*array, *buckets;
-	_wi_dictionary_bucket_t		*bucket;
+	wi_mutable_array_t			*array;
 	wi_array_callbacks_t		callbacks;
 	void						**data;
-	wi_uinteger_t				i;
+	wi_uinteger_t				i, count;
 	
 	if(dictionary->key_count == 0)
 		return wi_autorelease(wi_array_init(wi_array_alloc()));
 	
-	callbacks.retain		= NULL;
-	callbacks.release		= NULL;
-	callbacks.is_equal		= NULL;
-	callbacks.description	= NULL;
-	buckets					= wi_array_init_with_capacity_and_callbacks(wi_mutable_array_alloc(), dictionary->key_count, callbacks);
-
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next)
-			wi_mutable_array_add_data(buckets, bucket);
-	}
-	
 	data = wi_malloc(sizeof(void *) * dictionary->key_count);
-	wi_array_get_data(buckets, data);
+	
+	for(i = count = 0; i < dictionary->capacity; i++) {
+		if(_WI_DICTIONARY_IS_FULL(dictionary, i))
+			data[count++] = &dictionary->entries[i];
+	}
 	
 #ifdef _WI_DICTIONARY_USE_QSORT_R
-	qsort_r(data, dictionary->key_count, sizeof(void *), compare, _wi_dictionary_compare_buckets);
+	qsort_r(data, dictionary->key_count, sizeof(void *), compare, _wi_dictionary_compare_entries);
 #else
-	wi_lock_lock(_wi_dictionary_sort_lock);
+	wi_fast_lock_lock(&_wi_dictionary_sort_lock);
 	_wi_dictionary_sort_function = compare;
-	qsort(data, dictionary->key_count, sizeof(void *), _wi_dictionary_compare_buckets);
-	wi_lock_unlock(_wi_dictionary_sort_lock);
+	qsort(data, dictionary->key_count, sizeof(void *), _wi_dictionary_compare_entries);
+	wi_fast_lock_unlock(&_wi_dictionary_sort_lock);
 #endif
 	
 	callbacks.retain		= dictionary->key_callbacks.retain;
@@ -671,10 +677,9 @@ wi_array_t * wi_dictionary_keys_sorted_by_value(wi_dictionary_t *dictionary, wi_
 	array					= wi_array_init_with_capacity_and_callbacks(wi_mutable_array_alloc(), dictionary->key_count, callbacks);
 
 	for(i = 0; i < dictionary->key_count; i++)
-		wi_mutable_array_add_data(array, ((_wi_dictionary_bucket_t *) data[i])->key);
+		wi_mutable_array_add_data(array, ((_wi_dictionary_entry_t *) data[i])->key);
 	
 	wi_free(data);
-	wi_release(buckets);
 
 	wi_runtime_make_immutable(array);
 
@@ -697,34 +702,45 @@ wi_enumerator_t * wi_dictionary_data_enumerator(wi_dictionary_t *dictionary) {
 
 
 
-static _wi_dictionary_bucket_t * _wi_enumerator_dictionary_enumerator(wi_runtime_instance_t *instance, wi_enumerator_context_t *context) {
-	wi_dictionary_t				*dictionary = instance;
-	_wi_dictionary_bucket_t		*bucket;
+static wi_uinteger_t _wi_dictionary_enumerate(wi_dictionary_t *dictionary, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count, wi_boolean_t keys) {
+	wi_uinteger_t		i, n;
 	
-	bucket = context->bucket;
+	n = 0;
 	
-	if(bucket) {
-		if(bucket->next) {
-			bucket = bucket->next;
-			context->bucket = bucket;
-			
-			return bucket;
-		} else {
-			context->index++;
-			context->bucket = NULL;
-		}
+	for(i = state->state; i < dictionary->capacity && n < count; i++) {
+		if(_WI_DICTIONARY_IS_FULL(dictionary, i))
+			buffer[n++] = keys ? dictionary->entries[i].key : dictionary->entries[i].data;
 	}
 	
-	while(context->index < dictionary->buckets_count) {
-		bucket = dictionary->buckets[context->index];
-		
-		if(bucket) {
-			context->bucket = bucket;
-			
-			return bucket;
-		}
+	state->items = buffer;
+	state->state = i;
+	
+	return n;
+}
+
+
+
+wi_uinteger_t wi_dictionary_enumerate_keys(wi_dictionary_t *dictionary, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count) {
+	return _wi_dictionary_enumerate(dictionary, state, buffer, count, true);
+}
+
+
+
+wi_uinteger_t wi_dictionary_enumerate_data(wi_dictionary_t *dictionary, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count) {
+	return _wi_dictionary_enumerate(dictionary, state, buffer, count, false);
+}
+
+
+
+static _wi_dictionary_entry_t * _wi_enumerator_dictionary_enumerator(wi_runtime_instance_t *instance, wi_enumerator_context_t *context) {
+	wi_dictionary_t		*dictionary = instance;
+	wi_uinteger_t		i;
+	
+	while(context->index < dictionary->capacity) {
+		i = context->index++;
 		
-		context->index++;
+		if(_WI_DICTIONARY_IS_FULL(dictionary, i))
+			return &dictionary->entries[i];
 	}
 	
 	return NULL;
@@ -733,12 +749,12 @@ static _wi_dictionary_bucket_t * _wi_enumerator_dictionary_enumerator(wi_runtime
 
 
 void * wi_enumerator_dictionary_key_enumerator(wi_runtime_instance_t *instance, wi_enumerator_context_t *context) {
-	_wi_dictionary_bucket_t		*bucket;
+	_wi_dictionary_entry_t		*entry;
 	
-	bucket = _wi_enumerator_dictionary_enumerator(instance, context);
+	entry = _wi_enumerator_dictionary_enumerator(instance, context);
 	
-	if(bucket)
-		return bucket->key;
+	if(entry)
+		return entry->key;
 	
 	return NULL;
 }
@@ -746,12 +762,12 @@ void * wi_enumerator_dictionary_key_enumerator(wi_runtime_instance_t *instance,
 
 
 void * wi_enumerator_dictionary_data_enumerator(wi_runtime_instance_t *instance, wi_enumerator_context_t *context) {
-	_wi_dictionary_bucket_t		*bucket;
+	_wi_dictionary_entry_t		*entry;
 	
-	bucket = _wi_enumerator_dictionary_enumerator(instance, context);
+	entry = _wi_enumerator_dictionary_enumerator(instance, context);
 	
-	if(bucket)
-		return bucket->data;
+	if(entry)
+		return entry->data;
 	
 	return NULL;
 }
@@ -772,165 +788,243 @@ wi_boolean_t wi_dictionary_write_to_file(wi_dictionary_t *dictionary, wi_string_
 
 #pragma mark -
 
-static void _wi_dictionary_resize(wi_dictionary_t *dictionary) {
-	_wi_dictionary_bucket_t		**buckets, *bucket, *next_bucket;
-	wi_uinteger_t				i, index, capacity, buckets_count;
+static wi_uinteger_t _wi_dictionary_capacity_for_count(wi_uinteger_t count) {
+	wi_uinteger_t		capacity;
+	
+	capacity = _WI_DICTIONARY_MIN_CAPACITY;
+	
+	while(capacity * 3 < count * 4)
+		capacity *= 2;
+	
+	return capacity;
+}
 
-	capacity		= wi_exp2m1(wi_log2(dictionary->key_count) + 1);
-	buckets_count	= WI_CLAMP(capacity, dictionary->min_count, _WI_DICTIONARY_MAX_COUNT);
-	buckets			= wi_malloc(buckets_count * sizeof(_wi_dictionary_bucket_t *));
 
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = next_bucket) {
-			next_bucket		= bucket->next;
-			index			= _WI_DICTIONARY_KEY_HASH(dictionary, bucket->key) % buckets_count;
-			bucket->next	= buckets[index];
-			buckets[index]	= bucket;
-		}
-	}
-
-	wi_free(dictionary->buckets);
 
-	dictionary->buckets			= buckets;
-	dictionary->buckets_count	= buckets_count;
+static void _wi_dictionary_allocate(wi_dictionary_t *dictionary, wi_uinteger_t capacity) {
+	dictionary->storage				= wi_malloc(sizeof(_wi_dictionary_storage_t) + (capacity * (sizeof(_wi_dictionary_entry_t) + sizeof(uint8_t))));
+	dictionary->storage->references	= 1;
+	dictionary->entries				= dictionary->storage->entries;
+	dictionary->controls			= (uint8_t *) (dictionary->entries + capacity);
+	dictionary->capacity			= capacity;
+	dictionary->shift				= 64 - wi_log2(capacity);
+	dictionary->deleted_count		= 0;
 }
 
 
 
-#pragma mark -
-
-static _wi_dictionary_bucket_t * _wi_dictionary_bucket_create(wi_dictionary_t *dictionary) {
-	_wi_dictionary_bucket_t		*bucket, *bucket_block;
-	size_t						size;
-
-	if(!dictionary->bucket_free_list) {
-		if(dictionary->bucket_chunks_offset == _wi_dictionary_buckets_per_page) {
-			dictionary->bucket_chunks_count++;
+static void _wi_dictionary_resize(wi_dictionary_t *dictionary, wi_uinteger_t capacity) {
+	_wi_dictionary_storage_t	*storage;
+	_wi_dictionary_entry_t		*entries;
+	uint8_t						*controls;
+	wi_uinteger_t				i, index, old_capacity;
+	
+	storage			= dictionary->storage;
+	controls		= dictionary->controls;
+	entries			= dictionary->entries;
+	old_capacity	= dictionary->capacity;
+	
+	_wi_dictionary_allocate(dictionary, capacity);
+	
+	for(i = 0; i < old_capacity; i++) {
+		if(controls[i] & _WI_DICTIONARY_CONTROL_FULL) {
+			index = _wi_dictionary_index_for_insert(dictionary, entries[i].hash);
+			
+			dictionary->controls[index]	= controls[i];
+			dictionary->entries[index]	= entries[i];
+		}
+	}
+	
+	wi_free(storage);
+}
 
-			size = dictionary->bucket_chunks_count * sizeof(_wi_dictionary_bucket_t *);
-			dictionary->bucket_chunks = wi_realloc(dictionary->bucket_chunks, size);
 
-			size = _wi_dictionary_buckets_per_page * sizeof(_wi_dictionary_bucket_t);
-			dictionary->bucket_chunks[dictionary->bucket_chunks_count - 1] = wi_malloc(size);
 
-			dictionary->bucket_chunks_offset = 0;
+static void _wi_dictionary_release_storage(wi_dictionary_t *dictionary, _wi_dictionary_storage_t *storage, uint8_t *controls, wi_uinteger_t capacity) {
+	wi_uinteger_t		i;
+	
+	if(WI_ATOMIC_DECREMENT(storage->references) > 0)
+		return;
+	
+	for(i = 0; i < capacity; i++) {
+		if(controls[i] & _WI_DICTIONARY_CONTROL_FULL) {
+			_WI_DICTIONARY_VALUE_RELEASE(dictionary, storage->entries[i].data);
+			_WI_DICTIONARY_KEY_RELEASE(dictionary, storage->entries[i].key);
 		}
-
-		bucket_block = dictionary->bucket_chunks[dictionary->bucket_chunks_count - 1];
-		dictionary->bucket_free_list = &bucket_block[dictionary->bucket_chunks_offset++];
-		dictionary->bucket_free_list->link = NULL;
 	}
-
-	bucket = dictionary->bucket_free_list;
-	dictionary->bucket_free_list = bucket->link;
-
-	return bucket;
+	
+	wi_free(storage);
 }
 
 
 
-static _wi_dictionary_bucket_t * _wi_dictionary_bucket_for_key(wi_dictionary_t *dictionary, void *key, wi_uinteger_t index) {
-	_wi_dictionary_bucket_t		*bucket;
+static void _wi_dictionary_unshare(wi_dictionary_t *dictionary) {
+	_wi_dictionary_storage_t	*storage;
+	_wi_dictionary_entry_t		*entries;
+	uint8_t						*controls;
+	wi_uinteger_t				i, capacity, deleted_count;
 	
-	bucket = dictionary->buckets[index];
+	storage			= dictionary->storage;
+	controls		= dictionary->controls;
+	entries			= dictionary->entries;
+	capacity		= dictionary->capacity;
+	deleted_count	= dictionary->deleted_count;
+	
+	_wi_dictionary_allocate(dictionary, capacity);
+	
+	memcpy(dictionary->controls, controls, capacity * sizeof(uint8_t));
+	memcpy(dictionary->entries, entries, capacity * sizeof(_wi_dictionary_entry_t));
+	
+	dictionary->deleted_count = deleted_count;
+	
+	for(i = 0; i < capacity; i++) {
+		if(controls[i] & _WI_DICTIONARY_CONTROL_FULL) {
+			dictionary->entries[i].key	= _WI_DICTIONARY_KEY_RETAIN(dictionary, entries[i].key);
+			dictionary->entries[i].data	= _WI_DICTIONARY_VALUE_RETAIN(dictionary, entries[i].data);
+		}
+	}
+	
+	_wi_dictionary_release_storage(dictionary, storage, controls, capacity);
+}
 
-	if(!bucket)
-		return NULL;
 
-	for(; bucket; bucket = bucket->next) {
-		if(_WI_DICTIONARY_KEY_IS_EQUAL(dictionary, bucket->key, key))
-			return bucket;
-	}
+
+#pragma mark -
+
+static wi_uinteger_t _wi_dictionary_index_for_key(wi_dictionary_t *dictionary, void *key, wi_hash_code_t hash) {
+	_wi_dictionary_entry_t		*entry;
+	wi_uinteger_t				index, mask;
+	uint8_t						control;
+	
+	control		= _WI_DICTIONARY_HASH_CONTROL(hash);
+	mask		= dictionary->capacity - 1;
+	index		= _WI_DICTIONARY_HASH_INDEX(dictionary, hash);
+	
+	while(dictionary->controls[index] != _WI_DICTIONARY_CONTROL_EMPTY) {
+		if(dictionary->controls[index] == control) {
+			entry = &dictionary->entries[index];
+			
+			if(entry->key == key)
+				return index;
+			
+			if(entry->hash == hash && _WI_DICTIONARY_KEY_IS_EQUAL(dictionary, entry->key, key))
+				return index;
+		}
 		
-	return NULL;
+		index = (index + 1) & mask;
+	}
+	
+	return WI_NOT_FOUND;
 }
 
 
 
-static void _wi_dictionary_bucket_remove(wi_dictionary_t *dictionary, _wi_dictionary_bucket_t *bucket) {
-	_WI_DICTIONARY_VALUE_RELEASE(dictionary, bucket->data);
-	_WI_DICTIONARY_KEY_RELEASE(dictionary, bucket->key);
+static wi_uinteger_t _wi_dictionary_index_for_insert(wi_dictionary_t *dictionary, wi_hash_code_t hash) {
+	wi_uinteger_t		index, mask;
 	
-	bucket->link = dictionary->bucket_free_list;
-	dictionary->bucket_free_list = bucket;
-
-	dictionary->key_count--;
+	mask		= dictionary->capacity - 1;
+	index		= _WI_DICTIONARY_HASH_INDEX(dictionary, hash);
+	
+	while(dictionary->controls[index] & _WI_DICTIONARY_CONTROL_FULL)
+		index = (index + 1) & mask;
+	
+	return index;
 }
 
 
 
-static void _wi_dictionary_set_data_for_key(wi_mutable_dictionary_t *dictionary, void *data, void *key) {
-	_wi_dictionary_bucket_t		*bucket;
-	void						*new_key, *new_data;
+static void _wi_dictionary_set_data_for_key(wi_mutable_dictionary_t *dictionary, void *data, void *key, wi_hash_code_t hash) {
+	_wi_dictionary_entry_t		*entry;
+	void						*new_key, *new_data, *old_key, *old_data;
 	wi_uinteger_t				index;
 	
+	_WI_DICTIONARY_UNSHARE(dictionary);
+	
 	new_key				= _WI_DICTIONARY_KEY_RETAIN(dictionary, key);
 	new_data			= _WI_DICTIONARY_VALUE_RETAIN(dictionary, data);
-	index				= _WI_DICTIONARY_KEY_HASH(dictionary, key) % dictionary->buckets_count;
-	bucket				= _wi_dictionary_bucket_for_key(dictionary, key, index);
-
-	if(bucket) {
-		_WI_DICTIONARY_KEY_RELEASE(dictionary, bucket->key);
-		_WI_DICTIONARY_VALUE_RELEASE(dictionary, bucket->data);
+	index				= _wi_dictionary_index_for_key(dictionary, key, hash);
+
+	if(index != WI_NOT_FOUND) {
+		entry			= &dictionary->entries[index];
+		old_key			= entry->key;
+		old_data		= entry->data;
+		entry->key		= new_key;
+		entry->data		= new_data;
+		
+		_WI_DICTIONARY_KEY_RELEASE(dictionary, old_key);
+		_WI_DICTIONARY_VALUE_RELEASE(dictionary, old_data);
 	} else {
-		bucket			= _wi_dictionary_bucket_create(dictionary);
-		bucket->next	= dictionary->buckets[index];
-
+		/* sparse tables are shrunk here rather than on remove, so removing never moves entries */
+		if((dictionary->key_count + dictionary->deleted_count + 1) * 8 > dictionary->capacity * 7 ||
+		   (dictionary->capacity > dictionary->min_capacity && (dictionary->key_count + 1) * 8 < dictionary->capacity))
+			_wi_dictionary_resize(dictionary, WI_MAX(_wi_dictionary_capacity_for_count(dictionary->key_count + 1), dictionary->min_capacity));
+		
+		index = _wi_dictionary_index_for_insert(dictionary, hash);
+		
+		if(dictionary->controls[index] == _WI_DICTIONARY_CONTROL_DELETED)
+			dictionary->deleted_count--;
+		
+		entry			= &dictionary->entries[index];
+		entry->key		= new_key;
+		entry->data		= new_data;
+		entry->hash		= hash;
+		
+		dictionary->controls[index] = _WI_DICTIONARY_HASH_CONTROL(hash);
 		dictionary->key_count++;
-		dictionary->buckets[index] = bucket;
 	}
-	
-	bucket->key			= new_key;
-	bucket->data		= new_data;
-
-	_WI_DICTIONARY_CHECK_RESIZE(dictionary);
 }
 
 
 
-static void _wi_dictionary_remove_data_for_key(wi_mutable_dictionary_t *dictionary, void *key) {
-	_wi_dictionary_bucket_t		*bucket, *previous_bucket;
-	wi_uinteger_t				index;
+static void _wi_dictionary_remove_data_for_key(wi_mutable_dictionary_t *dictionary, void *key, wi_hash_code_t hash) {
+	_wi_dictionary_entry_t		*entry;
+	void						*old_key, *old_data;
+	wi_uinteger_t				index, next;
 
-	index = _WI_DICTIONARY_KEY_HASH(dictionary, key) % dictionary->buckets_count;
-	bucket = dictionary->buckets[index];
+	index = _wi_dictionary_index_for_key(dictionary, key, hash);
 
-	if(bucket) {
-		previous_bucket = NULL;
-		
-		for(; bucket; bucket = bucket->next) {
-			if(_WI_DICTIONARY_KEY_IS_EQUAL(dictionary, bucket->key, key)) {
-				if(bucket == dictionary->buckets[index])
-					dictionary->buckets[index] = bucket->next;
-				
-				if(previous_bucket)
-					previous_bucket->next = bucket->next;
-				
-				_wi_dictionary_bucket_remove(dictionary, bucket);
-				break;
-			}
-			
-			previous_bucket = bucket;
-		}
+	if(index == WI_NOT_FOUND)
+		return;
+	
+	_WI_DICTIONARY_UNSHARE(dictionary);
+	
+	entry		= &dictionary->entries[index];
+	old_key		= entry->key;
+	old_data	= entry->data;
+	next		= (index + 1) & (dictionary->capacity - 1);
+	
+	if(dictionary->controls[next] == _WI_DICTIONARY_CONTROL_EMPTY) {
+		dictionary->controls[index] = _WI_DICTIONARY_CONTROL_EMPTY;
+	} else {
+		dictionary->controls[index] = _WI_DICTIONARY_CONTROL_DELETED;
+		dictionary->deleted_count++;
 	}
 	
-	_WI_DICTIONARY_CHECK_RESIZE(dictionary);
+	entry->key	= NULL;
+	entry->data	= NULL;
+	
+	dictionary->key_count--;
+	
+	_WI_DICTIONARY_VALUE_RELEASE(dictionary, old_data);
+	_WI_DICTIONARY_KEY_RELEASE(dictionary, old_key);
 }
 
 
 
 static void _wi_dictionary_remove_all_data(wi_mutable_dictionary_t *dictionary) {
-	_wi_dictionary_bucket_t		*bucket;
-	wi_uinteger_t				i;
+	_wi_dictionary_storage_t	*storage;
+	uint8_t						*controls;
+	wi_uinteger_t				capacity;
 	
-	for(i = 0; i < dictionary->buckets_count; i++) {
-		for(bucket = dictionary->buckets[i]; bucket; bucket = bucket->next)
-			_wi_dictionary_bucket_remove(dictionary, bucket);
-
-		dictionary->buckets[i] = NULL;
-	}
-
-	_WI_DICTIONARY_CHECK_RESIZE(dictionary);
+	storage		= dictionary->storage;
+	controls	= dictionary->controls;
+	capacity	= dictionary->capacity;
+	
+	_wi_dictionary_allocate(dictionary, dictionary->min_capacity);
+	
+	dictionary->key_count = 0;
+	
+	_wi_dictionary_release_storage(dictionary, storage, controls, capacity);
 }
 
 
@@ -938,6 +1032,12 @@ static void _wi_dictionary_remove_all_data(wi_mutable_dictionary_t *dictionary)
 #pragma mark -
 
 void wi_mutable_dictionary_set_data_for_key(wi_mutable_dictionary_t *dictionary, void *data, void *key) {
+	wi_mutable_dictionary_set_data_for_key_with_hash(dictionary, data, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));
+}
+
+
+
+void wi_mutable_dictionary_set_data_for_key_with_hash(wi_mutable_dictionary_t *dictionary, void *data, void *key, wi_hash_code_t hash) {
 	WI_RUNTIME_ASSERT_MUTABLE(dictionary);
 
 	if(dictionary->value_callbacks.retain == wi_retain) {
@@ -952,20 +1052,23 @@ void wi_mutable_dictionary_set_data_for_key(wi_mutable_dictionary_t *dictionary,
 			dictionary);
 	}
 
-	_wi_dictionary_set_data_for_key(dictionary, data, key);
+	_wi_dictionary_set_data_for_key(dictionary, data, key, hash);
 }
 
 
 
 void wi_mutable_dictionary_add_entries_from_dictionary(wi_mutable_dictionary_t *dictionary, wi_dictionary_t *otherdictionary) {
-	_wi_dictionary_bucket_t		*bucket;
+	_wi_dictionary_entry_t		*entry;
 	wi_uinteger_t				i;
 
 	WI_RUNTIME_ASSERT_MUTABLE(dictionary);
 
-	for(i = 0; i < otherdictionary->buckets_count; i++) {
-		for(bucket = otherdictionary->buckets[i]; bucket; bucket = bucket->next)
-			_wi_dictionary_set_data_for_key(dictionary, bucket->data, bucket->key);
+	for(i = 0; i < otherdictionary->capacity; i++) {
+		if(_WI_DICTIONARY_IS_FULL(otherdictionary, i)) {
+			entry = &otherdictionary->entries[i];
+			
+			_wi_dictionary_set_data_for_key(dictionary, entry->data, entry->key, _WI_DICTIONARY_KEY_HASH(dictionary, entry->key));
+		}
 	}
 }
 
@@ -983,6 +1086,12 @@ void wi_mutable_dictionary_set_dictionary(wi_mutable_dictionary_t *dictionary, w
 #pragma mark -
 
 void wi_mutable_dictionary_remove_data_for_key(wi_mutable_dictionary_t *dictionary, void *key) {
+	wi_mutable_dictionary_remove_data_for_key_with_hash(dictionary, key, _WI_DICTIONARY_KEY_HASH(dictionary, key));
+}
+
+
+
+void wi_mutable_dictionary_remove_data_for_key_with_hash(wi_mutable_dictionary_t *dictionary, void *key, wi_hash_code_t hash) {
 	WI_RUNTIME_ASSERT_MUTABLE(dictionary);
 	
 	if(dictionary->key_callbacks.release == wi_release) {
@@ -991,7 +1100,7 @@ void wi_mutable_dictionary_remove_data_for_key(wi_mutable_dictionary_t *dictiona
 			dictionary);
 	}
 	
-	_wi_dictionary_remove_data_for_key(dictionary, key);
+	_wi_dictionary_remove_data_for_key(dictionary, key, hash);
 }
 
 
@@ -86,6 +86,8 @@ WI_EXPORT wi_array_t *								wi_dictionary_keys_sorted_by_value(wi_dictionary_t
 
 WI_EXPORT wi_enumerator_t *							wi_dictionary_key_enumerator(wi_dictionary_t *);
 WI_EXPORT wi_enumerator_t *							wi_dictionary_data_enumerator(wi_dictionary_t *);
+WI_EXPORT wi_uinteger_t								wi_dictionary_enumerate_keys(wi_dictionary_t *, wi_enumeration_state_t *, void **, wi_uinteger_t);
+WI_EXPORT wi_uinteger_t								wi_dictionary_enumerate_data(wi_dictionary_t *, wi_enumeration_state_t *, void **, wi_uinteger_t);
 
 WI_EXPORT wi_boolean_t								wi_dictionary_write_to_file(wi_dictionary_t *, wi_string_t *);
 
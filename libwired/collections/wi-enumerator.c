@@ -33,9 +33,13 @@
 #include <unistd.h>
 #include <string.h>
 
+#include <wired/wi-array.h>
+#include <wired/wi-assert.h>
+#include <wired/wi-dictionary.h>
 #include <wired/wi-enumerator.h>
 #include <wired/wi-private.h>
 #include <wired/wi-runtime.h>
+#include <wired/wi-set.h>
 #include <wired/wi-string.h>
 
 struct _wi_enumerator {
@@ -122,3 +126,46 @@ static wi_string_t * _wi_enumerator_description(wi_runtime_instance_t *instance)
 void * wi_enumerator_next_data(wi_enumerator_t *enumerator) {
 	return (*enumerator->func)(enumerator->collection, &enumerator->context);
 }
+
+
+
+wi_uinteger_t wi_enumerator_enumerate_data(wi_enumerator_t *enumerator, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count) {
+	void			*data;
+	wi_uinteger_t	i;
+	
+	for(i = 0; i < count; i++) {
+		data = (*enumerator->func)(enumerator->collection, &enumerator->context);
+		
+		if(!data)
+			break;
+		
+		buffer[i] = data;
+	}
+	
+	state->items = buffer;
+	
+	return i;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_enumerate_data(void *collection, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count) {
+	wi_runtime_id_t		id;
+	
+	id = wi_runtime_id(collection);
+	
+	if(id == wi_array_runtime_id())
+		return wi_array_enumerate_data(collection, state, buffer, count);
+	else if(id == wi_dictionary_runtime_id())
+		return wi_dictionary_enumerate_keys(collection, state, buffer, count);
+	else if(id == wi_set_runtime_id())
+		return wi_set_enumerate_data(collection, state, buffer, count);
+	else if(id == wi_enumerator_runtime_id())
+		return wi_enumerator_enumerate_data(collection, state, buffer, count);
+	
+	WI_ASSERT(0, "%@ does not support enumeration", collection);
+	
+	return 0;
+}
@@ -32,11 +32,53 @@
 #include <wired/wi-base.h>
 #include <wired/wi-runtime.h>
 
+#define WI_ENUMERATION_BATCH_COUNT			16
+
+#define WI_ENUMERATION_STATE(collection)									\
+	{ (collection), 0, 0, NULL, 0, 0, { NULL } }
+
+#define WI_FOREACH(data, collection)										\
+	for(wi_enumeration_state_t _wi_foreach_state = WI_ENUMERATION_STATE((collection));	\
+		wi_enumeration_state_has_next(&_wi_foreach_state) &&				\
+		(((data) = wi_enumeration_state_next(&_wi_foreach_state)), 1); )
+
+
 typedef struct _wi_enumerator				wi_enumerator_t;
 
 
+struct _wi_enumeration_state {
+	void									*collection;
+	wi_uinteger_t							state;
+	wi_uinteger_t							extra;
+	void									**items;
+	wi_uinteger_t							index;
+	wi_uinteger_t							count;
+	void									*buffer[WI_ENUMERATION_BATCH_COUNT];
+};
+typedef struct _wi_enumeration_state		wi_enumeration_state_t;
+
+
 WI_EXPORT wi_runtime_id_t					wi_enumerator_runtime_id(void);
 
 WI_EXPORT void *							wi_enumerator_next_data(wi_enumerator_t *);
+WI_EXPORT wi_uinteger_t						wi_enumerator_enumerate_data(wi_enumerator_t *, wi_enumeration_state_t *, void **, wi_uinteger_t);
+
+WI_EXPORT wi_uinteger_t						wi_enumerate_data(void *, wi_enumeration_state_t *, void **, wi_uinteger_t);
+
+
+WI_STATIC_INLINE wi_boolean_t wi_enumeration_state_has_next(wi_enumeration_state_t *state) {
+	if(state->index == state->count) {
+		state->count = wi_enumerate_data(state->collection, state, state->buffer, WI_ENUMERATION_BATCH_COUNT);
+		state->index = 0;
+	}
+	
+	return (state->count > 0);
+}
+
+
+
+WI_STATIC_INLINE void * wi_enumeration_state_next(wi_enumeration_state_t *state) {
+	return state->items[state->index++];
+}
 
 #endif /* WI_ENUMERATOR_H */
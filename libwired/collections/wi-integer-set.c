@@ -0,0 +1,675 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <wired/wi-assert.h>
+#include <wired/wi-integer-set.h>
+#include <wired/wi-macros.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-string.h>
+#include <wired/wi-system.h>
+
+#define _WI_INTEGER_SET_MIN_CAPACITY			8
+#define _WI_INTEGER_SET_SCAN_COUNT				16
+#define _WI_INTEGER_SET_GALLOP_RATIO			32
+
+#define _WI_INTEGER_SET_INDEX_ASSERT(set, index)						\
+	WI_ASSERT((index) < (set)->values_count,							\
+		"index %lu out of range (count %lu) in %@",						\
+		(index), (set)->values_count, (set))
+
+#define _WI_INTEGER_SET_EMPTY_ASSERT(set)								\
+	WI_ASSERT((set)->values_count > 0,									\
+		"attempt to get value from empty %@",							\
+		(set))
+
+
+struct _wi_integer_set {
+	wi_runtime_base_t						base;
+	
+	uint32_t								*values;
+	wi_uinteger_t							values_count;
+	wi_uinteger_t							capacity;
+};
+
+
+static void									_wi_integer_set_dealloc(wi_runtime_instance_t *);
+static wi_runtime_instance_t *				_wi_integer_set_copy(wi_runtime_instance_t *);
+static wi_boolean_t							_wi_integer_set_is_equal(wi_runtime_instance_t *, wi_runtime_instance_t *);
+static wi_string_t *						_wi_integer_set_description(wi_runtime_instance_t *);
+static wi_hash_code_t						_wi_integer_set_hash(wi_runtime_instance_t *);
+
+static int									_wi_integer_set_compare_values(const void *, const void *);
+static wi_uinteger_t						_wi_integer_set_lower_bound(const uint32_t *, wi_uinteger_t, uint32_t);
+static wi_uinteger_t						_wi_integer_set_unique_values(uint32_t *, wi_uinteger_t);
+
+static wi_uinteger_t						_wi_integer_set_union_values(uint32_t *, const uint32_t *, wi_uinteger_t, const uint32_t *, wi_uinteger_t);
+static wi_uinteger_t						_wi_integer_set_intersect_values(uint32_t *, const uint32_t *, wi_uinteger_t, const uint32_t *, wi_uinteger_t);
+static wi_uinteger_t						_wi_integer_set_subtract_values(uint32_t *, const uint32_t *, wi_uinteger_t, const uint32_t *, wi_uinteger_t);
+
+static void									_wi_integer_set_grow(wi_integer_set_t *, wi_uinteger_t);
+static void									_wi_integer_set_set_values(wi_integer_set_t *, uint32_t *, wi_uinteger_t, wi_uinteger_t);
+
+
+static wi_runtime_id_t						_wi_integer_set_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t					_wi_integer_set_runtime_class = {
+	"wi_integer_set_t",
+	_wi_integer_set_dealloc,
+	_wi_integer_set_copy,
+	_wi_integer_set_is_equal,
+	_wi_integer_set_description,
+	_wi_integer_set_hash
+};
+
+
+
+void wi_integer_set_register(void) {
+	_wi_integer_set_runtime_id = wi_runtime_register_class(&_wi_integer_set_runtime_class);
+}
+
+
+
+void wi_integer_set_initialize(void) {
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_integer_set_runtime_id(void) {
+	return _wi_integer_set_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_integer_set_t * wi_integer_set(void) {
+	return wi_autorelease(wi_integer_set_init(wi_integer_set_alloc()));
+}
+
+
+
+wi_integer_set_t * wi_integer_set_with_values(const uint32_t *values, wi_uinteger_t count) {
+	return wi_autorelease(wi_integer_set_init_with_values(wi_integer_set_alloc(), values, count));
+}
+
+
+
+wi_mutable_integer_set_t * wi_mutable_integer_set(void) {
+	return wi_autorelease(wi_integer_set_init(wi_mutable_integer_set_alloc()));
+}
+
+
+
+#pragma mark -
+
+wi_integer_set_t * wi_integer_set_alloc(void) {
+	return wi_runtime_create_instance_with_options(_wi_integer_set_runtime_id, sizeof(wi_integer_set_t), WI_RUNTIME_OPTION_IMMUTABLE);
+}
+
+
+
+wi_mutable_integer_set_t * wi_mutable_integer_set_alloc(void) {
+	return wi_runtime_create_instance_with_options(_wi_integer_set_runtime_id, sizeof(wi_integer_set_t), WI_RUNTIME_OPTION_MUTABLE);
+}
+
+
+
+wi_integer_set_t * wi_integer_set_init(wi_integer_set_t *set) {
+	return wi_integer_set_init_with_capacity(set, 0);
+}
+
+
+
+wi_integer_set_t * wi_integer_set_init_with_capacity(wi_integer_set_t *set, wi_uinteger_t capacity) {
+	set->capacity	= WI_MAX(capacity, _WI_INTEGER_SET_MIN_CAPACITY);
+	set->values		= wi_malloc(set->capacity * sizeof(uint32_t));
+	
+	return set;
+}
+
+
+
+wi_integer_set_t * wi_integer_set_init_with_values(wi_integer_set_t *set, const uint32_t *values, wi_uinteger_t count) {
+	set = wi_integer_set_init_with_capacity(set, count);
+	
+	if(count > 0) {
+		memcpy(set->values, values, count * sizeof(uint32_t));
+		qsort(set->values, count, sizeof(uint32_t), _wi_integer_set_compare_values);
+		
+		set->values_count = _wi_integer_set_unique_values(set->values, count);
+	}
+	
+	return set;
+}
+
+
+
+static void _wi_integer_set_dealloc(wi_runtime_instance_t *instance) {
+	wi_integer_set_t		*set = instance;
+	
+	wi_free(set->values);
+}
+
+
+
+static wi_runtime_instance_t * _wi_integer_set_copy(wi_runtime_instance_t *instance) {
+	wi_integer_set_t		*set = instance, *set_copy;
+	
+	set_copy = wi_integer_set_init_with_capacity(wi_integer_set_alloc(), set->values_count);
+	
+	memcpy(set_copy->values, set->values, set->values_count * sizeof(uint32_t));
+	
+	set_copy->values_count = set->values_count;
+	
+	return set_copy;
+}
+
+
+
+static wi_boolean_t _wi_integer_set_is_equal(wi_runtime_instance_t *instance1, wi_runtime_instance_t *instance2) {
+	wi_integer_set_t		*set1 = instance1;
+	wi_integer_set_t		*set2 = instance2;
+	
+	if(set1->values_count != set2->values_count)
+		return false;
+	
+	return (memcmp(set1->values, set2->values, set1->values_count * sizeof(uint32_t)) == 0);
+}
+
+
+
+static wi_string_t * _wi_integer_set_description(wi_runtime_instance_t *instance) {
+	wi_integer_set_t		*set = instance;
+	wi_mutable_string_t		*string;
+	wi_uinteger_t			i;
+	
+	string = wi_mutable_string_with_format(WI_STR("<%@ %p>{count = %lu, mutable = %u, values = ("),
+		wi_runtime_class_name(set),
+		set,
+		set->values_count,
+		wi_runtime_options(set) & WI_RUNTIME_OPTION_MUTABLE ? 1 : 0);
+	
+	for(i = 0; i < set->values_count; i++) {
+		if(i > 0)
+			wi_mutable_string_append_string(string, WI_STR(", "));
+		
+		wi_mutable_string_append_format(string, WI_STR("%u"), set->values[i]);
+	}
+	
+	wi_mutable_string_append_string(string, WI_STR(")}"));
+	
+	wi_runtime_make_immutable(string);
+	
+	return string;
+}
+
+
+
+static wi_hash_code_t _wi_integer_set_hash(wi_runtime_instance_t *instance) {
+	wi_integer_set_t		*set = instance;
+	
+	return wi_hash_data((const unsigned char *) set->values, set->values_count * sizeof(uint32_t));
+}
+
+
+
+#pragma mark -
+
+static int _wi_integer_set_compare_values(const void *p1, const void *p2) {
+	uint32_t	value1 = *(const uint32_t *) p1;
+	uint32_t	value2 = *(const uint32_t *) p2;
+	
+	return (value1 > value2) - (value1 < value2);
+}
+
+
+
+static wi_uinteger_t _wi_integer_set_lower_bound(const uint32_t *values, wi_uinteger_t count, uint32_t value) {
+	const uint32_t	*base = values;
+	wi_uinteger_t	i, half, index;
+	
+	while(count > _WI_INTEGER_SET_SCAN_COUNT) {
+		half	= count / 2;
+		base	= (base[half] < value) ? base + half : base;
+		count	-= half;
+	}
+	
+	for(i = index = 0; i < count; i++)
+		index += (base[i] < value);
+	
+	return (base - values) + index;
+}
+
+
+
+static wi_uinteger_t _wi_integer_set_unique_values(uint32_t *values, wi_uinteger_t count) {
+	wi_uinteger_t	i, n;
+	
+	if(count == 0)
+		return 0;
+	
+	for(i = n = 1; i < count; i++) {
+		values[n] = values[i];
+		n += (values[i] != values[n - 1]);
+	}
+	
+	return n;
+}
+
+
+
+#pragma mark -
+
+static wi_uinteger_t _wi_integer_set_union_values(uint32_t *output, const uint32_t *values1, wi_uinteger_t count1, const uint32_t *values2, wi_uinteger_t count2) {
+	uint32_t		value1, value2;
+	wi_uinteger_t	i, j, n;
+	
+	i = j = n = 0;
+	
+	while(i < count1 && j < count2) {
+		value1 = values1[i];
+		value2 = values2[j];
+		
+		output[n++] = (value1 < value2) ? value1 : value2;
+		
+		i += (value1 <= value2);
+		j += (value2 <= value1);
+	}
+	
+	memcpy(output + n, values1 + i, (count1 - i) * sizeof(uint32_t));
+	n += count1 - i;
+	
+	memcpy(output + n, values2 + j, (count2 - j) * sizeof(uint32_t));
+	n += count2 - j;
+	
+	return n;
+}
+
+
+
+static wi_uinteger_t _wi_integer_set_intersect_values(uint32_t *output, const uint32_t *values1, wi_uinteger_t count1, const uint32_t *values2, wi_uinteger_t count2) {
+	uint32_t		value1, value2;
+	wi_uinteger_t	i, j, n;
+	
+	i = j = n = 0;
+	
+	if(count1 * _WI_INTEGER_SET_GALLOP_RATIO < count2) {
+		for(i = 0; i < count1 && j < count2; i++) {
+			j += _wi_integer_set_lower_bound(values2 + j, count2 - j, values1[i]);
+			
+			if(j < count2 && values2[j] == values1[i])
+				output[n++] = values1[i];
+		}
+	}
+	else if(count2 * _WI_INTEGER_SET_GALLOP_RATIO < count1) {
+		for(j = 0; j < count2 && i < count1; j++) {
+			i += _wi_integer_set_lower_bound(values1 + i, count1 - i, values2[j]);
+			
+			if(i < count1 && values1[i] == values2[j])
+				output[n++] = values2[j];
+		}
+	}
+	else {
+		while(i < count1 && j < count2) {
+			value1 = values1[i];
+			value2 = values2[j];
+			
+			output[n] = value1;
+			n += (value1 == value2);
+			
+			i += (value1 <= value2);
+			j += (value2 <= value1);
+		}
+	}
+	
+	return n;
+}
+
+
+
+static wi_uinteger_t _wi_integer_set_subtract_values(uint32_t *output, const uint32_t *values1, wi_uinteger_t count1, const uint32_t *values2, wi_uinteger_t count2) {
+	uint32_t		value1, value2;
+	wi_uinteger_t	i, j, n;
+	
+	i = j = n = 0;
+	
+	if(count2 * _WI_INTEGER_SET_GALLOP_RATIO < count1) {
+		for(j = 0; j < count2 && i < count1; j++) {
+			wi_uinteger_t	index;
+			
+			index = i + _wi_integer_set_lower_bound(values1 + i, count1 - i, values2[j]);
+			
+			memmove(output + n, values1 + i, (index - i) * sizeof(uint32_t));
+			n += index - i;
+			
+			i = (index < count1 && values1[index] == values2[j]) ? index + 1 : index;
+		}
+	} else {
+		while(i < count1 && j < count2) {
+			value1 = values1[i];
+			value2 = values2[j];
+			
+			output[n] = value1;
+			n += (value1 < value2);
+			
+			i += (value1 <= value2);
+			j += (value2 <= value1);
+		}
+	}
+	
+	memmove(output + n, values1 + i, (count1 - i) * sizeof(uint32_t));
+	n += count1 - i;
+	
+	return n;
+}
+
+
+
+#pragma mark -
+
+static void _wi_integer_set_grow(wi_integer_set_t *set, wi_uinteger_t count) {
+	if(count > set->capacity) {
+		set->capacity	= WI_MAX(count, set->capacity + (set->capacity / 2));
+		set->values		= wi_realloc(set->values, set->capacity * sizeof(uint32_t));
+	}
+}
+
+
+
+static void _wi_integer_set_set_values(wi_integer_set_t *set, uint32_t *values, wi_uinteger_t count, wi_uinteger_t capacity) {
+	wi_free(set->values);
+	
+	set->values			= values;
+	set->values_count	= count;
+	set->capacity		= capacity;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_integer_set_count(wi_integer_set_t *set) {
+	return set->values_count;
+}
+
+
+
+const uint32_t * wi_integer_set_values(wi_integer_set_t *set) {
+	return set->values;
+}
+
+
+
+uint32_t wi_integer_set_value_at_index(wi_integer_set_t *set, wi_uinteger_t index) {
+	_WI_INTEGER_SET_INDEX_ASSERT(set, index);
+	
+	return set->values[index];
+}
+
+
+
+uint32_t wi_integer_set_first_value(wi_integer_set_t *set) {
+	_WI_INTEGER_SET_EMPTY_ASSERT(set);
+	
+	return set->values[0];
+}
+
+
+
+uint32_t wi_integer_set_last_value(wi_integer_set_t *set) {
+	_WI_INTEGER_SET_EMPTY_ASSERT(set);
+	
+	return set->values[set->values_count - 1];
+}
+
+
+
+#pragma mark -
+
+wi_boolean_t wi_integer_set_contains_value(wi_integer_set_t *set, uint32_t value) {
+	return (wi_integer_set_index_of_value(set, value) != WI_NOT_FOUND);
+}
+
+
+
+wi_uinteger_t wi_integer_set_index_of_value(wi_integer_set_t *set, uint32_t value) {
+	wi_uinteger_t	index;
+	
+	index = _wi_integer_set_lower_bound(set->values, set->values_count, value);
+	
+	if(index < set->values_count && set->values[index] == value)
+		return index;
+	
+	return WI_NOT_FOUND;
+}
+
+
+
+wi_boolean_t wi_integer_set_is_subset_of_set(wi_integer_set_t *set, wi_integer_set_t *otherset) {
+	wi_uinteger_t	i, j;
+	
+	if(set->values_count > otherset->values_count)
+		return false;
+	
+	for(i = j = 0; i < set->values_count; i++, j++) {
+		j += _wi_integer_set_lower_bound(otherset->values + j, otherset->values_count - j, set->values[i]);
+		
+		if(j == otherset->values_count || otherset->values[j] != set->values[i])
+			return false;
+	}
+	
+	return true;
+}
+
+
+
+wi_boolean_t wi_integer_set_intersects_set(wi_integer_set_t *set, wi_integer_set_t *otherset) {
+	uint32_t		value1, value2;
+	wi_uinteger_t	i, j;
+	
+	i = j = 0;
+	
+	while(i < set->values_count && j < otherset->values_count) {
+		value1 = set->values[i];
+		value2 = otherset->values[j];
+		
+		if(value1 == value2)
+			return true;
+		
+		i += (value1 < value2);
+		j += (value2 < value1);
+	}
+	
+	return false;
+}
+
+
+
+#pragma mark -
+
+wi_integer_set_t * wi_integer_set_union(wi_integer_set_t *set, wi_integer_set_t *otherset) {
+	wi_integer_set_t		*newset;
+	
+	newset = wi_integer_set_init_with_capacity(wi_integer_set_alloc(), set->values_count + otherset->values_count);
+	newset->values_count = _wi_integer_set_union_values(newset->values,
+		set->values, set->values_count,
+		otherset->values, otherset->values_count);
+	
+	return wi_autorelease(newset);
+}
+
+
+
+wi_integer_set_t * wi_integer_set_intersection(wi_integer_set_t *set, wi_integer_set_t *otherset) {
+	wi_integer_set_t		*newset;
+	
+	newset = wi_integer_set_init_with_capacity(wi_integer_set_alloc(), WI_MIN(set->values_count, otherset->values_count));
+	newset->values_count = _wi_integer_set_intersect_values(newset->values,
+		set->values, set->values_count,
+		otherset->values, otherset->values_count);
+	
+	return wi_autorelease(newset);
+}
+
+
+
+wi_integer_set_t * wi_integer_set_difference(wi_integer_set_t *set, wi_integer_set_t *otherset) {
+	wi_integer_set_t		*newset;
+	
+	newset = wi_integer_set_init_with_capacity(wi_integer_set_alloc(), set->values_count);
+	newset->values_count = _wi_integer_set_subtract_values(newset->values,
+		set->values, set->values_count,
+		otherset->values, otherset->values_count);
+	
+	return wi_autorelease(newset);
+}
+
+
+
+#pragma mark -
+
+void wi_mutable_integer_set_add_value(wi_mutable_integer_set_t *set, uint32_t value) {
+	wi_uinteger_t	index;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	index = _wi_integer_set_lower_bound(set->values, set->values_count, value);
+	
+	if(index < set->values_count && set->values[index] == value)
+		return;
+	
+	_wi_integer_set_grow(set, set->values_count + 1);
+	
+	memmove(set->values + index + 1, set->values + index, (set->values_count - index) * sizeof(uint32_t));
+	
+	set->values[index] = value;
+	set->values_count++;
+}
+
+
+
+void wi_mutable_integer_set_add_values(wi_mutable_integer_set_t *set, const uint32_t *values, wi_uinteger_t count) {
+	uint32_t		*sorted, *output;
+	wi_uinteger_t	capacity;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	if(count == 0)
+		return;
+	
+	sorted = wi_malloc(count * sizeof(uint32_t));
+	
+	memcpy(sorted, values, count * sizeof(uint32_t));
+	qsort(sorted, count, sizeof(uint32_t), _wi_integer_set_compare_values);
+	
+	count		= _wi_integer_set_unique_values(sorted, count);
+	capacity	= WI_MAX(set->values_count + count, _WI_INTEGER_SET_MIN_CAPACITY);
+	output		= wi_malloc(capacity * sizeof(uint32_t));
+	count		= _wi_integer_set_union_values(output, set->values, set->values_count, sorted, count);
+	
+	_wi_integer_set_set_values(set, output, count, capacity);
+	
+	wi_free(sorted);
+}
+
+
+
+void wi_mutable_integer_set_union_set(wi_mutable_integer_set_t *set, wi_integer_set_t *otherset) {
+	uint32_t		*output;
+	wi_uinteger_t	count, capacity;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	capacity	= WI_MAX(set->values_count + otherset->values_count, _WI_INTEGER_SET_MIN_CAPACITY);
+	output		= wi_malloc(capacity * sizeof(uint32_t));
+	count		= _wi_integer_set_union_values(output,
+		set->values, set->values_count,
+		otherset->values, otherset->values_count);
+	
+	_wi_integer_set_set_values(set, output, count, capacity);
+}
+
+
+
+void wi_mutable_integer_set_intersect_set(wi_mutable_integer_set_t *set, wi_integer_set_t *otherset) {
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	set->values_count = _wi_integer_set_intersect_values(set->values,
+		set->values, set->values_count,
+		otherset->values, otherset->values_count);
+}
+
+
+
+void wi_mutable_integer_set_minus_set(wi_mutable_integer_set_t *set, wi_integer_set_t *otherset) {
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	if(set == otherset) {
+		set->values_count = 0;
+		
+		return;
+	}
+	
+	set->values_count = _wi_integer_set_subtract_values(set->values,
+		set->values, set->values_count,
+		otherset->values, otherset->values_count);
+}
+
+
+
+#pragma mark -
+
+void wi_mutable_integer_set_remove_value(wi_mutable_integer_set_t *set, uint32_t value) {
+	wi_uinteger_t	index;
+	
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	index = wi_integer_set_index_of_value(set, value);
+	
+	if(index == WI_NOT_FOUND)
+		return;
+	
+	memmove(set->values + index, set->values + index + 1, (set->values_count - index - 1) * sizeof(uint32_t));
+	
+	set->values_count--;
+}
+
+
+
+void wi_mutable_integer_set_remove_all_values(wi_mutable_integer_set_t *set) {
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	set->values_count = 0;
+}
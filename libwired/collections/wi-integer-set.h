@@ -0,0 +1,75 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_INTEGER_SET_H
+#define WI_INTEGER_SET_H 1
+
+#include <wired/wi-base.h>
+#include <wired/wi-runtime.h>
+
+typedef struct _wi_integer_set					wi_integer_set_t;
+typedef struct _wi_integer_set					wi_mutable_integer_set_t;
+
+
+WI_EXPORT wi_runtime_id_t						wi_integer_set_runtime_id(void);
+
+WI_EXPORT wi_integer_set_t *					wi_integer_set(void);
+WI_EXPORT wi_integer_set_t *					wi_integer_set_with_values(const uint32_t *, wi_uinteger_t);
+WI_EXPORT wi_mutable_integer_set_t *			wi_mutable_integer_set(void);
+
+WI_EXPORT wi_integer_set_t *					wi_integer_set_alloc(void);
+WI_EXPORT wi_mutable_integer_set_t *			wi_mutable_integer_set_alloc(void);
+WI_EXPORT wi_integer_set_t *					wi_integer_set_init(wi_integer_set_t *);
+WI_EXPORT wi_integer_set_t *					wi_integer_set_init_with_capacity(wi_integer_set_t *, wi_uinteger_t);
+WI_EXPORT wi_integer_set_t *					wi_integer_set_init_with_values(wi_integer_set_t *, const uint32_t *, wi_uinteger_t);
+
+WI_EXPORT wi_uinteger_t							wi_integer_set_count(wi_integer_set_t *);
+WI_EXPORT const uint32_t *						wi_integer_set_values(wi_integer_set_t *);
+WI_EXPORT uint32_t								wi_integer_set_value_at_index(wi_integer_set_t *, wi_uinteger_t);
+WI_EXPORT uint32_t								wi_integer_set_first_value(wi_integer_set_t *);
+WI_EXPORT uint32_t								wi_integer_set_last_value(wi_integer_set_t *);
+
+WI_EXPORT wi_boolean_t							wi_integer_set_contains_value(wi_integer_set_t *, uint32_t);
+WI_EXPORT wi_uinteger_t							wi_integer_set_index_of_value(wi_integer_set_t *, uint32_t);
+WI_EXPORT wi_boolean_t							wi_integer_set_is_subset_of_set(wi_integer_set_t *, wi_integer_set_t *);
+WI_EXPORT wi_boolean_t							wi_integer_set_intersects_set(wi_integer_set_t *, wi_integer_set_t *);
+
+WI_EXPORT wi_integer_set_t *					wi_integer_set_union(wi_integer_set_t *, wi_integer_set_t *);
+WI_EXPORT wi_integer_set_t *					wi_integer_set_intersection(wi_integer_set_t *, wi_integer_set_t *);
+WI_EXPORT wi_integer_set_t *					wi_integer_set_difference(wi_integer_set_t *, wi_integer_set_t *);
+
+WI_EXPORT void									wi_mutable_integer_set_add_value(wi_mutable_integer_set_t *, uint32_t);
+WI_EXPORT void									wi_mutable_integer_set_add_values(wi_mutable_integer_set_t *, const uint32_t *, wi_uinteger_t);
+WI_EXPORT void									wi_mutable_integer_set_union_set(wi_mutable_integer_set_t *, wi_integer_set_t *);
+WI_EXPORT void									wi_mutable_integer_set_intersect_set(wi_mutable_integer_set_t *, wi_integer_set_t *);
+WI_EXPORT void									wi_mutable_integer_set_minus_set(wi_mutable_integer_set_t *, wi_integer_set_t *);
+
+WI_EXPORT void									wi_mutable_integer_set_remove_value(wi_mutable_integer_set_t *, uint32_t);
+WI_EXPORT void									wi_mutable_integer_set_remove_all_values(wi_mutable_integer_set_t *);
+
+#endif /* WI_INTEGER_SET_H */
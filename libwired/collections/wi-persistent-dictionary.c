@@ -0,0 +1,826 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wired/wi-array.h>
+#include <wired/wi-assert.h>
+#include <wired/wi-dictionary.h>
+#include <wired/wi-persistent-dictionary.h>
+#include <wired/wi-pool.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-string.h>
+#include <wired/wi-system.h>
+
+#define _WI_PERSISTENT_DICTIONARY_BITS				5
+#define _WI_PERSISTENT_DICTIONARY_MASK				((1 << _WI_PERSISTENT_DICTIONARY_BITS) - 1)
+#define _WI_PERSISTENT_DICTIONARY_MAX_SHIFT			(sizeof(wi_hash_code_t) * 8)
+
+#define _WI_PERSISTENT_DICTIONARY_BIT(hash, shift)							\
+	((uint32_t) 1 << (((hash) >> (shift)) & _WI_PERSISTENT_DICTIONARY_MASK))
+
+#define _WI_PERSISTENT_DICTIONARY_INDEX(map, bit)							\
+	_wi_persistent_dictionary_popcount((map) & ((bit) - 1))
+
+#define _WI_PERSISTENT_DICTIONARY_NODES(node)								\
+	((_wi_persistent_dictionary_node_t **) ((node)->entries + (node)->entries_count))
+
+#define _WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(e, k, h)					\
+	((e)->hash == (h) &&													\
+	 ((e)->key == (k) || wi_is_equal((e)->key, (k))))
+
+
+struct _wi_persistent_dictionary_entry {
+	void									*key;
+	void									*data;
+	wi_hash_code_t							hash;
+};
+typedef struct _wi_persistent_dictionary_entry	_wi_persistent_dictionary_entry_t;
+
+
+struct _wi_persistent_dictionary_node {
+	wi_uinteger_t							references;
+	uint32_t								datamap;
+	uint32_t								nodemap;
+	uint32_t								entries_count;
+	uint32_t								nodes_count;
+	_wi_persistent_dictionary_entry_t		entries[];
+};
+typedef struct _wi_persistent_dictionary_node	_wi_persistent_dictionary_node_t;
+
+
+struct _wi_persistent_dictionary {
+	wi_runtime_base_t						base;
+	
+	_wi_persistent_dictionary_node_t		*root;
+	wi_uinteger_t							count;
+};
+
+
+static void										_wi_persistent_dictionary_dealloc(wi_runtime_instance_t *);
+static wi_boolean_t								_wi_persistent_dictionary_is_equal(wi_runtime_instance_t *, wi_runtime_instance_t *);
+static wi_string_t *							_wi_persistent_dictionary_description(wi_runtime_instance_t *);
+static wi_hash_code_t							_wi_persistent_dictionary_hash(wi_runtime_instance_t *);
+
+static wi_persistent_dictionary_t *				_wi_persistent_dictionary_with_root(_wi_persistent_dictionary_node_t *, wi_uinteger_t);
+
+static uint32_t									_wi_persistent_dictionary_popcount(uint32_t);
+static _wi_persistent_dictionary_node_t *		_wi_persistent_dictionary_node_create(uint32_t, uint32_t, uint32_t, uint32_t);
+static _wi_persistent_dictionary_node_t *		_wi_persistent_dictionary_node_retain(_wi_persistent_dictionary_node_t *);
+static void										_wi_persistent_dictionary_node_release(_wi_persistent_dictionary_node_t *);
+static void										_wi_persistent_dictionary_node_copy_entry(_wi_persistent_dictionary_entry_t *, _wi_persistent_dictionary_entry_t *);
+static _wi_persistent_dictionary_entry_t *		_wi_persistent_dictionary_node_entry_for_key(_wi_persistent_dictionary_node_t *, void *, wi_hash_code_t);
+static _wi_persistent_dictionary_node_t *		_wi_persistent_dictionary_node_merge(_wi_persistent_dictionary_entry_t *, _wi_persistent_dictionary_entry_t *, wi_uinteger_t);
+static _wi_persistent_dictionary_node_t *		_wi_persistent_dictionary_node_set(_wi_persistent_dictionary_node_t *, _wi_persistent_dictionary_entry_t *, wi_uinteger_t, wi_boolean_t *);
+static _wi_persistent_dictionary_node_t *		_wi_persistent_dictionary_node_remove(_wi_persistent_dictionary_node_t *, void *, wi_hash_code_t, wi_uinteger_t, wi_boolean_t *);
+static void										_wi_persistent_dictionary_node_add_to_array(_wi_persistent_dictionary_node_t *, wi_mutable_array_t *, wi_boolean_t);
+static void										_wi_persistent_dictionary_node_add_to_dictionary(_wi_persistent_dictionary_node_t *, wi_mutable_dictionary_t *);
+static wi_boolean_t								_wi_persistent_dictionary_node_is_subset(_wi_persistent_dictionary_node_t *, wi_persistent_dictionary_t *);
+
+
+static wi_runtime_id_t							_wi_persistent_dictionary_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t						_wi_persistent_dictionary_runtime_class = {
+	"wi_persistent_dictionary_t",
+	_wi_persistent_dictionary_dealloc,
+	NULL,
+	_wi_persistent_dictionary_is_equal,
+	_wi_persistent_dictionary_description,
+	_wi_persistent_dictionary_hash
+};
+
+
+
+void wi_persistent_dictionary_register(void) {
+	_wi_persistent_dictionary_runtime_id = wi_runtime_register_class(&_wi_persistent_dictionary_runtime_class);
+}
+
+
+
+void wi_persistent_dictionary_initialize(void) {
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_persistent_dictionary_runtime_id(void) {
+	return _wi_persistent_dictionary_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_persistent_dictionary_t * wi_persistent_dictionary(void) {
+	return wi_autorelease(wi_persistent_dictionary_init(wi_persistent_dictionary_alloc()));
+}
+
+
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_with_dictionary(wi_dictionary_t *dictionary) {
+	return wi_autorelease(wi_persistent_dictionary_init_with_dictionary(wi_persistent_dictionary_alloc(), dictionary));
+}
+
+
+
+static wi_persistent_dictionary_t * _wi_persistent_dictionary_with_root(_wi_persistent_dictionary_node_t *root, wi_uinteger_t count) {
+	wi_persistent_dictionary_t		*dictionary;
+	
+	dictionary = wi_persistent_dictionary_init(wi_persistent_dictionary_alloc());
+	dictionary->root	= root;
+	dictionary->count	= count;
+	
+	return wi_autorelease(dictionary);
+}
+
+
+
+#pragma mark -
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_alloc(void) {
+	return wi_runtime_create_instance_with_options(_wi_persistent_dictionary_runtime_id, sizeof(wi_persistent_dictionary_t), WI_RUNTIME_OPTION_IMMUTABLE);
+}
+
+
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_init(wi_persistent_dictionary_t *dictionary) {
+	return dictionary;
+}
+
+
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_init_with_dictionary(wi_persistent_dictionary_t *dictionary, wi_dictionary_t *otherdictionary) {
+	_wi_persistent_dictionary_node_t		*root;
+	_wi_persistent_dictionary_entry_t		entry;
+	wi_enumerator_t							*enumerator;
+	wi_boolean_t							added;
+	
+	dictionary = wi_persistent_dictionary_init(dictionary);
+	
+	enumerator = wi_dictionary_key_enumerator(otherdictionary);
+	
+	while((entry.key = wi_enumerator_next_data(enumerator))) {
+		entry.data	= wi_dictionary_data_for_key(otherdictionary, entry.key);
+		entry.hash	= wi_hash(entry.key);
+		added		= false;
+		
+		if(dictionary->root) {
+			root = _wi_persistent_dictionary_node_set(dictionary->root, &entry, 0, &added);
+			
+			_wi_persistent_dictionary_node_release(dictionary->root);
+		} else {
+			root = _wi_persistent_dictionary_node_merge(&entry, NULL, 0);
+			added = true;
+		}
+		
+		dictionary->root = root;
+		
+		if(added)
+			dictionary->count++;
+	}
+	
+	return dictionary;
+}
+
+
+
+static void _wi_persistent_dictionary_dealloc(wi_runtime_instance_t *instance) {
+	wi_persistent_dictionary_t		*dictionary = instance;
+	
+	if(dictionary->root)
+		_wi_persistent_dictionary_node_release(dictionary->root);
+}
+
+
+
+static wi_boolean_t _wi_persistent_dictionary_is_equal(wi_runtime_instance_t *instance1, wi_runtime_instance_t *instance2) {
+	wi_persistent_dictionary_t		*dictionary1 = instance1;
+	wi_persistent_dictionary_t		*dictionary2 = instance2;
+	
+	if(dictionary1->count != dictionary2->count)
+		return false;
+	
+	if(dictionary1->root == dictionary2->root)
+		return true;
+	
+	return _wi_persistent_dictionary_node_is_subset(dictionary1->root, dictionary2);
+}
+
+
+
+static wi_string_t * _wi_persistent_dictionary_description(wi_runtime_instance_t *instance) {
+	wi_persistent_dictionary_t		*dictionary = instance;
+	
+	return wi_string_with_format(WI_STR("<%@ %p>{count = %lu, dictionary = %@}"),
+		wi_runtime_class_name(dictionary),
+		dictionary,
+		dictionary->count,
+		wi_persistent_dictionary_dictionary(dictionary));
+}
+
+
+
+static wi_hash_code_t _wi_persistent_dictionary_hash(wi_runtime_instance_t *instance) {
+	wi_persistent_dictionary_t		*dictionary = instance;
+	
+	return dictionary->count;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_persistent_dictionary_count(wi_persistent_dictionary_t *dictionary) {
+	return dictionary->count;
+}
+
+
+
+void * wi_persistent_dictionary_data_for_key(wi_persistent_dictionary_t *dictionary, void *key) {
+	_wi_persistent_dictionary_entry_t		*entry;
+	
+	if(!dictionary->root)
+		return NULL;
+	
+	entry = _wi_persistent_dictionary_node_entry_for_key(dictionary->root, key, wi_hash(key));
+	
+	return entry ? entry->data : NULL;
+}
+
+
+
+wi_boolean_t wi_persistent_dictionary_contains_key(wi_persistent_dictionary_t *dictionary, void *key) {
+	return (wi_persistent_dictionary_data_for_key(dictionary, key) != NULL);
+}
+
+
+
+wi_array_t * wi_persistent_dictionary_all_keys(wi_persistent_dictionary_t *dictionary) {
+	wi_mutable_array_t		*array;
+	
+	array = wi_array_init_with_capacity(wi_mutable_array_alloc(), dictionary->count);
+	
+	if(dictionary->root)
+		_wi_persistent_dictionary_node_add_to_array(dictionary->root, array, true);
+	
+	wi_runtime_make_immutable(array);
+	
+	return wi_autorelease(array);
+}
+
+
+
+wi_array_t * wi_persistent_dictionary_all_data(wi_persistent_dictionary_t *dictionary) {
+	wi_mutable_array_t		*array;
+	
+	array = wi_array_init_with_capacity(wi_mutable_array_alloc(), dictionary->count);
+	
+	if(dictionary->root)
+		_wi_persistent_dictionary_node_add_to_array(dictionary->root, array, false);
+	
+	wi_runtime_make_immutable(array);
+	
+	return wi_autorelease(array);
+}
+
+
+
+wi_dictionary_t * wi_persistent_dictionary_dictionary(wi_persistent_dictionary_t *dictionary) {
+	wi_mutable_dictionary_t		*otherdictionary;
+	
+	otherdictionary = wi_dictionary_init_with_capacity(wi_mutable_dictionary_alloc(), dictionary->count);
+	
+	if(dictionary->root)
+		_wi_persistent_dictionary_node_add_to_dictionary(dictionary->root, otherdictionary);
+	
+	wi_runtime_make_immutable(otherdictionary);
+	
+	return wi_autorelease(otherdictionary);
+}
+
+
+
+#pragma mark -
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_by_setting_data_for_key(wi_persistent_dictionary_t *dictionary, void *data, void *key) {
+	_wi_persistent_dictionary_node_t		*root;
+	_wi_persistent_dictionary_entry_t		entry;
+	wi_boolean_t							added;
+	
+	WI_ASSERT(data != NULL, "attempt to insert NULL data in %@", dictionary);
+	WI_ASSERT(key != NULL, "attempt to insert NULL key in %@", dictionary);
+	
+	entry.key	= wi_copy(key);
+	entry.data	= data;
+	entry.hash	= wi_hash(entry.key);
+	added		= false;
+	
+	if(dictionary->root) {
+		root = _wi_persistent_dictionary_node_set(dictionary->root, &entry, 0, &added);
+	} else {
+		root = _wi_persistent_dictionary_node_merge(&entry, NULL, 0);
+		added = true;
+	}
+	
+	wi_release(entry.key);
+	
+	return _wi_persistent_dictionary_with_root(root, dictionary->count + (added ? 1 : 0));
+}
+
+
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_by_removing_data_for_key(wi_persistent_dictionary_t *dictionary, void *key) {
+	_wi_persistent_dictionary_node_t		*root;
+	wi_boolean_t							removed;
+	
+	if(!dictionary->root)
+		return dictionary;
+	
+	removed = false;
+	root = _wi_persistent_dictionary_node_remove(dictionary->root, key, wi_hash(key), 0, &removed);
+	
+	if(!removed) {
+		_wi_persistent_dictionary_node_release(root);
+		
+		return dictionary;
+	}
+	
+	return _wi_persistent_dictionary_with_root(root, dictionary->count - 1);
+}
+
+
+
+#pragma mark -
+
+wi_persistent_dictionary_t * wi_persistent_dictionary_load(wi_persistent_dictionary_t **pointer) {
+	return wi_runtime_load_instance((wi_runtime_instance_t **) pointer);
+}
+
+
+
+void wi_persistent_dictionary_store(wi_persistent_dictionary_t **pointer, wi_persistent_dictionary_t *dictionary) {
+	wi_runtime_store_instance((wi_runtime_instance_t **) pointer, dictionary);
+}
+
+
+
+wi_boolean_t wi_persistent_dictionary_compare_and_store(wi_persistent_dictionary_t **pointer, wi_persistent_dictionary_t *expected_dictionary, wi_persistent_dictionary_t *dictionary) {
+	return wi_runtime_compare_and_store_instance((wi_runtime_instance_t **) pointer, expected_dictionary, dictionary);
+}
+
+
+
+#pragma mark -
+
+static uint32_t _wi_persistent_dictionary_popcount(uint32_t map) {
+#ifdef __GNUC__
+	return __builtin_popcount(map);
+#else
+	map = map - ((map >> 1) & 0x55555555);
+	map = (map & 0x33333333) + ((map >> 2) & 0x33333333);
+	
+	return (((map + (map >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+
+
+static _wi_persistent_dictionary_node_t * _wi_persistent_dictionary_node_create(uint32_t datamap, uint32_t nodemap, uint32_t entries_count, uint32_t nodes_count) {
+	_wi_persistent_dictionary_node_t		*node;
+	
+	node = wi_malloc(sizeof(_wi_persistent_dictionary_node_t) +
+					 (entries_count * sizeof(_wi_persistent_dictionary_entry_t)) +
+					 (nodes_count * sizeof(_wi_persistent_dictionary_node_t *)));
+	node->references		= 1;
+	node->datamap			= datamap;
+	node->nodemap			= nodemap;
+	node->entries_count		= entries_count;
+	node->nodes_count		= nodes_count;
+	
+	return node;
+}
+
+
+
+static _wi_persistent_dictionary_node_t * _wi_persistent_dictionary_node_retain(_wi_persistent_dictionary_node_t *node) {
+	WI_ATOMIC_INCREMENT(node->references);
+	
+	return node;
+}
+
+
+
+static void _wi_persistent_dictionary_node_release(_wi_persistent_dictionary_node_t *node) {
+	_wi_persistent_dictionary_node_t		**nodes;
+	uint32_t								i;
+	
+	if(WI_ATOMIC_DECREMENT(node->references) > 0)
+		return;
+	
+	for(i = 0; i < node->entries_count; i++) {
+		wi_release(node->entries[i].key);
+		wi_release(node->entries[i].data);
+	}
+	
+	nodes = _WI_PERSISTENT_DICTIONARY_NODES(node);
+	
+	for(i = 0; i < node->nodes_count; i++)
+		_wi_persistent_dictionary_node_release(nodes[i]);
+	
+	wi_free(node);
+}
+
+
+
+static void _wi_persistent_dictionary_node_copy_entry(_wi_persistent_dictionary_entry_t *entry, _wi_persistent_dictionary_entry_t *otherentry) {
+	entry->key		= wi_retain(otherentry->key);
+	entry->data		= wi_retain(otherentry->data);
+	entry->hash		= otherentry->hash;
+}
+
+
+
+static _wi_persistent_dictionary_entry_t * _wi_persistent_dictionary_node_entry_for_key(_wi_persistent_dictionary_node_t *node, void *key, wi_hash_code_t hash) {
+	_wi_persistent_dictionary_entry_t		*entry;
+	wi_uinteger_t							shift;
+	uint32_t								i, bit;
+	
+	for(shift = 0; shift < _WI_PERSISTENT_DICTIONARY_MAX_SHIFT; shift += _WI_PERSISTENT_DICTIONARY_BITS) {
+		bit = _WI_PERSISTENT_DICTIONARY_BIT(hash, shift);
+		
+		if(node->datamap & bit) {
+			entry = &node->entries[_WI_PERSISTENT_DICTIONARY_INDEX(node->datamap, bit)];
+			
+			return _WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(entry, key, hash) ? entry : NULL;
+		}
+		else if(node->nodemap & bit) {
+			node = _WI_PERSISTENT_DICTIONARY_NODES(node)[_WI_PERSISTENT_DICTIONARY_INDEX(node->nodemap, bit)];
+		}
+		else {
+			return NULL;
+		}
+	}
+	
+	for(i = 0; i < node->entries_count; i++) {
+		if(_WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(&node->entries[i], key, hash))
+			return &node->entries[i];
+	}
+	
+	return NULL;
+}
+
+
+
+static _wi_persistent_dictionary_node_t * _wi_persistent_dictionary_node_merge(_wi_persistent_dictionary_entry_t *entry1, _wi_persistent_dictionary_entry_t *entry2, wi_uinteger_t shift) {
+	_wi_persistent_dictionary_node_t		*node;
+	uint32_t								bit1, bit2;
+	
+	if(!entry2) {
+		node = _wi_persistent_dictionary_node_create(_WI_PERSISTENT_DICTIONARY_BIT(entry1->hash, shift), 0, 1, 0);
+		
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[0], entry1);
+		
+		return node;
+	}
+	
+	if(shift >= _WI_PERSISTENT_DICTIONARY_MAX_SHIFT) {
+		node = _wi_persistent_dictionary_node_create(0, 0, 2, 0);
+		
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[0], entry1);
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[1], entry2);
+		
+		return node;
+	}
+	
+	bit1 = _WI_PERSISTENT_DICTIONARY_BIT(entry1->hash, shift);
+	bit2 = _WI_PERSISTENT_DICTIONARY_BIT(entry2->hash, shift);
+	
+	if(bit1 == bit2) {
+		node = _wi_persistent_dictionary_node_create(0, bit1, 0, 1);
+		
+		_WI_PERSISTENT_DICTIONARY_NODES(node)[0] =
+			_wi_persistent_dictionary_node_merge(entry1, entry2, shift + _WI_PERSISTENT_DICTIONARY_BITS);
+		
+		return node;
+	}
+	
+	node = _wi_persistent_dictionary_node_create(bit1 | bit2, 0, 2, 0);
+	
+	if(bit1 < bit2) {
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[0], entry1);
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[1], entry2);
+	} else {
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[0], entry2);
+		_wi_persistent_dictionary_node_copy_entry(&node->entries[1], entry1);
+	}
+	
+	return node;
+}
+
+
+
+static _wi_persistent_dictionary_node_t * _wi_persistent_dictionary_node_set(_wi_persistent_dictionary_node_t *node, _wi_persistent_dictionary_entry_t *entry, wi_uinteger_t shift, wi_boolean_t *added) {
+	_wi_persistent_dictionary_node_t		*newnode, **nodes, **newnodes;
+	uint32_t								i, j, bit, index, nodeindex;
+	
+	nodes = _WI_PERSISTENT_DICTIONARY_NODES(node);
+	
+	if(shift >= _WI_PERSISTENT_DICTIONARY_MAX_SHIFT) {
+		for(index = 0; index < node->entries_count; index++) {
+			if(_WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(&node->entries[index], entry->key, entry->hash))
+				break;
+		}
+		
+		if(index == node->entries_count)
+			*added = true;
+		
+		newnode = _wi_persistent_dictionary_node_create(0, 0, node->entries_count + (*added ? 1 : 0), 0);
+		
+		for(i = 0; i < node->entries_count; i++) {
+			if(i != index)
+				_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &node->entries[i]);
+		}
+		
+		_wi_persistent_dictionary_node_copy_entry(&newnode->entries[index], entry);
+		
+		return newnode;
+	}
+	
+	bit = _WI_PERSISTENT_DICTIONARY_BIT(entry->hash, shift);
+	
+	if(node->datamap & bit) {
+		index = _WI_PERSISTENT_DICTIONARY_INDEX(node->datamap, bit);
+		
+		if(_WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(&node->entries[index], entry->key, entry->hash)) {
+			newnode = _wi_persistent_dictionary_node_create(node->datamap, node->nodemap, node->entries_count, node->nodes_count);
+			newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+			
+			for(i = 0; i < node->entries_count; i++)
+				_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], (i == index) ? entry : &node->entries[i]);
+			
+			for(i = 0; i < node->nodes_count; i++)
+				newnodes[i] = _wi_persistent_dictionary_node_retain(nodes[i]);
+			
+			return newnode;
+		}
+		
+		*added = true;
+		
+		newnode = _wi_persistent_dictionary_node_create(node->datamap & ~bit, node->nodemap | bit, node->entries_count - 1, node->nodes_count + 1);
+		newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+		nodeindex = _WI_PERSISTENT_DICTIONARY_INDEX(newnode->nodemap, bit);
+		
+		for(i = j = 0; i < node->entries_count; i++) {
+			if(i != index)
+				_wi_persistent_dictionary_node_copy_entry(&newnode->entries[j++], &node->entries[i]);
+		}
+		
+		for(i = j = 0; i < newnode->nodes_count; i++) {
+			if(i == nodeindex)
+				newnodes[i] = _wi_persistent_dictionary_node_merge(&node->entries[index], entry, shift + _WI_PERSISTENT_DICTIONARY_BITS);
+			else
+				newnodes[i] = _wi_persistent_dictionary_node_retain(nodes[j++]);
+		}
+		
+		return newnode;
+	}
+	
+	if(node->nodemap & bit) {
+		nodeindex = _WI_PERSISTENT_DICTIONARY_INDEX(node->nodemap, bit);
+		
+		newnode = _wi_persistent_dictionary_node_create(node->datamap, node->nodemap, node->entries_count, node->nodes_count);
+		newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+		
+		for(i = 0; i < node->entries_count; i++)
+			_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &node->entries[i]);
+		
+		for(i = 0; i < node->nodes_count; i++) {
+			if(i == nodeindex)
+				newnodes[i] = _wi_persistent_dictionary_node_set(nodes[i], entry, shift + _WI_PERSISTENT_DICTIONARY_BITS, added);
+			else
+				newnodes[i] = _wi_persistent_dictionary_node_retain(nodes[i]);
+		}
+		
+		return newnode;
+	}
+	
+	*added = true;
+	
+	newnode = _wi_persistent_dictionary_node_create(node->datamap | bit, node->nodemap, node->entries_count + 1, node->nodes_count);
+	newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+	index = _WI_PERSISTENT_DICTIONARY_INDEX(newnode->datamap, bit);
+	
+	for(i = j = 0; i < newnode->entries_count; i++) {
+		if(i == index)
+			_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], entry);
+		else
+			_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &node->entries[j++]);
+	}
+	
+	for(i = 0; i < node->nodes_count; i++)
+		newnodes[i] = _wi_persistent_dictionary_node_retain(nodes[i]);
+	
+	return newnode;
+}
+
+
+
+static _wi_persistent_dictionary_node_t * _wi_persistent_dictionary_node_remove(_wi_persistent_dictionary_node_t *node, void *key, wi_hash_code_t hash, wi_uinteger_t shift, wi_boolean_t *removed) {
+	_wi_persistent_dictionary_node_t		*newnode, *child, **nodes, **newnodes;
+	uint32_t								i, j, bit, index, nodeindex;
+	
+	nodes = _WI_PERSISTENT_DICTIONARY_NODES(node);
+	
+	if(shift >= _WI_PERSISTENT_DICTIONARY_MAX_SHIFT) {
+		for(index = 0; index < node->entries_count; index++) {
+			if(_WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(&node->entries[index], key, hash))
+				break;
+		}
+		
+		if(index == node->entries_count)
+			return _wi_persistent_dictionary_node_retain(node);
+		
+		*removed = true;
+		
+		if(node->entries_count == 1)
+			return NULL;
+		
+		newnode = _wi_persistent_dictionary_node_create(0, 0, node->entries_count - 1, 0);
+		
+		for(i = j = 0; i < node->entries_count; i++) {
+			if(i != index)
+				_wi_persistent_dictionary_node_copy_entry(&newnode->entries[j++], &node->entries[i]);
+		}
+		
+		return newnode;
+	}
+	
+	bit = _WI_PERSISTENT_DICTIONARY_BIT(hash, shift);
+	
+	if(node->datamap & bit) {
+		index = _WI_PERSISTENT_DICTIONARY_INDEX(node->datamap, bit);
+		
+		if(!_WI_PERSISTENT_DICTIONARY_ENTRY_MATCHES(&node->entries[index], key, hash))
+			return _wi_persistent_dictionary_node_retain(node);
+		
+		*removed = true;
+		
+		if(node->entries_count == 1 && node->nodes_count == 0)
+			return NULL;
+		
+		newnode = _wi_persistent_dictionary_node_create(node->datamap & ~bit, node->nodemap, node->entries_count - 1, node->nodes_count);
+		newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+		
+		for(i = j = 0; i < node->entries_count; i++) {
+			if(i != index)
+				_wi_persistent_dictionary_node_copy_entry(&newnode->entries[j++], &node->entries[i]);
+		}
+		
+		for(i = 0; i < node->nodes_count; i++)
+			newnodes[i] = _wi_persistent_dictionary_node_retain(nodes[i]);
+		
+		return newnode;
+	}
+	
+	if(!(node->nodemap & bit))
+		return _wi_persistent_dictionary_node_retain(node);
+	
+	nodeindex = _WI_PERSISTENT_DICTIONARY_INDEX(node->nodemap, bit);
+	child = _wi_persistent_dictionary_node_remove(nodes[nodeindex], key, hash, shift + _WI_PERSISTENT_DICTIONARY_BITS, removed);
+	
+	if(!*removed) {
+		_wi_persistent_dictionary_node_release(child);
+		
+		return _wi_persistent_dictionary_node_retain(node);
+	}
+	
+	if(!child || (child->entries_count == 1 && child->nodes_count == 0)) {
+		if(child) {
+			newnode = _wi_persistent_dictionary_node_create(node->datamap | bit, node->nodemap & ~bit, node->entries_count + 1, node->nodes_count - 1);
+			index = _WI_PERSISTENT_DICTIONARY_INDEX(newnode->datamap, bit);
+			
+			for(i = j = 0; i < newnode->entries_count; i++) {
+				if(i == index)
+					_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &child->entries[0]);
+				else
+					_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &node->entries[j++]);
+			}
+			
+			_wi_persistent_dictionary_node_release(child);
+		} else {
+			if(node->entries_count == 0 && node->nodes_count == 1)
+				return NULL;
+			
+			newnode = _wi_persistent_dictionary_node_create(node->datamap, node->nodemap & ~bit, node->entries_count, node->nodes_count - 1);
+			
+			for(i = 0; i < node->entries_count; i++)
+				_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &node->entries[i]);
+		}
+		
+		newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+		
+		for(i = j = 0; i < node->nodes_count; i++) {
+			if(i != nodeindex)
+				newnodes[j++] = _wi_persistent_dictionary_node_retain(nodes[i]);
+		}
+		
+		return newnode;
+	}
+	
+	newnode = _wi_persistent_dictionary_node_create(node->datamap, node->nodemap, node->entries_count, node->nodes_count);
+	newnodes = _WI_PERSISTENT_DICTIONARY_NODES(newnode);
+	
+	for(i = 0; i < node->entries_count; i++)
+		_wi_persistent_dictionary_node_copy_entry(&newnode->entries[i], &node->entries[i]);
+	
+	for(i = 0; i < node->nodes_count; i++)
+		newnodes[i] = (i == nodeindex) ? child : _wi_persistent_dictionary_node_retain(nodes[i]);
+	
+	return newnode;
+}
+
+
+
+static void _wi_persistent_dictionary_node_add_to_array(_wi_persistent_dictionary_node_t *node, wi_mutable_array_t *array, wi_boolean_t keys) {
+	_wi_persistent_dictionary_node_t		**nodes;
+	uint32_t								i;
+	
+	for(i = 0; i < node->entries_count; i++)
+		wi_mutable_array_add_data(array, keys ? node->entries[i].key : node->entries[i].data);
+	
+	nodes = _WI_PERSISTENT_DICTIONARY_NODES(node);
+	
+	for(i = 0; i < node->nodes_count; i++)
+		_wi_persistent_dictionary_node_add_to_array(nodes[i], array, keys);
+}
+
+
+
+static void _wi_persistent_dictionary_node_add_to_dictionary(_wi_persistent_dictionary_node_t *node, wi_mutable_dictionary_t *dictionary) {
+	_wi_persistent_dictionary_node_t		**nodes;
+	uint32_t								i;
+	
+	for(i = 0; i < node->entries_count; i++)
+		wi_mutable_dictionary_set_data_for_key(dictionary, node->entries[i].data, node->entries[i].key);
+	
+	nodes = _WI_PERSISTENT_DICTIONARY_NODES(node);
+	
+	for(i = 0; i < node->nodes_count; i++)
+		_wi_persistent_dictionary_node_add_to_dictionary(nodes[i], dictionary);
+}
+
+
+
+static wi_boolean_t _wi_persistent_dictionary_node_is_subset(_wi_persistent_dictionary_node_t *node, wi_persistent_dictionary_t *dictionary) {
+	_wi_persistent_dictionary_node_t		**nodes;
+	_wi_persistent_dictionary_entry_t		*entry;
+	uint32_t								i;
+	
+	if(!node)
+		return true;
+	
+	if(!dictionary->root)
+		return false;
+	
+	for(i = 0; i < node->entries_count; i++) {
+		entry = _wi_persistent_dictionary_node_entry_for_key(dictionary->root, node->entries[i].key, node->entries[i].hash);
+		
+		if(!entry || !wi_is_equal(entry->data, node->entries[i].data))
+			return false;
+	}
+	
+	nodes = _WI_PERSISTENT_DICTIONARY_NODES(node);
+	
+	for(i = 0; i < node->nodes_count; i++) {
+		if(!_wi_persistent_dictionary_node_is_subset(nodes[i], dictionary))
+			return false;
+	}
+	
+	return true;
+}
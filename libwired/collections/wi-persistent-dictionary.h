@@ -0,0 +1,62 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_PERSISTENT_DICTIONARY_H
+#define WI_PERSISTENT_DICTIONARY_H 1
+
+#include <wired/wi-base.h>
+#include <wired/wi-dictionary.h>
+#include <wired/wi-runtime.h>
+
+typedef struct _wi_persistent_dictionary				wi_persistent_dictionary_t;
+
+
+WI_EXPORT wi_runtime_id_t								wi_persistent_dictionary_runtime_id(void);
+
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary(void);
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_with_dictionary(wi_dictionary_t *);
+
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_alloc(void);
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_init(wi_persistent_dictionary_t *);
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_init_with_dictionary(wi_persistent_dictionary_t *, wi_dictionary_t *);
+
+WI_EXPORT wi_uinteger_t									wi_persistent_dictionary_count(wi_persistent_dictionary_t *);
+WI_EXPORT void *										wi_persistent_dictionary_data_for_key(wi_persistent_dictionary_t *, void *);
+WI_EXPORT wi_boolean_t									wi_persistent_dictionary_contains_key(wi_persistent_dictionary_t *, void *);
+WI_EXPORT wi_array_t *									wi_persistent_dictionary_all_keys(wi_persistent_dictionary_t *);
+WI_EXPORT wi_array_t *									wi_persistent_dictionary_all_data(wi_persistent_dictionary_t *);
+WI_EXPORT wi_dictionary_t *								wi_persistent_dictionary_dictionary(wi_persistent_dictionary_t *);
+
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_by_setting_data_for_key(wi_persistent_dictionary_t *, void *, void *);
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_by_removing_data_for_key(wi_persistent_dictionary_t *, void *);
+
+WI_EXPORT wi_persistent_dictionary_t *					wi_persistent_dictionary_load(wi_persistent_dictionary_t **);
+WI_EXPORT void											wi_persistent_dictionary_store(wi_persistent_dictionary_t **, wi_persistent_dictionary_t *);
+WI_EXPORT wi_boolean_t									wi_persistent_dictionary_compare_and_store(wi_persistent_dictionary_t **, wi_persistent_dictionary_t *, wi_persistent_dictionary_t *);
+
+#endif /* WI_PERSISTENT_DICTIONARY_H */
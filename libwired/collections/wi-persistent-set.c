@@ -0,0 +1,242 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wired/wi-array.h>
+#include <wired/wi-null.h>
+#include <wired/wi-persistent-dictionary.h>
+#include <wired/wi-persistent-set.h>
+#include <wired/wi-pool.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-string.h>
+
+struct _wi_persistent_set {
+	wi_runtime_base_t						base;
+	
+	wi_persistent_dictionary_t				*dictionary;
+};
+
+
+static void									_wi_persistent_set_dealloc(wi_runtime_instance_t *);
+static wi_boolean_t							_wi_persistent_set_is_equal(wi_runtime_instance_t *, wi_runtime_instance_t *);
+static wi_string_t *						_wi_persistent_set_description(wi_runtime_instance_t *);
+static wi_hash_code_t						_wi_persistent_set_hash(wi_runtime_instance_t *);
+
+static wi_persistent_set_t *				_wi_persistent_set_with_dictionary(wi_persistent_set_t *, wi_persistent_dictionary_t *);
+
+
+static wi_runtime_id_t						_wi_persistent_set_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t					_wi_persistent_set_runtime_class = {
+	"wi_persistent_set_t",
+	_wi_persistent_set_dealloc,
+	NULL,
+	_wi_persistent_set_is_equal,
+	_wi_persistent_set_description,
+	_wi_persistent_set_hash
+};
+
+
+
+void wi_persistent_set_register(void) {
+	_wi_persistent_set_runtime_id = wi_runtime_register_class(&_wi_persistent_set_runtime_class);
+}
+
+
+
+void wi_persistent_set_initialize(void) {
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_persistent_set_runtime_id(void) {
+	return _wi_persistent_set_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_persistent_set_t * wi_persistent_set(void) {
+	return wi_autorelease(wi_persistent_set_init(wi_persistent_set_alloc()));
+}
+
+
+
+wi_persistent_set_t * wi_persistent_set_with_array(wi_array_t *array) {
+	return wi_autorelease(wi_persistent_set_init_with_array(wi_persistent_set_alloc(), array));
+}
+
+
+
+static wi_persistent_set_t * _wi_persistent_set_with_dictionary(wi_persistent_set_t *set, wi_persistent_dictionary_t *dictionary) {
+	wi_persistent_set_t		*newset;
+	
+	if(dictionary == set->dictionary)
+		return set;
+	
+	newset = wi_persistent_set_alloc();
+	newset->dictionary = wi_retain(dictionary);
+	
+	return wi_autorelease(newset);
+}
+
+
+
+#pragma mark -
+
+wi_persistent_set_t * wi_persistent_set_alloc(void) {
+	return wi_runtime_create_instance_with_options(_wi_persistent_set_runtime_id, sizeof(wi_persistent_set_t), WI_RUNTIME_OPTION_IMMUTABLE);
+}
+
+
+
+wi_persistent_set_t * wi_persistent_set_init(wi_persistent_set_t *set) {
+	set->dictionary = wi_persistent_dictionary_init(wi_persistent_dictionary_alloc());
+	
+	return set;
+}
+
+
+
+wi_persistent_set_t * wi_persistent_set_init_with_array(wi_persistent_set_t *set, wi_array_t *array) {
+	wi_persistent_dictionary_t		*dictionary;
+	wi_pool_t						*pool;
+	wi_uinteger_t					i, count;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	
+	dictionary = wi_persistent_dictionary();
+	count = wi_array_count(array);
+	
+	for(i = 0; i < count; i++)
+		dictionary = wi_persistent_dictionary_by_setting_data_for_key(dictionary, wi_null(), WI_ARRAY(array, i));
+	
+	set->dictionary = wi_retain(dictionary);
+	
+	wi_release(pool);
+	
+	return set;
+}
+
+
+
+static void _wi_persistent_set_dealloc(wi_runtime_instance_t *instance) {
+	wi_persistent_set_t		*set = instance;
+	
+	wi_release(set->dictionary);
+}
+
+
+
+static wi_boolean_t _wi_persistent_set_is_equal(wi_runtime_instance_t *instance1, wi_runtime_instance_t *instance2) {
+	wi_persistent_set_t		*set1 = instance1;
+	wi_persistent_set_t		*set2 = instance2;
+	
+	return wi_is_equal(set1->dictionary, set2->dictionary);
+}
+
+
+
+static wi_string_t * _wi_persistent_set_description(wi_runtime_instance_t *instance) {
+	wi_persistent_set_t		*set = instance;
+	
+	return wi_string_with_format(WI_STR("<%@ %p>{count = %lu, values = %@}"),
+		wi_runtime_class_name(set),
+		set,
+		wi_persistent_dictionary_count(set->dictionary),
+		wi_persistent_set_all_data(set));
+}
+
+
+
+static wi_hash_code_t _wi_persistent_set_hash(wi_runtime_instance_t *instance) {
+	wi_persistent_set_t		*set = instance;
+	
+	return wi_persistent_dictionary_count(set->dictionary);
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_persistent_set_count(wi_persistent_set_t *set) {
+	return wi_persistent_dictionary_count(set->dictionary);
+}
+
+
+
+wi_boolean_t wi_persistent_set_contains_data(wi_persistent_set_t *set, void *data) {
+	return wi_persistent_dictionary_contains_key(set->dictionary, data);
+}
+
+
+
+wi_array_t * wi_persistent_set_all_data(wi_persistent_set_t *set) {
+	return wi_persistent_dictionary_all_keys(set->dictionary);
+}
+
+
+
+#pragma mark -
+
+wi_persistent_set_t * wi_persistent_set_by_adding_data(wi_persistent_set_t *set, void *data) {
+	if(wi_persistent_dictionary_contains_key(set->dictionary, data))
+		return set;
+	
+	return _wi_persistent_set_with_dictionary(set, wi_persistent_dictionary_by_setting_data_for_key(set->dictionary, wi_null(), data));
+}
+
+
+
+wi_persistent_set_t * wi_persistent_set_by_removing_data(wi_persistent_set_t *set, void *data) {
+	return _wi_persistent_set_with_dictionary(set, wi_persistent_dictionary_by_removing_data_for_key(set->dictionary, data));
+}
+
+
+
+#pragma mark -
+
+wi_persistent_set_t * wi_persistent_set_load(wi_persistent_set_t **pointer) {
+	return wi_runtime_load_instance((wi_runtime_instance_t **) pointer);
+}
+
+
+
+void wi_persistent_set_store(wi_persistent_set_t **pointer, wi_persistent_set_t *set) {
+	wi_runtime_store_instance((wi_runtime_instance_t **) pointer, set);
+}
+
+
+
+wi_boolean_t wi_persistent_set_compare_and_store(wi_persistent_set_t **pointer, wi_persistent_set_t *expected_set, wi_persistent_set_t *set) {
+	return wi_runtime_compare_and_store_instance((wi_runtime_instance_t **) pointer, expected_set, set);
+}
@@ -0,0 +1,59 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2005-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_PERSISTENT_SET_H
+#define WI_PERSISTENT_SET_H 1
+
+#include <wired/wi-array.h>
+#include <wired/wi-base.h>
+#include <wired/wi-runtime.h>
+
+typedef struct _wi_persistent_set				wi_persistent_set_t;
+
+
+WI_EXPORT wi_runtime_id_t						wi_persistent_set_runtime_id(void);
+
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set(void);
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_with_array(wi_array_t *);
+
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_alloc(void);
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_init(wi_persistent_set_t *);
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_init_with_array(wi_persistent_set_t *, wi_array_t *);
+
+WI_EXPORT wi_uinteger_t							wi_persistent_set_count(wi_persistent_set_t *);
+WI_EXPORT wi_boolean_t							wi_persistent_set_contains_data(wi_persistent_set_t *, void *);
+WI_EXPORT wi_array_t *							wi_persistent_set_all_data(wi_persistent_set_t *);
+
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_by_adding_data(wi_persistent_set_t *, void *);
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_by_removing_data(wi_persistent_set_t *, void *);
+
+WI_EXPORT wi_persistent_set_t *					wi_persistent_set_load(wi_persistent_set_t **);
+WI_EXPORT void									wi_persistent_set_store(wi_persistent_set_t **, wi_persistent_set_t *);
+WI_EXPORT wi_boolean_t							wi_persistent_set_compare_and_store(wi_persistent_set_t **, wi_persistent_set_t *, wi_persistent_set_t *);
+
+#endif /* WI_PERSISTENT_SET_H */
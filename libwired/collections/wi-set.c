@@ -53,7 +53,7 @@
 		    set->buckets_count >  set->min_count) ||					\
 		   (set->data_count    >= 3 * set->buckets_count &&				\
 			set->buckets_count <  _WI_SET_MAX_COUNT))					\
-			_wi_set_resize(set);										\
+			_wi_set_resize(set, set->data_count);						\
 	WI_STMT_END
 
 #define _WI_SET_RETAIN(set, data)										\
@@ -73,15 +73,15 @@
 		: wi_hash_pointer((data)))
 
 #define _WI_SET_IS_EQUAL(set, data1, data2)								\
-	(((set)->callbacks.is_equal &&										\
-	  (*(set)->callbacks.is_equal)((data1), (data2))) ||				\
-	 (!(set)->callbacks.is_equal &&										\
-	  (data1) == (data2)))
+	((data1) == (data2) ||												\
+	 ((set)->callbacks.is_equal &&										\
+	  (*(set)->callbacks.is_equal)((data1), (data2))))
 
 
 struct _wi_set_bucket {
 	void								*data;
 	wi_uinteger_t						count;
+	wi_hash_code_t						hash;
 
 	struct _wi_set_bucket				*next, *link;
 };
@@ -116,14 +116,20 @@ static wi_boolean_t						_wi_set_is_equal(wi_runtime_instance_t *, wi_runtime_in
 static wi_string_t *					_wi_set_description(wi_runtime_instance_t *);
 static wi_hash_code_t					_wi_set_hash(wi_runtime_instance_t *);
 
-static void								_wi_set_resize(wi_set_t *);
+static void								_wi_set_resize(wi_set_t *, wi_uinteger_t);
+static void								_wi_set_reserve(wi_set_t *, wi_uinteger_t);
 
 static _wi_set_bucket_t *				_wi_set_bucket_create(wi_set_t *);
-static _wi_set_bucket_t *				_wi_set_bucket_for_data(wi_set_t *, void *, wi_uinteger_t);
+static _wi_set_bucket_t *				_wi_set_bucket_for_data(wi_set_t *, void *, wi_hash_code_t);
 static void								_wi_set_bucket_remove(wi_set_t *, _wi_set_bucket_t *);
 
+static wi_hash_code_t					_wi_set_hash_for_bucket(wi_set_t *, wi_set_t *, _wi_set_bucket_t *);
+static void								_wi_set_insert_data(wi_set_t *, void *, wi_hash_code_t, wi_uinteger_t);
 static void								_wi_set_add_data(wi_set_t *, void *);
 static void								_wi_set_add_data_from_array(wi_set_t *, wi_array_t *);
+static void								_wi_set_add_data_from_set(wi_set_t *, wi_set_t *);
+static void								_wi_set_add_data_in_both_sets(wi_set_t *, wi_set_t *, wi_set_t *);
+static void								_wi_set_remove_data_by_set(wi_set_t *, wi_set_t *, wi_boolean_t);
 static void								_wi_set_remove_all_data(wi_set_t *);
 
 
@@ -304,17 +310,10 @@ static void _wi_set_dealloc(wi_runtime_instance_t *instance) {
 
 static wi_runtime_instance_t * _wi_set_copy(wi_runtime_instance_t *instance) {
 	wi_set_t			*set = instance, *set_copy;
-	_wi_set_bucket_t	*bucket;
-	wi_uinteger_t		i, j;
 	
 	set_copy = wi_set_init_with_capacity_and_callbacks(wi_set_alloc(), set->data_count, set->counted, set->callbacks);
 	
-	for(i = 0; i < set->buckets_count; i++) {
-		for(bucket = set->buckets[i]; bucket; bucket = bucket->next) {
-			for(j = 0; j < bucket->count; j++)
-				_wi_set_add_data(set_copy, bucket->data);
-		}
-	}
+	_wi_set_add_data_from_set(set_copy, set);
 	
 	return set_copy;
 }
@@ -332,7 +331,7 @@ static wi_boolean_t _wi_set_is_equal(wi_runtime_instance_t *instance1, wi_runtim
 	
 	for(i = 0; i < set1->buckets_count; i++) {
 		for(bucket = set1->buckets[i]; bucket; bucket = bucket->next) {
-			if(!wi_set_contains_data(set2, bucket->data))
+			if(!_wi_set_bucket_for_data(set2, bucket->data, _wi_set_hash_for_bucket(set2, set1, bucket)))
 				return false;
 		}
 	}
@@ -458,6 +457,37 @@ wi_enumerator_t * wi_set_data_enumerator(wi_set_t *set) {
 
 
 
+wi_uinteger_t wi_set_enumerate_data(wi_set_t *set, wi_enumeration_state_t *state, void **buffer, wi_uinteger_t count) {
+	_wi_set_bucket_t		*bucket;
+	wi_uinteger_t			i, n;
+	
+	n = 0;
+	
+	while(state->state < set->buckets_count && n < count) {
+		bucket = set->buckets[state->state];
+		
+		for(i = 0; bucket && i < state->extra; i++)
+			bucket = bucket->next;
+		
+		while(bucket && n < count) {
+			buffer[n++] = bucket->data;
+			bucket = bucket->next;
+			state->extra++;
+		}
+		
+		if(!bucket) {
+			state->state++;
+			state->extra = 0;
+		}
+	}
+	
+	state->items = buffer;
+	
+	return n;
+}
+
+
+
 void * wi_enumerator_set_data_enumerator(wi_runtime_instance_t *instance, wi_enumerator_context_t *context) {
 	wi_set_t				*set = instance;
 	_wi_set_bucket_t		*bucket;
@@ -495,18 +525,18 @@ void * wi_enumerator_set_data_enumerator(wi_runtime_instance_t *instance, wi_enu
 
 #pragma mark -
 
-static void _wi_set_resize(wi_set_t *set) {
+static void _wi_set_resize(wi_set_t *set, wi_uinteger_t count) {
 	_wi_set_bucket_t	**buckets, *bucket, *next_bucket;
 	wi_uinteger_t		i, index, capacity, buckets_count;
 
-	capacity		= wi_exp2m1(wi_log2(set->data_count) + 1);
+	capacity		= wi_exp2m1(wi_log2(count) + 1);
 	buckets_count	= WI_CLAMP(capacity, set->min_count, _WI_SET_MAX_COUNT);
 	buckets			= wi_malloc(buckets_count * sizeof(_wi_set_bucket_t *));
 
 	for(i = 0; i < set->buckets_count; i++) {
 		for(bucket = set->buckets[i]; bucket; bucket = next_bucket) {
 			next_bucket		= bucket->next;
-			index			= _WI_SET_HASH(set, bucket->data) % buckets_count;
+			index			= bucket->hash % buckets_count;
 			bucket->next	= buckets[index];
 			buckets[index]	= bucket;
 		}
@@ -520,6 +550,13 @@ static void _wi_set_resize(wi_set_t *set) {
 
 
 
+static void _wi_set_reserve(wi_set_t *set, wi_uinteger_t count) {
+	if(count > set->buckets_count && set->buckets_count < _WI_SET_MAX_COUNT)
+		_wi_set_resize(set, count);
+}
+
+
+
 #pragma mark -
 
 static _wi_set_bucket_t * _wi_set_bucket_create(wi_set_t *set) {
@@ -552,16 +589,16 @@ static _wi_set_bucket_t * _wi_set_bucket_create(wi_set_t *set) {
 
 
 
-static _wi_set_bucket_t * _wi_set_bucket_for_data(wi_set_t *set, void *data, wi_uinteger_t index) {
+static _wi_set_bucket_t * _wi_set_bucket_for_data(wi_set_t *set, void *data, wi_hash_code_t hash) {
 	_wi_set_bucket_t	*bucket;
 	
-	bucket = set->buckets[index];
+	bucket = set->buckets[hash % set->buckets_count];
 
 	if(!bucket)
 		return NULL;
 
 	for(; bucket; bucket = bucket->next) {
-		if(_WI_SET_IS_EQUAL(set, bucket->data, data))
+		if(bucket->hash == hash && _WI_SET_IS_EQUAL(set, bucket->data, data))
 			return bucket;
 	}
 		
@@ -583,24 +620,40 @@ static void _wi_set_bucket_remove(wi_set_t *set, _wi_set_bucket_t *bucket) {
 
 #pragma mark -
 
-static void _wi_set_add_data(wi_set_t *set, void *data) {
+static wi_hash_code_t _wi_set_hash_for_bucket(wi_set_t *set, wi_set_t *otherset, _wi_set_bucket_t *bucket) {
+	if(set->callbacks.hash == otherset->callbacks.hash)
+		return bucket->hash;
+	
+	return _WI_SET_HASH(set, bucket->data);
+}
+
+
+
+static void _wi_set_insert_data(wi_set_t *set, void *data, wi_hash_code_t hash, wi_uinteger_t count) {
 	_wi_set_bucket_t	*bucket;
 	wi_uinteger_t		index;
 	
-	index = _WI_SET_HASH(set, data) % set->buckets_count;
-	bucket = _wi_set_bucket_for_data(set, data, index);
+	bucket = _wi_set_bucket_for_data(set, data, hash);
 
 	if(bucket) {
-		bucket->count++;
+		bucket->count += count;
 	} else {
+		index				= hash % set->buckets_count;
 		bucket				= _wi_set_bucket_create(set);
 		bucket->next		= set->buckets[index];
 		bucket->data		= _WI_SET_RETAIN(set, data);
-		bucket->count		= 1;
+		bucket->count		= count;
+		bucket->hash		= hash;
 
 		set->data_count++;
 		set->buckets[index] = bucket;
 	}
+}
+
+
+
+static void _wi_set_add_data(wi_set_t *set, void *data) {
+	_wi_set_insert_data(set, data, _WI_SET_HASH(set, data), 1);
 
 	_WI_SET_CHECK_RESIZE(set);
 }
@@ -608,12 +661,111 @@ static void _wi_set_add_data(wi_set_t *set, void *data) {
 
 
 static void _wi_set_add_data_from_array(wi_set_t *set, wi_array_t *array) {
+	void			*data;
 	wi_uinteger_t	i, count;
 	
 	count = wi_array_count(array);
 	
-	for(i = 0; i < count; i++)
-		_wi_set_add_data(set, WI_ARRAY(array, i));
+	_wi_set_reserve(set, set->data_count + count);
+	
+	for(i = 0; i < count; i++) {
+		data = WI_ARRAY(array, i);
+		
+		_wi_set_insert_data(set, data, _WI_SET_HASH(set, data), 1);
+	}
+
+	_WI_SET_CHECK_RESIZE(set);
+}
+
+
+
+static void _wi_set_add_data_from_set(wi_set_t *set, wi_set_t *otherset) {
+	_wi_set_bucket_t	*bucket;
+	wi_uinteger_t		i;
+	
+	_wi_set_reserve(set, set->data_count + otherset->data_count);
+	
+	for(i = 0; i < otherset->buckets_count; i++) {
+		for(bucket = otherset->buckets[i]; bucket; bucket = bucket->next)
+			_wi_set_insert_data(set, bucket->data, _wi_set_hash_for_bucket(set, otherset, bucket), bucket->count);
+	}
+
+	_WI_SET_CHECK_RESIZE(set);
+}
+
+
+
+static void _wi_set_add_data_in_both_sets(wi_set_t *newset, wi_set_t *set, wi_set_t *otherset) {
+	_wi_set_bucket_t	*bucket, *otherbucket;
+	wi_uinteger_t		i;
+	
+	if(set->data_count <= otherset->data_count) {
+		for(i = 0; i < set->buckets_count; i++) {
+			for(bucket = set->buckets[i]; bucket; bucket = bucket->next) {
+				otherbucket = _wi_set_bucket_for_data(otherset, bucket->data, _wi_set_hash_for_bucket(otherset, set, bucket));
+				
+				if(otherbucket) {
+					_wi_set_insert_data(newset, bucket->data, _wi_set_hash_for_bucket(newset, set, bucket),
+						WI_MIN(bucket->count, otherbucket->count));
+				}
+			}
+		}
+	} else {
+		for(i = 0; i < otherset->buckets_count; i++) {
+			for(otherbucket = otherset->buckets[i]; otherbucket; otherbucket = otherbucket->next) {
+				bucket = _wi_set_bucket_for_data(set, otherbucket->data, _wi_set_hash_for_bucket(set, otherset, otherbucket));
+				
+				if(bucket) {
+					_wi_set_insert_data(newset, bucket->data, _wi_set_hash_for_bucket(newset, set, bucket),
+						WI_MIN(bucket->count, otherbucket->count));
+				}
+			}
+		}
+	}
+
+	_WI_SET_CHECK_RESIZE(newset);
+}
+
+
+
+static void _wi_set_remove_data_by_set(wi_set_t *set, wi_set_t *otherset, wi_boolean_t intersect) {
+	_wi_set_bucket_t	*bucket, *otherbucket, *previous_bucket, *next_bucket;
+	wi_uinteger_t		i;
+	
+	for(i = 0; i < set->buckets_count; i++) {
+		previous_bucket = NULL;
+		
+		for(bucket = set->buckets[i]; bucket; bucket = next_bucket) {
+			next_bucket = bucket->next;
+			otherbucket = _wi_set_bucket_for_data(otherset, bucket->data, _wi_set_hash_for_bucket(otherset, set, bucket));
+			
+			if(intersect) {
+				if(otherbucket)
+					bucket->count = WI_MIN(bucket->count, otherbucket->count);
+				else
+					bucket->count = 0;
+			}
+			else if(otherbucket) {
+				if(set->counted && bucket->count > otherbucket->count)
+					bucket->count -= otherbucket->count;
+				else
+					bucket->count = 0;
+			}
+			
+			if(bucket->count == 0) {
+				if(previous_bucket)
+					previous_bucket->next = next_bucket;
+				else
+					set->buckets[i] = next_bucket;
+				
+				_wi_set_bucket_remove(set, bucket);
+			} else {
+				previous_bucket = bucket;
+			}
+		}
+	}
+	
+	_WI_SET_CHECK_RESIZE(set);
 }
 
 
@@ -638,10 +790,8 @@ static void _wi_set_remove_all_data(wi_set_t *set) {
 
 wi_boolean_t wi_set_contains_data(wi_set_t *set, void *data) {
 	_wi_set_bucket_t	*bucket;
-	wi_uinteger_t		index;
 	
-	index = _WI_SET_HASH(set, data) % set->buckets_count;
-	bucket = _wi_set_bucket_for_data(set, data, index);
+	bucket = _wi_set_bucket_for_data(set, data, _WI_SET_HASH(set, data));
 	
 	return (bucket != NULL);
 }
@@ -650,10 +800,8 @@ wi_boolean_t wi_set_contains_data(wi_set_t *set, void *data) {
 
 wi_uinteger_t wi_set_count_for_data(wi_set_t *set, void *data) {
 	_wi_set_bucket_t	*bucket;
-	wi_uinteger_t		index;
 	
-	index = _WI_SET_HASH(set, data) % set->buckets_count;
-	bucket = _wi_set_bucket_for_data(set, data, index);
+	bucket = _wi_set_bucket_for_data(set, data, _WI_SET_HASH(set, data));
 	
 	if(!bucket)
 		return 0;
@@ -663,6 +811,84 @@ wi_uinteger_t wi_set_count_for_data(wi_set_t *set, void *data) {
 
 
 
+wi_boolean_t wi_set_is_subset_of_set(wi_set_t *set, wi_set_t *otherset) {
+	_wi_set_bucket_t	*bucket;
+	wi_uinteger_t		i;
+	
+	if(set->data_count > otherset->data_count)
+		return false;
+	
+	for(i = 0; i < set->buckets_count; i++) {
+		for(bucket = set->buckets[i]; bucket; bucket = bucket->next) {
+			if(!_wi_set_bucket_for_data(otherset, bucket->data, _wi_set_hash_for_bucket(otherset, set, bucket)))
+				return false;
+		}
+	}
+	
+	return true;
+}
+
+
+
+wi_boolean_t wi_set_intersects_set(wi_set_t *set, wi_set_t *otherset) {
+	_wi_set_bucket_t	*bucket;
+	wi_uinteger_t		i;
+	
+	if(set->data_count > otherset->data_count)
+		return wi_set_intersects_set(otherset, set);
+	
+	for(i = 0; i < set->buckets_count; i++) {
+		for(bucket = set->buckets[i]; bucket; bucket = bucket->next) {
+			if(_wi_set_bucket_for_data(otherset, bucket->data, _wi_set_hash_for_bucket(otherset, set, bucket)))
+				return true;
+		}
+	}
+	
+	return false;
+}
+
+
+
+#pragma mark -
+
+wi_set_t * wi_set_union(wi_set_t *set, wi_set_t *otherset) {
+	wi_set_t		*newset;
+	
+	newset = wi_set_init_with_capacity_and_callbacks(wi_set_alloc(), set->data_count + otherset->data_count, set->counted, set->callbacks);
+	
+	_wi_set_add_data_from_set(newset, set);
+	_wi_set_add_data_from_set(newset, otherset);
+	
+	return wi_autorelease(newset);
+}
+
+
+
+wi_set_t * wi_set_intersection(wi_set_t *set, wi_set_t *otherset) {
+	wi_set_t		*newset;
+	
+	newset = wi_set_init_with_capacity_and_callbacks(wi_set_alloc(), WI_MIN(set->data_count, otherset->data_count), set->counted, set->callbacks);
+	
+	_wi_set_add_data_in_both_sets(newset, set, otherset);
+	
+	return wi_autorelease(newset);
+}
+
+
+
+wi_set_t * wi_set_difference(wi_set_t *set, wi_set_t *otherset) {
+	wi_set_t		*newset;
+	
+	newset = wi_set_init_with_capacity_and_callbacks(wi_set_alloc(), set->data_count, set->counted, set->callbacks);
+	
+	_wi_set_add_data_from_set(newset, set);
+	_wi_set_remove_data_by_set(newset, otherset, false);
+	
+	return wi_autorelease(newset);
+}
+
+
+
 #pragma mark -
 
 void wi_mutable_set_add_data(wi_mutable_set_t *set, void *data) {
@@ -694,11 +920,38 @@ void wi_mutable_set_set_set(wi_mutable_set_t *set, wi_set_t *otherset) {
 	WI_RUNTIME_ASSERT_MUTABLE(set);
 
 	_wi_set_remove_all_data(set);
+	_wi_set_reserve(set, otherset->data_count);
 
 	for(i = 0; i < otherset->buckets_count; i++) {
 		for(bucket = otherset->buckets[i]; bucket; bucket = bucket->next)
-			_wi_set_add_data(set, bucket->data);
+			_wi_set_insert_data(set, bucket->data, _wi_set_hash_for_bucket(set, otherset, bucket), bucket->count);
 	}
+
+	_WI_SET_CHECK_RESIZE(set);
+}
+
+
+
+void wi_mutable_set_union_set(wi_mutable_set_t *set, wi_set_t *otherset) {
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	_wi_set_add_data_from_set(set, otherset);
+}
+
+
+
+void wi_mutable_set_intersect_set(wi_mutable_set_t *set, wi_set_t *otherset) {
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	_wi_set_remove_data_by_set(set, otherset, true);
+}
+
+
+
+void wi_mutable_set_minus_set(wi_mutable_set_t *set, wi_set_t *otherset) {
+	WI_RUNTIME_ASSERT_MUTABLE(set);
+	
+	_wi_set_remove_data_by_set(set, otherset, false);
 }
 
 
@@ -707,6 +960,7 @@ void wi_mutable_set_set_set(wi_mutable_set_t *set, wi_set_t *otherset) {
 
 void wi_mutable_set_remove_data(wi_mutable_set_t *set, void *data) {
 	_wi_set_bucket_t	*bucket, *previous_bucket;
+	wi_hash_code_t		hash;
 	wi_uinteger_t		index;
 	wi_boolean_t		remove = false;
 
@@ -718,14 +972,15 @@ void wi_mutable_set_remove_data(wi_mutable_set_t *set, void *data) {
 			set);
 	}
 
-	index = _WI_SET_HASH(set, data) % set->buckets_count;
+	hash = _WI_SET_HASH(set, data);
+	index = hash % set->buckets_count;
 	bucket = set->buckets[index];
 
 	if(bucket) {
 		previous_bucket = NULL;
 		
 		for(; bucket; bucket = bucket->next) {
-			if(_WI_SET_IS_EQUAL(set, bucket->data, data)) {
+			if(bucket->hash == hash && _WI_SET_IS_EQUAL(set, bucket->data, data)) {
 				if(set->counted) {
 					if(--bucket->count == 0)
 						remove = true;
@@ -70,13 +70,23 @@ WI_EXPORT wi_uinteger_t						wi_set_count(wi_set_t *);
 WI_EXPORT wi_array_t *						wi_set_all_data(wi_set_t *);
 
 WI_EXPORT wi_enumerator_t *					wi_set_data_enumerator(wi_set_t *);
+WI_EXPORT wi_uinteger_t						wi_set_enumerate_data(wi_set_t *, wi_enumeration_state_t *, void **, wi_uinteger_t);
 
 WI_EXPORT wi_boolean_t						wi_set_contains_data(wi_set_t *, void *);
 WI_EXPORT wi_uinteger_t						wi_set_count_for_data(wi_set_t *, void *);
+WI_EXPORT wi_boolean_t						wi_set_is_subset_of_set(wi_set_t *, wi_set_t *);
+WI_EXPORT wi_boolean_t						wi_set_intersects_set(wi_set_t *, wi_set_t *);
+
+WI_EXPORT wi_set_t *						wi_set_union(wi_set_t *, wi_set_t *);
+WI_EXPORT wi_set_t *						wi_set_intersection(wi_set_t *, wi_set_t *);
+WI_EXPORT wi_set_t *						wi_set_difference(wi_set_t *, wi_set_t *);
 
 WI_EXPORT void								wi_mutable_set_add_data(wi_mutable_set_t *, void *);
 WI_EXPORT void								wi_mutable_set_add_data_from_array(wi_mutable_set_t *, wi_array_t *);
 WI_EXPORT void								wi_mutable_set_set_set(wi_mutable_set_t *, wi_set_t *);
+WI_EXPORT void								wi_mutable_set_union_set(wi_mutable_set_t *, wi_set_t *);
+WI_EXPORT void								wi_mutable_set_intersect_set(wi_mutable_set_t *, wi_set_t *);
+WI_EXPORT void								wi_mutable_set_minus_set(wi_mutable_set_t *, wi_set_t *);
 
 WI_EXPORT void								wi_mutable_set_remove_data(wi_mutable_set_t *, void *);
 WI_EXPORT void								wi_mutable_set_remove_all_data(wi_mutable_set_t *);
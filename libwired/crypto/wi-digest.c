@@ -28,6 +28,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <wired/wi-data.h>
 #include <wired/wi-digest.h>
 #include <wired/wi-private.h>
@@ -42,8 +44,6 @@
 #define WI_DIGEST_OPENSSL				1
 #endif
 
-#include <string.h>
-
 #ifdef HAVE_OPENSSL_SHA_H
 #include <openssl/md5.h>
 #include <openssl/sha.h>
@@ -310,20 +310,11 @@ wi_data_t * wi_md5_data(wi_md5_t *md5) {
 
 
 wi_string_t * wi_md5_string(wi_md5_t *md5) {
-	static unsigned char	hex[] = "0123456789abcdef";
-	char					md5_hex[sizeof(md5->buffer) * 2 + 1];
-	wi_uinteger_t			i;
+	char		md5_hex[sizeof(md5->buffer) * 2];
 
 	_WI_DIGEST_ASSERT_CLOSED(md5);
 	
-	for(i = 0; i < sizeof(md5->buffer); i++) {
-		md5_hex[i+i]	= hex[md5->buffer[i] >> 4];
-		md5_hex[i+i+1]	= hex[md5->buffer[i] & 0x0F];
-	}
-
-	md5_hex[i+i] = '\0';
-
-	return wi_string_with_cstring(md5_hex);
+	return wi_string_with_bytes(md5_hex, wi_hex_encode(md5->buffer, sizeof(md5->buffer), md5_hex));
 }
 
 
@@ -416,20 +407,178 @@ wi_data_t * wi_sha1_data(wi_sha1_t *sha1) {
 
 
 wi_string_t * wi_sha1_string(wi_sha1_t *sha1) {
-	static unsigned char	hex[] = "0123456789abcdef";
-	char					sha1_hex[sizeof(sha1->buffer) * 2 + 1];
-	wi_uinteger_t			i;
+	char		sha1_hex[sizeof(sha1->buffer) * 2];
 
 	_WI_DIGEST_ASSERT_CLOSED(sha1);
 	
-	for(i = 0; i < sizeof(sha1->buffer); i++) {
-		sha1_hex[i+i]	= hex[sha1->buffer[i] >> 4];
-		sha1_hex[i+i+1]	= hex[sha1->buffer[i] & 0x0F];
+	return wi_string_with_bytes(sha1_hex, wi_hex_encode(sha1->buffer, sizeof(sha1->buffer), sha1_hex));
+}
+
+#endif
+
+
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define _WI_DIGEST_SSE2					1
+#include <emmintrin.h>
+#endif
+
+#if defined(_WI_DIGEST_SSE2) && defined(__x86_64__) && (__GNUC__ >= 5 || defined(__clang__))
+#define _WI_DIGEST_SSSE3				1
+#include <tmmintrin.h>
+#endif
+
+
+static wi_uinteger_t					_wi_base64_encode_triplets(const unsigned char *, wi_uinteger_t, char *);
+static wi_uinteger_t					_wi_base64_decode_quantum(const unsigned char *, wi_uinteger_t, unsigned char *);
+#ifdef _WI_DIGEST_SSSE3
+static wi_uinteger_t					_wi_base64_encode_ssse3(const unsigned char *, wi_uinteger_t, char *);
+static wi_boolean_t						_wi_base64_decode_ssse3(const char *, unsigned char *);
+#endif
+
+static int								_wi_hex_value(char);
+
+
+static const char						_wi_base64_table[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const unsigned char				_wi_base64_decode_table[256] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+		0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0x40, 0xFF, 0xFF,
+		0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+		0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#ifdef _WI_DIGEST_SSSE3
+static int								_wi_digest_ssse3_supported = -1;
+#endif
+
+
+
+#pragma mark -
+
+static wi_uinteger_t _wi_base64_encode_triplets(const unsigned char *bytes, wi_uinteger_t length, char *buffer) {
+	const unsigned char		*p;
+	char					*s;
+	wi_uinteger_t			i;
+	uint32_t				value;
+
+	i = 0;
+	s = buffer;
+
+#ifdef _WI_DIGEST_SSSE3
+	if(_wi_digest_ssse3_supported < 0)
+		_wi_digest_ssse3_supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+
+	if(_wi_digest_ssse3_supported) {
+		i = _wi_base64_encode_ssse3(bytes, length, buffer);
+		s = buffer + ((i / 3) * 4);
+	}
+#endif
+
+	for(; i < length; i += 3) {
+		p		= bytes + i;
+		value	= (p[0] << 16) | (p[1] << 8) | p[2];
+
+		*s++ = _wi_base64_table[(value >> 18) & 0x3F];
+		*s++ = _wi_base64_table[(value >> 12) & 0x3F];
+		*s++ = _wi_base64_table[(value >> 6) & 0x3F];
+		*s++ = _wi_base64_table[value & 0x3F];
+	}
+
+	return s - buffer;
+}
+
+
+
+static wi_uinteger_t _wi_base64_decode_quantum(const unsigned char *values, wi_uinteger_t count, unsigned char *buffer) {
+	uint32_t		value;
+
+	value = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+
+	buffer[0] = value >> 16;
+
+	if(count > 2)
+		buffer[1] = value >> 8;
+
+	if(count > 3)
+		buffer[2] = value;
+
+	return count - 1;
+}
+
+
+
+#ifdef _WI_DIGEST_SSSE3
+
+__attribute__((target("ssse3")))
+static wi_uinteger_t _wi_base64_encode_ssse3(const unsigned char *bytes, wi_uinteger_t length, char *buffer) {
+	__m128i			in, t0, t1, t2, t3, indices, result, less;
+	wi_uinteger_t	i;
+
+	for(i = 0; i + 16 <= length; i += 12) {
+		in		= _mm_loadu_si128((const __m128i *) (bytes + i));
+		in		= _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		t0		= _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+		t1		= _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+		t2		= _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+		t3		= _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+		indices	= _mm_or_si128(t1, t3);
+
+		result	= _mm_subs_epu8(indices, _mm_set1_epi8(51));
+		less	= _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+		result	= _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+		result	= _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												 '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+												 '/' - 63, 'A', 0, 0),
+								   result);
+
+		_mm_storeu_si128((__m128i *) (buffer + ((i / 3) * 4)), _mm_add_epi8(result, indices));
 	}
 
-	sha1_hex[i+i] = '\0';
+	return i;
+}
+
 
-	return wi_string_with_cstring(sha1_hex);
+
+__attribute__((target("ssse3")))
+static wi_boolean_t _wi_base64_decode_ssse3(const char *string, unsigned char *buffer) {
+	__m128i			in, hi, lo, roll, merged;
+
+	in		= _mm_loadu_si128((const __m128i *) string);
+	hi		= _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F));
+	lo		= _mm_and_si128(in, _mm_set1_epi8(0x0F));
+
+	lo		= _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+											 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), lo);
+	roll	= _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+											 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hi);
+
+	if(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, roll), _mm_setzero_si128())) != 0)
+		return false;
+
+	roll	= _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+							   _mm_add_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), hi));
+	in		= _mm_add_epi8(in, roll);
+	merged	= _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+	merged	= _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+	merged	= _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+	_mm_storeu_si128((__m128i *) buffer, merged);
+
+	return true;
 }
 
 #endif
@@ -438,126 +587,271 @@ wi_string_t * wi_sha1_string(wi_sha1_t *sha1) {
 
 #pragma mark -
 
-wi_string_t * wi_base64_string_from_data(wi_data_t *data) {
-	static char				base64_table[] =
-		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-	wi_mutable_string_t		*base64;
-	const unsigned char		*bytes;
-	unsigned char			inbuffer[3], outbuffer[4];
-	wi_uinteger_t			i, length, count, position, remaining;
-	size_t					size;
-
-	position		= 0;
-	length			= wi_data_length(data);
-	size			= (length * (4.0 / 3.0)) + 3;
-	bytes			= wi_data_bytes(data);
-	base64			= wi_string_init_with_capacity(wi_mutable_string_alloc(), size);
-	
-	while(position < length) {
-		for(i = 0; i < 3; i++) {
-			if(position + i < length)
-				inbuffer[i] = bytes[position + i];
-			else
-				inbuffer[i] = '\0';
-		}
+void wi_base64_context_init(wi_base64_context_t *context) {
+	memset(context, 0, sizeof(*context));
+}
 
-		outbuffer[0] =  (inbuffer[0] & 0xFC) >> 2;
-		outbuffer[1] = ((inbuffer[0] & 0x03) << 4) | ((inbuffer[1] & 0xF0) >> 4);
-		outbuffer[2] = ((inbuffer[1] & 0x0F) << 2) | ((inbuffer[2] & 0xC0) >> 6);
-		outbuffer[3] =   inbuffer[2] & 0x3F;
 
-		remaining = length - position;
-		
-		if(remaining == 1)
-			count = 2;
-		else if(remaining == 2)
-			count = 3;
-		else
-			count = 4;
 
-		for(i = 0; i < count; i++)
-			wi_mutable_string_append_bytes(base64, &base64_table[outbuffer[i]], 1);
+wi_uinteger_t wi_base64_encode_update(wi_base64_context_t *context, const void *bytes, wi_uinteger_t length, char *buffer) {
+	const unsigned char		*p = bytes;
+	wi_uinteger_t			size = 0, triplets;
 
-		for(i = count; i < 4; i++)
-			wi_mutable_string_append_bytes(base64, "=", 1);
+	while(context->count > 0 && context->count < 3 && length > 0) {
+		context->buffer[context->count++] = *p++;
+		length--;
+	}
 
-		position += 3;
+	if(context->count == 3) {
+		size += _wi_base64_encode_triplets(context->buffer, 3, buffer);
+		context->count = 0;
 	}
-	
-	wi_runtime_make_immutable(base64);
-	
-	return wi_autorelease(base64);
+	else if(context->count > 0) {
+		return 0;
+	}
+
+	triplets = (length / 3) * 3;
+	size += _wi_base64_encode_triplets(p, triplets, buffer + size);
+
+	memcpy(context->buffer, p + triplets, length - triplets);
+	context->count = length - triplets;
+
+	return size;
 }
 
 
 
-wi_data_t * wi_data_from_base64_string(wi_string_t *string) {
-	wi_mutable_data_t	*data;
-	const char			*buffer;
-	char				ch, inbuffer[4], outbuffer[3];
-	wi_uinteger_t		length, count, i, position, offset;
-	wi_boolean_t		ignore, stop, end;
-	
-	length			= wi_string_length(string);
-	buffer			= wi_string_cstring(string);
-	position		= 0;
-	offset			= 0;
-	data			= wi_data_init_with_capacity(wi_mutable_data_alloc(), length);
-	
-	while(position < length) {
-		ignore = end = false;
-		ch = buffer[position++];
-		
-		if(ch >= 'A' && ch <= 'Z')
-			ch = ch - 'A';
-		else if(ch >= 'a' && ch <= 'z')
-			ch = ch - 'a' + 26;
-		else if(ch >= '0' && ch <= '9')
-			ch = ch - '0' + 52;
-		else if(ch == '+')
-			ch = 62;
-		else if(ch == '=')
-			end = true;
-		else if(ch == '/')
-			ch = 63;
-		else
-			ignore = true;
-		
-		if(!ignore) {
-			count = 3;
-			stop = false;
-			
-			if(end) {
-				if(offset == 0)
-					break;
-				else if(offset == 1 || offset == 2)
-					count = 1;
-				else
-					count = 2;
-				
-				offset = 3;
-				stop = true;
-			}
-			
-			inbuffer[offset++] = ch;
-			
-			if(offset == 4) {
-				outbuffer[0] =  (inbuffer[0]         << 2) | ((inbuffer[1] & 0x30) >> 4);
-				outbuffer[1] = ((inbuffer[1] & 0x0F) << 4) | ((inbuffer[2] & 0x3C) >> 2);
-				outbuffer[2] = ((inbuffer[2] & 0x03) << 6) |  (inbuffer[3] & 0x3F);
-				
-				for(i = 0; i < count; i++)
-					wi_mutable_data_append_bytes(data, &outbuffer[i], 1);
-
-				offset = 0;
+wi_uinteger_t wi_base64_encode_final(wi_base64_context_t *context, char *buffer) {
+	wi_uinteger_t	count;
+
+	count = context->count;
+
+	if(count == 0)
+		return 0;
+
+	memset(context->buffer + count, 0, 3 - count);
+
+	_wi_base64_encode_triplets(context->buffer, 3, buffer);
+
+	buffer[3] = '=';
+
+	if(count == 1)
+		buffer[2] = '=';
+
+	context->count = 0;
+
+	return 4;
+}
+
+
+
+wi_uinteger_t wi_base64_decode_update(wi_base64_context_t *context, const char *string, wi_uinteger_t length, void *buffer) {
+	unsigned char		*s = buffer;
+	wi_uinteger_t		i;
+	unsigned char		value;
+
+	i = 0;
+
+	while(i < length && !context->end) {
+#ifdef _WI_DIGEST_SSSE3
+		if(context->count == 0 && length - i >= 24) {
+			if(_wi_digest_ssse3_supported < 0)
+				_wi_digest_ssse3_supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+
+			if(_wi_digest_ssse3_supported) {
+				while(length - i >= 24 && _wi_base64_decode_ssse3(string + i, s)) {
+					i += 16;
+					s += 12;
+				}
 			}
-			
-			if(stop)
-				break;
+		}
+#endif
+
+		value = _wi_base64_decode_table[(unsigned char) string[i++]];
+
+		if(value == 0xFF)
+			continue;
+
+		if(value == 0x40) {
+			if(context->count >= 2)
+				s += _wi_base64_decode_quantum(context->buffer, context->count, s);
+
+			context->count	= 0;
+			context->end	= true;
+
+			break;
+		}
+
+		context->buffer[context->count++] = value;
+
+		if(context->count == 4) {
+			s += _wi_base64_decode_quantum(context->buffer, 4, s);
+
+			context->count = 0;
 		}
 	}
-	
-	wi_runtime_make_immutable(data);
-	
-	return wi_autorelease(data);
+
+	return s - (unsigned char *) buffer;
+}
+
+
+
+wi_uinteger_t wi_base64_decode_final(wi_base64_context_t *context, void *buffer) {
+	wi_uinteger_t	size = 0;
+
+	if(context->count >= 2) {
+		memset(context->buffer + context->count, 0, 4 - context->count);
+
+		size = _wi_base64_decode_quantum(context->buffer, context->count, buffer);
+	}
+
+	context->count = 0;
+
+	return size;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_base64_encode(const void *bytes, wi_uinteger_t length, char *buffer) {
+	wi_base64_context_t		context;
+	wi_uinteger_t			size;
+
+	wi_base64_context_init(&context);
+
+	size = wi_base64_encode_update(&context, bytes, length, buffer);
+
+	return size + wi_base64_encode_final(&context, buffer + size);
+}
+
+
+
+wi_uinteger_t wi_base64_decode(const char *string, wi_uinteger_t length, void *buffer) {
+	wi_base64_context_t		context;
+	wi_uinteger_t			size;
+
+	wi_base64_context_init(&context);
+
+	size = wi_base64_decode_update(&context, string, length, buffer);
+
+	return size + wi_base64_decode_final(&context, (unsigned char *) buffer + size);
+}
+
+
+
+wi_string_t * wi_base64_string_from_data(wi_data_t *data) {
+	char			*buffer;
+	wi_uinteger_t	length;
+
+	buffer	= wi_malloc(WI_BASE64_ENCODED_LENGTH(wi_data_length(data)) + 1);
+	length	= wi_base64_encode(wi_data_bytes(data), wi_data_length(data), buffer);
+
+	buffer[length] = '\0';
+
+	return wi_autorelease(wi_string_init_with_bytes_no_copy(wi_string_alloc(), buffer, length, true));
+}
+
+
+
+wi_data_t * wi_data_from_base64_string(wi_string_t *string) {
+	unsigned char	*buffer;
+	wi_uinteger_t	length;
+
+	buffer	= wi_malloc(WI_BASE64_DECODED_LENGTH(wi_string_length(string)) + 1);
+	length	= wi_base64_decode(wi_string_cstring(string), wi_string_length(string), buffer);
+
+	return wi_autorelease(wi_data_init_with_bytes_no_copy(wi_data_alloc(), buffer, length, true));
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_hex_encode(const void *bytes, wi_uinteger_t length, char *buffer) {
+	static const char		hex[] = "0123456789abcdef";
+	const unsigned char		*p = bytes;
+	wi_uinteger_t			i = 0;
+
+#ifdef _WI_DIGEST_SSE2
+	__m128i					in, hi, lo, nine, offset;
+
+	nine	= _mm_set1_epi8(9);
+	offset	= _mm_set1_epi8('a' - '0' - 10);
+
+	for(; i + 16 <= length; i += 16) {
+		in	= _mm_loadu_si128((const __m128i *) (p + i));
+		hi	= _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F));
+		lo	= _mm_and_si128(in, _mm_set1_epi8(0x0F));
+		hi	= _mm_add_epi8(_mm_add_epi8(hi, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), offset));
+		lo	= _mm_add_epi8(_mm_add_epi8(lo, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), offset));
+
+		_mm_storeu_si128((__m128i *) (buffer + i + i), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (buffer + i + i + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+#endif
+
+	for(; i < length; i++) {
+		buffer[i + i]		= hex[p[i] >> 4];
+		buffer[i + i + 1]	= hex[p[i] & 0x0F];
+	}
+
+	return length * 2;
+}
+
+
+
+wi_uinteger_t wi_hex_decode(const char *string, wi_uinteger_t length, void *buffer) {
+	unsigned char			*s = buffer;
+	wi_uinteger_t			i = 0;
+	int						hi, lo;
+#ifdef _WI_DIGEST_SSE2
+	__m128i					in, lower, digits, letters, values;
+#endif
+
+	if(length % 2 != 0)
+		return WI_NOT_FOUND;
+
+#ifdef _WI_DIGEST_SSE2
+	for(; i + 16 <= length; i += 16) {
+		in		= _mm_loadu_si128((const __m128i *) (string + i));
+		lower	= _mm_or_si128(in, _mm_set1_epi8(0x20));
+		digits	= _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+		letters	= _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+		if(_mm_movemask_epi8(_mm_or_si128(digits, letters)) != 0xFFFF)
+			return WI_NOT_FOUND;
+
+		values	= _mm_or_si128(_mm_and_si128(digits, _mm_sub_epi8(in, _mm_set1_epi8('0'))),
+							   _mm_and_si128(letters, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+		values	= _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(values, 8));
+
+		_mm_storel_epi64((__m128i *) (s + (i / 2)), _mm_packus_epi16(values, values));
+	}
+#endif
+
+	for(; i < length; i += 2) {
+		hi = _wi_hex_value(string[i]);
+		lo = _wi_hex_value(string[i + 1]);
+
+		if(hi < 0 || lo < 0)
+			return WI_NOT_FOUND;
+
+		s[i / 2] = (hi << 4) | lo;
+	}
+
+	return length / 2;
+}
+
+
+
+static int _wi_hex_value(char ch) {
+	if(ch >= '0' && ch <= '9')
+		return ch - '0';
+	else if(ch >= 'a' && ch <= 'f')
+		return ch - 'a' + 10;
+	else if(ch >= 'A' && ch <= 'F')
+		return ch - 'A' + 10;
+
+	return -1;
 }
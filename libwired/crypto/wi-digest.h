@@ -36,9 +36,19 @@
 #define WI_MD5_DIGEST_LENGTH			16
 #define WI_SHA1_DIGEST_LENGTH			20
 
+#define WI_BASE64_ENCODED_LENGTH(length)	((((length) + 2) / 3) * 4)
+#define WI_BASE64_DECODED_LENGTH(length)	((((length) + 3) / 4) * 3)
+
 typedef struct _wi_md5					wi_md5_t;
 typedef struct _wi_sha1					wi_sha1_t;
 
+struct _wi_base64_context {
+	unsigned char						buffer[4];
+	wi_uinteger_t						count;
+	wi_boolean_t						end;
+};
+typedef struct _wi_base64_context		wi_base64_context_t;
+
 
 WI_EXPORT void							wi_md5_digest(const void *, wi_uinteger_t, unsigned char *);
 WI_EXPORT wi_string_t *					wi_md5_digest_string(wi_data_t *);
@@ -72,7 +82,19 @@ WI_EXPORT wi_data_t *					wi_sha1_data(wi_sha1_t *);
 WI_EXPORT wi_string_t *					wi_sha1_string(wi_sha1_t *);
 
 
+WI_EXPORT wi_uinteger_t					wi_base64_encode(const void *, wi_uinteger_t, char *);
+WI_EXPORT wi_uinteger_t					wi_base64_decode(const char *, wi_uinteger_t, void *);
 WI_EXPORT wi_string_t *					wi_base64_string_from_data(wi_data_t *);
 WI_EXPORT wi_data_t *					wi_data_from_base64_string(wi_string_t *);
 
+WI_EXPORT void							wi_base64_context_init(wi_base64_context_t *);
+WI_EXPORT wi_uinteger_t					wi_base64_encode_update(wi_base64_context_t *, const void *, wi_uinteger_t, char *);
+WI_EXPORT wi_uinteger_t					wi_base64_encode_final(wi_base64_context_t *, char *);
+WI_EXPORT wi_uinteger_t					wi_base64_decode_update(wi_base64_context_t *, const char *, wi_uinteger_t, void *);
+WI_EXPORT wi_uinteger_t					wi_base64_decode_final(wi_base64_context_t *, void *);
+
+
+WI_EXPORT wi_uinteger_t					wi_hex_encode(const void *, wi_uinteger_t, char *);
+WI_EXPORT wi_uinteger_t					wi_hex_decode(const char *, wi_uinteger_t, void *);
+
 #endif /* WI_DIGEST_H */
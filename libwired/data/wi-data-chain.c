@@ -0,0 +1,339 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2006-2009 Axel Andersson
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <string.h>
+
+#include <wired/wi-data.h>
+#include <wired/wi-data-chain.h>
+#include <wired/wi-macros.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-string.h>
+#include <wired/wi-system.h>
+
+#define _WI_DATA_CHAIN_MIN_COUNT			8
+#define _WI_DATA_CHAIN_CHUNK_SIZE			4096
+#define _WI_DATA_CHAIN_COPY_SIZE			256
+
+
+struct _wi_data_chain {
+	wi_runtime_base_t						base;
+	
+	wi_data_t								**segments;
+	struct iovec							*iovecs;
+	wi_uinteger_t							count;
+	wi_uinteger_t							capacity;
+	wi_uinteger_t							length;
+	
+	wi_data_t								*chunk;
+	wi_uinteger_t							chunk_offset;
+};
+
+
+static void									_wi_data_chain_dealloc(wi_runtime_instance_t *);
+static wi_string_t *						_wi_data_chain_description(wi_runtime_instance_t *);
+
+static void									_wi_data_chain_add_segment(wi_data_chain_t *, wi_data_t *, const void *, wi_uinteger_t);
+
+
+static wi_runtime_id_t						_wi_data_chain_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t					_wi_data_chain_runtime_class = {
+	"wi_data_chain_t",
+	_wi_data_chain_dealloc,
+	NULL,
+	NULL,
+	_wi_data_chain_description,
+	NULL
+};
+
+
+
+void wi_data_chain_register(void) {
+	_wi_data_chain_runtime_id = wi_runtime_register_class(&_wi_data_chain_runtime_class);
+}
+
+
+
+void wi_data_chain_initialize(void) {
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_data_chain_runtime_id(void) {
+	return _wi_data_chain_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_data_chain_t * wi_data_chain(void) {
+	return wi_autorelease(wi_data_chain_init(wi_data_chain_alloc()));
+}
+
+
+
+#pragma mark -
+
+wi_data_chain_t * wi_data_chain_alloc(void) {
+	return wi_runtime_create_instance(_wi_data_chain_runtime_id, sizeof(wi_data_chain_t));
+}
+
+
+
+wi_data_chain_t * wi_data_chain_init(wi_data_chain_t *chain) {
+	return wi_data_chain_init_with_capacity(chain, 0);
+}
+
+
+
+wi_data_chain_t * wi_data_chain_init_with_capacity(wi_data_chain_t *chain, wi_uinteger_t capacity) {
+	chain->capacity		= WI_MAX(capacity, _WI_DATA_CHAIN_MIN_COUNT);
+	chain->segments		= wi_malloc(chain->capacity * sizeof(wi_data_t *));
+	chain->iovecs		= wi_malloc(chain->capacity * sizeof(struct iovec));
+	
+	return chain;
+}
+
+
+
+static void _wi_data_chain_dealloc(wi_runtime_instance_t *instance) {
+	wi_data_chain_t		*chain = instance;
+	wi_uinteger_t		i;
+	
+	for(i = 0; i < chain->count; i++)
+		wi_release(chain->segments[i]);
+	
+	wi_free(chain->segments);
+	wi_free(chain->iovecs);
+	
+	wi_release(chain->chunk);
+}
+
+
+
+static wi_string_t * _wi_data_chain_description(wi_runtime_instance_t *instance) {
+	wi_data_chain_t		*chain = instance;
+	
+	return wi_string_with_format(WI_STR("<%@ %p>{length = %lu, count = %lu}"),
+		wi_runtime_class_name(chain),
+		chain,
+		chain->length,
+		chain->count);
+}
+
+
+
+#pragma mark -
+
+static void _wi_data_chain_add_segment(wi_data_chain_t *chain, wi_data_t *data, const void *bytes, wi_uinteger_t length) {
+	if(chain->count == chain->capacity) {
+		chain->capacity		+= chain->capacity / 2;
+		chain->segments		= wi_realloc(chain->segments, chain->capacity * sizeof(wi_data_t *));
+		chain->iovecs		= wi_realloc(chain->iovecs, chain->capacity * sizeof(struct iovec));
+	}
+	
+	chain->segments[chain->count]			= wi_retain(data);
+	chain->iovecs[chain->count].iov_base	= (void *) bytes;
+	chain->iovecs[chain->count].iov_len		= length;
+	
+	chain->count++;
+	chain->length += length;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_data_chain_length(wi_data_chain_t *chain) {
+	return chain->length;
+}
+
+
+
+wi_uinteger_t wi_data_chain_count(wi_data_chain_t *chain) {
+	return chain->count;
+}
+
+
+
+const struct iovec * wi_data_chain_iovecs(wi_data_chain_t *chain) {
+	return chain->iovecs;
+}
+
+
+
+wi_data_t * wi_data_chain_data(wi_data_chain_t *chain) {
+	wi_mutable_data_t		*data;
+	wi_uinteger_t			i;
+	
+	if(chain->count == 1 &&
+	   chain->iovecs[0].iov_base == wi_data_bytes(chain->segments[0]) &&
+	   chain->iovecs[0].iov_len == wi_data_length(chain->segments[0]))
+		return wi_autorelease(wi_retain(chain->segments[0]));
+	
+	data = wi_data_init_with_capacity(wi_mutable_data_alloc(), chain->length);
+	
+	for(i = 0; i < chain->count; i++)
+		wi_mutable_data_append_bytes(data, chain->iovecs[i].iov_base, chain->iovecs[i].iov_len);
+	
+	wi_runtime_make_immutable(data);
+	
+	return wi_autorelease(data);
+}
+
+
+
+#pragma mark -
+
+void wi_data_chain_append_data(wi_data_chain_t *chain, wi_data_t *data) {
+	wi_data_t		*copy;
+	wi_uinteger_t	length;
+	
+	length = wi_data_length(data);
+	
+	if(length < _WI_DATA_CHAIN_COPY_SIZE) {
+		wi_data_chain_append_bytes(chain, wi_data_bytes(data), length);
+	} else {
+		copy = wi_copy(data);
+		
+		_wi_data_chain_add_segment(chain, copy, wi_data_bytes(copy), length);
+		
+		wi_release(copy);
+	}
+}
+
+
+
+void wi_data_chain_append_data_chain(wi_data_chain_t *chain, wi_data_chain_t *otherchain) {
+	wi_uinteger_t	i, count;
+	
+	count = otherchain->count;
+	
+	for(i = 0; i < count; i++) {
+		_wi_data_chain_add_segment(chain,
+			otherchain->segments[i],
+			otherchain->iovecs[i].iov_base,
+			otherchain->iovecs[i].iov_len);
+	}
+}
+
+
+
+void wi_data_chain_append_bytes(wi_data_chain_t *chain, const void *bytes, wi_uinteger_t length) {
+	wi_data_t		*data;
+	struct iovec	*iovec;
+	char			*buffer;
+	
+	if(length == 0)
+		return;
+	
+	if(length >= _WI_DATA_CHAIN_COPY_SIZE) {
+		data = wi_data_init_with_bytes(wi_data_alloc(), bytes, length);
+		
+		_wi_data_chain_add_segment(chain, data, wi_data_bytes(data), length);
+		
+		wi_release(data);
+		
+		return;
+	}
+	
+	if(!chain->chunk || chain->chunk_offset + length > _WI_DATA_CHAIN_CHUNK_SIZE) {
+		wi_release(chain->chunk);
+		
+		chain->chunk = wi_data_init_with_bytes_no_copy(wi_data_alloc(), wi_malloc(_WI_DATA_CHAIN_CHUNK_SIZE), _WI_DATA_CHAIN_CHUNK_SIZE, true);
+		chain->chunk_offset = 0;
+	}
+	
+	buffer = (char *) wi_data_bytes(chain->chunk) + chain->chunk_offset;
+	
+	memcpy(buffer, bytes, length);
+	
+	chain->chunk_offset += length;
+	
+	if(chain->count > 0) {
+		iovec = &chain->iovecs[chain->count - 1];
+		
+		if(chain->segments[chain->count - 1] == chain->chunk && (char *) iovec->iov_base + iovec->iov_len == buffer) {
+			iovec->iov_len += length;
+			chain->length += length;
+			
+			return;
+		}
+	}
+	
+	_wi_data_chain_add_segment(chain, chain->chunk, buffer, length);
+}
+
+
+
+#pragma mark -
+
+void wi_data_chain_remove_length(wi_data_chain_t *chain, wi_uinteger_t length) {
+	wi_uinteger_t	i;
+	
+	length = WI_MIN(length, chain->length);
+	
+	chain->length -= length;
+	
+	for(i = 0; i < chain->count && length >= chain->iovecs[i].iov_len; i++) {
+		length -= chain->iovecs[i].iov_len;
+		
+		wi_release(chain->segments[i]);
+	}
+	
+	if(i < chain->count && length > 0) {
+		chain->iovecs[i].iov_base	= (char *) chain->iovecs[i].iov_base + length;
+		chain->iovecs[i].iov_len	-= length;
+	}
+	
+	if(i > 0) {
+		memmove(chain->segments, chain->segments + i, (chain->count - i) * sizeof(wi_data_t *));
+		memmove(chain->iovecs, chain->iovecs + i, (chain->count - i) * sizeof(struct iovec));
+		
+		chain->count -= i;
+	}
+}
+
+
+
+void wi_data_chain_remove_all_data(wi_data_chain_t *chain) {
+	wi_uinteger_t	i;
+	
+	for(i = 0; i < chain->count; i++)
+		wi_release(chain->segments[i]);
+	
+	chain->count = 0;
+	chain->length = 0;
+}
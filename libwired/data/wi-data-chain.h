@@ -0,0 +1,61 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2006-2009 Axel Andersson
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_DATA_CHAIN_H
+#define WI_DATA_CHAIN_H 1
+
+#include <wired/wi-base.h>
+#include <wired/wi-data.h>
+#include <wired/wi-runtime.h>
+
+struct iovec;
+
+typedef struct _wi_data_chain			wi_data_chain_t;
+
+
+WI_EXPORT wi_runtime_id_t				wi_data_chain_runtime_id(void);
+
+WI_EXPORT wi_data_chain_t *				wi_data_chain(void);
+
+WI_EXPORT wi_data_chain_t *				wi_data_chain_alloc(void);
+WI_EXPORT wi_data_chain_t *				wi_data_chain_init(wi_data_chain_t *);
+WI_EXPORT wi_data_chain_t *				wi_data_chain_init_with_capacity(wi_data_chain_t *, wi_uinteger_t);
+
+WI_EXPORT wi_uinteger_t					wi_data_chain_length(wi_data_chain_t *);
+WI_EXPORT wi_uinteger_t					wi_data_chain_count(wi_data_chain_t *);
+WI_EXPORT const struct iovec *			wi_data_chain_iovecs(wi_data_chain_t *);
+WI_EXPORT wi_data_t *					wi_data_chain_data(wi_data_chain_t *);
+
+WI_EXPORT void							wi_data_chain_append_data(wi_data_chain_t *, wi_data_t *);
+WI_EXPORT void							wi_data_chain_append_data_chain(wi_data_chain_t *, wi_data_chain_t *);
+WI_EXPORT void							wi_data_chain_append_bytes(wi_data_chain_t *, const void *, wi_uinteger_t);
+
+WI_EXPORT void							wi_data_chain_remove_length(wi_data_chain_t *, wi_uinteger_t);
+WI_EXPORT void							wi_data_chain_remove_all_data(wi_data_chain_t *);
+
+#endif /* WI_DATA_CHAIN_H */
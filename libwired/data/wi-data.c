@@ -28,14 +28,18 @@
 
 #include "config.h"
 
+#include <sys/types.h>
 #include <sys/fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 
+#include <wired/wi-assert.h>
 #include <wired/wi-data.h>
 #include <wired/wi-digest.h>
-#include <wired/wi-file.h>
 #include <wired/wi-fs.h>
 #include <wired/wi-macros.h>
 #include <wired/wi-private.h>
@@ -46,6 +50,11 @@
 
 #define _WI_DATA_MIN_SIZE				128
 
+#define _WI_DATA_RANGE_ASSERT(data, range)								\
+	WI_ASSERT((range).location + (range).length <= (data)->length,		\
+		"range %lu,%lu out of range (length %lu) in %@",				\
+		(range).location, (range).length, (data)->length, (data))
+
 
 struct _wi_data {
 	wi_runtime_base_t					base;
@@ -54,6 +63,10 @@ struct _wi_data {
 	wi_uinteger_t						length;
 	wi_uinteger_t						capacity;
 	wi_boolean_t						free;
+	wi_boolean_t						mapped;
+	wi_hash_code_t						hash;
+	
+	wi_data_t							*parent;
 };
 
 
@@ -63,6 +76,11 @@ static wi_boolean_t						_wi_data_is_equal(wi_runtime_instance_t *, wi_runtime_i
 static wi_string_t *					_wi_data_description(wi_runtime_instance_t *);
 static wi_hash_code_t					_wi_data_hash(wi_runtime_instance_t *);
 
+static wi_data_t *						_wi_data_init_with_descriptor(wi_data_t *, int, wi_uinteger_t);
+static wi_data_t *						_wi_data_init_with_mapped_descriptor(wi_data_t *, int, wi_uinteger_t);
+static wi_data_t *						_wi_data_init_with_contents_of_file(wi_data_t *, wi_string_t *, wi_boolean_t);
+
+static void								_wi_data_unmap(wi_data_t *);
 static void								_wi_data_append_bytes(wi_mutable_data_t *, const void *, wi_uinteger_t);
 
 
@@ -129,8 +147,14 @@ wi_data_t * wi_data_with_base64(wi_string_t *base64) {
 
 
 
-wi_data_t * wi_data_with_contents_of_file(wi_string_t *base64) {
-	return wi_autorelease(wi_data_init_with_contents_of_file(wi_data_alloc(), base64));
+wi_data_t * wi_data_with_contents_of_file(wi_string_t *path) {
+	return wi_autorelease(wi_data_init_with_contents_of_file(wi_data_alloc(), path));
+}
+
+
+
+wi_data_t * wi_data_with_contents_of_mapped_file(wi_string_t *path) {
+	return wi_autorelease(wi_data_init_with_contents_of_mapped_file(wi_data_alloc(), path));
 }
 
 
@@ -217,29 +241,97 @@ wi_data_t * wi_data_init_with_base64(wi_data_t *data, wi_string_t *string) {
 
 
 wi_data_t * wi_data_init_with_contents_of_file(wi_data_t *data, wi_string_t *path) {
-	wi_file_t		*file;
-	wi_fs_stat_t	sb;
-	char			buffer[WI_FILE_BUFFER_SIZE];
-	wi_integer_t	bytes;
+	return _wi_data_init_with_contents_of_file(data, path, false);
+}
+
+
+
+wi_data_t * wi_data_init_with_contents_of_mapped_file(wi_data_t *data, wi_string_t *path) {
+	/* reading a mapped file that someone else truncates raises SIGBUS, so only map files nobody rewrites */
+	return _wi_data_init_with_contents_of_file(data, path, true);
+}
+
+
+
+static wi_data_t * _wi_data_init_with_contents_of_file(wi_data_t *data, wi_string_t *path, wi_boolean_t map) {
+	struct stat		sb;
+	int				fd;
+	
+	fd = open(wi_string_cstring(path), O_RDONLY);
 	
-	if(!wi_fs_stat_path(path, &sb)) {
+	if(fd < 0 || fstat(fd, &sb) < 0) {
+		wi_error_set_errno(errno);
+		
+		if(fd >= 0)
+			close(fd);
+		
 		wi_release(data);
 		
 		return NULL;
 	}
 	
-	file = wi_file_for_reading(path);
+	if(map && S_ISREG(sb.st_mode)) {
+		if(_wi_data_init_with_mapped_descriptor(data, fd, sb.st_size)) {
+			close(fd);
+			
+			return data;
+		}
+	}
 	
-	if(!file) {
-		wi_release(data);
+	data = _wi_data_init_with_descriptor(data, fd, S_ISREG(sb.st_mode) ? sb.st_size : 0);
+	
+	close(fd);
+	
+	return data;
+}
+
+
+
+static wi_data_t * _wi_data_init_with_descriptor(wi_data_t *data, int fd, wi_uinteger_t size) {
+	wi_integer_t	bytes;
+	
+	data = wi_data_init_with_capacity(data, size + 1);
+	
+	while(true) {
+		if(data->length == data->capacity) {
+			data->capacity	+= data->capacity / 2;
+			data->bytes		= wi_realloc(data->bytes, data->capacity);
+		}
 		
-		return NULL;
+		bytes = read(fd, data->bytes + data->length, data->capacity - data->length);
+		
+		if(bytes > 0) {
+			data->length += bytes;
+		}
+		else if(bytes == 0) {
+			break;
+		}
+		else if(errno != EINTR) {
+			wi_error_set_errno(errno);
+			
+			wi_release(data);
+			
+			return NULL;
+		}
 	}
 	
-	data = wi_data_init_with_capacity(data, sb.size);
+	return data;
+}
+
+
+
+static wi_data_t * _wi_data_init_with_mapped_descriptor(wi_data_t *data, int fd, wi_uinteger_t size) {
+	void			*bytes;
+	
+	bytes = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
 	
-	while((bytes = wi_file_read_buffer(file, buffer, sizeof(buffer))))
-		_wi_data_append_bytes(data, buffer, bytes);
+	if(bytes == MAP_FAILED)
+		return NULL;
+	
+	data->bytes		= bytes;
+	data->length	= size;
+	data->capacity	= size;
+	data->mapped	= true;
 	
 	return data;
 }
@@ -251,6 +343,10 @@ static void _wi_data_dealloc(wi_runtime_instance_t *instance) {
 	
 	if(data->free)
 		wi_free(data->bytes);
+	else if(data->mapped)
+		_wi_data_unmap(data);
+	
+	wi_release(data->parent);
 }
 
 
@@ -300,8 +396,17 @@ static wi_string_t * _wi_data_description(wi_runtime_instance_t *instance) {
 
 static wi_hash_code_t _wi_data_hash(wi_runtime_instance_t *instance) {
 	wi_data_t		*data = instance;
+	wi_hash_code_t	hash;
+	
+	if(data->hash != 0)
+		return data->hash;
+	
+	hash = wi_hash_data(data->bytes, data->length);
 	
-	return wi_hash_data(data->bytes, WI_MIN(data->length, 16));
+	if(wi_runtime_options(data) & WI_RUNTIME_OPTION_IMMUTABLE)
+		data->hash = hash;
+	
+	return hash;
 }
 
 
@@ -326,12 +431,71 @@ void wi_data_get_bytes(wi_data_t *data, void *bytes, wi_uinteger_t length) {
 
 
 
+wi_boolean_t wi_data_is_mapped(wi_data_t *data) {
+	if(data->parent)
+		return data->parent->mapped;
+	
+	return data->mapped;
+}
+
+
+
+void wi_data_advise(wi_data_t *data, wi_data_advice_t advice) {
+#ifdef HAVE_MADVISE
+	wi_uinteger_t	offset;
+	int				flag;
+	
+	if(!wi_data_is_mapped(data) || data->length == 0)
+		return;
+	
+	switch(advice) {
+		case WI_DATA_ADVICE_NORMAL:			flag = MADV_NORMAL;			break;
+		case WI_DATA_ADVICE_SEQUENTIAL:		flag = MADV_SEQUENTIAL;		break;
+		case WI_DATA_ADVICE_RANDOM:			flag = MADV_RANDOM;			break;
+		case WI_DATA_ADVICE_WILL_NEED:		flag = MADV_WILLNEED;		break;
+		case WI_DATA_ADVICE_DONT_NEED:		flag = MADV_DONTNEED;		break;
+		default:							return;
+	}
+	
+	offset = (uintptr_t) data->bytes % wi_page_size();
+	
+	madvise(data->bytes - offset, data->length + offset, flag);
+#endif
+}
+
+
+
+#pragma mark -
+
+static void _wi_data_unmap(wi_data_t *data) {
+	munmap(data->bytes, data->length);
+	
+	data->mapped = false;
+}
+
+
+
 #pragma mark -
 
 static void _wi_data_append_bytes(wi_mutable_data_t *data, const void *bytes, wi_uinteger_t length) {
+	void			*newbytes;
+	
 	if(data->length + length > data->capacity) {
-		data->capacity		= data->length + length;
-		data->bytes			= wi_realloc(data->bytes, data->capacity);
+		data->capacity		= WI_MAX(data->length + length, data->capacity + (data->capacity / 2));
+		
+		if(data->free) {
+			data->bytes		= wi_realloc(data->bytes, data->capacity);
+		} else {
+			newbytes		= wi_malloc(data->capacity);
+			
+			memcpy(newbytes, data->bytes, data->length);
+			
+			if(data->mapped)
+				_wi_data_unmap(data);
+			
+			data->bytes		= newbytes;
+			data->free		= true;
+		}
 	}
 	
 	memcpy(data->bytes + data->length, bytes, length);
@@ -343,15 +507,41 @@ static void _wi_data_append_bytes(wi_mutable_data_t *data, const void *bytes, wi
 
 #pragma mark -
 
-wi_data_t * wi_data_by_appending_data(wi_data_t *data, wi_data_t *append_data) {
-	wi_mutable_data_t		*newdata;
+wi_data_t * wi_data_subdata_with_range(wi_data_t *data, wi_range_t range) {
+	wi_data_t		*subdata;
 	
-	newdata = wi_mutable_copy(data);
-	wi_mutable_data_append_bytes(newdata, append_data->bytes, append_data->length);
+	_WI_DATA_RANGE_ASSERT(data, range);
 	
-	wi_runtime_make_immutable(data);
+	if(wi_runtime_options(data) & WI_RUNTIME_OPTION_MUTABLE)
+		return wi_data_with_bytes(data->bytes + range.location, range.length);
 	
-	return wi_autorelease(newdata);
+	if(range.location == 0 && range.length == data->length)
+		return wi_autorelease(wi_retain(data));
+	
+	subdata = wi_data_init_with_bytes_no_copy(wi_data_alloc(), data->bytes + range.location, range.length, false);
+	subdata->parent = wi_retain(data->parent ? data->parent : data);
+	
+	return wi_autorelease(subdata);
+}
+
+
+
+wi_data_t * wi_data_subdata_from_index(wi_data_t *data, wi_uinteger_t index) {
+	return wi_data_subdata_with_range(data, wi_make_range(index, data->length - index));
+}
+
+
+
+wi_data_t * wi_data_subdata_to_index(wi_data_t *data, wi_uinteger_t index) {
+	return wi_data_subdata_with_range(data, wi_make_range(0, index));
+}
+
+
+
+#pragma mark -
+
+wi_data_t * wi_data_by_appending_data(wi_data_t *data, wi_data_t *append_data) {
+	return wi_data_by_appending_bytes(data, append_data->bytes, append_data->length);
 }
 
 
@@ -359,10 +549,12 @@ wi_data_t * wi_data_by_appending_data(wi_data_t *data, wi_data_t *append_data) {
 wi_data_t * wi_data_by_appending_bytes(wi_data_t *data, const void *bytes, wi_uinteger_t length) {
 	wi_mutable_data_t		*newdata;
 	
-	newdata = wi_copy(data);
-	wi_mutable_data_append_bytes(newdata, bytes, length);
+	newdata = wi_data_init_with_capacity(wi_mutable_data_alloc(), data->length + length);
+	
+	_wi_data_append_bytes(newdata, data->bytes, data->length);
+	_wi_data_append_bytes(newdata, bytes, length);
 	
-	wi_runtime_make_immutable(data);
+	wi_runtime_make_immutable(newdata);
 
 	return wi_autorelease(newdata);
 }
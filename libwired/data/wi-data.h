@@ -32,6 +32,16 @@
 #include <wired/wi-base.h>
 #include <wired/wi-runtime.h>
 
+enum _wi_data_advice {
+	WI_DATA_ADVICE_NORMAL,
+	WI_DATA_ADVICE_SEQUENTIAL,
+	WI_DATA_ADVICE_RANDOM,
+	WI_DATA_ADVICE_WILL_NEED,
+	WI_DATA_ADVICE_DONT_NEED
+};
+typedef enum _wi_data_advice			wi_data_advice_t;
+
+
 typedef struct _wi_data					wi_data_t;
 typedef struct _wi_data					wi_mutable_data_t;
 
@@ -44,6 +54,7 @@ WI_EXPORT wi_data_t *					wi_data_with_bytes_no_copy(void *, wi_uinteger_t, wi_b
 WI_EXPORT wi_data_t *					wi_data_with_random_bytes(wi_uinteger_t);
 WI_EXPORT wi_data_t *					wi_data_with_base64(wi_string_t *);
 WI_EXPORT wi_data_t *					wi_data_with_contents_of_file(wi_string_t *);
+WI_EXPORT wi_data_t *					wi_data_with_contents_of_mapped_file(wi_string_t *);
 WI_EXPORT wi_mutable_data_t *			wi_mutable_data(void);
 
 WI_EXPORT wi_data_t *					wi_data_alloc(void);
@@ -55,10 +66,17 @@ WI_EXPORT wi_data_t *					wi_data_init_with_bytes_no_copy(wi_data_t *, void *, w
 WI_EXPORT wi_data_t *					wi_data_init_with_random_bytes(wi_data_t *, wi_uinteger_t);
 WI_EXPORT wi_data_t *					wi_data_init_with_base64(wi_data_t *, wi_string_t *);
 WI_EXPORT wi_data_t *					wi_data_init_with_contents_of_file(wi_data_t *, wi_string_t *);
+WI_EXPORT wi_data_t *					wi_data_init_with_contents_of_mapped_file(wi_data_t *, wi_string_t *);
 
 WI_EXPORT const void *					wi_data_bytes(wi_data_t *);
 WI_EXPORT wi_uinteger_t					wi_data_length(wi_data_t *);
 WI_EXPORT void							wi_data_get_bytes(wi_data_t *, void *, wi_uinteger_t);
+WI_EXPORT wi_boolean_t					wi_data_is_mapped(wi_data_t *);
+WI_EXPORT void							wi_data_advise(wi_data_t *, wi_data_advice_t);
+
+WI_EXPORT wi_data_t *					wi_data_subdata_with_range(wi_data_t *, wi_range_t);
+WI_EXPORT wi_data_t *					wi_data_subdata_from_index(wi_data_t *, wi_uinteger_t);
+WI_EXPORT wi_data_t *					wi_data_subdata_to_index(wi_data_t *, wi_uinteger_t);
 
 WI_EXPORT wi_data_t *					wi_data_by_appending_data(wi_data_t *, wi_data_t *);
 WI_EXPORT wi_data_t *					wi_data_by_appending_bytes(wi_data_t *, const void *, wi_uinteger_t);
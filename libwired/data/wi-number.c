@@ -39,6 +39,7 @@
 #include <ctype.h>
 
 #include <wired/wi-number.h>
+#include <wired/wi-numeric.h>
 #include <wired/wi-pool.h>
 #include <wired/wi-private.h>
 #include <wired/wi-runtime.h>
@@ -54,6 +55,13 @@ union _wi_number_value {
 };
 typedef union _wi_number_value			_wi_number_value_t;
 
+#define _WI_NUMBER_CACHE_MIN			-16
+#define _WI_NUMBER_CACHE_MAX			255
+#define _WI_NUMBER_CACHE_SIZE			(_WI_NUMBER_CACHE_MAX - _WI_NUMBER_CACHE_MIN + 1)
+
+#define _WI_NUMBER_IS_CACHED(value) \
+	((value) >= _WI_NUMBER_CACHE_MIN && (value) <= _WI_NUMBER_CACHE_MAX)
+
 
 struct _wi_number {
 	wi_runtime_base_t					base;
@@ -70,6 +78,8 @@ static wi_boolean_t						_wi_number_is_equal(wi_runtime_instance_t *, wi_runtime
 static wi_hash_code_t					_wi_number_hash(wi_runtime_instance_t *);
 static wi_string_t *					_wi_number_description(wi_runtime_instance_t *);
 
+static void								_wi_number_initialize_immortal(wi_number_t *, wi_number_type_t, const void *);
+
 static wi_boolean_t						_wi_number_is_float(wi_number_t *);
 static wi_number_storage_type_t			_wi_number_storage_type(wi_number_type_t);
 
@@ -84,6 +94,10 @@ static wi_runtime_class_t				_wi_number_runtime_class = {
 	_wi_number_hash
 };
 
+static wi_number_t						_wi_number_bools[2];
+static wi_number_t						_wi_number_int32s[_WI_NUMBER_CACHE_SIZE];
+static wi_number_t						_wi_number_int64s[_WI_NUMBER_CACHE_SIZE];
+
 
 
 void wi_number_register(void) {
@@ -93,6 +107,35 @@ void wi_number_register(void) {
 
 
 void wi_number_initialize(void) {
+	wi_boolean_t	value;
+	int32_t			i32;
+	int64_t			i64;
+	int				i;
+	
+	for(i = 0; i < 2; i++) {
+		value = (i == 1);
+		
+		_wi_number_initialize_immortal(&_wi_number_bools[i], WI_NUMBER_BOOL, &value);
+	}
+	
+	for(i = 0; i < _WI_NUMBER_CACHE_SIZE; i++) {
+		i32 = _WI_NUMBER_CACHE_MIN + i;
+		i64 = _WI_NUMBER_CACHE_MIN + i;
+		
+		_wi_number_initialize_immortal(&_wi_number_int32s[i], WI_NUMBER_INT32, &i32);
+		_wi_number_initialize_immortal(&_wi_number_int64s[i], WI_NUMBER_INT64, &i64);
+	}
+}
+
+
+
+static void _wi_number_initialize_immortal(wi_number_t *number, wi_number_type_t type, const void *value) {
+	WI_RUNTIME_BASE(number)->magic			= WI_RUNTIME_MAGIC;
+	WI_RUNTIME_BASE(number)->id				= _wi_number_runtime_id;
+	WI_RUNTIME_BASE(number)->retain_count	= 1;
+	WI_RUNTIME_BASE(number)->options		= WI_RUNTIME_OPTION_IMMUTABLE | WI_RUNTIME_OPTION_IMMORTAL;
+	
+	wi_number_init_with_value(number, type, value);
 }
 
 
@@ -114,7 +157,7 @@ wi_number_t * wi_number_with_value(wi_number_type_t type, const void *value) {
 
 
 wi_number_t * wi_number_with_bool(wi_boolean_t value) {
-	return wi_autorelease(wi_number_init_with_bool(wi_number_alloc(), value));
+	return &_wi_number_bools[value ? 1 : 0];
 }
 
 
@@ -138,19 +181,29 @@ wi_number_t * wi_number_with_int(int value) {
 
 
 wi_number_t * wi_number_with_int32(int32_t value) {
+	if(_WI_NUMBER_IS_CACHED(value))
+		return &_wi_number_int32s[value - _WI_NUMBER_CACHE_MIN];
+	
 	return wi_autorelease(wi_number_init_with_int32(wi_number_alloc(), value));
 }
 
 
 
 wi_number_t * wi_number_with_int64(int64_t value) {
+	if(_WI_NUMBER_IS_CACHED(value))
+		return &_wi_number_int64s[value - _WI_NUMBER_CACHE_MIN];
+	
 	return wi_autorelease(wi_number_init_with_int64(wi_number_alloc(), value));
 }
 
 
 
 wi_number_t * wi_number_with_integer(wi_integer_t value) {
-	return wi_autorelease(wi_number_init_with_integer(wi_number_alloc(), value));
+#if WI_32
+	return wi_number_with_int32(value);
+#else
+	return wi_number_with_int64(value);
+#endif
 }
 
 
@@ -290,16 +343,19 @@ static wi_boolean_t _wi_number_is_equal(wi_runtime_instance_t *instance1, wi_run
 static wi_string_t * _wi_number_description(wi_runtime_instance_t *instance) {
 	wi_number_t				*number = instance;
 	wi_mutable_string_t		*string;
+	char					buffer[WI_NUMERIC_DOUBLE_BUFFER_SIZE];
+	wi_uinteger_t			length;
 	
 	string = wi_mutable_string_with_format(WI_STR("<%@ %p>{value = "),
 		wi_runtime_class_name(number),
 		number);
 	
 	if(_wi_number_is_float(number))
-		wi_mutable_string_append_format(string, WI_STR("%f"), wi_number_double(number));
+		length = wi_numeric_format_double(buffer, wi_number_double(number));
 	else
-		wi_mutable_string_append_format(string, WI_STR("%lld"), wi_number_int64(number));
+		length = wi_numeric_format_int64(buffer, wi_number_int64(number));
 	
+	wi_mutable_string_append_bytes(string, buffer, length);
 	wi_mutable_string_append_string(string, WI_STR("}"));
 	
 	wi_runtime_make_immutable(string);
@@ -536,8 +592,13 @@ double wi_number_double(wi_number_t *number) {
 #pragma mark -
 
 wi_string_t * wi_number_string(wi_number_t *number) {
+	char			buffer[WI_NUMERIC_DOUBLE_BUFFER_SIZE];
+	wi_uinteger_t	length;
+	
 	if(_wi_number_is_float(number))
-		return wi_string_with_format(WI_STR("%f"), wi_number_double(number));
+		length = wi_numeric_format_double(buffer, wi_number_double(number));
 	else
-		return wi_string_with_format(WI_STR("%lld"), wi_number_int64(number));
+		length = wi_numeric_format_int64(buffer, wi_number_int64(number));
+	
+	return wi_string_with_bytes(buffer, length);
 }
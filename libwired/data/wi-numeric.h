@@ -0,0 +1,47 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2003-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_NUMERIC_H
+#define WI_NUMERIC_H 1
+
+#include <inttypes.h>
+#include <wired/wi-base.h>
+
+#define WI_NUMERIC_INTEGER_BUFFER_SIZE		24
+#define WI_NUMERIC_DOUBLE_BUFFER_SIZE		32
+
+
+WI_EXPORT wi_uinteger_t						wi_numeric_format_int64(char *, int64_t);
+WI_EXPORT wi_uinteger_t						wi_numeric_format_uint64(char *, uint64_t);
+WI_EXPORT wi_uinteger_t						wi_numeric_format_double(char *, double);
+
+WI_EXPORT wi_boolean_t						wi_numeric_parse_int64(const char *, wi_uinteger_t, int64_t *);
+WI_EXPORT wi_boolean_t						wi_numeric_parse_uint64(const char *, wi_uinteger_t, uint64_t *);
+WI_EXPORT wi_boolean_t						wi_numeric_parse_double(const char *, wi_uinteger_t, double *);
+
+#endif /* WI_NUMERIC_H */
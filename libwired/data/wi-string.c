@@ -65,14 +65,51 @@
 #include <wired/wi-file.h>
 #include <wired/wi-lock.h>
 #include <wired/wi-macros.h>
+#include <wired/wi-numeric.h>
+#include <wired/wi-path.h>
 #include <wired/wi-private.h>
 #include <wired/wi-random.h>
 #include <wired/wi-runtime.h>
 #include <wired/wi-string.h>
 #include <wired/wi-system.h>
 
-#define _WI_STRING_MIN_SIZE				256
+#define _WI_STRING_MIN_SIZE				64
+#define _WI_STRING_INLINE_SIZE			32
 #define _WI_STRING_FORMAT_BUFSIZ		64
+#define _WI_STRING_FORMAT_STACK_COUNT	16
+
+#define _WI_STRING_FORMAT_ALT				(1 << 0)
+#define _WI_STRING_FORMAT_LEFT				(1 << 1)
+#define _WI_STRING_FORMAT_PLUS				(1 << 2)
+#define _WI_STRING_FORMAT_SPACE				(1 << 3)
+#define _WI_STRING_FORMAT_ZERO				(1 << 4)
+#define _WI_STRING_FORMAT_QUOTE				(1 << 5)
+#define _WI_STRING_FORMAT_WIDTH_STAR		(1 << 6)
+#define _WI_STRING_FORMAT_PRECISION_STAR	(1 << 7)
+
+#define _WI_STRING_FORMAT_SIMPLE_INTEGER(flags, precision)						\
+	(!((flags) & (_WI_STRING_FORMAT_ALT | _WI_STRING_FORMAT_PLUS |				\
+				  _WI_STRING_FORMAT_SPACE | _WI_STRING_FORMAT_QUOTE)) &&		\
+	 (precision) < 0)
+
+#define _WI_STRING_APPEND_PRINTF(string, cfmt, value)							\
+	WI_STMT_START																\
+		int		_size;															\
+																				\
+		_WI_STRING_GROW((string), _WI_STRING_FORMAT_BUFSIZ);					\
+		_size = snprintf((string)->string + (string)->length,					\
+			(string)->capacity - (string)->length, (cfmt), (value));			\
+																				\
+		if(_size > 0) {															\
+			if((wi_uinteger_t) _size >= (string)->capacity - (string)->length) {	\
+				_WI_STRING_GROW((string), _size);								\
+				snprintf((string)->string + (string)->length,					\
+					(string)->capacity - (string)->length, (cfmt), (value));	\
+			}																	\
+																				\
+			(string)->length += _size;											\
+		}																		\
+	WI_STMT_END
 
 #define _WI_STRING_GROW(string, n)												\
 	WI_STMT_START																\
@@ -99,22 +136,68 @@ struct _wi_string {
 	wi_uinteger_t						length;
 	wi_uinteger_t						capacity;
 	wi_boolean_t						free;
+	wi_boolean_t						atom;
+	wi_hash_code_t						hash;
+	void								*format;
+	
+	char								inline_string[_WI_STRING_INLINE_SIZE];
+};
+
+
+enum _wi_string_format_modifier {
+	_WI_STRING_FORMAT_INT				= 0,
+	_WI_STRING_FORMAT_CHAR,
+	_WI_STRING_FORMAT_SHORT,
+	_WI_STRING_FORMAT_LONG,
+	_WI_STRING_FORMAT_LONG_LONG,
+	_WI_STRING_FORMAT_INTMAX,
+	_WI_STRING_FORMAT_PTRDIFF,
+	_WI_STRING_FORMAT_SIZE,
+	_WI_STRING_FORMAT_LONG_DOUBLE
 };
 
 
+struct _wi_string_format_spec {
+	uint32_t							literal;
+	uint32_t							literal_length;
+	int32_t								width;
+	int32_t								precision;
+	uint16_t							flags;
+	uint8_t								modifier;
+	char								conversion;
+};
+typedef struct _wi_string_format_spec	_wi_string_format_spec_t;
+
+
+struct _wi_string_format {
+	wi_uinteger_t						count;
+	_wi_string_format_spec_t			specs[];
+};
+typedef struct _wi_string_format		_wi_string_format_t;
+
+
 static void								_wi_string_dealloc(wi_runtime_instance_t *);
 static wi_runtime_instance_t *			_wi_string_copy(wi_runtime_instance_t *);
 static wi_boolean_t						_wi_string_is_equal(wi_runtime_instance_t *, wi_runtime_instance_t *);
 static wi_string_t *					_wi_string_description(wi_runtime_instance_t *);
 static wi_hash_code_t					_wi_string_hash(wi_runtime_instance_t *);
 
+static wi_string_t *					_wi_string_intern(wi_string_t *, wi_boolean_t);
+
 static void								_wi_string_grow(wi_string_t *, wi_uinteger_t);
-static void								_wi_string_append_arguments(wi_string_t *, const char *, va_list);
+static void								_wi_string_append_arguments(wi_string_t *, wi_string_t *, va_list);
+static wi_uinteger_t					_wi_string_format_compile(const char *, _wi_string_format_spec_t *, wi_uinteger_t);
+static void								_wi_string_format_cfmt(char *, const _wi_string_format_spec_t *, int, int, wi_boolean_t);
+static void								_wi_string_append_format(wi_string_t *, const char *, const _wi_string_format_spec_t *, wi_uinteger_t, va_list);
+static void								_wi_string_append_integer(wi_string_t *, unsigned long long, wi_boolean_t, unsigned int, wi_boolean_t, int, uint16_t);
+static void								_wi_string_append_padded_bytes(wi_string_t *, const void *, wi_uinteger_t, int, uint16_t);
 static void								_wi_string_append_cstring(wi_string_t *, const char *);
 static void								_wi_string_append_bytes(wi_string_t *, const void *, wi_uinteger_t);
 
 static wi_string_t *					_wi_string_sqlite3_escaped_string(wi_string_t *);
 
+static wi_boolean_t						_wi_string_is_case_insensitive_search(wi_string_t *, wi_uinteger_t);
+
 static wi_boolean_t						_wi_mutable_string_char_is_whitespace(char);
 
 static wi_mutable_array_t *				_wi_string_path_components(wi_string_t *);
@@ -124,9 +207,13 @@ static void								_wi_mutable_string_resolve_mac_alias_in_path(wi_string_t *);
 #endif
 
 
-static wi_lock_t						*_wi_string_constant_string_lock;
+static wi_fast_lock_t					_wi_string_constant_string_lock = WI_FAST_LOCK_INITIALIZER;
 static wi_dictionary_t					*_wi_string_constant_string_table;
 
+/* never purged, atoms are immortal, so only intern keys and names from a bounded set, never peer input */
+static wi_fast_lock_t					_wi_string_intern_lock = WI_FAST_LOCK_INITIALIZER;
+static wi_mutable_dictionary_t			*_wi_string_intern_table;
+
 static wi_runtime_id_t					_wi_string_runtime_id = WI_RUNTIME_ID_NULL;
 static wi_runtime_class_t				_wi_string_runtime_class = {
 	"wi_string_t",
@@ -168,9 +255,38 @@ static wi_runtime_class_t				_wi_string_encoding_runtime_class = {
 #endif
 
 
+struct _wi_string_matcher {
+	wi_runtime_base_t					base;
+	
+	wi_string_t							*string;
+	wi_uinteger_t						anchor1;
+	wi_uinteger_t						anchor2;
+	wi_boolean_t						insensitive;
+	wi_boolean_t						backwards;
+};
+
+
+static void								_wi_string_matcher_dealloc(wi_runtime_instance_t *);
+static wi_string_t *					_wi_string_matcher_description(wi_runtime_instance_t *);
+
+static wi_uinteger_t					_wi_string_matcher_byte_frequency(unsigned char);
+
+
+static wi_runtime_id_t					_wi_string_matcher_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t				_wi_string_matcher_runtime_class = {
+	"wi_string_matcher_t",
+	_wi_string_matcher_dealloc,
+	NULL,
+	NULL,
+	_wi_string_matcher_description,
+	NULL
+};
+
+
 
 void wi_string_register(void) {
 	_wi_string_runtime_id = wi_runtime_register_class(&_wi_string_runtime_class);
+	_wi_string_matcher_runtime_id = wi_runtime_register_class(&_wi_string_matcher_runtime_class);
 	
 #ifdef WI_ICONV
 	_wi_string_encoding_runtime_id = wi_runtime_register_class(&_wi_string_encoding_runtime_class);
@@ -180,9 +296,10 @@ void wi_string_register(void) {
 
 
 void wi_string_initialize(void) {
-	_wi_string_constant_string_lock = wi_lock_init(wi_lock_alloc());
 	_wi_string_constant_string_table = wi_dictionary_init_with_capacity_and_callbacks(wi_mutable_dictionary_alloc(),
 		2000, wi_dictionary_null_key_callbacks, wi_dictionary_default_value_callbacks);
+
+	_wi_string_intern_table = wi_dictionary_init_with_capacity(wi_mutable_dictionary_alloc(), 2000);
 }
 
 
@@ -298,10 +415,17 @@ wi_string_t * wi_string_init(wi_string_t *string) {
 
 
 wi_string_t * wi_string_init_with_capacity(wi_string_t *string, wi_uinteger_t capacity) {
-	string->capacity	= WI_MAX(wi_exp2m1(wi_log2(capacity) + 1), _WI_STRING_MIN_SIZE);
-	string->string		= wi_malloc(string->capacity);
+	if(capacity < _WI_STRING_INLINE_SIZE) {
+		string->capacity	= _WI_STRING_INLINE_SIZE;
+		string->string		= string->inline_string;
+		string->free		= false;
+	} else {
+		string->capacity	= WI_MAX(wi_exp2m1(wi_log2(capacity) + 1), _WI_STRING_MIN_SIZE);
+		string->string		= wi_malloc(string->capacity);
+		string->free		= true;
+	}
+	
 	string->length		= 0;
-	string->free		= true;
 	
 	return string;
 }
@@ -383,7 +507,7 @@ wi_string_t * wi_string_init_with_format(wi_string_t *string, wi_string_t *fmt,
 wi_string_t * wi_string_init_with_format_and_arguments(wi_string_t *string, wi_string_t *fmt, va_list ap) {
 	string = wi_string_init(string);
 	
-	_wi_string_append_arguments(string, wi_string_cstring(fmt), ap);
+	_wi_string_append_arguments(string, fmt, ap);
 	
 	return string;
 }
@@ -397,20 +521,17 @@ wi_string_t * wi_string_init_with_base64(wi_string_t *string, wi_string_t *base6
 
 
 wi_string_t * wi_string_init_with_contents_of_file(wi_string_t *string, wi_string_t *path) {
-	wi_file_t       *file;
+	wi_data_t		*data;
 	
-	wi_release(string);
-		
-	file = wi_file_for_reading(path);
+	data = wi_data_with_contents_of_file(path);
 	
-	if(!file)
+	if(!data) {
+		wi_release(string);
+		
 		return NULL;
+	}
 	
-	string = wi_file_read_to_end_of_file(file);
-	
-	wi_file_close(file);
-	
-	return wi_retain(string);
+	return wi_string_init_with_bytes(string, wi_data_bytes(data), wi_data_length(data));
 }
 
 
@@ -420,6 +541,9 @@ static void _wi_string_dealloc(wi_runtime_instance_t *instance) {
 	
 	if(string->string && string->free)
 		wi_free(string->string);
+	
+	if(string->format)
+		wi_free(string->format);
 }
 
 
@@ -427,13 +551,22 @@ static void _wi_string_dealloc(wi_runtime_instance_t *instance) {
 static wi_runtime_instance_t * _wi_string_copy(wi_runtime_instance_t *instance) {
 	wi_string_t		*string = instance;
 	
-	return wi_string_init_with_cstring(wi_string_alloc(), string->string);
+	return wi_string_init_with_bytes(wi_string_alloc(), string->string, string->length);
 }
 
 
 
 static wi_boolean_t _wi_string_is_equal(wi_runtime_instance_t *instance1, wi_runtime_instance_t *instance2) {
-	return (wi_string_compare(instance1, instance2) == 0);
+	wi_string_t		*string1 = instance1;
+	wi_string_t		*string2 = instance2;
+	
+	if(WI_ATOMIC_LOAD_ACQUIRE(string1->atom) && WI_ATOMIC_LOAD_ACQUIRE(string2->atom))
+		return (string1 == string2);
+	
+	if(string1->length != string2->length)
+		return false;
+	
+	return (memcmp(string1->string, string2->string, string1->length) == 0);
 }
 
 
@@ -449,7 +582,17 @@ static wi_string_t * _wi_string_description(wi_runtime_instance_t *instance) {
 static wi_hash_code_t _wi_string_hash(wi_runtime_instance_t *instance) {
 	wi_string_t		*string = instance;
 	
-	return wi_hash_cstring(string->string, string->length);
+	wi_hash_code_t	hash;
+	
+	if(string->hash != 0)
+		return string->hash;
+	
+	hash = wi_hash_cstring(string->string, string->length);
+	
+	if(wi_runtime_options(string) & WI_RUNTIME_OPTION_IMMUTABLE)
+		string->hash = hash;
+	
+	return hash;
 }
 
 
@@ -502,31 +645,100 @@ char wi_string_character_at_index(wi_string_t *string, wi_uinteger_t index) {
 wi_string_t * _wi_string_constant_string(const char *cstring) {
 	wi_string_t			*string;
 	
-	wi_lock_lock(_wi_string_constant_string_lock);
+	wi_fast_lock_lock(&_wi_string_constant_string_lock);
 	string = wi_dictionary_data_for_key(_wi_string_constant_string_table, (void *) cstring);
 	
 	if(!string) {
-		string = wi_string_init_with_cstring(wi_string_alloc(), cstring);
-		wi_mutable_dictionary_set_data_for_key(_wi_string_constant_string_table, string, (void *) cstring);
+		string = wi_string_init_with_cstring_no_copy(wi_string_alloc(), (char *) cstring, false);
+		wi_mutable_dictionary_set_data_for_key(_wi_string_constant_string_table, _wi_string_intern(string, false), (void *) cstring);
 		wi_release(string);
+		
+		string = wi_dictionary_data_for_key(_wi_string_constant_string_table, (void *) cstring);
 	}
 	
-	wi_lock_unlock(_wi_string_constant_string_lock);
+	wi_fast_lock_unlock(&_wi_string_constant_string_lock);
 
 	return string;
 }
 
 
 
+#pragma mark -
+
+wi_string_t * wi_string_intern(wi_string_t *string) {
+	if(WI_ATOMIC_LOAD_ACQUIRE(string->atom))
+		return string;
+	
+	/* the caller's instance may be shared, so never mark it in place */
+	return _wi_string_intern(string, true);
+}
+
+
+
+wi_string_t * wi_string_intern_cstring(const char *cstring) {
+	wi_string_t		*string, *atom;
+	
+	string = wi_string_init_with_cstring_no_copy(wi_string_alloc(), (char *) cstring, false);
+	atom = _wi_string_intern(string, true);
+	wi_release(string);
+	
+	return atom;
+}
+
+
+
+wi_boolean_t wi_string_is_interned(wi_string_t *string) {
+	return WI_ATOMIC_LOAD_ACQUIRE(string->atom);
+}
+
+
+
+static wi_string_t * _wi_string_intern(wi_string_t *string, wi_boolean_t copy) {
+	wi_string_t		*atom;
+	
+	wi_fast_lock_lock(&_wi_string_intern_lock);
+	
+	atom = wi_dictionary_data_for_key(_wi_string_intern_table, string);
+	
+	if(!atom) {
+		if(copy)
+			atom = wi_string_init_with_bytes(wi_string_alloc(), string->string, string->length);
+		else
+			atom = wi_retain(string);
+		
+		atom->hash = _wi_string_hash(atom);
+		
+		/* the string may already be shared, so readers that see the flag must also see the hash */
+		WI_ATOMIC_STORE_RELEASE(atom->atom, true);
+		
+		wi_mutable_dictionary_set_data_for_key(_wi_string_intern_table, atom, atom);
+		wi_release(atom);
+		
+		wi_runtime_make_immortal(atom);
+	}
+	
+	wi_fast_lock_unlock(&_wi_string_intern_lock);
+	
+	return atom;
+}
+
+
+
 #pragma mark -
 
 static void _wi_string_grow(wi_string_t *string, wi_uinteger_t capacity) {
-	capacity = WI_MAX(wi_exp2m1(wi_log2(capacity) + 1), _WI_STRING_MIN_SIZE);
+	char		*buffer;
+	
+	capacity = WI_MAX(wi_exp2m1(wi_log2(capacity + 1) + 1), _WI_STRING_MIN_SIZE);
 
 	if(string->free) {
 		string->string = wi_realloc(string->string, capacity);
 	} else {
-		string->string = wi_malloc(capacity);
+		buffer = wi_malloc(capacity);
+		
+		memcpy(buffer, string->string, string->length);
+		
+		string->string = buffer;
 		string->free = true;
 	}
 
@@ -535,262 +747,472 @@ static void _wi_string_grow(wi_string_t *string, wi_uinteger_t capacity) {
 
 
 
-static void _wi_string_append_arguments(wi_string_t *string, const char *fmt, va_list ap) {
-	wi_string_t			*description;
-	const char			*p, *pfmt;
-	char				*s, *vbuffer, cfmt[_WI_STRING_FORMAT_BUFSIZ], buffer[_WI_STRING_FORMAT_BUFSIZ];
-	wi_uinteger_t		i, size, totalsize;
-	int					ch, length;
-	wi_boolean_t		alt, star, h, hh, j, t, l, ll, L, z;
-	
-	pfmt = fmt;
-	
+static void _wi_string_append_arguments(wi_string_t *string, wi_string_t *fmt, va_list ap) {
+	_wi_string_format_spec_t	stackspecs[_WI_STRING_FORMAT_STACK_COUNT], *specs;
+	_wi_string_format_t			*format, *newformat;
+	wi_uinteger_t				count;
+
+	if(WI_ATOMIC_LOAD_ACQUIRE(fmt->atom)) {
+		format = WI_ATOMIC_LOAD_ACQUIRE(fmt->format);
+
+		if(!format) {
+			count				= _wi_string_format_compile(fmt->string, NULL, 0);
+			newformat			= wi_malloc(sizeof(_wi_string_format_t) + (count * sizeof(_wi_string_format_spec_t)));
+			newformat->count	= _wi_string_format_compile(fmt->string, newformat->specs, count);
+
+			if(WI_ATOMIC_COMPARE_AND_SWAP(fmt->format, NULL, newformat)) {
+				format = newformat;
+			} else {
+				wi_free(newformat);
+
+				format = WI_ATOMIC_LOAD_ACQUIRE(fmt->format);
+			}
+		}
+
+		_wi_string_append_format(string, fmt->string, format->specs, format->count, ap);
+	} else {
+		count = _wi_string_format_compile(fmt->string, stackspecs, _WI_STRING_FORMAT_STACK_COUNT);
+
+		if(count > _WI_STRING_FORMAT_STACK_COUNT) {
+			specs = wi_malloc(count * sizeof(_wi_string_format_spec_t));
+
+			_wi_string_format_compile(fmt->string, specs, count);
+			_wi_string_append_format(string, fmt->string, specs, count, ap);
+
+			wi_free(specs);
+		} else {
+			_wi_string_append_format(string, fmt->string, stackspecs, count, ap);
+		}
+	}
+}
+
+
+
+static wi_uinteger_t _wi_string_format_compile(const char *fmt, _wi_string_format_spec_t *specs, wi_uinteger_t capacity) {
+	_wi_string_format_spec_t	spec;
+	const char					*p, *pfmt;
+	wi_uinteger_t				count;
+	wi_boolean_t				precision;
+	int							ch, value;
+
+	pfmt	= fmt;
+	count	= 0;
+
 	while(true) {
-		i = totalsize = length = 0;
 		p = pfmt;
-		
+
 		while(*pfmt && *pfmt != '%')
 			pfmt++;
 
-		size = pfmt - p;
-		
-		if(size > 0)
-			_wi_string_append_bytes(string, p, size);
-		
-		if(!*pfmt)
-			return;
-		
-		alt = star = h = hh = j = t = l = ll = L = z = false;
-		
-		ch			= *pfmt++;
-		cfmt[i++]	= ch;
-
-nextflag:
-		ch			= *pfmt++;
-		cfmt[i++]	= ch;
-		cfmt[i]		= '\0';
-
-		switch(ch) {
-			case '#':
-				alt = true;
-				
-				goto nextflag;
+		memset(&spec, 0, sizeof(spec));
+
+		spec.literal			= p - fmt;
+		spec.literal_length		= pfmt - p;
+		spec.width				= -1;
+		spec.precision			= -1;
+
+		if(*pfmt) {
+			pfmt++;
+			precision = false;
+
+			while(true) {
+				ch = *pfmt++;
+
+				switch(ch) {
+					case '#':
+						spec.flags |= _WI_STRING_FORMAT_ALT;
+						continue;
+
+					case '-':
+						spec.flags |= _WI_STRING_FORMAT_LEFT;
+						continue;
+
+					case '+':
+						spec.flags |= _WI_STRING_FORMAT_PLUS;
+						continue;
+
+					case ' ':
+						spec.flags |= _WI_STRING_FORMAT_SPACE;
+						continue;
+
+					case '\'':
+						spec.flags |= _WI_STRING_FORMAT_QUOTE;
+						continue;
+
+					case '.':
+						precision = true;
+						spec.precision = 0;
+						continue;
+
+					case '*':
+						if(precision)
+							spec.flags |= _WI_STRING_FORMAT_PRECISION_STAR;
+						else
+							spec.flags |= _WI_STRING_FORMAT_WIDTH_STAR;
+						continue;
+
+					case '0':
+						if(!precision && spec.width < 0) {
+							spec.flags |= _WI_STRING_FORMAT_ZERO;
+							continue;
+						}
+						/* FALLTHROUGH */
+
+					case '1':
+					case '2':
+					case '3':
+					case '4':
+					case '5':
+					case '6':
+					case '7':
+					case '8':
+					case '9':
+						value = ch - '0';
+
+						while(*pfmt >= '0' && *pfmt <= '9')
+							value = (value * 10) + (*pfmt++ - '0');
+
+						if(precision)
+							spec.precision = value;
+						else
+							spec.width = value;
+						continue;
+
+					case 'h':
+						spec.modifier = (spec.modifier == _WI_STRING_FORMAT_SHORT)
+							? _WI_STRING_FORMAT_CHAR
+							: _WI_STRING_FORMAT_SHORT;
+						continue;
+
+					case 'l':
+						spec.modifier = (spec.modifier == _WI_STRING_FORMAT_LONG)
+							? _WI_STRING_FORMAT_LONG_LONG
+							: _WI_STRING_FORMAT_LONG;
+						continue;
+
+					case 'L':
+						spec.modifier = _WI_STRING_FORMAT_LONG_DOUBLE;
+						continue;
+
+					case 'j':
+						spec.modifier = _WI_STRING_FORMAT_INTMAX;
+						continue;
+
+					case 't':
+						spec.modifier = _WI_STRING_FORMAT_PTRDIFF;
+						continue;
+
+					case 'z':
+						spec.modifier = _WI_STRING_FORMAT_SIZE;
+						continue;
+
+					case 'D':
+					case 'O':
+					case 'U':
+						spec.modifier = _WI_STRING_FORMAT_LONG;
+						spec.conversion = ch - 'A' + 'a';
+						break;
+
+					case '\0':
+						pfmt--;
+						break;
+
+					default:
+						spec.conversion = ch;
+						break;
+				}
+
 				break;
-				
+			}
+		}
+
+		if(spec.literal_length > 0 || spec.conversion) {
+			if(count < capacity)
+				specs[count] = spec;
+
+			count++;
+		}
+
+		if(!*pfmt)
+			break;
+	}
+
+	return count;
+}
+
+
+
+static void _wi_string_format_cfmt(char *cfmt, const _wi_string_format_spec_t *spec, int width, int precision, wi_boolean_t extended) {
+	char		*p = cfmt;
+
+	*p++ = '%';
+
+	if(spec->flags & _WI_STRING_FORMAT_ALT)
+		*p++ = '#';
+
+	if(spec->flags & _WI_STRING_FORMAT_LEFT)
+		*p++ = '-';
+
+	if(spec->flags & _WI_STRING_FORMAT_PLUS)
+		*p++ = '+';
+
+	if(spec->flags & _WI_STRING_FORMAT_SPACE)
+		*p++ = ' ';
+
+	if(spec->flags & _WI_STRING_FORMAT_ZERO)
+		*p++ = '0';
+
+	if(spec->flags & _WI_STRING_FORMAT_QUOTE)
+		*p++ = '\'';
+
+	if(width >= 0)
+		p += sprintf(p, "%d", width);
+
+	if(precision >= 0)
+		p += sprintf(p, ".%d", precision);
+
+	if(extended) {
+		if(spec->modifier == _WI_STRING_FORMAT_LONG_DOUBLE) {
+			*p++ = 'L';
+		} else {
+			*p++ = 'l';
+			*p++ = 'l';
+		}
+	}
+
+	*p++ = spec->conversion;
+	*p = '\0';
+}
+
+
+
+static void _wi_string_append_format(wi_string_t *string, const char *fmt, const _wi_string_format_spec_t *specs, wi_uinteger_t count, va_list ap) {
+	const _wi_string_format_spec_t	*spec;
+	wi_runtime_instance_t			*instance;
+	wi_string_t						*description;
+	const char						*s;
+	void							*pointer;
+	char							cfmt[_WI_STRING_FORMAT_BUFSIZ];
+	long double						ldvalue;
+	double							dvalue;
+	long long						value;
+	unsigned long long				uvalue;
+	wi_uinteger_t					i, start, totalsize;
+	int								width, precision;
+	uint16_t						flags;
+
+	start = string->length;
+
+	for(i = 0; i < count; i++) {
+		spec = &specs[i];
+
+		if(spec->literal_length > 0)
+			_wi_string_append_bytes(string, fmt + spec->literal, spec->literal_length);
+
+		if(!spec->conversion)
+			continue;
+
+		flags		= spec->flags;
+		width		= spec->width;
+		precision	= spec->precision;
+
+		if(flags & _WI_STRING_FORMAT_WIDTH_STAR) {
+			width = va_arg(ap, int);
+
+			if(width < 0) {
+				flags |= _WI_STRING_FORMAT_LEFT;
+				width = -width;
+			}
+		}
+
+		if(flags & _WI_STRING_FORMAT_PRECISION_STAR) {
+			precision = va_arg(ap, int);
+
+			if(precision < 0)
+				precision = -1;
+		}
+
+		switch(spec->conversion) {
 			case '@':
-				description = wi_description(va_arg(ap, wi_runtime_instance_t *));
-				
-				if(description) {
-					_wi_string_append_cstring(string, description->string);
-					totalsize += description->length;
-				}
-				else if(!alt) {
-					_wi_string_append_cstring(string, "(null)");
-					totalsize += 6;
-				}
+				instance = va_arg(ap, wi_runtime_instance_t *);
+
+				if(instance && wi_runtime_id(instance) == _wi_string_runtime_id)
+					description = instance;
+				else
+					description = wi_description(instance);
+
+				if(description)
+					_wi_string_append_bytes(string, description->string, description->length);
+				else if(!(flags & _WI_STRING_FORMAT_ALT))
+					_wi_string_append_bytes(string, "(null)", 6);
 				break;
-			
+
 			case 'q':
 				description = wi_description(va_arg(ap, wi_runtime_instance_t *));
-				
+
 				if(description) {
 					description = _wi_string_sqlite3_escaped_string(description);
-					_wi_string_append_cstring(string, description->string);
-					totalsize += description->length;
+					_wi_string_append_bytes(string, description->string, description->length);
 				} else {
-					_wi_string_append_cstring(string, "'(null)'");
-					totalsize += 8;
+					_wi_string_append_bytes(string, "'(null)'", 8);
 				}
 				break;
-				
+
 			case 'Q':
 				description = wi_description(va_arg(ap, wi_runtime_instance_t *));
-				
+
 				if(description) {
 					description = _wi_string_sqlite3_escaped_string(description);
-					_wi_string_append_cstring(string, "'");
-					_wi_string_append_cstring(string, description->string);
-					_wi_string_append_cstring(string, "'");
-					totalsize += description->length + 2;
+					_wi_string_append_bytes(string, "'", 1);
+					_wi_string_append_bytes(string, description->string, description->length);
+					_wi_string_append_bytes(string, "'", 1);
 				} else {
-					_wi_string_append_cstring(string, "NULL");
-					totalsize += 4;
+					_wi_string_append_bytes(string, "NULL", 4);
 				}
 				break;
-			
-			case ' ':
-			case '-':
-			case '+':
-			case '.':
-			case '\'':
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				goto nextflag;
-				break;
-			
-			case '*':
-				star = true;
-				length = va_arg(ap, int);
-				
-				goto nextflag;
-				break;
-				
-			case 'h':
-				if(h)
-					hh = true;
-				else
-					h = true;
 
-				goto nextflag;
+			case 'm':
+				description = wi_error_string();
+				_wi_string_append_bytes(string, description->string, description->length);
 				break;
-				
-			case 'j':
-				j = true;
-				
-				goto nextflag;
+
+			case 'd':
+			case 'i':
+				switch(spec->modifier) {
+					case _WI_STRING_FORMAT_CHAR:		value = (signed char) va_arg(ap, int);		break;
+					case _WI_STRING_FORMAT_SHORT:		value = (short) va_arg(ap, int);			break;
+					case _WI_STRING_FORMAT_LONG:		value = va_arg(ap, long);					break;
+					case _WI_STRING_FORMAT_LONG_LONG:	value = va_arg(ap, long long);				break;
+#ifdef HAVE_INTMAX_T
+					case _WI_STRING_FORMAT_INTMAX:		value = va_arg(ap, intmax_t);				break;
+#endif
+#ifdef HAVE_PTRDIFF_T
+					case _WI_STRING_FORMAT_PTRDIFF:		value = va_arg(ap, ptrdiff_t);				break;
+#endif
+					case _WI_STRING_FORMAT_SIZE:		value = (ssize_t) va_arg(ap, size_t);		break;
+					default:							value = va_arg(ap, int);					break;
+				}
+
+				if(_WI_STRING_FORMAT_SIMPLE_INTEGER(flags, precision)) {
+					if(value < 0)
+						_wi_string_append_integer(string, -(unsigned long long) value, true, 10, false, width, flags);
+					else
+						_wi_string_append_integer(string, value, false, 10, false, width, flags);
+				} else {
+					_wi_string_format_cfmt(cfmt, spec, width, precision, true);
+					_WI_STRING_APPEND_PRINTF(string, cfmt, value);
+				}
 				break;
-			
-			case 't':
-				t = true;
-				
-				goto nextflag;
+
+			case 'o':
+			case 'u':
+			case 'x':
+			case 'X':
+				switch(spec->modifier) {
+					case _WI_STRING_FORMAT_CHAR:		uvalue = (unsigned char) va_arg(ap, int);		break;
+					case _WI_STRING_FORMAT_SHORT:		uvalue = (unsigned short) va_arg(ap, int);		break;
+					case _WI_STRING_FORMAT_LONG:		uvalue = va_arg(ap, unsigned long);				break;
+					case _WI_STRING_FORMAT_LONG_LONG:	uvalue = va_arg(ap, unsigned long long);		break;
+#ifdef HAVE_INTMAX_T
+					case _WI_STRING_FORMAT_INTMAX:		uvalue = va_arg(ap, uintmax_t);					break;
+#endif
+#ifdef HAVE_PTRDIFF_T
+					case _WI_STRING_FORMAT_PTRDIFF:		uvalue = va_arg(ap, ptrdiff_t);					break;
+#endif
+					case _WI_STRING_FORMAT_SIZE:		uvalue = va_arg(ap, size_t);					break;
+					default:							uvalue = va_arg(ap, unsigned int);				break;
+				}
+
+				if(_WI_STRING_FORMAT_SIMPLE_INTEGER(flags, precision)) {
+					_wi_string_append_integer(string,
+											  uvalue,
+											  false,
+											  spec->conversion == 'o' ? 8 : spec->conversion == 'u' ? 10 : 16,
+											  spec->conversion == 'X',
+											  width,
+											  flags);
+				} else {
+					_wi_string_format_cfmt(cfmt, spec, width, precision, true);
+					_WI_STRING_APPEND_PRINTF(string, cfmt, uvalue);
+				}
 				break;
-			
-			case 'l':
-				if(l)
-					ll = true;
-				else
-					l = true;
 
-				goto nextflag;
+			case 'c':
+				value = va_arg(ap, int);
+
+				if(width < 0 && spec->modifier == _WI_STRING_FORMAT_INT) {
+					cfmt[0] = value;
+
+					_wi_string_append_bytes(string, cfmt, 1);
+				} else {
+					_wi_string_format_cfmt(cfmt, spec, width, precision, false);
+					_WI_STRING_APPEND_PRINTF(string, cfmt, (int) value);
+				}
 				break;
 
-			case 'L':
-				L = true;
-				
-				goto nextflag;
+			case 's':
+				s = va_arg(ap, const char *);
+
+				if(s) {
+					_wi_string_append_padded_bytes(string,
+												   s,
+												   precision >= 0 ? strnlen(s, precision) : strlen(s),
+												   width,
+												   flags);
+				}
+				else if(!(flags & _WI_STRING_FORMAT_ALT)) {
+					_wi_string_append_bytes(string, "(null)", 6);
+				}
 				break;
-			
+
 			case 'a':
 			case 'A':
 			case 'e':
 			case 'E':
 			case 'f':
+			case 'F':
 			case 'g':
 			case 'G':
-				if(L)
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, long double));
-				else
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, double));
-				
-				_wi_string_append_bytes(string, buffer, size);
-				totalsize += size;
+				if(spec->modifier == _WI_STRING_FORMAT_LONG_DOUBLE) {
+					ldvalue = va_arg(ap, long double);
+
+					_wi_string_format_cfmt(cfmt, spec, width, precision, true);
+					_WI_STRING_APPEND_PRINTF(string, cfmt, ldvalue);
+				} else {
+					dvalue = va_arg(ap, double);
+
+					_wi_string_format_cfmt(cfmt, spec, width, precision, false);
+					_WI_STRING_APPEND_PRINTF(string, cfmt, dvalue);
+				}
 				break;
-				
-			case 'c':
-			case 'D':
-			case 'd':
-			case 'i':
-			case 'O':
-			case 'o':
+
 			case 'p':
-			case 'U':
-			case 'u':
-			case 'X':
-			case 'x':
-				if(ll)
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, long long));
-				else if(l || ch == 'D' || ch == 'O' || ch == 'U')
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, long));
-				else if(ch == 'p')
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, void *));
-#ifdef HAVE_INTMAX_T
-				else if(j)
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, intmax_t));
-#endif
-#ifdef HAVE_PTRDIFF_T
-				else if(t)
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, ptrdiff_t));
-#endif
-				else if(z)
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, size_t));
-				else
-					size = snprintf(buffer, sizeof(buffer), cfmt, va_arg(ap, int));
-				
-				_wi_string_append_bytes(string, buffer, size);
-				totalsize += size;
-				break;
-			
-			case 'm':
-				description = wi_error_string();
-				_wi_string_append_cstring(string, description->string);
-				totalsize += description->length;
+				_wi_string_format_cfmt(cfmt, spec, width, precision, false);
+				pointer = va_arg(ap, void *);
+				_WI_STRING_APPEND_PRINTF(string, cfmt, pointer);
 				break;
-			
+
 			case 'n':
-				if(hh)
-					*(va_arg(ap, signed char *)) = totalsize;
-				else if(h)
-					*(va_arg(ap, short *)) = totalsize;
-				if(ll)
-					*(va_arg(ap, long long *)) = totalsize;
-				else if(l)
-					*(va_arg(ap, long *)) = totalsize;
+				totalsize = string->length - start;
+
+				switch(spec->modifier) {
+					case _WI_STRING_FORMAT_CHAR:		*(va_arg(ap, signed char *)) = totalsize;		break;
+					case _WI_STRING_FORMAT_SHORT:		*(va_arg(ap, short *)) = totalsize;				break;
+					case _WI_STRING_FORMAT_LONG:		*(va_arg(ap, long *)) = totalsize;				break;
+					case _WI_STRING_FORMAT_LONG_LONG:	*(va_arg(ap, long long *)) = totalsize;			break;
 #ifdef HAVE_INTMAX_T
-				else if(j)
-					*(va_arg(ap, intmax_t *)) = totalsize;
+					case _WI_STRING_FORMAT_INTMAX:		*(va_arg(ap, intmax_t *)) = totalsize;			break;
 #endif
 #ifdef HAVE_PTRDIFF_T
-				else if(t)
-					*(va_arg(ap, ptrdiff_t *)) = totalsize;
+					case _WI_STRING_FORMAT_PTRDIFF:		*(va_arg(ap, ptrdiff_t *)) = totalsize;			break;
 #endif
-				else if(z)
-					*(va_arg(ap, size_t *)) = totalsize;
-				break;
-			
-			case 's':
-				s = va_arg(ap, char *);
-				
-				if(s) {
-					if(star)
-						size = wi_asprintf(&vbuffer, cfmt, length, s);
-					else
-						size = wi_asprintf(&vbuffer, cfmt, s);
-					
-					if(size > 0 && vbuffer) {
-						_wi_string_append_bytes(string, vbuffer, size);
-						totalsize += size;
-						free(vbuffer);
-					}
-				}
-				else if(!alt) {
-					_wi_string_append_cstring(string, "(null)");
-					totalsize += 6;
+					case _WI_STRING_FORMAT_SIZE:		*(va_arg(ap, size_t *)) = totalsize;			break;
+					default:							*(va_arg(ap, int *)) = totalsize;				break;
 				}
 				break;
-			
-			case 'z':
-				z = true;
-				
-				goto nextflag;
-				break;
-				
-			default:
-				if(ch == '\0')
-					return;
-				
-				buffer[0] = ch;
 
-				_wi_string_append_bytes(string, buffer, 1);
-				totalsize += 1;
+			default:
+				_wi_string_append_bytes(string, &spec->conversion, 1);
 				break;
 		}
 	}
@@ -798,6 +1220,118 @@ nextflag:
 
 
 
+static void _wi_string_append_integer(wi_string_t *string, unsigned long long value, wi_boolean_t negative, unsigned int base, wi_boolean_t uppercase, int width, uint16_t flags) {
+	static const char		digits[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+	const char				*hexdigits;
+	char					buffer[_WI_STRING_FORMAT_BUFSIZ], *p, *s;
+	wi_uinteger_t			length, size, padding;
+
+	p = buffer + sizeof(buffer);
+
+	if(base == 10) {
+		while(value >= 100) {
+			p -= 2;
+			memcpy(p, &digits[(value % 100) * 2], 2);
+			value /= 100;
+		}
+
+		if(value >= 10) {
+			p -= 2;
+			memcpy(p, &digits[value * 2], 2);
+		} else {
+			*--p = '0' + value;
+		}
+	} else {
+		hexdigits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+
+		do {
+			*--p = hexdigits[value % base];
+			value /= base;
+		} while(value > 0);
+	}
+
+	length		= (buffer + sizeof(buffer)) - p;
+	size		= length + (negative ? 1 : 0);
+	padding		= (width > 0 && (wi_uinteger_t) width > size) ? width - size : 0;
+
+	_WI_STRING_GROW(string, size + padding);
+
+	s = string->string + string->length;
+
+	if(padding > 0 && !(flags & (_WI_STRING_FORMAT_LEFT | _WI_STRING_FORMAT_ZERO))) {
+		memset(s, ' ', padding);
+		s += padding;
+	}
+
+	if(negative)
+		*s++ = '-';
+
+	if(padding > 0 && (flags & _WI_STRING_FORMAT_ZERO) && !(flags & _WI_STRING_FORMAT_LEFT)) {
+		memset(s, '0', padding);
+		s += padding;
+	}
+
+	memcpy(s, p, length);
+	s += length;
+
+	if(padding > 0 && (flags & _WI_STRING_FORMAT_LEFT)) {
+		memset(s, ' ', padding);
+		s += padding;
+	}
+
+	*s = '\0';
+
+	string->length = s - string->string;
+}
+
+
+
+static void _wi_string_append_padded_bytes(wi_string_t *string, const void *bytes, wi_uinteger_t length, int width, uint16_t flags) {
+	wi_uinteger_t		padding;
+	char				*s;
+
+	padding = (width > 0 && (wi_uinteger_t) width > length) ? width - length : 0;
+
+	if(padding == 0) {
+		_wi_string_append_bytes(string, bytes, length);
+
+		return;
+	}
+
+	_WI_STRING_GROW(string, length + padding);
+
+	s = string->string + string->length;
+
+	if(!(flags & _WI_STRING_FORMAT_LEFT)) {
+		memset(s, ' ', padding);
+		s += padding;
+	}
+
+	memcpy(s, bytes, length);
+	s += length;
+
+	if(flags & _WI_STRING_FORMAT_LEFT) {
+		memset(s, ' ', padding);
+		s += padding;
+	}
+
+	*s = '\0';
+
+	string->length = s - string->string;
+}
+
+
+
 static void _wi_string_append_cstring(wi_string_t *string, const char *cstring) {
 	_wi_string_append_bytes(string, cstring, strlen(cstring));
 }
@@ -1088,6 +1622,26 @@ wi_range_t wi_string_range_of_string_in_range(wi_string_t *string, wi_string_t *
 
 
 
+static wi_boolean_t _wi_string_is_case_insensitive_search(wi_string_t *string, wi_uinteger_t options) {
+	wi_uinteger_t	i;
+
+	if(options & WI_STRING_CASE_INSENSITIVE)
+		return true;
+
+	if(options & WI_STRING_SMART_CASE_INSENSITIVE) {
+		for(i = 0; i < string->length; i++) {
+			if(isupper((unsigned char) string->string[i]))
+				return false;
+		}
+		
+		return true;
+	}
+	
+	return false;
+}
+
+
+
 wi_uinteger_t wi_string_index_of_string(wi_string_t *string, wi_string_t *otherstring, wi_uinteger_t options) {
 	return wi_string_index_of_string_in_range(string, otherstring, options, wi_make_range(0, string->length));
 }
@@ -1095,81 +1649,61 @@ wi_uinteger_t wi_string_index_of_string(wi_string_t *string, wi_string_t *others
 
 
 wi_uinteger_t wi_string_index_of_string_in_range(wi_string_t *string, wi_string_t *otherstring, wi_uinteger_t options, wi_range_t range) {
-	char			*p;
-	wi_uinteger_t	i, index;
-	wi_boolean_t	insensitive = false;
+	const char		*p, *bytes;
+	wi_boolean_t	insensitive;
 
 	_WI_STRING_RANGE_ASSERT(string, range);
 	
 	if(range.length == 0)
 		return WI_NOT_FOUND;
 
-	if(options & WI_STRING_CASE_INSENSITIVE) {
-		insensitive = true;
-	}
-	else if(options & WI_STRING_SMART_CASE_INSENSITIVE) {
-		insensitive = true;
-		
-		for(i = 0; i < otherstring->length; i++) {
-			if(isupper(otherstring->string[i])) {
-				insensitive = false;
-				
-				break;
-			}
-		}
-	}
+	insensitive	= _wi_string_is_case_insensitive_search(otherstring, options);
+	bytes		= string->string + range.location;
 
 	if(options & WI_STRING_BACKWARDS) {
 		if(insensitive)
-			p = wi_strrncasestr(string->string + range.location, otherstring->string, range.length);
+			p = wi_memrcasemem(bytes, range.length, otherstring->string, otherstring->length);
 		else
-			p = wi_strrnstr(string->string + range.location, otherstring->string, range.length);
+			p = wi_memrmem(bytes, range.length, otherstring->string, otherstring->length);
 	} else {
 		if(insensitive)
-			p = wi_strncasestr(string->string + range.location, otherstring->string, range.length);
+			p = wi_memcasemem(bytes, range.length, otherstring->string, otherstring->length);
 		else
-			p = wi_strnstr(string->string + range.location, otherstring->string, range.length);
+			p = wi_memmem(bytes, range.length, otherstring->string, otherstring->length);
 	}
 	
 	if(!p)
 		return WI_NOT_FOUND;
 	
-	index = p - string->string;
-	
-	if(index > range.location + range.length)
-		return WI_NOT_FOUND;
-	
-	return index;
+	return p - string->string;
 }
 
 
 
 wi_uinteger_t wi_string_index_of_char(wi_string_t *string, int ch, wi_uinteger_t options) {
-	wi_uinteger_t	i, index = WI_NOT_FOUND;
-	char			*p;
-	int				c;
+	const char		*p;
 	wi_boolean_t	insensitive = false;
 
 	if((options & WI_STRING_CASE_INSENSITIVE) ||
-	   (options & WI_STRING_SMART_CASE_INSENSITIVE && isupper(ch))) {
+	   (options & WI_STRING_SMART_CASE_INSENSITIVE && isupper(ch)))
 		insensitive = true;
-		ch = tolower((unsigned int) ch);
-	}
-
-	p = string->string;
-	
-	for(i = 0; *p; p++, i++) {
-		c = insensitive ? tolower((unsigned int) *p) : *p;
-		
-		if(c == ch) {
-			index = i;
 
-			if(!(options & WI_STRING_BACKWARDS))
-				break;
-		}
+	if(options & WI_STRING_BACKWARDS) {
+		if(insensitive)
+			p = wi_memrcasechr(string->string, ch, string->length);
+		else
+			p = wi_memrchr(string->string, ch, string->length);
+	} else {
+		if(insensitive)
+			p = wi_memcasechr(string->string, ch, string->length);
+		else
+			p = memchr(string->string, ch, string->length);
 	}
 	
-	return index;
+	if(!p)
+		return WI_NOT_FOUND;
+	
+	return p - string->string;
 }
 
  
@@ -1236,21 +1770,19 @@ wi_string_t * wi_string_uppercase_string(wi_string_t *string) {
 #pragma mark -
 
 static wi_mutable_array_t * _wi_string_path_components(wi_string_t *path) {
-	wi_array_t		*array, *components;
-	wi_string_t		*component;
-	wi_uinteger_t	i, count;
+	wi_mutable_array_t		*array;
+	wi_string_t				*component;
+	wi_path_iterator_t		iterator;
+	wi_range_t				range;
 	
-	components	= wi_string_components_separated_by_string(path, WI_STR("/"));
-	count		= wi_array_count(components);
-	array		= wi_array_init_with_capacity(wi_mutable_array_alloc(), count);
-
-	for(i = 0; i < count; i++) {
-		component = WI_ARRAY(components, i);
+	array = wi_array_init_with_capacity(wi_mutable_array_alloc(), wi_path_count_components(path->string, path->length));
+	
+	wi_path_iterator_init(&iterator, path->string, path->length);
 
-		if(wi_string_length(component) > 0)
-			wi_mutable_array_add_data(array, component);
-		else if(i == 0)
-			wi_mutable_array_add_data(array, WI_STR("/"));
+	while(wi_path_iterator_next(&iterator, &range)) {
+		component = wi_string_init_with_bytes(wi_string_alloc(), path->string + range.location, range.length);
+		wi_mutable_array_add_data(array, component);
+		wi_release(component);
 	}
 
 	return wi_autorelease(array);
@@ -1342,31 +1874,13 @@ wi_string_t * wi_string_by_appending_path_components(wi_string_t *path, wi_array
 
 wi_string_t * wi_string_last_path_component(wi_string_t *path) {
 	wi_range_t			range;
-	wi_uinteger_t		length, index;
 
-	if(wi_is_equal(path, WI_STR("/")))
-		return path;
+	range = wi_path_last_component_range(path->string, path->length);
 
-	length	= wi_string_length(path);
-	range 	= wi_make_range(0, length);
-
-	while(true) {
-		index = wi_string_index_of_string_in_range(path, WI_STR("/"), WI_STRING_BACKWARDS, range);
-
-		if(index == WI_NOT_FOUND) {
-			return path;
-		}
-		else if(index == length - 1) {
-			range.length--;
-
-			if(range.length == 0)
-				return WI_STR("/");
-
-			continue;
-		}
+	if(range.location == 0 && range.length == path->length)
+		return path;
 
-		return wi_string_substring_with_range(path, wi_make_range(index + 1, range.length - index - 1));
-	}
+	return wi_string_substring_with_range(path, range);
 }
 
 
@@ -1386,12 +1900,12 @@ wi_string_t * wi_string_by_appending_path_extension(wi_string_t *path, wi_string
 
 
 wi_string_t * wi_string_path_extension(wi_string_t *path) {
-	wi_uinteger_t	index;
+	wi_range_t		range;
 	
-	index = wi_string_index_of_char(path, '.', WI_STRING_BACKWARDS);
+	range = wi_path_extension_range(path->string, path->length);
 
-	if(index != WI_NOT_FOUND && index + 1 < path->length)
-		return wi_string_by_deleting_characters_to_index(path, index + 1);
+	if(range.location != WI_NOT_FOUND && range.length > 0)
+		return wi_string_substring_with_range(path, range);
 	
 	return WI_STR("");
 }
@@ -1438,67 +1952,51 @@ wi_boolean_t wi_string_bool(wi_string_t *string) {
 
 
 int32_t wi_string_int32(wi_string_t *string) {
-	long		l;
-	char		*ep;
+	int64_t		value;
 	
-	errno = 0;
-	l = strtol(string->string, &ep, 0);
-	
-	if(string->string == ep || *ep != '\0' || errno == ERANGE)
+	if(!wi_numeric_parse_int64(string->string, string->length, &value))
 		return 0;
 	
-	if(l > INT32_MAX || l < INT32_MIN)
+	if(value > INT32_MAX || value < INT32_MIN)
 		return 0;
 	
-	return (int32_t) l;
+	return (int32_t) value;
 }
 
 
 
 uint32_t wi_string_uint32(wi_string_t *string) {
-	unsigned long	ul;
-	char			*ep;
-	
-	errno = 0;
-	ul = strtoul(string->string, &ep, 0);
+	uint64_t	value;
 	
-	if(string->string == ep || *ep != '\0' || errno == ERANGE)
+	if(!wi_numeric_parse_uint64(string->string, string->length, &value))
 		return 0;
 	
-	if(ul > UINT32_MAX)
+	if(value > UINT32_MAX)
 		return 0;
 	
-	return (uint32_t) ul;
+	return (uint32_t) value;
 }
 
 
 
 int64_t wi_string_int64(wi_string_t *string) {
-	long long	ll;
-	char		*ep;
+	int64_t		value;
 	
-	errno = 0;
-	ll = strtoll(string->string, &ep, 0);
-	
-	if(string->string == ep || *ep != '\0' || errno == ERANGE)
+	if(!wi_numeric_parse_int64(string->string, string->length, &value))
 		return 0;
 	
-	return (int64_t) ll;
+	return value;
 }
 
 
 
 uint64_t wi_string_uint64(wi_string_t *string) {
-	unsigned long long	ull;
-	char				*ep;
-	
-	errno = 0;
-	ull = strtoull(string->string, &ep, 0);
+	uint64_t	value;
 	
-	if(string->string == ep || *ep != '\0' || errno == ERANGE)
+	if(!wi_numeric_parse_uint64(string->string, string->length, &value))
 		return 0ULL;
 	
-	return (uint64_t) ull;
+	return value;
 }
 
 
@@ -1524,34 +2022,26 @@ wi_uinteger_t wi_string_uinteger(wi_string_t *string) {
 
 
 float wi_string_float(wi_string_t *string) {
-	double		d;
-	char		*ep;
+	double		value;
 	
-	errno = 0;
-	d = strtod(string->string, &ep);
-	
-	if(string->string == ep || *ep != '\0' || errno == ERANGE)
+	if(!wi_numeric_parse_double(string->string, string->length, &value))
 		return 0.0;
 	
-	if(d > FLT_MAX || d < FLT_MIN)
+	if(value > FLT_MAX || value < -FLT_MAX)
 		return 0.0;
 	
-	return (float) d;
+	return (float) value;
 }
 
 
 
 double wi_string_double(wi_string_t *string) {
-	double		d;
-	char		*ep;
-	
-	errno = 0;
-	d = strtod(string->string, &ep);
+	double		value;
 	
-	if(string->string == ep || *ep != '\0' || errno == ERANGE)
+	if(!wi_numeric_parse_double(string->string, string->length, &value))
 		return 0.0;
 	
-	return d;
+	return value;
 }
 
 
@@ -1715,7 +2205,7 @@ void wi_mutable_string_append_format(wi_mutable_string_t *string, wi_string_t *f
 	WI_RUNTIME_ASSERT_MUTABLE(string);
 	
 	va_start(ap, fmt);
-	_wi_string_append_arguments(string, wi_string_cstring(fmt), ap);
+	_wi_string_append_arguments(string, fmt, ap);
 	va_end(ap);
 }
 
@@ -1724,7 +2214,7 @@ void wi_mutable_string_append_format(wi_mutable_string_t *string, wi_string_t *f
 void wi_mutable_string_append_format_and_arguments(wi_mutable_string_t *string, wi_string_t *fmt, va_list ap) {
 	WI_RUNTIME_ASSERT_MUTABLE(string);
 	
-	_wi_string_append_arguments(string, wi_string_cstring(fmt), ap);
+	_wi_string_append_arguments(string, fmt, ap);
 }
 
 
@@ -1841,52 +2331,15 @@ void wi_mutable_string_delete_surrounding_whitespace(wi_mutable_string_t *string
 #pragma mark -
 
 void wi_mutable_string_normalize_path(wi_mutable_string_t *path) {
-	wi_mutable_array_t		*array;
-	wi_string_t				*component, *string;
-	wi_boolean_t			absolute;
-	wi_uinteger_t			i, count;
-	
 	WI_RUNTIME_ASSERT_MUTABLE(path);
 	
-	if(wi_string_length(path) == 0 || wi_is_equal(path, WI_STR("/")))
-	   return;
+	if(path->length == 0)
+		return;
 
 	wi_mutable_string_expand_tilde_in_path(path);
-
-	absolute	= wi_string_has_prefix(path, WI_STR("/"));
-	array		= _wi_string_path_components(path);
-	count		= wi_array_count(array);
 	
-	for(i = 0; i < count; i++) {
-		component = WI_ARRAY(array, i);
-
-		if(wi_string_length(component) == 0 || wi_is_equal(component, WI_STR("/"))) {
-			wi_mutable_array_remove_data_at_index(array, i);
-
-			i--;
-			count--;
-		}
-		else if(wi_is_equal(component, WI_STR("."))) {
-			wi_mutable_array_remove_data_at_index(array, i);
-			
-			i--;
-			count--;
-		}
-		else if(absolute && wi_is_equal(component, WI_STR("..")) && i > 0) {
-			wi_mutable_array_remove_data_at_index(array, i - 1);
-			wi_mutable_array_remove_data_at_index(array, i - 1);
-			
-			i -= 2;
-			count -= 2;
-		}
-	}
-	
-	string = wi_array_components_joined_by_string(array, WI_STR("/"));
-	
-	if(wi_string_has_prefix(path, WI_STR("/")))
-		wi_mutable_string_set_format(path, WI_STR("/%@"), string);
-	else
-		wi_mutable_string_set_string(path, string);
+	path->length = wi_path_normalize(path->string, path->length);
+	path->string[path->length] = '\0';
 }
 
 
@@ -1985,18 +2438,9 @@ void wi_mutable_string_expand_tilde_in_path(wi_mutable_string_t *path) {
 void wi_mutable_string_append_path_component(wi_mutable_string_t *path, wi_string_t *component) {
 	WI_RUNTIME_ASSERT_MUTABLE(path);
 	
-	if(wi_string_length(path) == 0) {
-		wi_mutable_string_append_string(path, component);
-	}
-	else if(wi_string_has_suffix(path, WI_STR("/"))) {
-		if(wi_string_has_prefix(component, WI_STR("/")))
-		   wi_mutable_string_delete_characters_from_index(path, path->length - 1);
-
-		wi_mutable_string_append_string(path, component);
-	}
-	else if(!wi_is_equal(component, WI_STR("/"))) {
-	   wi_mutable_string_append_format(path, WI_STR("/%@"), component);
-	}
+	_WI_STRING_GROW(path, component->length + 1);
+	
+	path->length = wi_path_append_component(path->string, path->length, path->capacity, component->string, component->length);
 }
 
 
@@ -2015,25 +2459,12 @@ void wi_mutable_string_append_path_components(wi_mutable_string_t *path, wi_arra
 
 
 void wi_mutable_string_delete_last_path_component(wi_mutable_string_t *path) {
-	wi_mutable_array_t		*array;
-	wi_string_t				*string;
-	wi_uinteger_t			count;
-	
 	WI_RUNTIME_ASSERT_MUTABLE(path);
 	
-	if(wi_is_equal(path, WI_STR("/")))
-		return;
-	
-	array = _wi_string_path_components(path);
-	count = wi_array_count(array);
+	path->length = wi_path_parent_length(path->string, path->length);
+	path->string[path->length] = '\0';
 	
-	if(count > 0) {
-		wi_mutable_array_remove_data_at_index(array, count - 1);
-		
-		string = wi_array_components_joined_by_string(array, WI_STR("/"));
-		wi_mutable_string_set_string(path, string);
-		wi_mutable_string_normalize_path(path);
-	}
+	wi_mutable_string_normalize_path(path);
 }
 
 
@@ -2047,14 +2478,14 @@ void wi_mutable_string_append_path_extension(wi_mutable_string_t *path, wi_strin
 
 
 void wi_mutable_string_delete_path_extension(wi_mutable_string_t *path) {
-	wi_uinteger_t	index;
+	wi_range_t		range;
 	
 	WI_RUNTIME_ASSERT_MUTABLE(path);
 	
-	index = wi_string_index_of_char(path, '.', WI_STRING_BACKWARDS);
+	range = wi_path_extension_range(path->string, path->length);
 
-	if(index != WI_NOT_FOUND)
-		wi_mutable_string_delete_characters_from_index(path, index);
+	if(range.location != WI_NOT_FOUND)
+		wi_mutable_string_delete_characters_from_index(path, range.location - 1);
 }
 
 
@@ -2184,3 +2615,143 @@ wi_string_t * wi_string_encoding_charset(wi_string_encoding_t *encoding) {
 }
 
 #endif /* WI_ICONV */
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_string_matcher_runtime_id(void) {
+	return _wi_string_matcher_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_string_matcher_t * wi_string_matcher_with_string(wi_string_t *string, wi_uinteger_t options) {
+	return wi_autorelease(wi_string_matcher_init_with_string(wi_string_matcher_alloc(), string, options));
+}
+
+
+
+#pragma mark -
+
+wi_string_matcher_t * wi_string_matcher_alloc(void) {
+	return wi_runtime_create_instance_with_options(_wi_string_matcher_runtime_id, sizeof(wi_string_matcher_t), WI_RUNTIME_OPTION_IMMUTABLE);
+}
+
+
+
+wi_string_matcher_t * wi_string_matcher_init_with_string(wi_string_matcher_t *matcher, wi_string_t *string, wi_uinteger_t options) {
+	wi_uinteger_t		i, frequency, frequency1, frequency2;
+	
+	matcher->string			= wi_copy(string);
+	matcher->insensitive	= _wi_string_is_case_insensitive_search(string, options);
+	matcher->backwards		= ((options & WI_STRING_BACKWARDS) != 0);
+	
+	if(string->length > 1) {
+		frequency1 = frequency2 = WI_UINTEGER_MAX;
+		
+		for(i = 0; i < string->length; i++) {
+			frequency = _wi_string_matcher_byte_frequency(string->string[i]);
+			
+			if(frequency < frequency1) {
+				matcher->anchor2	= matcher->anchor1;
+				frequency2			= frequency1;
+				matcher->anchor1	= i;
+				frequency1			= frequency;
+			}
+			else if(frequency < frequency2) {
+				matcher->anchor2	= i;
+				frequency2			= frequency;
+			}
+		}
+		
+		if(matcher->anchor1 == matcher->anchor2)
+			matcher->anchor2 = (matcher->anchor1 == 0) ? string->length - 1 : 0;
+	}
+	
+	return matcher;
+}
+
+
+
+static void _wi_string_matcher_dealloc(wi_runtime_instance_t *instance) {
+	wi_string_matcher_t		*matcher = instance;
+	
+	wi_release(matcher->string);
+}
+
+
+
+static wi_string_t * _wi_string_matcher_description(wi_runtime_instance_t *instance) {
+	wi_string_matcher_t		*matcher = instance;
+	
+	return wi_string_with_format(WI_STR("<%@ %p>{string = %@, insensitive = %d, backwards = %d}"),
+		wi_runtime_class_name(matcher),
+		matcher,
+		matcher->string,
+		matcher->insensitive,
+		matcher->backwards);
+}
+
+
+
+#pragma mark -
+
+static wi_uinteger_t _wi_string_matcher_byte_frequency(unsigned char ch) {
+	static const char		bytes[] = "zqjxkvbywgpfmucdlhrsniotae ._-";
+	const char				*p;
+	
+	if(ch == '\0')
+		return 0;
+	
+	p = strchr(bytes, tolower(ch));
+	
+	return p ? (wi_uinteger_t) (p - bytes) + 1 : 0;
+}
+
+
+
+#pragma mark -
+
+wi_string_t * wi_string_matcher_string(wi_string_matcher_t *matcher) {
+	return matcher->string;
+}
+
+
+
+wi_uinteger_t wi_string_matcher_index_in_string(wi_string_matcher_t *matcher, wi_string_t *string) {
+	return wi_string_matcher_index_in_string_in_range(matcher, string, wi_make_range(0, string->length));
+}
+
+
+
+wi_uinteger_t wi_string_matcher_index_in_string_in_range(wi_string_matcher_t *matcher, wi_string_t *string, wi_range_t range) {
+	const char		*p;
+	
+	_WI_STRING_RANGE_ASSERT(string, range);
+	
+	if(range.length == 0)
+		return WI_NOT_FOUND;
+	
+	p = wi_memmem_with_anchors(string->string + range.location,
+							   range.length,
+							   matcher->string->string,
+							   matcher->string->length,
+							   matcher->anchor1,
+							   matcher->anchor2,
+							   matcher->insensitive,
+							   matcher->backwards);
+	
+	if(!p)
+		return WI_NOT_FOUND;
+	
+	return p - string->string;
+}
+
+
+
+wi_boolean_t wi_string_matcher_matches_string(wi_string_matcher_t *matcher, wi_string_t *string) {
+	return (wi_string_matcher_index_in_string(matcher, string) != WI_NOT_FOUND);
+}
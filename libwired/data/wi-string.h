@@ -40,6 +40,7 @@
 
 
 typedef struct _wi_string_encoding			wi_string_encoding_t;
+typedef struct _wi_string_matcher			wi_string_matcher_t;
 
 
 enum _wi_string_options {
@@ -88,6 +89,10 @@ WI_EXPORT char								wi_string_character_at_index(wi_string_t *, wi_uinteger_t)
 
 WI_EXPORT wi_string_t *						_wi_string_constant_string(const char *);
 
+WI_EXPORT wi_string_t *						wi_string_intern(wi_string_t *);
+WI_EXPORT wi_string_t *						wi_string_intern_cstring(const char *);
+WI_EXPORT wi_boolean_t						wi_string_is_interned(wi_string_t *);
+
 WI_EXPORT wi_string_t *						wi_string_by_appending_cstring(wi_string_t *, const char *);
 WI_EXPORT wi_string_t *						wi_string_by_appending_bytes(wi_string_t *, const void *, wi_uinteger_t);
 WI_EXPORT wi_string_t *						wi_string_by_appending_string(wi_string_t *, wi_string_t *);
@@ -203,4 +208,17 @@ WI_EXPORT wi_string_encoding_t *			wi_string_encoding_init_with_charset(wi_strin
 
 WI_EXPORT wi_string_t *						wi_string_encoding_charset(wi_string_encoding_t *);
 
+
+WI_EXPORT wi_runtime_id_t					wi_string_matcher_runtime_id(void);
+
+WI_EXPORT wi_string_matcher_t *				wi_string_matcher_with_string(wi_string_t *, wi_uinteger_t);
+
+WI_EXPORT wi_string_matcher_t *				wi_string_matcher_alloc(void);
+WI_EXPORT wi_string_matcher_t *				wi_string_matcher_init_with_string(wi_string_matcher_t *, wi_string_t *, wi_uinteger_t);
+
+WI_EXPORT wi_string_t *						wi_string_matcher_string(wi_string_matcher_t *);
+WI_EXPORT wi_uinteger_t						wi_string_matcher_index_in_string(wi_string_matcher_t *, wi_string_t *);
+WI_EXPORT wi_uinteger_t						wi_string_matcher_index_in_string_in_range(wi_string_matcher_t *, wi_string_t *, wi_range_t);
+WI_EXPORT wi_boolean_t						wi_string_matcher_matches_string(wi_string_matcher_t *, wi_string_t *);
+
 #endif /* WI_STRING_H */
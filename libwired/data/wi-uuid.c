@@ -126,7 +126,7 @@ static wi_boolean_t						_wi_uuid_get_node(unsigned char *);
 static void								_wi_uuid_get_clock(uint32_t *, uint32_t *, uint16_t *);
 
 
-static wi_lock_t						*_wi_uuid_clock_lock;
+static wi_fast_lock_t					_wi_uuid_clock_lock = WI_FAST_LOCK_INITIALIZER;
 static unsigned char					_wi_uuid_node[_WI_UUID_NODE_SIZE];
 
 static wi_runtime_id_t					_wi_uuid_runtime_id = WI_RUNTIME_ID_NULL;
@@ -148,7 +148,6 @@ void wi_uuid_register(void) {
 
 
 void wi_uuid_initialize(void) {
-	_wi_uuid_clock_lock = wi_lock_init(wi_lock_alloc());
 	
 	if(!_wi_uuid_get_node(_wi_uuid_node)) {
 		_wi_uuid_get_random_buffer(_wi_uuid_node, sizeof(_wi_uuid_node));
@@ -492,7 +491,7 @@ static void _wi_uuid_get_clock(uint32_t *clock_high, uint32_t *clock_low, uint16
 	struct timeval 			tv;
 	wi_boolean_t			tryagain;
 	
-	wi_lock_lock(_wi_uuid_clock_lock);
+	wi_fast_lock_lock(&_wi_uuid_clock_lock);
 	
 	do {
 		tryagain = false;
@@ -525,7 +524,7 @@ static void _wi_uuid_get_clock(uint32_t *clock_high, uint32_t *clock_low, uint16
 		}
 	} while(tryagain);
 
-	wi_lock_unlock(_wi_uuid_clock_lock);
+	wi_fast_lock_unlock(&_wi_uuid_clock_lock);
 		
 	clock_reg	= (tv.tv_usec * 10) + adjustment;
 	clock_reg	+= ((uint64_t) tv.tv_sec) * 10000000;
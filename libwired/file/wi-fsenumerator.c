@@ -108,6 +108,21 @@ static void _wi_fsenumerator_dealloc(wi_runtime_instance_t *instance) {
 #pragma mark -
 
 wi_fsenumerator_status_t wi_fsenumerator_get_next_path(wi_fsenumerator_t *fsenumerator, wi_string_t **path) {
+	wi_fsenumerator_status_t	status;
+	const char					*cpath;
+	wi_uinteger_t				length;
+	
+	status = wi_fsenumerator_get_next_cpath(fsenumerator, &cpath, &length);
+	
+	if(status != WI_FSENUMERATOR_EOF)
+		*path = wi_string_with_bytes(cpath, length);
+	
+	return status;
+}
+
+
+
+wi_fsenumerator_status_t wi_fsenumerator_get_next_cpath(wi_fsenumerator_t *fsenumerator, const char **path, wi_uinteger_t *length) {
 	while((fsenumerator->ftsent = wi_fts_read(fsenumerator->fts))) {
 		if(fsenumerator->ftsent->fts_level == 0)
 			continue;
@@ -120,7 +135,8 @@ wi_fsenumerator_status_t wi_fsenumerator_get_next_path(wi_fsenumerator_t *fsenum
 		
 		switch(fsenumerator->ftsent->fts_info) {
 			case WI_FTS_DC:
-				*path = wi_string_with_cstring(fsenumerator->ftsent->fts_path);
+				*path = fsenumerator->ftsent->fts_path;
+				*length = fsenumerator->ftsent->fts_pathlen;
 				wi_error_set_errno(ELOOP);
 
 				return WI_FSENUMERATOR_ERROR;
@@ -128,7 +144,8 @@ wi_fsenumerator_status_t wi_fsenumerator_get_next_path(wi_fsenumerator_t *fsenum
 
 			case WI_FTS_DNR:
 			case WI_FTS_ERR:
-				*path = wi_string_with_cstring(fsenumerator->ftsent->fts_path);
+				*path = fsenumerator->ftsent->fts_path;
+				*length = fsenumerator->ftsent->fts_pathlen;
 				wi_error_set_errno(fsenumerator->ftsent->fts_errno);
 
 				return WI_FSENUMERATOR_ERROR;
@@ -139,7 +156,8 @@ wi_fsenumerator_status_t wi_fsenumerator_get_next_path(wi_fsenumerator_t *fsenum
 				break;
 
 			default:
-				*path = wi_string_with_cstring(fsenumerator->ftsent->fts_path);
+				*path = fsenumerator->ftsent->fts_path;
+				*length = fsenumerator->ftsent->fts_pathlen;
 
 				return WI_FSENUMERATOR_PATH;
 				break;
@@ -0,0 +1,234 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <wired/wi-macros.h>
+#include <wired/wi-path.h>
+
+static wi_uinteger_t					_wi_path_append_bytes(char *, wi_uinteger_t, wi_uinteger_t, const char *, wi_uinteger_t);
+
+
+
+void wi_path_iterator_init(wi_path_iterator_t *iterator, const char *path, wi_uinteger_t length) {
+	iterator->path		= path;
+	iterator->length	= length;
+	iterator->offset	= 0;
+}
+
+
+
+wi_boolean_t wi_path_iterator_next(wi_path_iterator_t *iterator, wi_range_t *range) {
+	const char		*path = iterator->path;
+	wi_uinteger_t	i, start;
+
+	i = iterator->offset;
+
+	if(i == 0 && iterator->length > 0 && path[0] == '/') {
+		*range = wi_make_range(0, 1);
+		iterator->offset = 1;
+
+		return true;
+	}
+
+	while(i < iterator->length && path[i] == '/')
+		i++;
+
+	if(i == iterator->length) {
+		iterator->offset = i;
+
+		return false;
+	}
+
+	start = i;
+
+	while(i < iterator->length && path[i] != '/')
+		i++;
+
+	*range = wi_make_range(start, i - start);
+	iterator->offset = i;
+
+	return true;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_path_normalize(char *path, wi_uinteger_t length) {
+	wi_path_iterator_t	iterator;
+	wi_range_t			range;
+	const char			*component;
+	wi_uinteger_t		root, end;
+	wi_boolean_t		absolute;
+
+	absolute	= (length > 0 && path[0] == '/');
+	root		= absolute ? 1 : 0;
+	end			= root;
+
+	wi_path_iterator_init(&iterator, path, length);
+
+	while(wi_path_iterator_next(&iterator, &range)) {
+		component = path + range.location;
+
+		if(absolute && range.location == 0)
+			continue;
+
+		if(range.length == 1 && component[0] == '.')
+			continue;
+
+		if(absolute && range.length == 2 && component[0] == '.' && component[1] == '.') {
+			while(end > root && path[end - 1] != '/')
+				end--;
+
+			if(end > root)
+				end--;
+
+			continue;
+		}
+
+		if(end > root)
+			path[end++] = '/';
+
+		memmove(path + end, component, range.length);
+
+		end += range.length;
+	}
+
+	/* never terminated here, the buffer may hold exactly length bytes */
+	return end;
+}
+
+
+
+wi_uinteger_t wi_path_append_component(char *path, wi_uinteger_t length, wi_uinteger_t size, const char *component, wi_uinteger_t componentlength) {
+	if(length == 0)
+		return _wi_path_append_bytes(path, 0, size, component, componentlength);
+
+	if(path[length - 1] == '/') {
+		if(componentlength > 0 && component[0] == '/')
+			length--;
+
+		return _wi_path_append_bytes(path, length, size, component, componentlength);
+	}
+
+	if(componentlength == 1 && component[0] == '/')
+		return length;
+
+	length = _wi_path_append_bytes(path, length, size, "/", 1);
+
+	return _wi_path_append_bytes(path, length, size, component, componentlength);
+}
+
+
+
+static wi_uinteger_t _wi_path_append_bytes(char *path, wi_uinteger_t length, wi_uinteger_t size, const char *bytes, wi_uinteger_t count) {
+	wi_uinteger_t	copy;
+
+	if(length + 1 < size) {
+		copy = WI_MIN(count, size - length - 1);
+
+		memmove(path + length, bytes, copy);
+
+		path[length + copy] = '\0';
+	}
+
+	return length + count;
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_path_count_components(const char *path, wi_uinteger_t length) {
+	wi_path_iterator_t	iterator;
+	wi_range_t			range;
+	wi_uinteger_t		count = 0;
+
+	wi_path_iterator_init(&iterator, path, length);
+
+	while(wi_path_iterator_next(&iterator, &range))
+		count++;
+
+	return count;
+}
+
+
+
+wi_range_t wi_path_last_component_range(const char *path, wi_uinteger_t length) {
+	wi_uinteger_t	start, end;
+
+	end = length;
+
+	while(end > 0 && path[end - 1] == '/')
+		end--;
+
+	if(end == 0)
+		return wi_make_range(0, (length > 0) ? 1 : 0);
+
+	start = end;
+
+	while(start > 0 && path[start - 1] != '/')
+		start--;
+
+	return wi_make_range(start, end - start);
+}
+
+
+
+wi_uinteger_t wi_path_parent_length(const char *path, wi_uinteger_t length) {
+	wi_uinteger_t	end;
+
+	end = wi_path_last_component_range(path, length).location;
+
+	while(end > 0 && path[end - 1] == '/')
+		end--;
+
+	if(end == 0 && length > 0 && path[0] == '/')
+		return 1;
+
+	return end;
+}
+
+
+
+wi_range_t wi_path_extension_range(const char *path, wi_uinteger_t length) {
+	wi_range_t		range;
+	wi_uinteger_t	i;
+
+	range = wi_path_last_component_range(path, length);
+
+	for(i = range.location + range.length; i > range.location; i--) {
+		if(path[i - 1] == '.')
+			return wi_make_range(i, range.location + range.length - i);
+	}
+
+	return wi_make_range(WI_NOT_FOUND, 0);
+}
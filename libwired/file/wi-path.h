@@ -0,0 +1,52 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_PATH_H
+#define WI_PATH_H 1
+
+#include <wired/wi-base.h>
+
+struct _wi_path_iterator {
+	const char							*path;
+	wi_uinteger_t						length;
+	wi_uinteger_t						offset;
+};
+typedef struct _wi_path_iterator		wi_path_iterator_t;
+
+
+WI_EXPORT void							wi_path_iterator_init(wi_path_iterator_t *, const char *, wi_uinteger_t);
+WI_EXPORT wi_boolean_t					wi_path_iterator_next(wi_path_iterator_t *, wi_range_t *);
+
+WI_EXPORT wi_uinteger_t					wi_path_normalize(char *, wi_uinteger_t);
+WI_EXPORT wi_uinteger_t					wi_path_append_component(char *, wi_uinteger_t, wi_uinteger_t, const char *, wi_uinteger_t);
+WI_EXPORT wi_uinteger_t					wi_path_count_components(const char *, wi_uinteger_t);
+WI_EXPORT wi_range_t					wi_path_last_component_range(const char *, wi_uinteger_t);
+WI_EXPORT wi_uinteger_t					wi_path_parent_length(const char *, wi_uinteger_t);
+WI_EXPORT wi_range_t					wi_path_extension_range(const char *, wi_uinteger_t);
+
+#endif /* WI_PATH_H */
@@ -67,8 +67,6 @@
 #include <wired/wi-string.h>
 #include <wired/wi-thread.h>
 
-#define _WI_ERROR_THREAD_KEY			"_wi_error_t"
-
 
 struct _wi_error {
 	wi_runtime_base_t					base;
@@ -100,6 +98,9 @@ static const char 						*_wi_error_strings[] = {
 	/* WI_ERROR_CIPHER_CIPHERNOTSUPP */
 	"Cipher not supported",
 	
+	/* WI_ERROR_EVENT_LOOP_NOTSUPP */
+	"No compatible API available",
+	
 	/* WI_ERROR_FILE_NOCARBON */
 	"Carbon not supported",
 
@@ -245,7 +246,7 @@ static void _wi_error_dealloc(wi_runtime_instance_t *instance) {
 static wi_error_t * _wi_error_get_error(void) {
 	wi_error_t		*error;
 	
-	error = wi_dictionary_data_for_key(wi_thread_dictionary(), WI_STR(_WI_ERROR_THREAD_KEY));
+	error = wi_thread_error(wi_thread_current_thread());
 
 	WI_ASSERT(error != NULL, "no wi_error_t created for thread", 0);
 	
@@ -269,7 +270,7 @@ void wi_error_enter_thread(void) {
 	wi_error_t		*error;
 
 	error = _wi_error_init(_wi_error_alloc());
-	wi_mutable_dictionary_set_data_for_key(wi_thread_dictionary(), error, WI_STR(_WI_ERROR_THREAD_KEY));
+	wi_thread_set_error(wi_thread_current_thread(), error);
 	wi_release(error);
 	
 	wi_error_set_error(WI_ERROR_DOMAIN_NONE, WI_ERROR_NONE);
@@ -290,8 +291,10 @@ void wi_error_set_error(wi_error_domain_t domain, int code) {
 	error->domain	= domain;
 	error->code		= code;
 
-	wi_release(error->string);
-	error->string = NULL;
+	if(error->string) {
+		wi_release(error->string);
+		error->string = NULL;
+	}
 }
 
 
@@ -60,6 +60,8 @@ enum _wi_error_code {
 	
 	WI_ERROR_CIPHER_CIPHERNOTSUPP,
 	
+	WI_ERROR_EVENT_LOOP_NOTSUPP,
+	
 	WI_ERROR_FILE_NOCARBON,
 	
 	WI_ERROR_FSEVENTS_NOTSUPP,
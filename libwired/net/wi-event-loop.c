@@ -0,0 +1,654 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_EVENTFD_H) && defined(HAVE_SYS_TIMERFD_H)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#define _WI_EVENT_LOOP_EPOLL
+#endif
+
+#include <wired/wi-dictionary.h>
+#include <wired/wi-error.h>
+#include <wired/wi-event-loop.h>
+#include <wired/wi-lock.h>
+#include <wired/wi-log.h>
+#include <wired/wi-pool.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-socket.h>
+#include <wired/wi-string.h>
+#include <wired/wi-system.h>
+#include <wired/wi-timer.h>
+
+#define _WI_EVENT_LOOP_MAX_EVENTS			64
+
+
+enum _wi_event_loop_source_type {
+	_WI_EVENT_LOOP_SOURCE_WAKEUP,
+	_WI_EVENT_LOOP_SOURCE_SOCKET,
+	_WI_EVENT_LOOP_SOURCE_TIMER
+};
+typedef enum _wi_event_loop_source_type		_wi_event_loop_source_type_t;
+
+
+struct _wi_event_loop_source {
+	_wi_event_loop_source_type_t			type;
+	int										fd;
+	
+	wi_runtime_instance_t					*instance;
+	wi_event_loop_socket_func_t				*func;
+	wi_boolean_t							armed;
+	wi_boolean_t							repeats;
+	
+	struct _wi_event_loop_source			*previous, *next;
+};
+typedef struct _wi_event_loop_source		_wi_event_loop_source_t;
+
+
+struct _wi_event_loop_perform {
+	wi_event_loop_func_t					*func;
+	wi_runtime_instance_t					*instance;
+};
+typedef struct _wi_event_loop_perform		_wi_event_loop_perform_t;
+
+
+struct _wi_event_loop {
+	wi_runtime_base_t						base;
+	
+#ifdef _WI_EVENT_LOOP_EPOLL
+	int										epoll;
+	_wi_event_loop_source_t					wakeup;
+#endif
+	
+	wi_lock_t								*lock;
+	wi_mutable_dictionary_t					*sources_for_instances;
+	_wi_event_loop_source_t					*sources;
+	_wi_event_loop_source_t					*dead_sources;
+	
+	_wi_event_loop_perform_t				*performs;
+	wi_uinteger_t							performs_count;
+	wi_uinteger_t							performs_capacity;
+	
+	wi_boolean_t							stopped;
+};
+
+
+static void									_wi_event_loop_dealloc(wi_runtime_instance_t *);
+
+#ifdef _WI_EVENT_LOOP_EPOLL
+static void									_wi_event_loop_wakeup(wi_event_loop_t *);
+static void									_wi_event_loop_perform_functions(wi_event_loop_t *);
+
+static _wi_event_loop_source_t *			_wi_event_loop_add_source(wi_event_loop_t *, _wi_event_loop_source_type_t, int, wi_runtime_instance_t *);
+static void									_wi_event_loop_remove_source(wi_event_loop_t *, _wi_event_loop_source_t *);
+static void									_wi_event_loop_free_dead_sources(wi_event_loop_t *);
+
+#ifdef WI_PTHREADS
+static void									_wi_event_loop_fire_timer(wi_event_loop_t *, _wi_event_loop_source_t *);
+#endif
+#endif
+
+
+static wi_runtime_id_t						_wi_event_loop_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t					_wi_event_loop_runtime_class = {
+	"wi_event_loop_t",
+	_wi_event_loop_dealloc,
+	NULL,
+	NULL,
+	NULL,
+	NULL
+};
+
+
+
+void wi_event_loop_register(void) {
+	_wi_event_loop_runtime_id = wi_runtime_register_class(&_wi_event_loop_runtime_class);
+}
+
+
+
+void wi_event_loop_initialize(void) {
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_event_loop_runtime_id(void) {
+	return _wi_event_loop_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_event_loop_t * wi_event_loop_alloc(void) {
+	return wi_runtime_create_instance(_wi_event_loop_runtime_id, sizeof(wi_event_loop_t));
+}
+
+
+
+wi_event_loop_t * wi_event_loop_init(wi_event_loop_t *loop) {
+#ifdef _WI_EVENT_LOOP_EPOLL
+	struct epoll_event		event;
+	
+	loop->epoll			= -1;
+	loop->wakeup.fd		= -1;
+	
+	loop->lock			= wi_lock_init(wi_lock_alloc());
+	loop->sources_for_instances = wi_dictionary_init_with_capacity_and_callbacks(wi_mutable_dictionary_alloc(), 0,
+		wi_dictionary_null_key_callbacks, wi_dictionary_null_value_callbacks);
+	
+	loop->epoll = epoll_create1(EPOLL_CLOEXEC);
+	
+	if(loop->epoll < 0) {
+		wi_error_set_errno(errno);
+		
+		wi_release(loop);
+		
+		return NULL;
+	}
+	
+	loop->wakeup.type	= _WI_EVENT_LOOP_SOURCE_WAKEUP;
+	loop->wakeup.fd		= eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	
+	if(loop->wakeup.fd < 0) {
+		wi_error_set_errno(errno);
+		
+		wi_release(loop);
+		
+		return NULL;
+	}
+	
+	event.events		= EPOLLIN;
+	event.data.ptr		= &loop->wakeup;
+	
+	if(epoll_ctl(loop->epoll, EPOLL_CTL_ADD, loop->wakeup.fd, &event) < 0) {
+		wi_error_set_errno(errno);
+		
+		wi_release(loop);
+		
+		return NULL;
+	}
+	
+	return loop;
+#else
+	wi_error_set_libwired_error(WI_ERROR_EVENT_LOOP_NOTSUPP);
+	
+	wi_release(loop);
+	
+	return NULL;
+#endif
+}
+
+
+
+static void _wi_event_loop_dealloc(wi_runtime_instance_t *instance) {
+	wi_event_loop_t		*loop = instance;
+	wi_uinteger_t		i;
+	
+#ifdef _WI_EVENT_LOOP_EPOLL
+	while(loop->sources)
+		_wi_event_loop_remove_source(loop, loop->sources);
+	
+	_wi_event_loop_free_dead_sources(loop);
+	
+	if(loop->wakeup.fd >= 0)
+		close(loop->wakeup.fd);
+	
+	if(loop->epoll >= 0)
+		close(loop->epoll);
+#endif
+	
+	for(i = 0; i < loop->performs_count; i++)
+		wi_release(loop->performs[i].instance);
+	
+	if(loop->performs)
+		wi_free(loop->performs);
+	
+	wi_release(loop->sources_for_instances);
+	wi_release(loop->lock);
+}
+
+
+
+#pragma mark -
+
+#ifdef _WI_EVENT_LOOP_EPOLL
+
+static void _wi_event_loop_wakeup(wi_event_loop_t *loop) {
+	uint64_t		value = 1;
+	
+	if(write(loop->wakeup.fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+		wi_log_warn(WI_STR("Could not wake up event loop: %s"), strerror(errno));
+}
+
+
+
+static void _wi_event_loop_perform_functions(wi_event_loop_t *loop) {
+	_wi_event_loop_perform_t	*performs;
+	uint64_t					value;
+	wi_uinteger_t				i, count;
+	
+	(void) read(loop->wakeup.fd, &value, sizeof(value));
+	
+	wi_lock_lock(loop->lock);
+	
+	performs					= loop->performs;
+	count						= loop->performs_count;
+	
+	loop->performs				= NULL;
+	loop->performs_count		= 0;
+	loop->performs_capacity		= 0;
+	
+	wi_lock_unlock(loop->lock);
+	
+	for(i = 0; i < count; i++) {
+		(*performs[i].func)(loop, performs[i].instance);
+		
+		wi_release(performs[i].instance);
+	}
+	
+	if(performs)
+		wi_free(performs);
+}
+
+
+
+#pragma mark -
+
+static _wi_event_loop_source_t * _wi_event_loop_add_source(wi_event_loop_t *loop, _wi_event_loop_source_type_t type, int fd, wi_runtime_instance_t *instance) {
+	_wi_event_loop_source_t		*source;
+	struct epoll_event			event;
+	
+	source				= wi_malloc(sizeof(_wi_event_loop_source_t));
+	source->type		= type;
+	source->fd			= fd;
+	
+	event.events		= EPOLLIN;
+	event.data.ptr		= source;
+	
+	if(epoll_ctl(loop->epoll, EPOLL_CTL_ADD, fd, &event) < 0) {
+		wi_error_set_errno(errno);
+		
+		wi_free(source);
+		
+		return NULL;
+	}
+	
+	source->instance	= wi_retain(instance);
+	source->next		= loop->sources;
+	
+	if(loop->sources)
+		loop->sources->previous = source;
+	
+	loop->sources = source;
+	
+	wi_mutable_dictionary_set_data_for_key(loop->sources_for_instances, source, instance);
+	
+	return source;
+}
+
+
+
+static void _wi_event_loop_remove_source(wi_event_loop_t *loop, _wi_event_loop_source_t *source) {
+	epoll_ctl(loop->epoll, EPOLL_CTL_DEL, source->fd, NULL);
+	
+	if(source->type == _WI_EVENT_LOOP_SOURCE_TIMER) {
+		close(source->fd);
+		
+#ifdef WI_PTHREADS
+		wi_timer_set_scheduled(source->instance, false);
+#endif
+	}
+	
+	source->fd = -1;
+	
+	if(source->previous)
+		source->previous->next = source->next;
+	else
+		loop->sources = source->next;
+	
+	if(source->next)
+		source->next->previous = source->previous;
+	
+	wi_mutable_dictionary_remove_data_for_key(loop->sources_for_instances, source->instance);
+	
+	source->previous	= NULL;
+	source->next		= loop->dead_sources;
+	loop->dead_sources	= source;
+}
+
+
+
+static void _wi_event_loop_free_dead_sources(wi_event_loop_t *loop) {
+	_wi_event_loop_source_t		*source, *next;
+	
+	source = loop->dead_sources;
+	loop->dead_sources = NULL;
+	
+	while(source) {
+		next = source->next;
+		
+		wi_release(source->instance);
+		wi_free(source);
+		
+		source = next;
+	}
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void _wi_event_loop_fire_timer(wi_event_loop_t *loop, _wi_event_loop_source_t *source) {
+	wi_timer_t		*timer;
+	uint64_t		expirations;
+	
+	if(read(source->fd, &expirations, sizeof(expirations)) < 0)
+		return;
+	
+	timer = source->instance;
+	
+	if(!source->repeats) {
+		source->armed = false;
+		
+		wi_timer_set_scheduled(timer, false);
+	}
+	
+	wi_lock_unlock(loop->lock);
+	
+	wi_timer_fire(timer);
+	
+	wi_lock_lock(loop->lock);
+	
+	if(!source->armed && source->fd >= 0)
+		_wi_event_loop_remove_source(loop, source);
+}
+
+#endif
+
+#endif
+
+
+
+#pragma mark -
+
+void wi_event_loop_run(wi_event_loop_t *loop) {
+	wi_pool_t		*pool;
+	wi_boolean_t	stopped;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	
+	do {
+		if(!wi_event_loop_run_with_timeout(loop, 0.0))
+			break;
+		
+		wi_pool_drain(pool);
+		
+		wi_lock_lock(loop->lock);
+		stopped = loop->stopped;
+		wi_lock_unlock(loop->lock);
+	} while(!stopped);
+	
+	wi_lock_lock(loop->lock);
+	loop->stopped = false;
+	wi_lock_unlock(loop->lock);
+	
+	wi_release(pool);
+}
+
+
+
+wi_boolean_t wi_event_loop_run_with_timeout(wi_event_loop_t *loop, wi_time_interval_t timeout) {
+#ifdef _WI_EVENT_LOOP_EPOLL
+	struct epoll_event			events[_WI_EVENT_LOOP_MAX_EVENTS];
+	_wi_event_loop_source_t		*source;
+	wi_socket_t					*socket;
+	wi_event_loop_socket_func_t	*func;
+	int							i, count;
+	
+	count = epoll_wait(loop->epoll, events, _WI_EVENT_LOOP_MAX_EVENTS, (timeout > 0.0) ? (int) (timeout * 1000.0) : -1);
+	
+	if(count < 0) {
+		if(errno == EINTR)
+			return true;
+		
+		wi_error_set_errno(errno);
+		
+		return false;
+	}
+	
+	wi_lock_lock(loop->lock);
+	
+	for(i = 0; i < count; i++) {
+		source = events[i].data.ptr;
+		
+		if(source->type == _WI_EVENT_LOOP_SOURCE_WAKEUP) {
+			wi_lock_unlock(loop->lock);
+			_wi_event_loop_perform_functions(loop);
+			wi_lock_lock(loop->lock);
+		}
+		else if(source->fd >= 0) {
+			if(source->type == _WI_EVENT_LOOP_SOURCE_SOCKET) {
+				socket	= wi_retain(source->instance);
+				func	= source->func;
+				
+				wi_lock_unlock(loop->lock);
+				(*func)(loop, socket);
+				wi_release(socket);
+				wi_lock_lock(loop->lock);
+			}
+#ifdef WI_PTHREADS
+			else if(source->type == _WI_EVENT_LOOP_SOURCE_TIMER) {
+				_wi_event_loop_fire_timer(loop, source);
+			}
+#endif
+		}
+	}
+	
+	_wi_event_loop_free_dead_sources(loop);
+	
+	wi_lock_unlock(loop->lock);
+	
+	return true;
+#else
+	wi_error_set_libwired_error(WI_ERROR_EVENT_LOOP_NOTSUPP);
+	
+	return false;
+#endif
+}
+
+
+
+void wi_event_loop_stop(wi_event_loop_t *loop) {
+	wi_lock_lock(loop->lock);
+	loop->stopped = true;
+	wi_lock_unlock(loop->lock);
+	
+#ifdef _WI_EVENT_LOOP_EPOLL
+	_wi_event_loop_wakeup(loop);
+#endif
+}
+
+
+
+#pragma mark -
+
+wi_boolean_t wi_event_loop_add_socket(wi_event_loop_t *loop, wi_socket_t *socket, wi_event_loop_socket_func_t *func) {
+#ifdef _WI_EVENT_LOOP_EPOLL
+	_wi_event_loop_source_t		*source;
+	
+	wi_lock_lock(loop->lock);
+	
+	source = wi_dictionary_data_for_key(loop->sources_for_instances, socket);
+	
+	if(!source)
+		source = _wi_event_loop_add_source(loop, _WI_EVENT_LOOP_SOURCE_SOCKET, wi_socket_descriptor(socket), socket);
+	
+	if(source)
+		source->func = func;
+	
+	wi_lock_unlock(loop->lock);
+	
+	return (source != NULL);
+#else
+	wi_error_set_libwired_error(WI_ERROR_EVENT_LOOP_NOTSUPP);
+	
+	return false;
+#endif
+}
+
+
+
+void wi_event_loop_remove_socket(wi_event_loop_t *loop, wi_socket_t *socket) {
+#ifdef _WI_EVENT_LOOP_EPOLL
+	_wi_event_loop_source_t		*source;
+	
+	wi_lock_lock(loop->lock);
+	
+	source = wi_dictionary_data_for_key(loop->sources_for_instances, socket);
+	
+	if(source)
+		_wi_event_loop_remove_source(loop, source);
+	
+	wi_lock_unlock(loop->lock);
+#endif
+}
+
+
+
+#pragma mark -
+
+void wi_event_loop_perform_function(wi_event_loop_t *loop, wi_event_loop_func_t *func, wi_runtime_instance_t *instance) {
+	wi_lock_lock(loop->lock);
+	
+	if(loop->performs_count == loop->performs_capacity) {
+		loop->performs_capacity = (loop->performs_capacity == 0) ? 8 : loop->performs_capacity * 2;
+		loop->performs = wi_realloc(loop->performs, loop->performs_capacity * sizeof(_wi_event_loop_perform_t));
+	}
+	
+	loop->performs[loop->performs_count].func		= func;
+	loop->performs[loop->performs_count].instance	= wi_retain(instance);
+	loop->performs_count++;
+	
+	wi_lock_unlock(loop->lock);
+	
+#ifdef _WI_EVENT_LOOP_EPOLL
+	_wi_event_loop_wakeup(loop);
+#endif
+}
+
+
+
+#pragma mark -
+
+#ifdef WI_PTHREADS
+
+void wi_event_loop_schedule_timer(wi_event_loop_t *loop, wi_timer_t *timer, wi_time_interval_t interval, wi_boolean_t repeats, wi_boolean_t reset) {
+#ifdef _WI_EVENT_LOOP_EPOLL
+	_wi_event_loop_source_t		*source;
+	struct itimerspec			its;
+	int							fd;
+	
+	wi_lock_lock(loop->lock);
+	
+	source = wi_dictionary_data_for_key(loop->sources_for_instances, timer);
+	
+	if(!source) {
+		fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		
+		if(fd < 0) {
+			wi_log_warn(WI_STR("Could not create timer: %s"), strerror(errno));
+			
+			wi_lock_unlock(loop->lock);
+			
+			return;
+		}
+		
+		source = _wi_event_loop_add_source(loop, _WI_EVENT_LOOP_SOURCE_TIMER, fd, timer);
+		
+		if(!source) {
+			wi_log_warn(WI_STR("Could not add timer: %m"));
+			
+			close(fd);
+			
+			wi_lock_unlock(loop->lock);
+			
+			return;
+		}
+		
+		source->armed = false;
+	}
+	
+	if(!source->armed || reset) {
+		its.it_value.tv_sec			= (time_t) interval;
+		its.it_value.tv_nsec		= (long) ((interval - its.it_value.tv_sec) * 1000000000.0);
+		its.it_interval				= repeats ? its.it_value : (struct timespec) { 0, 0 };
+		
+		if(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+			its.it_value.tv_nsec = 1;
+		
+		timerfd_settime(source->fd, 0, &its, NULL);
+		
+		source->armed		= true;
+		source->repeats		= repeats;
+		
+		wi_timer_set_scheduled(timer, true);
+	}
+	
+	wi_lock_unlock(loop->lock);
+#endif
+}
+
+
+
+void wi_event_loop_invalidate_timer(wi_event_loop_t *loop, wi_timer_t *timer) {
+#ifdef _WI_EVENT_LOOP_EPOLL
+	_wi_event_loop_source_t		*source;
+	
+	wi_lock_lock(loop->lock);
+	
+	source = wi_dictionary_data_for_key(loop->sources_for_instances, timer);
+	
+	if(source)
+		_wi_event_loop_remove_source(loop, source);
+	
+	wi_lock_unlock(loop->lock);
+#endif
+}
+
+#endif
@@ -0,0 +1,55 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WI_EVENT_LOOP_H
+#define WI_EVENT_LOOP_H 1
+
+#include <wired/wi-base.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-socket.h>
+
+typedef struct _wi_event_loop			wi_event_loop_t;
+
+typedef void							wi_event_loop_func_t(wi_event_loop_t *, wi_runtime_instance_t *);
+typedef void							wi_event_loop_socket_func_t(wi_event_loop_t *, wi_socket_t *);
+
+
+WI_EXPORT wi_runtime_id_t				wi_event_loop_runtime_id(void);
+
+WI_EXPORT wi_event_loop_t *				wi_event_loop_alloc(void);
+WI_EXPORT wi_event_loop_t *				wi_event_loop_init(wi_event_loop_t *);
+
+WI_EXPORT void							wi_event_loop_run(wi_event_loop_t *);
+WI_EXPORT wi_boolean_t					wi_event_loop_run_with_timeout(wi_event_loop_t *, wi_time_interval_t);
+WI_EXPORT void							wi_event_loop_stop(wi_event_loop_t *);
+
+WI_EXPORT wi_boolean_t					wi_event_loop_add_socket(wi_event_loop_t *, wi_socket_t *, wi_event_loop_socket_func_t *);
+WI_EXPORT void							wi_event_loop_remove_socket(wi_event_loop_t *, wi_socket_t *);
+
+WI_EXPORT void							wi_event_loop_perform_function(wi_event_loop_t *, wi_event_loop_func_t *, wi_runtime_instance_t *);
+
+#endif /* WI_EVENT_LOOP_H */
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/time.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 
 #ifdef HAVE_NETINET_IN_SYSTM_H
@@ -46,6 +47,7 @@
 #include <netdb.h>
 #include <net/if.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
@@ -76,6 +78,12 @@
 
 #define _WI_SOCKET_BUFFER_MAX_SIZE		262144
 
+#if defined(IOV_MAX) && IOV_MAX < 64
+#define _WI_SOCKET_IOVEC_COUNT			IOV_MAX
+#else
+#define _WI_SOCKET_IOVEC_COUNT			64
+#endif
+
 
 struct _wi_socket_tls {
 	wi_runtime_base_t					base;
@@ -1515,6 +1523,93 @@ wi_integer_t wi_socket_write_buffer(wi_socket_t *socket, wi_time_interval_t time
 
 
 
+wi_integer_t wi_socket_write_iovecs(wi_socket_t *socket, wi_time_interval_t timeout, const struct iovec *iovecs, wi_uinteger_t count) {
+	struct iovec		buffer[_WI_SOCKET_IOVEC_COUNT];
+	wi_socket_state_t	state;
+	wi_uinteger_t		i, n, index, offset, total;
+	wi_integer_t		bytes;
+	
+	WI_ASSERT(socket->sd >= 0, "socket %@ should be valid", socket);
+	
+	total = 0;
+	
+#ifdef HAVE_OPENSSL_SSL_H
+	if(socket->ssl) {
+		for(i = 0; i < count; i++) {
+			if(iovecs[i].iov_len == 0)
+				continue;
+			
+			bytes = wi_socket_write_buffer(socket, timeout, iovecs[i].iov_base, iovecs[i].iov_len);
+			
+			if(bytes <= 0)
+				return bytes;
+			
+			total += bytes;
+		}
+		
+		return total;
+	}
+#endif
+
+	index = offset = 0;
+	
+	while(index < count) {
+		if(timeout > 0.0) {
+			state = wi_socket_wait_descriptor(socket->sd, timeout, false, true);
+
+			if(state != WI_SOCKET_READY) {
+				if(state == WI_SOCKET_TIMEOUT)
+					wi_error_set_errno(ETIMEDOUT);
+				
+				return -1;
+			}
+		}
+		
+		n = WI_MIN(count - index, _WI_SOCKET_IOVEC_COUNT);
+		
+		memcpy(buffer, iovecs + index, n * sizeof(struct iovec));
+		
+		buffer[0].iov_base	= (char *) buffer[0].iov_base + offset;
+		buffer[0].iov_len	-= offset;
+		
+		bytes = writev(socket->sd, buffer, n);
+		
+		if(bytes < 0) {
+			wi_error_set_errno(errno);
+			
+			return bytes;
+		}
+		
+		total += bytes;
+		
+		for(i = 0; i < n && (wi_uinteger_t) bytes >= buffer[i].iov_len; i++) {
+			bytes -= buffer[i].iov_len;
+			offset = 0;
+			index++;
+		}
+		
+		if(i < n) {
+			if(bytes == 0 && i == 0) {
+				wi_error_set_libwired_error(WI_ERROR_SOCKET_EOF);
+				
+				return 0;
+			}
+			
+			offset += bytes;
+		}
+	}
+	
+	return total;
+}
+
+
+
+wi_integer_t wi_socket_write_data_chain(wi_socket_t *socket, wi_time_interval_t timeout, wi_data_chain_t *chain) {
+	return wi_socket_write_iovecs(socket, timeout, wi_data_chain_iovecs(chain), wi_data_chain_count(chain));
+}
+
+
+
 wi_string_t * wi_socket_read_string(wi_socket_t *socket, wi_time_interval_t timeout) {
 	wi_mutable_string_t		*string;
 	char					buffer[WI_SOCKET_BUFFER_SIZE];
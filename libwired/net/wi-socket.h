@@ -33,6 +33,7 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <wired/wi-base.h>
+#include <wired/wi-data-chain.h>
 #include <wired/wi-rsa.h>
 #include <wired/wi-runtime.h>
 #include <wired/wi-x509.h>
@@ -137,6 +138,8 @@ WI_EXPORT wi_integer_t					wi_socket_recvfrom(wi_socket_t *, char *, size_t, wi_
 
 WI_EXPORT wi_integer_t					wi_socket_write_format(wi_socket_t *, wi_time_interval_t, wi_string_t *, ...);
 WI_EXPORT wi_integer_t					wi_socket_write_buffer(wi_socket_t *, wi_time_interval_t, const void *, size_t);
+WI_EXPORT wi_integer_t					wi_socket_write_iovecs(wi_socket_t *, wi_time_interval_t, const struct iovec *, wi_uinteger_t);
+WI_EXPORT wi_integer_t					wi_socket_write_data_chain(wi_socket_t *, wi_time_interval_t, wi_data_chain_t *);
 WI_EXPORT wi_string_t *					wi_socket_read_string(wi_socket_t *, wi_time_interval_t);
 WI_EXPORT wi_string_t *					wi_socket_read_to_string(wi_socket_t *, wi_time_interval_t, wi_string_t *);
 WI_EXPORT wi_integer_t					wi_socket_read_buffer(wi_socket_t *, wi_time_interval_t, void *, size_t);
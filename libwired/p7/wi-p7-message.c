@@ -38,6 +38,7 @@ int wi_p7_message_dummy = 0;
 #include <wired/wi-byteorder.h>
 #include <wired/wi-dictionary.h>
 #include <wired/wi-libxml2.h>
+#include <wired/wi-numeric.h>
 #include <wired/wi-p7-message.h>
 #include <wired/wi-p7-socket.h>
 #include <wired/wi-p7-spec.h>
@@ -493,6 +494,8 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 	wi_string_t				*string;
 	wi_data_t				*data;
 	wi_array_t				*list;
+	const char				*field_content;
+	char					number[WI_NUMERIC_DOUBLE_BUFFER_SIZE];
 	wi_uinteger_t			i, count;
 	uint32_t				message_size, field_id, field_size;
 	
@@ -528,12 +531,13 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 			
 			field_name		= wi_p7_spec_field_name(field);
 			field_value		= NULL;
+			field_content	= NULL;
 			type			= wi_p7_spec_field_type(field);
 
 			switch(wi_p7_spec_type_id(type)) {
 				case WI_P7_BOOL:
 					if(wi_p7_message_get_bool_for_name(p7_message, &p7_bool, field_name))
-						field_value = wi_string_with_format(WI_STR("%u"), p7_bool ? 1 : 0);
+						field_content = p7_bool ? "1" : "0";
 					break;
 					
 				case WI_P7_ENUM:
@@ -544,28 +548,38 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 					break;
 					
 				case WI_P7_INT32:
-					if(wi_p7_message_get_int32_for_name(p7_message, &p7_int32, field_name))
-						field_value = wi_string_with_format(WI_STR("%u"), p7_int32);
+					if(wi_p7_message_get_int32_for_name(p7_message, &p7_int32, field_name)) {
+						wi_numeric_format_int64(number, p7_int32);
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_UINT32:
-					if(wi_p7_message_get_uint32_for_name(p7_message, &p7_uint32, field_name))
-						field_value = wi_string_with_format(WI_STR("%u"), p7_uint32);
+					if(wi_p7_message_get_uint32_for_name(p7_message, &p7_uint32, field_name)) {
+						wi_numeric_format_uint64(number, p7_uint32);
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_INT64:
-					if(wi_p7_message_get_int64_for_name(p7_message, &p7_int64, field_name))
-						field_value = wi_string_with_format(WI_STR("%lld"), p7_int64);
+					if(wi_p7_message_get_int64_for_name(p7_message, &p7_int64, field_name)) {
+						wi_numeric_format_int64(number, p7_int64);
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_UINT64:
-					if(wi_p7_message_get_uint64_for_name(p7_message, &p7_uint64, field_name))
-						field_value = wi_string_with_format(WI_STR("%llu"), p7_uint64);
+					if(wi_p7_message_get_uint64_for_name(p7_message, &p7_uint64, field_name)) {
+						wi_numeric_format_uint64(number, p7_uint64);
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_DOUBLE:
-					if(wi_p7_message_get_double_for_name(p7_message, &p7_double, field_name))
-						field_value = wi_string_with_format(WI_STR("%f"), p7_double);
+					if(wi_p7_message_get_double_for_name(p7_message, &p7_double, field_name)) {
+						wi_numeric_format_double(number, p7_double);
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_STRING:
@@ -585,8 +599,10 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 				case WI_P7_DATE:
 					date = wi_p7_message_date_for_name(p7_message, field_name);
 					
-					if(date)
-						field_value = wi_string_with_format(WI_STR("%f"), wi_date_time_interval(date));
+					if(date) {
+						wi_numeric_format_double(number, wi_date_time_interval(date));
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_DATA:
@@ -597,8 +613,10 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 					break;
 					
 				case WI_P7_OOBDATA:
-					if(wi_p7_message_get_oobdata_for_name(p7_message, &p7_oobdata, field_name))
-						field_value = wi_string_with_format(WI_STR("%llu"), p7_oobdata);
+					if(wi_p7_message_get_oobdata_for_name(p7_message, &p7_oobdata, field_name)) {
+						wi_numeric_format_uint64(number, p7_oobdata);
+						field_content = number;
+					}
 					break;
 					
 				case WI_P7_LIST:
@@ -628,7 +646,10 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 					break;
 			}
 			
-			if(field_value) {
+			if(field_value)
+				field_content = wi_string_cstring(field_value);
+			
+			if(field_content) {
 				item_node = wi_xml_node_child_with_name(root_node, field_name);
 				
 				if(!item_node) {
@@ -637,7 +658,7 @@ void wi_p7_message_serialize(wi_p7_message_t *p7_message, wi_p7_serialization_t
 					xmlAddChild(root_node, item_node);
 				}
 				
-				xmlNodeSetContent(item_node, (xmlChar *) wi_string_cstring(field_value));
+				xmlNodeSetContent(item_node, (xmlChar *) field_content);
 
 			}
 			
@@ -660,6 +681,12 @@ void wi_p7_message_deserialize(wi_p7_message_t *p7_message, wi_p7_serialization_
 	wi_uuid_t					*uuid;
 	wi_date_t					*date;
 	wi_data_t					*data;
+	xmlChar						*content;
+	const char					*cstring;
+	wi_uinteger_t				length;
+	int64_t						int64;
+	uint64_t					uint64;
+	double						d;
 	
 	if(serialization == WI_P7_BINARY) {
 		p7_message->binary_id = wi_read_swap_big_to_host_int32(p7_message->binary_buffer, 0);
@@ -683,41 +710,90 @@ void wi_p7_message_deserialize(wi_p7_message_t *p7_message, wi_p7_serialization_
 				if(field_node->type == XML_ELEMENT_NODE) {
 					if(wi_is_equal(wi_xml_node_name(field_node), WI_STR("field"))) {
 						field_name		= wi_xml_node_attribute_with_name(field_node, WI_STR("name"));
-						field_value		= wi_xml_node_content(field_node);
 						field			= wi_p7_spec_field_with_name(p7_message->spec, field_name);
 						
-						if(!field_name || !field_value || !field)
+						if(!field_name || !field)
+							continue;
+						
+						content			= xmlNodeGetContent(field_node);
+						
+						if(!content)
 							continue;
 						
+						cstring			= (const char *) content;
+						length			= strlen(cstring);
+						field_value		= NULL;
+						
 						switch(wi_p7_spec_type_id(wi_p7_spec_field_type(field))) {
 							case WI_P7_BOOL:
-								wi_p7_message_set_bool_for_name(p7_message, wi_string_bool(field_value), field_name);
+								if(strcasecmp(cstring, "yes") == 0)
+									int64 = 1;
+								else if(!wi_numeric_parse_int64(cstring, length, &int64) || int64 > INT32_MAX || int64 < INT32_MIN)
+									int64 = 0;
+								
+								wi_p7_message_set_bool_for_name(p7_message, (int64 > 0), field_name);
 								break;
 								
 							case WI_P7_ENUM:
-								wi_p7_message_set_enum_for_name(p7_message, wi_string_uint32(field_value), field_name);
+								if(!wi_numeric_parse_uint64(cstring, length, &uint64) || uint64 > UINT32_MAX)
+									uint64 = 0;
+								
+								wi_p7_message_set_enum_for_name(p7_message, (wi_p7_enum_t) uint64, field_name);
 								break;
 								
 							case WI_P7_INT32:
-								wi_p7_message_set_int32_for_name(p7_message, wi_string_int32(field_value), field_name);
+								if(!wi_numeric_parse_int64(cstring, length, &int64) || int64 > INT32_MAX || int64 < INT32_MIN)
+									int64 = 0;
+								
+								wi_p7_message_set_int32_for_name(p7_message, (wi_p7_int32_t) int64, field_name);
 								break;
 								
 							case WI_P7_UINT32:
-								wi_p7_message_set_uint32_for_name(p7_message, wi_string_uint32(field_value), field_name);
+								if(!wi_numeric_parse_uint64(cstring, length, &uint64) || uint64 > UINT32_MAX)
+									uint64 = 0;
+								
+								wi_p7_message_set_uint32_for_name(p7_message, (wi_p7_uint32_t) uint64, field_name);
 								break;
 								
 							case WI_P7_INT64:
-								wi_p7_message_set_int64_for_name(p7_message, wi_string_int64(field_value), field_name);
+								if(!wi_numeric_parse_int64(cstring, length, &int64))
+									int64 = 0;
+								
+								wi_p7_message_set_int64_for_name(p7_message, int64, field_name);
 								break;
 								
 							case WI_P7_UINT64:
-								wi_p7_message_set_uint64_for_name(p7_message, wi_string_uint64(field_value), field_name);
+								if(!wi_numeric_parse_uint64(cstring, length, &uint64))
+									uint64 = 0;
+								
+								wi_p7_message_set_uint64_for_name(p7_message, uint64, field_name);
 								break;
 								
 							case WI_P7_DOUBLE:
-								wi_p7_message_set_double_for_name(p7_message, wi_string_double(field_value), field_name);
+								if(!wi_numeric_parse_double(cstring, length, &d))
+									d = 0.0;
+								
+								wi_p7_message_set_double_for_name(p7_message, d, field_name);
 								break;
 								
+							case WI_P7_OOBDATA:
+								if(!wi_numeric_parse_uint64(cstring, length, &uint64))
+									uint64 = 0;
+								
+								wi_p7_message_set_oobdata_for_name(p7_message, uint64, field_name);
+								break;
+							
+							default:
+								field_value = wi_string_with_bytes(cstring, length);
+								break;
+						}
+						
+						xmlFree(content);
+						
+						if(!field_value)
+							continue;
+						
+						switch(wi_p7_spec_type_id(wi_p7_spec_field_type(field))) {
 							case WI_P7_STRING:
 								wi_p7_message_set_string_for_name(p7_message, field_value, field_name);
 								break;
@@ -730,7 +806,10 @@ void wi_p7_message_deserialize(wi_p7_message_t *p7_message, wi_p7_serialization_
 								break;
 								
 							case WI_P7_DATE:
-								date = wi_date_with_rfc3339_string(field_value);
+								if(wi_numeric_parse_double(wi_string_cstring(field_value), wi_string_length(field_value), &d))
+									date = wi_date_with_time_interval(d);
+								else
+									date = wi_date_with_rfc3339_string(field_value);
 								
 								if(date)
 									wi_p7_message_set_date_for_name(p7_message, date, field_name);
@@ -743,13 +822,12 @@ void wi_p7_message_deserialize(wi_p7_message_t *p7_message, wi_p7_serialization_
 									wi_p7_message_set_data_for_name(p7_message, data, field_name);
 								break;
 							
-							case WI_P7_OOBDATA:
-								wi_p7_message_set_oobdata_for_name(p7_message, wi_string_uint64(field_value), field_name);
-								break;
-							
 							case WI_P7_LIST:
 								WI_ASSERT(0, "Can't deserialize XML with lists at the moment");
 								break;
+							
+							default:
+								break;
 						}
 					}
 				}
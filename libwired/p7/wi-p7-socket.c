@@ -1152,11 +1152,13 @@ static wi_boolean_t _wi_p7_socket_write_binary_message(wi_p7_socket_t *p7_socket
 	const void			*send_buffer;
 	char				length_buffer[_WI_P7_SOCKET_LENGTH_SIZE];
 	unsigned char		checksum_buffer[_WI_P7_SOCKET_CHECKSUM_LENGTH];
+	struct iovec		iovecs[3];
 	wi_integer_t		compressed_size;
 #ifdef WI_RSA
 	wi_integer_t		encrypted_size;
 #endif	
 	uint32_t			send_size;
+	wi_uinteger_t		count;
 	
 	send_size	= p7_message->binary_size;
 	send_buffer	= p7_message->binary_buffer;
@@ -1203,19 +1205,23 @@ static wi_boolean_t _wi_p7_socket_write_binary_message(wi_p7_socket_t *p7_socket
 
 	wi_write_swap_host_to_big_int32(length_buffer, 0, send_size);
 	
-	if(wi_socket_write_buffer(p7_socket->socket, timeout, length_buffer, sizeof(length_buffer)) < 0)
-		return false;
-
-	if(wi_socket_write_buffer(p7_socket->socket, timeout, send_buffer, send_size) < 0)
-		return false;
+	iovecs[0].iov_base	= length_buffer;
+	iovecs[0].iov_len	= sizeof(length_buffer);
+	iovecs[1].iov_base	= (void *) send_buffer;
+	iovecs[1].iov_len	= send_size;
+	count				= 2;
 	
 	if(p7_socket->checksum_enabled) {
 		_wi_p7_socket_checksum_binary_message(p7_socket, p7_message, checksum_buffer);
 		
-		if(wi_socket_write_buffer(p7_socket->socket, timeout, checksum_buffer, p7_socket->checksum_length) < 0)
-			return false;
+		iovecs[2].iov_base	= checksum_buffer;
+		iovecs[2].iov_len	= p7_socket->checksum_length;
+		count				= 3;
 	}
 	
+	if(wi_socket_write_iovecs(p7_socket->socket, timeout, iovecs, count) < 0)
+		return false;
+	
 	return true;
 }
 
@@ -1679,11 +1685,13 @@ wi_boolean_t wi_p7_socket_write_oobdata(wi_p7_socket_t *p7_socket, wi_time_inter
 	const void			*send_buffer;
 	char				length_buffer[_WI_P7_SOCKET_LENGTH_SIZE];
 	unsigned char		checksum_buffer[_WI_P7_SOCKET_CHECKSUM_LENGTH];
+	struct iovec		iovecs[3];
 	wi_integer_t		compressed_size;
 #ifdef WI_RSA
 	wi_integer_t		encrypted_size;
 #endif
 	uint32_t			send_size;
+	wi_uinteger_t		count;
 	
 	send_size = size;
 	send_buffer	= buffer;
@@ -1729,17 +1737,21 @@ wi_boolean_t wi_p7_socket_write_oobdata(wi_p7_socket_t *p7_socket, wi_time_inter
 
 	wi_write_swap_host_to_big_int32(length_buffer, 0, send_size);
 
-	if(wi_socket_write_buffer(p7_socket->socket, timeout, length_buffer, sizeof(length_buffer)) < 0)
-		return false;
-
-	if(wi_socket_write_buffer(p7_socket->socket, timeout, send_buffer, send_size) < 0)
-		return false;
+	iovecs[0].iov_base	= length_buffer;
+	iovecs[0].iov_len	= sizeof(length_buffer);
+	iovecs[1].iov_base	= (void *) send_buffer;
+	iovecs[1].iov_len	= send_size;
+	count				= 2;
 
 	if(p7_socket->checksum_enabled) {
-		if(wi_socket_write_buffer(p7_socket->socket, timeout, checksum_buffer, p7_socket->checksum_length) < 0)
-			return false;
+		iovecs[2].iov_base	= checksum_buffer;
+		iovecs[2].iov_len	= p7_socket->checksum_length;
+		count				= 3;
 	}
 	
+	if(wi_socket_write_iovecs(p7_socket->socket, timeout, iovecs, count) < 0)
+		return false;
+	
 	return true;
 }
 
@@ -313,6 +313,7 @@ struct _wi_p7_spec {
 };
 
 static wi_string_t *						_wi_p7_spec_originator(wi_p7_originator_t);
+static wi_string_t *						_wi_p7_spec_name_attribute(xmlNodePtr, wi_string_t *);
 
 static wi_p7_spec_t *						_wi_p7_spec_init(wi_p7_spec_t *, wi_p7_originator_t);
 static wi_p7_spec_t *						_wi_p7_spec_init_builtin_spec(wi_p7_spec_t *);
@@ -549,6 +550,19 @@ static wi_string_t * _wi_p7_spec_originator(wi_p7_originator_t originator) {
 
 
 
+static wi_string_t * _wi_p7_spec_name_attribute(xmlNodePtr node, wi_string_t *attribute) {
+	wi_string_t		*name;
+	
+	name = wi_xml_node_attribute_with_name(node, attribute);
+	
+	if(!name)
+		return NULL;
+	
+	return wi_string_intern(name);
+}
+
+
+
 #pragma mark -
 
 wi_p7_spec_t * wi_p7_spec_alloc(void) {
@@ -1740,7 +1754,7 @@ static wi_p7_spec_type_t * _wi_p7_spec_type_with_node(wi_p7_spec_t *p7_spec, xml
 	wi_p7_spec_type_t		*type;
 	
     type = wi_autorelease(wi_runtime_create_instance(_wi_p7_spec_type_runtime_id, sizeof(wi_p7_spec_type_t)));
-	type->name = wi_retain(wi_xml_node_attribute_with_name(type_node, WI_STR("name")));
+	type->name = wi_retain(_wi_p7_spec_name_attribute(type_node, WI_STR("name")));
 	
 	if(!type->name) {
 		wi_error_set_libwired_error_with_format(WI_ERROR_P7_INVALIDSPEC,
@@ -1824,7 +1838,7 @@ static wi_p7_spec_field_t * _wi_p7_spec_field_with_node(wi_p7_spec_t *p7_spec, x
 	wi_integer_t				value;
 	
     field = wi_autorelease(wi_runtime_create_instance(_wi_p7_spec_field_runtime_id, sizeof(wi_p7_spec_field_t)));
-	field->name = wi_retain(wi_xml_node_attribute_with_name(node, WI_STR("name")));
+	field->name = wi_retain(_wi_p7_spec_name_attribute(node, WI_STR("name")));
 
 	if(!field->name) {
 		wi_error_set_libwired_error_with_format(WI_ERROR_P7_INVALIDSPEC,
@@ -1917,7 +1931,7 @@ static wi_p7_spec_field_t * _wi_p7_spec_field_with_node(wi_p7_spec_t *p7_spec, x
 				return NULL;
 			}
 			
-			name = wi_xml_node_attribute_with_name(enum_node, WI_STR("name"));
+			name = _wi_p7_spec_name_attribute(enum_node, WI_STR("name"));
 			
 			if(!name) {
 				wi_error_set_libwired_error_with_format(WI_ERROR_P7_INVALIDSPEC,
@@ -2032,7 +2046,7 @@ static _wi_p7_spec_collection_t * _wi_p7_spec_collection_with_node(wi_p7_spec_t
 	wi_string_t					*field_name;
 	
     collection = wi_autorelease(wi_runtime_create_instance(_wi_p7_spec_collection_runtime_id, sizeof(_wi_p7_spec_collection_t)));
-	collection->name = wi_retain(wi_xml_node_attribute_with_name(node, WI_STR("name")));
+	collection->name = wi_retain(_wi_p7_spec_name_attribute(node, WI_STR("name")));
 
 	if(!collection->name) {
 		wi_error_set_libwired_error_with_format(WI_ERROR_P7_INVALIDSPEC,
@@ -2136,7 +2150,7 @@ static wi_p7_spec_message_t * _wi_p7_spec_message_with_node(wi_p7_spec_t *p7_spe
 	wi_boolean_t				required;
 
     message = wi_autorelease(wi_runtime_create_instance(_wi_p7_spec_message_runtime_id, sizeof(wi_p7_spec_message_t)));
-	message->name = wi_retain(wi_xml_node_attribute_with_name(node, WI_STR("name")));
+	message->name = wi_retain(_wi_p7_spec_name_attribute(node, WI_STR("name")));
 
 	if(!message->name) {
 		wi_error_set_libwired_error_with_format(WI_ERROR_P7_INVALIDSPEC,
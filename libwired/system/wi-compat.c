@@ -41,8 +41,30 @@
 
 #include <wired/wi-compat.h>
 #include <wired/wi-file.h>
+#include <wired/wi-private.h>
 #include <wired/wi-system.h>
 
+#if defined(__GNUC__) && defined(__SSE2__)
+#define _WI_COMPAT_SSE2					1
+#include <emmintrin.h>
+#endif
+
+#if defined(_WI_COMPAT_SSE2) && defined(__x86_64__) && (__GNUC__ >= 5 || defined(__clang__))
+#define _WI_COMPAT_AVX2					1
+#include <immintrin.h>
+#endif
+
+#define _WI_COMPAT_TOLOWER(c)											\
+	(((c) >= 'A' && (c) <= 'Z') ? ((c) | 0x20) : (c))
+#define _WI_COMPAT_TOUPPER(c)											\
+	(((c) >= 'a' && (c) <= 'z') ? ((c) & ~0x20) : (c))
+
+
+#ifdef _WI_COMPAT_AVX2
+static int								_wi_memmem_avx2_supported = -1;
+#endif
+
+
 /*      $OpenBSD: strsep.c,v 1.5 2003/06/11 21:08:16 deraadt Exp $        */
 
 /*-
@@ -105,180 +127,32 @@ char * wi_strsep(char **stringp, const char *delim) {
 
 
 
-/*-
- * Copyright (c) 2001 Mike Barcroft <mike@FreeBSD.org>
- * Copyright (c) 1990, 1993
- *	The Regents of the University of California.  All rights reserved.
- *
- * This code is derived from software contributed to Berkeley by
- * Chris Torek.
- *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions
- * are met:
- * 1. Redistributions of source code must retain the above copyright
- *    notice, this list of conditions and the following disclaimer.
- * 2. Redistributions in binary form must reproduce the above copyright
- *    notice, this list of conditions and the following disclaimer in the
- *    documentation and/or other materials provided with the distribution.
- * 3. All advertising materials mentioning features or use of this software
- *    must display the following acknowledgement:
- *	This product includes software developed by the University of
- *	California, Berkeley and its contributors.
- * 4. Neither the name of the University nor the names of its contributors
- *    may be used to endorse or promote products derived from this software
- *    without specific prior written permission.
- *
- * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
- * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
- * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
- * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
- * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
- * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
- * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
- * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
- * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
- * SUCH DAMAGE.
- */
-
 char * wi_strnstr(const char *s, const char *find, size_t slen) {
-	char	c, sc;
-	size_t	len;
-
-	if((c = *find++) != '\0') {
-		len = strlen(find);
-		
-		do {
-			do {
-				if(slen-- < 1 || (sc = *s++) == '\0')
-					return NULL;
-			} while(sc != c);
-			
-			if(len > slen)
-				return NULL;
-		} while(strncmp(s, find, len) != 0);
-
-		s--; 
-	}
-	return (char *) s;
+	return wi_memmem(s, strnlen(s, slen), find, strlen(find));
 }
 
 
 
-/*-
- * Copyright (c) 1990, 1993
- *	The Regents of the University of California.  All rights reserved.
- *
- * This code is derived from software contributed to Berkeley by
- * Chris Torek.
- *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions
- * are met:
- * 1. Redistributions of source code must retain the above copyright
- *    notice, this list of conditions and the following disclaimer.
- * 2. Redistributions in binary form must reproduce the above copyright
- *    notice, this list of conditions and the following disclaimer in the
- *    documentation and/or other materials provided with the distribution.
- * 3. All advertising materials mentioning features or use of this software
- *    must display the following acknowledgement:
- *	This product includes software developed by the University of
- *	California, Berkeley and its contributors.
- * 4. Neither the name of the University nor the names of its contributors
- *    may be used to endorse or promote products derived from this software
- *    without specific prior written permission.
- *
- * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
- * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
- * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
- * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
- * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
- * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
- * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
- * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
- * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
- * SUCH DAMAGE.
- */
-
 char * wi_strcasestr(const char *s, const char *find) {
-	char	c, sc;
-	size_t	len;
-
-	if((c = *find++) != '\0') {
-		c	= tolower((unsigned char) c);
-		len	= strlen(find);
-
-		do {
-			do {
-				if((sc = *s++) == '\0')
-					return NULL;
-			} while((char) tolower((unsigned char) sc) != c);
-		} while(strncasecmp(s, find, len) != 0);
-
-		s--;
-	}
-
-	return (char *) s;
+	return wi_memcasemem(s, strlen(s), find, strlen(find));
 }
 
 
 
 char * wi_strncasestr(const char *s, const char *find, size_t slen) {
-	char	c, sc;
-	size_t	len;
-
-	if((c = *find++) != '\0') {
-		c	= tolower((unsigned char) c);
-		len	= strlen(find);
-
-		do {
-			do {
-				if(slen-- < 1 || (sc = *s++) == '\0')
-					return NULL;
-			} while((char) tolower((unsigned char) sc) != c);
-
-			if(len > slen)
-				return NULL;
-		} while(strncasecmp(s, find, len) != 0);
-
-		s--;
-	}
-
-	return (char *) s;
+	return wi_memcasemem(s, strnlen(s, slen), find, strlen(find));
 }
 
 
 
 char * wi_strrnstr(const char *s, const char *find, size_t slen) {
-	const char	*p;
-	size_t		len;
-
-	len = strlen(find);
-
-	for(p = s + slen - 1; p >= s; --p) {
-		if(strncmp(p, find, len) == 0)
-			return (char *) p;
-	}
-
-	return NULL;
+	return wi_memrmem(s, strnlen(s, slen), find, strlen(find));
 }
 
 
 
 char * wi_strrncasestr(const char *s, const char *find, size_t slen) {
-	const char	*p;
-	size_t		len;
-
-	len = strlen(find);
-
-	for(p = s + slen - 1; p >= s; --p) {
-		if(strncmp(p, find, len) == 0)
-			return (char *) p;
-	}
-
-	return NULL;
+	return wi_memrcasemem(s, strnlen(s, slen), find, strlen(find));
 }
 
 
@@ -486,3 +360,246 @@ time_t wi_timegm(struct tm *tm) {
 	return clock;
 #endif
 }
+
+
+
+#pragma mark -
+
+static wi_boolean_t _wi_memmem_is_equal(const unsigned char *s, const unsigned char *find, size_t len, wi_boolean_t insensitive) {
+	size_t		i;
+
+	if(!insensitive)
+		return (memcmp(s, find, len) == 0);
+
+	for(i = 0; i < len; i++) {
+		if(_WI_COMPAT_TOLOWER(s[i]) != _WI_COMPAT_TOLOWER(find[i]))
+			return false;
+	}
+
+	return true;
+}
+
+
+
+static const unsigned char * _wi_memmem_scalar(const unsigned char *s, size_t first, size_t last, const unsigned char *find, size_t len, size_t anchor1, size_t anchor2, wi_boolean_t insensitive, wi_boolean_t backwards) {
+	unsigned char	c1, c2;
+	size_t			i;
+
+	c1 = _WI_COMPAT_TOLOWER(find[anchor1]);
+	c2 = _WI_COMPAT_TOLOWER(find[anchor2]);
+
+	for(i = 0; first + i <= last; i++) {
+		const unsigned char		*p = s + (backwards ? last - i : first + i);
+
+		if(insensitive) {
+			if(_WI_COMPAT_TOLOWER(p[anchor1]) != c1 || _WI_COMPAT_TOLOWER(p[anchor2]) != c2)
+				continue;
+		} else {
+			if(p[anchor1] != find[anchor1] || p[anchor2] != find[anchor2])
+				continue;
+		}
+
+		if(_wi_memmem_is_equal(p, find, len, insensitive))
+			return p;
+	}
+
+	return NULL;
+}
+
+
+
+#ifdef _WI_COMPAT_SSE2
+
+static const unsigned char * _wi_memmem_sse2(const unsigned char *s, size_t slen, const unsigned char *find, size_t len, size_t anchor1, size_t anchor2, wi_boolean_t insensitive, wi_boolean_t backwards) {
+	const unsigned char		*p;
+	__m128i					lower1, upper1, lower2, upper2, block1, block2;
+	size_t					i, last;
+	unsigned int			mask;
+	int						bit;
+
+	last	= slen - len;
+	lower1	= _mm_set1_epi8(insensitive ? _WI_COMPAT_TOLOWER(find[anchor1]) : find[anchor1]);
+	upper1	= _mm_set1_epi8(insensitive ? _WI_COMPAT_TOUPPER(find[anchor1]) : find[anchor1]);
+	lower2	= _mm_set1_epi8(insensitive ? _WI_COMPAT_TOLOWER(find[anchor2]) : find[anchor2]);
+	upper2	= _mm_set1_epi8(insensitive ? _WI_COMPAT_TOUPPER(find[anchor2]) : find[anchor2]);
+
+	if(!backwards) {
+		for(i = 0; i + 16 <= last + 1; i += 16) {
+			block1	= _mm_loadu_si128((const __m128i *) (s + i + anchor1));
+			block2	= _mm_loadu_si128((const __m128i *) (s + i + anchor2));
+			mask	= _mm_movemask_epi8(_mm_and_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(block1, lower1), _mm_cmpeq_epi8(block1, upper1)),
+				_mm_or_si128(_mm_cmpeq_epi8(block2, lower2), _mm_cmpeq_epi8(block2, upper2))));
+
+			while(mask != 0) {
+				bit = __builtin_ctz(mask);
+
+				if(_wi_memmem_is_equal(s + i + bit, find, len, insensitive))
+					return s + i + bit;
+
+				mask &= mask - 1;
+			}
+		}
+
+		return (i <= last) ? _wi_memmem_scalar(s, i, last, find, len, anchor1, anchor2, insensitive, false) : NULL;
+	} else {
+		for(i = last + 1; i >= 16; i -= 16) {
+			p		= s + i - 16;
+			block1	= _mm_loadu_si128((const __m128i *) (p + anchor1));
+			block2	= _mm_loadu_si128((const __m128i *) (p + anchor2));
+			mask	= _mm_movemask_epi8(_mm_and_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(block1, lower1), _mm_cmpeq_epi8(block1, upper1)),
+				_mm_or_si128(_mm_cmpeq_epi8(block2, lower2), _mm_cmpeq_epi8(block2, upper2))));
+
+			while(mask != 0) {
+				bit = 31 - __builtin_clz(mask);
+
+				if(_wi_memmem_is_equal(p + bit, find, len, insensitive))
+					return p + bit;
+
+				mask &= ~(1U << bit);
+			}
+		}
+
+		return (i > 0) ? _wi_memmem_scalar(s, 0, i - 1, find, len, anchor1, anchor2, insensitive, true) : NULL;
+	}
+}
+
+#endif
+
+
+
+#ifdef _WI_COMPAT_AVX2
+
+__attribute__((target("avx2")))
+static const unsigned char * _wi_memmem_avx2(const unsigned char *s, size_t slen, const unsigned char *find, size_t len, size_t anchor1, size_t anchor2, wi_boolean_t insensitive, wi_boolean_t backwards) {
+	const unsigned char		*p;
+	__m256i					lower1, upper1, lower2, upper2, block1, block2;
+	size_t					i, last;
+	unsigned int			mask;
+	int						bit;
+
+	last	= slen - len;
+	lower1	= _mm256_set1_epi8(insensitive ? _WI_COMPAT_TOLOWER(find[anchor1]) : find[anchor1]);
+	upper1	= _mm256_set1_epi8(insensitive ? _WI_COMPAT_TOUPPER(find[anchor1]) : find[anchor1]);
+	lower2	= _mm256_set1_epi8(insensitive ? _WI_COMPAT_TOLOWER(find[anchor2]) : find[anchor2]);
+	upper2	= _mm256_set1_epi8(insensitive ? _WI_COMPAT_TOUPPER(find[anchor2]) : find[anchor2]);
+
+	if(!backwards) {
+		for(i = 0; i + 32 <= last + 1; i += 32) {
+			block1	= _mm256_loadu_si256((const __m256i *) (s + i + anchor1));
+			block2	= _mm256_loadu_si256((const __m256i *) (s + i + anchor2));
+			mask	= _mm256_movemask_epi8(_mm256_and_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(block1, lower1), _mm256_cmpeq_epi8(block1, upper1)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(block2, lower2), _mm256_cmpeq_epi8(block2, upper2))));
+
+			while(mask != 0) {
+				bit = __builtin_ctz(mask);
+
+				if(_wi_memmem_is_equal(s + i + bit, find, len, insensitive))
+					return s + i + bit;
+
+				mask &= mask - 1;
+			}
+		}
+
+		return (i <= last) ? _wi_memmem_sse2(s + i, slen - i, find, len, anchor1, anchor2, insensitive, false) : NULL;
+	} else {
+		for(i = last + 1; i >= 32; i -= 32) {
+			p		= s + i - 32;
+			block1	= _mm256_loadu_si256((const __m256i *) (p + anchor1));
+			block2	= _mm256_loadu_si256((const __m256i *) (p + anchor2));
+			mask	= _mm256_movemask_epi8(_mm256_and_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(block1, lower1), _mm256_cmpeq_epi8(block1, upper1)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(block2, lower2), _mm256_cmpeq_epi8(block2, upper2))));
+
+			while(mask != 0) {
+				bit = 31 - __builtin_clz(mask);
+
+				if(_wi_memmem_is_equal(p + bit, find, len, insensitive))
+					return p + bit;
+
+				mask &= ~(1U << bit);
+			}
+		}
+
+		return (i > 0) ? _wi_memmem_sse2(s, i - 1 + len, find, len, anchor1, anchor2, insensitive, true) : NULL;
+	}
+}
+
+#endif
+
+
+
+void * wi_memmem_with_anchors(const void *s, size_t slen, const void *find, size_t len, size_t anchor1, size_t anchor2, wi_boolean_t insensitive, wi_boolean_t backwards) {
+	if(len == 0)
+		return (char *) s + (backwards ? slen : 0);
+
+	if(len > slen)
+		return NULL;
+
+#ifdef _WI_COMPAT_AVX2
+	if(_wi_memmem_avx2_supported < 0)
+		_wi_memmem_avx2_supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+
+	if(_wi_memmem_avx2_supported)
+		return (void *) _wi_memmem_avx2(s, slen, find, len, anchor1, anchor2, insensitive, backwards);
+#endif
+
+#ifdef _WI_COMPAT_SSE2
+	return (void *) _wi_memmem_sse2(s, slen, find, len, anchor1, anchor2, insensitive, backwards);
+#else
+	return (void *) _wi_memmem_scalar(s, 0, slen - len, find, len, anchor1, anchor2, insensitive, backwards);
+#endif
+}
+
+
+
+void * wi_memmem(const void *s, size_t slen, const void *find, size_t len) {
+	if(len == 1)
+		return memchr(s, *(const unsigned char *) find, slen);
+
+	return wi_memmem_with_anchors(s, slen, find, len, 0, len > 0 ? len - 1 : 0, false, false);
+}
+
+
+
+void * wi_memcasemem(const void *s, size_t slen, const void *find, size_t len) {
+	return wi_memmem_with_anchors(s, slen, find, len, 0, len > 0 ? len - 1 : 0, true, false);
+}
+
+
+
+void * wi_memrmem(const void *s, size_t slen, const void *find, size_t len) {
+	return wi_memmem_with_anchors(s, slen, find, len, 0, len > 0 ? len - 1 : 0, false, true);
+}
+
+
+
+void * wi_memrcasemem(const void *s, size_t slen, const void *find, size_t len) {
+	return wi_memmem_with_anchors(s, slen, find, len, 0, len > 0 ? len - 1 : 0, true, true);
+}
+
+
+
+void * wi_memcasechr(const void *s, int c, size_t slen) {
+	unsigned char	ch = c;
+
+	return wi_memmem_with_anchors(s, slen, &ch, 1, 0, 0, true, false);
+}
+
+
+
+void * wi_memrchr(const void *s, int c, size_t slen) {
+	unsigned char	ch = c;
+
+	return wi_memmem_with_anchors(s, slen, &ch, 1, 0, 0, false, true);
+}
+
+
+
+void * wi_memrcasechr(const void *s, int c, size_t slen) {
+	unsigned char	ch = c;
+
+	return wi_memmem_with_anchors(s, slen, &ch, 1, 0, 0, true, true);
+}
@@ -42,6 +42,13 @@ WI_EXPORT char *					wi_strcasestr(const char *, const char *);
 WI_EXPORT char *					wi_strncasestr(const char *, const char *, size_t);
 WI_EXPORT char *					wi_strrnstr(const char *, const char *, size_t);
 WI_EXPORT char *					wi_strrncasestr(const char *, const char *, size_t);
+WI_EXPORT void *					wi_memmem(const void *, size_t, const void *, size_t);
+WI_EXPORT void *					wi_memcasemem(const void *, size_t, const void *, size_t);
+WI_EXPORT void *					wi_memrmem(const void *, size_t, const void *, size_t);
+WI_EXPORT void *					wi_memrcasemem(const void *, size_t, const void *, size_t);
+WI_EXPORT void *					wi_memcasechr(const void *, int, size_t);
+WI_EXPORT void *					wi_memrchr(const void *, int, size_t);
+WI_EXPORT void *					wi_memrcasechr(const void *, int, size_t);
 WI_EXPORT size_t					wi_strlcat(char *, const char *, size_t);
 WI_EXPORT size_t					wi_strlcpy(char *, const char *, size_t);
 WI_EXPORT int						wi_asprintf(char **, const char *, ...);
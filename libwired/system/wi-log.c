@@ -79,7 +79,7 @@ wi_log_callback_func_t			*wi_log_callback = NULL;
 
 static int						_wi_log_lines;
 static wi_boolean_t				_wi_log_in_callback;
-static wi_recursive_lock_t		*_wi_log_lock;
+static wi_fast_lock_t			_wi_log_lock = WI_FAST_LOCK_INITIALIZER;
 
 
 
@@ -89,7 +89,6 @@ void wi_log_register(void) {
 
 
 void wi_log_initialize(void) {
-	_wi_log_lock = wi_recursive_lock_init(wi_recursive_lock_alloc());
 }
 
 
@@ -219,7 +218,7 @@ static void _wi_log_vlog(wi_log_level_t level, wi_string_t *fmt, va_list ap) {
 		syslog(priority, "%s", cstring);
 
 	if(wi_log_file && wi_log_path) {
-		wi_recursive_lock_lock(_wi_log_lock);
+		wi_fast_lock_lock(&_wi_log_lock);
 
 		path = wi_string_cstring(wi_log_path);
 
@@ -242,7 +241,7 @@ static void _wi_log_vlog(wi_log_level_t level, wi_string_t *fmt, va_list ap) {
 			fprintf(stderr, "%s: %s: %s\n", name, path, strerror(errno));
 		}
 
-		wi_recursive_lock_unlock(_wi_log_lock);
+		wi_fast_lock_unlock(&_wi_log_lock);
 	}
 
 	if(wi_log_callback) {
@@ -170,6 +170,20 @@ wi_uinteger_t wi_page_size(void) {
 
 
 
+wi_uinteger_t wi_processor_count(void) {
+#if defined(_SC_NPROCESSORS_ONLN)
+	long		count;
+	
+	count = sysconf(_SC_NPROCESSORS_ONLN);
+	
+	return (count > 0) ? (wi_uinteger_t) count : 1;
+#else
+	return 1;
+#endif
+}
+
+
+
 #pragma mark -
 
 pid_t wi_fork(void) {
@@ -29,19 +29,118 @@
 #include "config.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <signal.h>
+#include <time.h>
 
 #ifdef WI_PTHREADS
 #include <pthread.h>
+#include <sched.h>
 #endif
 
+#include <unistd.h>
+
+#ifdef HAVE_LINUX_FUTEX_H
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <wired/wi-array.h>
 #include <wired/wi-assert.h>
 #include <wired/wi-date.h>
+#include <wired/wi-dictionary.h>
 #include <wired/wi-lock.h>
+#include <wired/wi-log.h>
+#include <wired/wi-macros.h>
+#include <wired/wi-number.h>
+#include <wired/wi-pool.h>
 #include <wired/wi-private.h>
 #include <wired/wi-string.h>
 #include <wired/wi-runtime.h>
+#include <wired/wi-system.h>
+#include <wired/wi-thread.h>
+
+#define _WI_FAST_LOCK_MAX_SPINS			100
+
+#if defined(__i386__) || defined(__x86_64__)
+#define _WI_FAST_LOCK_PAUSE()			__builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define _WI_FAST_LOCK_PAUSE()			__asm__ __volatile__("yield")
+#else
+#define _WI_FAST_LOCK_PAUSE()			do { } while(0)
+#endif
+
+
+enum _wi_lock_profile_mode {
+	_WI_LOCK_PROFILE_SHARED,
+	_WI_LOCK_PROFILE_EXCLUSIVE,
+	_WI_LOCK_PROFILE_RECURSIVE
+};
+typedef enum _wi_lock_profile_mode		_wi_lock_profile_mode_t;
+
+
+struct _wi_lock_profile {
+	wi_runtime_instance_t				*lock;
+	wi_string_t							*name;
+	
+	uint64_t							acquisitions;
+	uint64_t							contentions;
+	uint64_t							total_wait;
+	uint64_t							max_wait;
+	uint64_t							max_hold;
+	
+	uint64_t							locked;
+	wi_uinteger_t						depth;
+	
+	wi_boolean_t						registered;
+	struct _wi_lock_profile				*previous, *next;
+};
+typedef struct _wi_lock_profile			_wi_lock_profile_t;
+
+
+struct _wi_lock_profile_snapshot {
+	wi_string_t							*name;
+	const char							*class_name;
+	void								*lock;
+	uint64_t							acquisitions;
+	uint64_t							contentions;
+	uint64_t							total_wait;
+	uint64_t							max_wait;
+	uint64_t							max_hold;
+};
+typedef struct _wi_lock_profile_snapshot	_wi_lock_profile_snapshot_t;
+
+
+#ifdef WI_PTHREADS
+static uint64_t							_wi_lock_profile_time(void);
+static void								_wi_lock_profile_update_max(uint64_t *, uint64_t);
+static void								_wi_lock_profile_register(_wi_lock_profile_t *, wi_runtime_instance_t *);
+static void								_wi_lock_profile_acquired(_wi_lock_profile_t *, wi_runtime_instance_t *, uint64_t, _wi_lock_profile_mode_t);
+static void								_wi_lock_profile_released(_wi_lock_profile_t *);
+static void								_wi_lock_profile_lock_mutex(_wi_lock_profile_t *, wi_runtime_instance_t *, pthread_mutex_t *, _wi_lock_profile_mode_t);
+static int								_wi_lock_profile_compare_snapshots(const void *, const void *);
+static _wi_lock_profile_snapshot_t *	_wi_lock_profile_copy_snapshots(wi_uinteger_t *);
+static void								_wi_lock_profile_create_signal_thread(void);
+static void								_wi_lock_profile_signal_handler(int);
+static void								_wi_lock_profile_signal_thread(wi_runtime_instance_t *);
+#endif
+
+static void								_wi_lock_profile_set_name(_wi_lock_profile_t *, wi_string_t *);
+static void								_wi_lock_profile_dealloc(_wi_lock_profile_t *);
+
+
+#ifdef WI_PTHREADS
+static volatile wi_boolean_t			_wi_lock_profiling;
+static pthread_mutex_t					_wi_lock_profiles_mutex = PTHREAD_MUTEX_INITIALIZER;
+static _wi_lock_profile_t				*_wi_lock_profiles;
+
+static pthread_once_t					_wi_lock_profile_signal_once = PTHREAD_ONCE_INIT;
+static int								_wi_lock_profile_signal_pipe[2] = { -1, -1 };
+#endif
+
+
 
 struct _wi_lock {
 	wi_runtime_base_t					base;
@@ -49,6 +148,8 @@ struct _wi_lock {
 #ifdef WI_PTHREADS
 	pthread_mutex_t						mutex;
 #endif
+	
+	_wi_lock_profile_t					profile;
 };
 
 static void								_wi_lock_dealloc(wi_runtime_instance_t *);
@@ -71,6 +172,8 @@ struct _wi_recursive_lock {
 #ifdef WI_PTHREADS
 	pthread_mutex_t						mutex;
 #endif
+	
+	_wi_lock_profile_t					profile;
 };
 
 static void								_wi_recursive_lock_dealloc(wi_runtime_instance_t *);
@@ -93,6 +196,8 @@ struct _wi_rwlock {
 #ifdef WI_PTHREADS
 	pthread_rwlock_t					rwlock;
 #endif
+	
+	_wi_lock_profile_t					profile;
 };
 
 static void								_wi_rwlock_dealloc(wi_runtime_instance_t *);
@@ -118,6 +223,8 @@ struct _wi_condition_lock {
 #endif
 	
 	int									condition;
+	
+	_wi_lock_profile_t					profile;
 };
 
 static void								_wi_condition_lock_dealloc(wi_runtime_instance_t *);
@@ -190,13 +297,29 @@ wi_lock_t * wi_lock_init(wi_lock_t *lock) {
 #pragma mark -
 
 static void _wi_lock_dealloc(wi_runtime_instance_t *instance) {
-#ifdef WI_PTHREADS
 	wi_lock_t		*lock = instance;
+#ifdef WI_PTHREADS
 	int				err;
 
 	if((err = pthread_mutex_destroy(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_destroy: %s", strerror(err));
 #endif
+	
+	_wi_lock_profile_dealloc(&lock->profile);
+}
+
+
+
+#pragma mark -
+
+void wi_lock_set_name(wi_lock_t *lock, wi_string_t *name) {
+	_wi_lock_profile_set_name(&lock->profile, name);
+}
+
+
+
+wi_string_t * wi_lock_name(wi_lock_t *lock) {
+	return lock->profile.name;
 }
 
 
@@ -207,6 +330,12 @@ void wi_lock_lock(wi_lock_t *lock) {
 #ifdef WI_PTHREADS
 	int		err;
 	
+	if(_wi_lock_profiling) {
+		_wi_lock_profile_lock_mutex(&lock->profile, lock, &lock->mutex, _WI_LOCK_PROFILE_EXCLUSIVE);
+		
+		return;
+	}
+	
 	if((err = pthread_mutex_lock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_lock: %s", strerror(err));
 #endif
@@ -216,7 +345,13 @@ void wi_lock_lock(wi_lock_t *lock) {
 
 wi_boolean_t wi_lock_trylock(wi_lock_t *lock) {
 #ifdef WI_PTHREADS
-	return (pthread_mutex_trylock(&lock->mutex) == 0);
+	if(pthread_mutex_trylock(&lock->mutex) != 0)
+		return false;
+	
+	if(_wi_lock_profiling)
+		_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_EXCLUSIVE);
+	
+	return true;
 #else
 	return true;
 #endif
@@ -228,6 +363,9 @@ void wi_lock_unlock(wi_lock_t *lock) {
 #ifdef WI_PTHREADS
 	int		err;
 	
+	if(lock->profile.depth > 0)
+		_wi_lock_profile_released(&lock->profile);
+	
 	if((err = pthread_mutex_unlock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_unlock: %s", strerror(err));
 #endif
@@ -277,13 +415,29 @@ wi_recursive_lock_t * wi_recursive_lock_init(wi_recursive_lock_t *lock) {
 #pragma mark -
 
 static void _wi_recursive_lock_dealloc(wi_runtime_instance_t *instance) {
-#ifdef WI_PTHREADS
 	wi_recursive_lock_t		*lock = instance;
+#ifdef WI_PTHREADS
 	int						err;
 
 	if((err = pthread_mutex_destroy(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_destroy: %s", strerror(err));
 #endif
+	
+	_wi_lock_profile_dealloc(&lock->profile);
+}
+
+
+
+#pragma mark -
+
+void wi_recursive_lock_set_name(wi_recursive_lock_t *lock, wi_string_t *name) {
+	_wi_lock_profile_set_name(&lock->profile, name);
+}
+
+
+
+wi_string_t * wi_recursive_lock_name(wi_recursive_lock_t *lock) {
+	return lock->profile.name;
 }
 
 
@@ -294,6 +448,12 @@ void wi_recursive_lock_lock(wi_recursive_lock_t *lock) {
 #ifdef WI_PTHREADS
 	int		err;
 	
+	if(_wi_lock_profiling) {
+		_wi_lock_profile_lock_mutex(&lock->profile, lock, &lock->mutex, _WI_LOCK_PROFILE_RECURSIVE);
+		
+		return;
+	}
+	
 	if((err = pthread_mutex_lock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_lock: %s", strerror(err));
 #endif
@@ -303,7 +463,13 @@ void wi_recursive_lock_lock(wi_recursive_lock_t *lock) {
 
 wi_boolean_t wi_recursive_lock_trylock(wi_recursive_lock_t *lock) {
 #ifdef WI_PTHREADS
-	return (pthread_mutex_trylock(&lock->mutex) == 0);
+	if(pthread_mutex_trylock(&lock->mutex) != 0)
+		return false;
+	
+	if(_wi_lock_profiling)
+		_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_RECURSIVE);
+	
+	return true;
 #else
 	return true;
 #endif
@@ -315,6 +481,9 @@ void wi_recursive_lock_unlock(wi_recursive_lock_t *lock) {
 #ifdef WI_PTHREADS
 	int		err;
 	
+	if(lock->profile.depth > 0)
+		_wi_lock_profile_released(&lock->profile);
+	
 	if((err = pthread_mutex_unlock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_unlock: %s", strerror(err));
 #endif
@@ -354,13 +523,29 @@ wi_rwlock_t * wi_rwlock_init(wi_rwlock_t *lock) {
 #pragma mark -
 
 static void _wi_rwlock_dealloc(wi_runtime_instance_t *instance) {
-#ifdef WI_PTHREADS
 	wi_rwlock_t		*lock = instance;
+#ifdef WI_PTHREADS
 	int				err;
 	
 	if((err = pthread_rwlock_destroy(&lock->rwlock)) != 0)
 		WI_ASSERT(0, "pthread_rwlock_destroy: %s", strerror(err));
 #endif
+	
+	_wi_lock_profile_dealloc(&lock->profile);
+}
+
+
+
+#pragma mark -
+
+void wi_rwlock_set_name(wi_rwlock_t *lock, wi_string_t *name) {
+	_wi_lock_profile_set_name(&lock->profile, name);
+}
+
+
+
+wi_string_t * wi_rwlock_name(wi_rwlock_t *lock) {
+	return lock->profile.name;
 }
 
 
@@ -369,10 +554,24 @@ static void _wi_rwlock_dealloc(wi_runtime_instance_t *instance) {
 
 void wi_rwlock_wrlock(wi_rwlock_t *lock) {
 #ifdef WI_PTHREADS
-	int		err;
+	uint64_t	start = 0;
+	int			err;
+	
+	if(_wi_lock_profiling) {
+		if(pthread_rwlock_trywrlock(&lock->rwlock) == 0) {
+			_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_EXCLUSIVE);
+			
+			return;
+		}
+		
+		start = _wi_lock_profile_time();
+	}
 	
 	if((err = pthread_rwlock_wrlock(&lock->rwlock)) != 0)
 		WI_ASSERT(0, "pthread_rwlock_wrlock: %s", strerror(err));
+	
+	if(start > 0)
+		_wi_lock_profile_acquired(&lock->profile, lock, start, _WI_LOCK_PROFILE_EXCLUSIVE);
 #endif
 }
 
@@ -380,7 +579,13 @@ void wi_rwlock_wrlock(wi_rwlock_t *lock) {
 
 wi_boolean_t wi_rwlock_trywrlock(wi_rwlock_t *lock) {
 #ifdef WI_PTHREADS
-	return (pthread_rwlock_trywrlock(&lock->rwlock) == 0);
+	if(pthread_rwlock_trywrlock(&lock->rwlock) != 0)
+		return false;
+	
+	if(_wi_lock_profiling)
+		_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_EXCLUSIVE);
+	
+	return true;
 #else
 	return true;
 #endif
@@ -390,10 +595,24 @@ wi_boolean_t wi_rwlock_trywrlock(wi_rwlock_t *lock) {
 
 void wi_rwlock_rdlock(wi_rwlock_t *lock) {
 #ifdef WI_PTHREADS
-	int		err;
+	uint64_t	start = 0;
+	int			err;
+	
+	if(_wi_lock_profiling) {
+		if(pthread_rwlock_tryrdlock(&lock->rwlock) == 0) {
+			_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_SHARED);
+			
+			return;
+		}
+		
+		start = _wi_lock_profile_time();
+	}
 	
 	if((err = pthread_rwlock_rdlock(&lock->rwlock)) != 0)
 		WI_ASSERT(0, "pthread_rwlock_rdlock: %s", strerror(err));
+	
+	if(start > 0)
+		_wi_lock_profile_acquired(&lock->profile, lock, start, _WI_LOCK_PROFILE_SHARED);
 #endif
 }
 
@@ -401,7 +620,13 @@ void wi_rwlock_rdlock(wi_rwlock_t *lock) {
 
 wi_boolean_t wi_rwlock_tryrdlock(wi_rwlock_t *lock) {
 #ifdef WI_PTHREADS
-	return (pthread_rwlock_tryrdlock(&lock->rwlock) == 0);
+	if(pthread_rwlock_tryrdlock(&lock->rwlock) != 0)
+		return false;
+	
+	if(_wi_lock_profiling)
+		_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_SHARED);
+	
+	return true;
 #else
 	return true;
 #endif
@@ -413,6 +638,10 @@ void wi_rwlock_unlock(wi_rwlock_t *lock) {
 #ifdef WI_PTHREADS
 	int		err;
 	
+	/* only a writer sets the depth, and no reader can hold the lock at the same time */
+	if(lock->profile.depth > 0)
+		_wi_lock_profile_released(&lock->profile);
+	
 	if((err = pthread_rwlock_unlock(&lock->rwlock)) != 0)
 		WI_ASSERT(0, "pthread_rwlock_unlock: %s", strerror(err));
 #endif
@@ -470,8 +699,8 @@ wi_condition_lock_t * wi_condition_lock_init_with_condition(wi_condition_lock_t
 #pragma mark -
 
 static void _wi_condition_lock_dealloc(wi_runtime_instance_t *instance) {
-#ifdef WI_PTHREADS
 	wi_condition_lock_t		*lock = instance;
+#ifdef WI_PTHREADS
 	int						err;
 
 	if((err = pthread_mutex_destroy(&lock->mutex)) != 0)
@@ -480,6 +709,22 @@ static void _wi_condition_lock_dealloc(wi_runtime_instance_t *instance) {
 	if((err = pthread_cond_destroy(&lock->cond)) != 0)
 		WI_ASSERT(0, "pthread_cond_destroy: %s", strerror(err));
 #endif
+	
+	_wi_lock_profile_dealloc(&lock->profile);
+}
+
+
+
+#pragma mark -
+
+void wi_condition_lock_set_name(wi_condition_lock_t *lock, wi_string_t *name) {
+	_wi_lock_profile_set_name(&lock->profile, name);
+}
+
+
+
+wi_string_t * wi_condition_lock_name(wi_condition_lock_t *lock) {
+	return lock->profile.name;
 }
 
 
@@ -490,6 +735,12 @@ void wi_condition_lock_lock(wi_condition_lock_t *lock) {
 #ifdef WI_PTHREADS
 	int		err;
 	
+	if(_wi_lock_profiling) {
+		_wi_lock_profile_lock_mutex(&lock->profile, lock, &lock->mutex, _WI_LOCK_PROFILE_EXCLUSIVE);
+		
+		return;
+	}
+	
 	if((err = pthread_mutex_lock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_lock: %s", strerror(err));
 #endif
@@ -502,8 +753,7 @@ wi_boolean_t wi_condition_lock_lock_when_condition(wi_condition_lock_t *lock, in
 	struct timespec		ts;
 	int					err;
 	
-	if((err = pthread_mutex_lock(&lock->mutex)) != 0)
-		WI_ASSERT(0, "pthread_mutex_lock: %s", strerror(err));
+	wi_condition_lock_lock(lock);
 	
 	if(lock->condition != condition) {
 		if(time > 0.0) {
@@ -517,6 +767,9 @@ wi_boolean_t wi_condition_lock_lock_when_condition(wi_condition_lock_t *lock, in
 			} while(lock->condition != condition && err != ETIMEDOUT);
 
 			if(err == ETIMEDOUT) {
+				if(lock->profile.depth > 0)
+					_wi_lock_profile_released(&lock->profile);
+				
 				if((err = pthread_mutex_unlock(&lock->mutex)) != 0)
 					WI_ASSERT(0, "pthread_mutex_unlock: %s", strerror(err));
 				
@@ -528,6 +781,10 @@ wi_boolean_t wi_condition_lock_lock_when_condition(wi_condition_lock_t *lock, in
 					WI_ASSERT(0, "pthread_cond_wait: %s", strerror(err));
 			} while(lock->condition != condition);
 		}
+		
+		/* waiting for the condition is not holding the lock */
+		if(lock->profile.depth > 0)
+			lock->profile.locked = _wi_lock_profile_time();
 	}
 	
 	return true;
@@ -540,7 +797,13 @@ wi_boolean_t wi_condition_lock_lock_when_condition(wi_condition_lock_t *lock, in
 
 wi_boolean_t wi_condition_lock_trylock(wi_condition_lock_t *lock) {
 #ifdef WI_PTHREADS
-	return (pthread_mutex_trylock(&lock->mutex) == 0);
+	if(pthread_mutex_trylock(&lock->mutex) != 0)
+		return false;
+	
+	if(_wi_lock_profiling)
+		_wi_lock_profile_acquired(&lock->profile, lock, 0, _WI_LOCK_PROFILE_EXCLUSIVE);
+	
+	return true;
 #else
 	return true;
 #endif
@@ -574,6 +837,9 @@ void wi_condition_lock_unlock(wi_condition_lock_t *lock) {
 	if((err = pthread_cond_broadcast(&lock->cond)) != 0)
 		WI_ASSERT(0, "pthread_cond_broadcast: %s", strerror(err));
 
+	if(lock->profile.depth > 0)
+		_wi_lock_profile_released(&lock->profile);
+	
 	if((err = pthread_mutex_unlock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_unlock: %s", strerror(err));
 #endif
@@ -592,6 +858,9 @@ void wi_condition_lock_unlock_with_condition(wi_condition_lock_t *lock, int cond
 	if((err = pthread_cond_broadcast(&lock->cond)) != 0)
 		WI_ASSERT(0, "pthread_cond_broadcast: %s", strerror(err));
 	
+	if(lock->profile.depth > 0)
+		_wi_lock_profile_released(&lock->profile);
+	
 	if((err = pthread_mutex_unlock(&lock->mutex)) != 0)
 		WI_ASSERT(0, "pthread_mutex_unlock: %s", strerror(err));
 #endif
@@ -602,3 +871,458 @@ void wi_condition_lock_unlock_with_condition(wi_condition_lock_t *lock, int cond
 int wi_condition_lock_condition(wi_condition_lock_t *lock) {
 	return lock->condition;
 }
+
+
+
+#pragma mark -
+
+void wi_lock_set_profiling_enabled(wi_boolean_t enabled) {
+#ifdef WI_PTHREADS
+	_wi_lock_profiling = enabled;
+#endif
+}
+
+
+
+wi_boolean_t wi_lock_profiling_enabled(void) {
+#ifdef WI_PTHREADS
+	return _wi_lock_profiling;
+#else
+	return false;
+#endif
+}
+
+
+
+void wi_lock_reset_profile(void) {
+#ifdef WI_PTHREADS
+	_wi_lock_profile_t		*profile;
+	
+	pthread_mutex_lock(&_wi_lock_profiles_mutex);
+	
+	for(profile = _wi_lock_profiles; profile; profile = profile->next) {
+		profile->acquisitions	= 0;
+		profile->contentions	= 0;
+		profile->total_wait		= 0;
+		profile->max_wait		= 0;
+		profile->max_hold		= 0;
+	}
+	
+	pthread_mutex_unlock(&_wi_lock_profiles_mutex);
+#endif
+}
+
+
+
+wi_array_t * wi_lock_profile(void) {
+	wi_mutable_array_t				*array;
+#ifdef WI_PTHREADS
+	_wi_lock_profile_snapshot_t		*snapshots;
+	wi_uinteger_t					i, count;
+#endif
+	
+	array = wi_mutable_array();
+	
+#ifdef WI_PTHREADS
+	snapshots = _wi_lock_profile_copy_snapshots(&count);
+	
+	for(i = 0; i < count; i++) {
+		wi_mutable_array_add_data(array, wi_dictionary_with_data_and_keys(
+			snapshots[i].name,											WI_STR("name"),
+			wi_number_with_int64(snapshots[i].acquisitions),			WI_STR("acquisitions"),
+			wi_number_with_int64(snapshots[i].contentions),				WI_STR("contentions"),
+			wi_number_with_double(snapshots[i].total_wait / 1.0e9),		WI_STR("total_wait"),
+			wi_number_with_double(snapshots[i].max_wait / 1.0e9),		WI_STR("max_wait"),
+			wi_number_with_double(snapshots[i].max_hold / 1.0e9),		WI_STR("max_hold"),
+			NULL));
+		
+		wi_release(snapshots[i].name);
+	}
+	
+	wi_free(snapshots);
+#endif
+	
+	wi_runtime_make_immutable(array);
+	
+	return array;
+}
+
+
+
+void wi_lock_log_profile(void) {
+#ifdef WI_PTHREADS
+	_wi_lock_profile_snapshot_t		*snapshots;
+	wi_uinteger_t					i, count;
+	
+	snapshots = _wi_lock_profile_copy_snapshots(&count);
+	
+	wi_log_info(WI_STR("Lock profile for %lu %s:"), (unsigned long) count, count == 1 ? "lock" : "locks");
+	
+	for(i = 0; i < count; i++) {
+		wi_log_info(WI_STR("%@: %llu acquisitions, %llu contended, %.6fs total wait, %.6fs max wait, %.6fs max hold"),
+			snapshots[i].name,
+			(unsigned long long) snapshots[i].acquisitions,
+			(unsigned long long) snapshots[i].contentions,
+			snapshots[i].total_wait / 1.0e9,
+			snapshots[i].max_wait / 1.0e9,
+			snapshots[i].max_hold / 1.0e9);
+		
+		wi_release(snapshots[i].name);
+	}
+	
+	wi_free(snapshots);
+#endif
+}
+
+
+
+wi_boolean_t wi_lock_log_profile_on_signal(int signal) {
+#ifdef WI_PTHREADS
+	struct sigaction	action;
+	
+	pthread_once(&_wi_lock_profile_signal_once, _wi_lock_profile_create_signal_thread);
+	
+	if(_wi_lock_profile_signal_pipe[1] < 0)
+		return false;
+	
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = _wi_lock_profile_signal_handler;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	
+	return (sigaction(signal, &action, NULL) == 0);
+#else
+	return false;
+#endif
+}
+
+
+
+#pragma mark -
+
+static void _wi_lock_profile_set_name(_wi_lock_profile_t *profile, wi_string_t *name) {
+	wi_string_t		*oldname;
+	
+	name = wi_copy(name);
+	
+#ifdef WI_PTHREADS
+	pthread_mutex_lock(&_wi_lock_profiles_mutex);
+#endif
+	
+	oldname = profile->name;
+	profile->name = name;
+	
+#ifdef WI_PTHREADS
+	pthread_mutex_unlock(&_wi_lock_profiles_mutex);
+#endif
+	
+	wi_release(oldname);
+}
+
+
+
+static void _wi_lock_profile_dealloc(_wi_lock_profile_t *profile) {
+#ifdef WI_PTHREADS
+	if(profile->registered) {
+		pthread_mutex_lock(&_wi_lock_profiles_mutex);
+		
+		if(profile->previous)
+			profile->previous->next = profile->next;
+		else
+			_wi_lock_profiles = profile->next;
+		
+		if(profile->next)
+			profile->next->previous = profile->previous;
+		
+		pthread_mutex_unlock(&_wi_lock_profiles_mutex);
+	}
+#endif
+	
+	wi_release(profile->name);
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static uint64_t _wi_lock_profile_time(void) {
+	struct timespec		ts;
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	
+	return ((uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+
+
+static void _wi_lock_profile_update_max(uint64_t *max, uint64_t value) {
+	uint64_t	oldvalue;
+	
+	do {
+		oldvalue = *max;
+		
+		if(value <= oldvalue)
+			return;
+	} while(!__sync_bool_compare_and_swap(max, oldvalue, value));
+}
+
+
+
+static void _wi_lock_profile_register(_wi_lock_profile_t *profile, wi_runtime_instance_t *lock) {
+	pthread_mutex_lock(&_wi_lock_profiles_mutex);
+	
+	if(!profile->registered) {
+		profile->lock		= lock;
+		profile->previous	= NULL;
+		profile->next		= _wi_lock_profiles;
+		
+		if(_wi_lock_profiles)
+			_wi_lock_profiles->previous = profile;
+		
+		_wi_lock_profiles = profile;
+		profile->registered = true;
+	}
+	
+	pthread_mutex_unlock(&_wi_lock_profiles_mutex);
+}
+
+
+
+static void _wi_lock_profile_acquired(_wi_lock_profile_t *profile, wi_runtime_instance_t *lock, uint64_t start, _wi_lock_profile_mode_t mode) {
+	uint64_t	now, wait;
+	
+	if(!profile->registered)
+		_wi_lock_profile_register(profile, lock);
+	
+	if(mode == _WI_LOCK_PROFILE_SHARED) {
+		__sync_add_and_fetch(&profile->acquisitions, 1);
+		
+		if(start > 0) {
+			wait = _wi_lock_profile_time() - start;
+			
+			__sync_add_and_fetch(&profile->contentions, 1);
+			__sync_add_and_fetch(&profile->total_wait, wait);
+			
+			_wi_lock_profile_update_max(&profile->max_wait, wait);
+		}
+		
+		return;
+	}
+	
+	/* the caller owns the lock exclusively here, so no atomics are needed */
+	now = _wi_lock_profile_time();
+	
+	profile->acquisitions++;
+	
+	if(start > 0) {
+		wait = now - start;
+		
+		profile->contentions++;
+		profile->total_wait += wait;
+		
+		if(wait > profile->max_wait)
+			profile->max_wait = wait;
+	}
+	
+	if(mode == _WI_LOCK_PROFILE_EXCLUSIVE) {
+		profile->locked = now;
+		profile->depth = 1;
+	}
+	else if(mode == _WI_LOCK_PROFILE_RECURSIVE) {
+		if(profile->depth++ == 0)
+			profile->locked = now;
+	}
+}
+
+
+
+static void _wi_lock_profile_released(_wi_lock_profile_t *profile) {
+	uint64_t	hold;
+	
+	if(--profile->depth > 0)
+		return;
+	
+	hold = _wi_lock_profile_time() - profile->locked;
+	
+	if(hold > profile->max_hold)
+		profile->max_hold = hold;
+}
+
+
+
+static void _wi_lock_profile_lock_mutex(_wi_lock_profile_t *profile, wi_runtime_instance_t *lock, pthread_mutex_t *mutex, _wi_lock_profile_mode_t mode) {
+	uint64_t	start = 0;
+	int			err;
+	
+	if(pthread_mutex_trylock(mutex) != 0) {
+		start = _wi_lock_profile_time();
+		
+		if((err = pthread_mutex_lock(mutex)) != 0)
+			WI_ASSERT(0, "pthread_mutex_lock: %s", strerror(err));
+	}
+	
+	_wi_lock_profile_acquired(profile, lock, start, mode);
+}
+
+
+
+static int _wi_lock_profile_compare_snapshots(const void *p1, const void *p2) {
+	const _wi_lock_profile_snapshot_t		*snapshot1 = p1, *snapshot2 = p2;
+	
+	if(snapshot1->total_wait > snapshot2->total_wait)
+		return -1;
+	else if(snapshot1->total_wait < snapshot2->total_wait)
+		return 1;
+	
+	return 0;
+}
+
+
+
+static _wi_lock_profile_snapshot_t * _wi_lock_profile_copy_snapshots(wi_uinteger_t *count) {
+	_wi_lock_profile_snapshot_t		*snapshots;
+	_wi_lock_profile_t				*profile;
+	wi_uinteger_t					i;
+	
+	pthread_mutex_lock(&_wi_lock_profiles_mutex);
+	
+	*count = 0;
+	
+	for(profile = _wi_lock_profiles; profile; profile = profile->next)
+		(*count)++;
+	
+	snapshots = wi_malloc(WI_MAX(*count, 1U) * sizeof(_wi_lock_profile_snapshot_t));
+	
+	for(i = 0, profile = _wi_lock_profiles; profile; i++, profile = profile->next) {
+		snapshots[i].name			= wi_retain(profile->name);
+		snapshots[i].class_name		= wi_runtime_class(profile->lock)->name;
+		snapshots[i].lock			= profile->lock;
+		snapshots[i].acquisitions	= profile->acquisitions;
+		snapshots[i].contentions	= profile->contentions;
+		snapshots[i].total_wait		= profile->total_wait;
+		snapshots[i].max_wait		= profile->max_wait;
+		snapshots[i].max_hold		= profile->max_hold;
+	}
+	
+	pthread_mutex_unlock(&_wi_lock_profiles_mutex);
+	
+	/* formatting may take other locks, so unnamed locks get their names outside the registry mutex */
+	for(i = 0; i < *count; i++) {
+		if(!snapshots[i].name) {
+			snapshots[i].name = wi_string_init_with_format(wi_string_alloc(), WI_STR("%s %p"),
+				snapshots[i].class_name, snapshots[i].lock);
+		}
+	}
+	
+	qsort(snapshots, *count, sizeof(_wi_lock_profile_snapshot_t), _wi_lock_profile_compare_snapshots);
+	
+	return snapshots;
+}
+
+
+
+static void _wi_lock_profile_create_signal_thread(void) {
+	if(pipe(_wi_lock_profile_signal_pipe) < 0)
+		return;
+	
+	if(!wi_thread_create_thread(_wi_lock_profile_signal_thread, NULL)) {
+		close(_wi_lock_profile_signal_pipe[0]);
+		close(_wi_lock_profile_signal_pipe[1]);
+		
+		_wi_lock_profile_signal_pipe[0] = _wi_lock_profile_signal_pipe[1] = -1;
+	}
+}
+
+
+
+static void _wi_lock_profile_signal_handler(int signal) {
+	char	byte = 0;
+	int		saved_errno;
+	
+	/* any thread may take the signal, so only hand it off to the logging thread here */
+	saved_errno = errno;
+	(void) write(_wi_lock_profile_signal_pipe[1], &byte, 1);
+	errno = saved_errno;
+}
+
+
+
+static void _wi_lock_profile_signal_thread(wi_runtime_instance_t *argument) {
+	wi_pool_t		*pool;
+	ssize_t			bytes;
+	char			byte;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	
+	while(true) {
+		bytes = read(_wi_lock_profile_signal_pipe[0], &byte, 1);
+		
+		if(bytes > 0)
+			wi_lock_log_profile();
+		else if(bytes == 0 || errno != EINTR)
+			break;
+		
+		wi_pool_drain(pool);
+	}
+	
+	wi_release(pool);
+}
+
+#endif
+
+
+
+#pragma mark -
+
+void wi_fast_lock_init(wi_fast_lock_t *lock) {
+	lock->state = 0;
+	lock->spins = 0;
+}
+
+
+
+#pragma mark -
+
+void wi_fast_lock_lock_contended(wi_fast_lock_t *lock) {
+#ifdef WI_PTHREADS
+	int32_t		i, spins;
+	
+	/* spin for about as long as the lock was held recently before sleeping */
+	spins = WI_MIN(_WI_FAST_LOCK_MAX_SPINS, (lock->spins * 2) + 10);
+	
+	for(i = 0; i < spins; i++) {
+		if(lock->state == 0 && __sync_bool_compare_and_swap(&lock->state, 0, 1)) {
+			lock->spins += (i - lock->spins) / 8;
+			
+			return;
+		}
+		
+		_WI_FAST_LOCK_PAUSE();
+	}
+	
+	lock->spins += (spins - lock->spins) / 8;
+	
+	/* state 2 means locked with possible sleepers, so that unlock knows to wake one */
+	while(__sync_lock_test_and_set(&lock->state, 2) != 0) {
+#ifdef HAVE_LINUX_FUTEX_H
+		syscall(SYS_futex, &lock->state, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+#else
+		sched_yield();
+#endif
+	}
+#endif
+}
+
+
+
+void wi_fast_lock_unlock_contended(wi_fast_lock_t *lock) {
+#ifdef WI_PTHREADS
+	lock->state = 0;
+	
+	__sync_synchronize();
+	
+#ifdef HAVE_LINUX_FUTEX_H
+	syscall(SYS_futex, &lock->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+#endif
+}
@@ -40,12 +40,23 @@ typedef struct _wi_rwlock				wi_rwlock_t;
 
 typedef struct _wi_condition_lock		wi_condition_lock_t;
 
+struct _wi_fast_lock {
+	volatile int32_t					state;
+	int32_t								spins;
+};
+typedef struct _wi_fast_lock			wi_fast_lock_t;
+
+#define WI_FAST_LOCK_INITIALIZER		{ 0, 0 }
+
 
 WI_EXPORT wi_runtime_id_t				wi_lock_runtime_id(void);
 
 WI_EXPORT wi_lock_t *					wi_lock_alloc(void);
 WI_EXPORT wi_lock_t *					wi_lock_init(wi_lock_t *);
 
+WI_EXPORT void							wi_lock_set_name(wi_lock_t *, wi_string_t *);
+WI_EXPORT wi_string_t *					wi_lock_name(wi_lock_t *);
+
 WI_EXPORT void							wi_lock_lock(wi_lock_t *);
 WI_EXPORT wi_boolean_t					wi_lock_trylock(wi_lock_t *);
 WI_EXPORT void							wi_lock_unlock(wi_lock_t *);
@@ -56,6 +67,9 @@ WI_EXPORT wi_runtime_id_t				wi_recursive_lock_runtime_id(void);
 WI_EXPORT wi_recursive_lock_t *			wi_recursive_lock_alloc(void);
 WI_EXPORT wi_recursive_lock_t *			wi_recursive_lock_init(wi_recursive_lock_t *);
 
+WI_EXPORT void							wi_recursive_lock_set_name(wi_recursive_lock_t *, wi_string_t *);
+WI_EXPORT wi_string_t *					wi_recursive_lock_name(wi_recursive_lock_t *);
+
 WI_EXPORT void							wi_recursive_lock_lock(wi_recursive_lock_t *);
 WI_EXPORT wi_boolean_t					wi_recursive_lock_trylock(wi_recursive_lock_t *);
 WI_EXPORT void							wi_recursive_lock_unlock(wi_recursive_lock_t *);
@@ -66,6 +80,9 @@ WI_EXPORT wi_runtime_id_t				wi_rwlock_runtime_id(void);
 WI_EXPORT wi_rwlock_t *					wi_rwlock_alloc(void);
 WI_EXPORT wi_rwlock_t *					wi_rwlock_init(wi_rwlock_t *);
 
+WI_EXPORT void							wi_rwlock_set_name(wi_rwlock_t *, wi_string_t *);
+WI_EXPORT wi_string_t *					wi_rwlock_name(wi_rwlock_t *);
+
 WI_EXPORT void							wi_rwlock_wrlock(wi_rwlock_t *);
 WI_EXPORT wi_boolean_t					wi_rwlock_trywrlock(wi_rwlock_t *);
 WI_EXPORT void							wi_rwlock_rdlock(wi_rwlock_t *);
@@ -79,6 +96,9 @@ WI_EXPORT wi_condition_lock_t *			wi_condition_lock_alloc(void);
 WI_EXPORT wi_condition_lock_t *			wi_condition_lock_init(wi_condition_lock_t *);
 WI_EXPORT wi_condition_lock_t *			wi_condition_lock_init_with_condition(wi_condition_lock_t *, int);
 
+WI_EXPORT void							wi_condition_lock_set_name(wi_condition_lock_t *, wi_string_t *);
+WI_EXPORT wi_string_t *					wi_condition_lock_name(wi_condition_lock_t *);
+
 WI_EXPORT void							wi_condition_lock_lock(wi_condition_lock_t *);
 WI_EXPORT wi_boolean_t					wi_condition_lock_lock_when_condition(wi_condition_lock_t *, int, wi_time_interval_t);
 WI_EXPORT wi_boolean_t					wi_condition_lock_trylock(wi_condition_lock_t *);
@@ -87,4 +107,45 @@ WI_EXPORT void							wi_condition_lock_unlock(wi_condition_lock_t *);
 WI_EXPORT void							wi_condition_lock_unlock_with_condition(wi_condition_lock_t *, int);
 WI_EXPORT int							wi_condition_lock_condition(wi_condition_lock_t *);
 
+
+WI_EXPORT void							wi_lock_set_profiling_enabled(wi_boolean_t);
+WI_EXPORT wi_boolean_t					wi_lock_profiling_enabled(void);
+WI_EXPORT void							wi_lock_reset_profile(void);
+WI_EXPORT wi_array_t *					wi_lock_profile(void);
+WI_EXPORT void							wi_lock_log_profile(void);
+WI_EXPORT wi_boolean_t					wi_lock_log_profile_on_signal(int);
+
+
+WI_EXPORT void							wi_fast_lock_init(wi_fast_lock_t *);
+
+WI_EXPORT void							wi_fast_lock_lock_contended(wi_fast_lock_t *);
+WI_EXPORT void							wi_fast_lock_unlock_contended(wi_fast_lock_t *);
+
+
+WI_STATIC_INLINE void wi_fast_lock_lock(wi_fast_lock_t *lock) {
+#ifdef WI_PTHREADS
+	if(!__sync_bool_compare_and_swap(&lock->state, 0, 1))
+		wi_fast_lock_lock_contended(lock);
+#endif
+}
+
+
+
+WI_STATIC_INLINE wi_boolean_t wi_fast_lock_trylock(wi_fast_lock_t *lock) {
+#ifdef WI_PTHREADS
+	return __sync_bool_compare_and_swap(&lock->state, 0, 1);
+#else
+	return true;
+#endif
+}
+
+
+
+WI_STATIC_INLINE void wi_fast_lock_unlock(wi_fast_lock_t *lock) {
+#ifdef WI_PTHREADS
+	if(__sync_fetch_and_sub(&lock->state, 1) != 1)
+		wi_fast_lock_unlock_contended(lock);
+#endif
+}
+
 #endif /* WI_LOCK_H */
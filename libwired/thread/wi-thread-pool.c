@@ -0,0 +1,665 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2003-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#ifndef WI_PTHREADS
+
+int wi_thread_pool_dummy = 0;
+
+#else
+
+#include <pthread.h>
+#include <string.h>
+
+#include <wired/wi-assert.h>
+#include <wired/wi-lock.h>
+#include <wired/wi-pool.h>
+#include <wired/wi-private.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-string.h>
+#include <wired/wi-system.h>
+#include <wired/wi-thread-pool.h>
+
+#define _WI_THREAD_POOL_DEQUE_INITIAL_CAPACITY	64
+
+#define _WI_THREAD_POOL_LOCK(mutex)												\
+	WI_STMT_START																\
+		int		_err;															\
+																				\
+		if((_err = pthread_mutex_lock((mutex))) != 0)							\
+			WI_ASSERT(0, "pthread_mutex_lock: %s", strerror(_err));				\
+	WI_STMT_END
+
+#define _WI_THREAD_POOL_UNLOCK(mutex)											\
+	WI_STMT_START																\
+		int		_err;															\
+																				\
+		if((_err = pthread_mutex_unlock((mutex))) != 0)							\
+			WI_ASSERT(0, "pthread_mutex_unlock: %s", strerror(_err));			\
+	WI_STMT_END
+
+
+struct _wi_thread_pool_task {
+	wi_thread_func_t					*function;
+	wi_thread_pool_func_t				*future_function;
+	wi_runtime_instance_t				*argument;
+	wi_future_t							*future;
+};
+typedef struct _wi_thread_pool_task		_wi_thread_pool_task_t;
+
+
+struct _wi_thread_pool_deque {
+	pthread_mutex_t						mutex;
+	
+	_wi_thread_pool_task_t				**tasks;
+	wi_uinteger_t						capacity;
+	wi_uinteger_t						head;
+	wi_uinteger_t						count;
+};
+typedef struct _wi_thread_pool_deque	_wi_thread_pool_deque_t;
+
+
+struct _wi_thread_pool_worker {
+	wi_thread_pool_t					*pool;
+	wi_uinteger_t						index;
+	
+	pthread_t							thread;
+	_wi_thread_pool_deque_t				deque;
+};
+typedef struct _wi_thread_pool_worker	_wi_thread_pool_worker_t;
+
+
+struct _wi_thread_pool {
+	wi_runtime_base_t					base;
+	
+	pthread_mutex_t						mutex;
+	pthread_cond_t						work_cond;
+	pthread_cond_t						idle_cond;
+	
+	_wi_thread_pool_deque_t				injector;
+	_wi_thread_pool_worker_t			*workers;
+	wi_uinteger_t						count;
+	wi_uinteger_t						started;
+	
+	wi_uinteger_t						pending;
+	wi_uinteger_t						active;
+	wi_uinteger_t						sleeping;
+	wi_uinteger_t						steals;
+	wi_boolean_t						stopping;
+};
+
+
+struct _wi_future {
+	wi_runtime_base_t					base;
+	
+	wi_condition_lock_t					*lock;
+	wi_runtime_instance_t				*result;
+};
+
+
+static void								_wi_thread_pool_dealloc(wi_runtime_instance_t *);
+static wi_string_t *					_wi_thread_pool_description(wi_runtime_instance_t *);
+
+static void								_wi_thread_pool_deque_init(_wi_thread_pool_deque_t *);
+static void								_wi_thread_pool_deque_destroy(_wi_thread_pool_deque_t *);
+static void								_wi_thread_pool_deque_push(_wi_thread_pool_deque_t *, _wi_thread_pool_task_t *);
+static _wi_thread_pool_task_t *			_wi_thread_pool_deque_pop(_wi_thread_pool_deque_t *);
+static _wi_thread_pool_task_t *			_wi_thread_pool_deque_steal(_wi_thread_pool_deque_t *);
+
+static void								_wi_thread_pool_add_task(wi_thread_pool_t *, _wi_thread_pool_task_t *);
+static _wi_thread_pool_task_t *			_wi_thread_pool_next_task(wi_thread_pool_t *, _wi_thread_pool_worker_t *);
+static void								_wi_thread_pool_run_task(_wi_thread_pool_task_t *);
+static void *							_wi_thread_pool_worker_thread(void *);
+
+static wi_future_t *					_wi_future_alloc(void);
+static wi_future_t *					_wi_future_init(wi_future_t *);
+static void								_wi_future_dealloc(wi_runtime_instance_t *);
+static void								_wi_future_complete(wi_future_t *, wi_runtime_instance_t *);
+
+
+static pthread_key_t					_wi_thread_pool_worker_key;
+
+static wi_runtime_id_t					_wi_thread_pool_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t				_wi_thread_pool_runtime_class = {
+	"wi_thread_pool_t",
+	_wi_thread_pool_dealloc,
+	NULL,
+	NULL,
+	_wi_thread_pool_description,
+	NULL
+};
+
+static wi_runtime_id_t					_wi_future_runtime_id = WI_RUNTIME_ID_NULL;
+static wi_runtime_class_t				_wi_future_runtime_class = {
+	"wi_future_t",
+	_wi_future_dealloc,
+	NULL,
+	NULL,
+	NULL,
+	NULL
+};
+
+
+
+void wi_thread_pool_register(void) {
+	_wi_thread_pool_runtime_id = wi_runtime_register_class(&_wi_thread_pool_runtime_class);
+	_wi_future_runtime_id = wi_runtime_register_class(&_wi_future_runtime_class);
+}
+
+
+
+void wi_thread_pool_initialize(void) {
+	pthread_key_create(&_wi_thread_pool_worker_key, NULL);
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_thread_pool_runtime_id(void) {
+	return _wi_thread_pool_runtime_id;
+}
+
+
+
+#pragma mark -
+
+wi_thread_pool_t * wi_thread_pool_alloc(void) {
+	return wi_runtime_create_instance(_wi_thread_pool_runtime_id, sizeof(wi_thread_pool_t));
+}
+
+
+
+wi_thread_pool_t * wi_thread_pool_init(wi_thread_pool_t *pool) {
+	return wi_thread_pool_init_with_workers(pool, wi_processor_count());
+}
+
+
+
+wi_thread_pool_t * wi_thread_pool_init_with_workers(wi_thread_pool_t *pool, wi_uinteger_t count) {
+	wi_uinteger_t		i;
+	int					err;
+	
+	if(count == 0)
+		count = 1;
+	
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->work_cond, NULL);
+	pthread_cond_init(&pool->idle_cond, NULL);
+	
+	_wi_thread_pool_deque_init(&pool->injector);
+	
+	pool->count		= count;
+	pool->workers	= wi_malloc(count * sizeof(_wi_thread_pool_worker_t));
+	
+	for(i = 0; i < count; i++) {
+		pool->workers[i].pool	= pool;
+		pool->workers[i].index	= i;
+		
+		_wi_thread_pool_deque_init(&pool->workers[i].deque);
+	}
+	
+	for(i = 0; i < count; i++) {
+		err = pthread_create(&pool->workers[i].thread, NULL, _wi_thread_pool_worker_thread, &pool->workers[i]);
+		
+		if(err != 0) {
+			wi_error_set_errno(err);
+			
+			wi_release(pool);
+			
+			return NULL;
+		}
+		
+		pool->started++;
+	}
+	
+	return pool;
+}
+
+
+
+static void _wi_thread_pool_dealloc(wi_runtime_instance_t *instance) {
+	wi_thread_pool_t			*pool = instance;
+	_wi_thread_pool_worker_t	*self;
+	_wi_thread_pool_task_t		*task;
+	wi_uinteger_t				i;
+	
+	/* the last reference may be dropped by a task running on one of our own workers */
+	self = pthread_getspecific(_wi_thread_pool_worker_key);
+	
+	if(self && self->pool != pool)
+		self = NULL;
+	
+	_WI_THREAD_POOL_LOCK(&pool->mutex);
+	pool->stopping = true;
+	pthread_cond_broadcast(&pool->work_cond);
+	_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+	
+	for(i = 0; i < pool->started; i++) {
+		if(&pool->workers[i] != self)
+			pthread_join(pool->workers[i].thread, NULL);
+	}
+	
+	if(self) {
+		while((task = _wi_thread_pool_next_task(pool, self)))
+			_wi_thread_pool_run_task(task);
+		
+		/* tell the worker to exit without touching the pool again */
+		pthread_setspecific(_wi_thread_pool_worker_key, NULL);
+		pthread_detach(self->thread);
+	}
+	
+	for(i = 0; i < pool->count; i++)
+		_wi_thread_pool_deque_destroy(&pool->workers[i].deque);
+	
+	_wi_thread_pool_deque_destroy(&pool->injector);
+	
+	wi_free(pool->workers);
+	
+	pthread_cond_destroy(&pool->idle_cond);
+	pthread_cond_destroy(&pool->work_cond);
+	pthread_mutex_destroy(&pool->mutex);
+}
+
+
+
+static wi_string_t * _wi_thread_pool_description(wi_runtime_instance_t *instance) {
+	wi_thread_pool_t		*pool = instance;
+	
+	return wi_string_with_format(WI_STR("<%@ %p>{workers = %lu, pending = %lu, active = %lu}"),
+		wi_runtime_class_name(pool),
+		pool,
+		pool->count,
+		pool->pending,
+		pool->active);
+}
+
+
+
+#pragma mark -
+
+static void _wi_thread_pool_deque_init(_wi_thread_pool_deque_t *deque) {
+	pthread_mutex_init(&deque->mutex, NULL);
+	
+	deque->capacity		= _WI_THREAD_POOL_DEQUE_INITIAL_CAPACITY;
+	deque->tasks		= wi_malloc(deque->capacity * sizeof(_wi_thread_pool_task_t *));
+	deque->head			= 0;
+	deque->count		= 0;
+}
+
+
+
+static void _wi_thread_pool_deque_destroy(_wi_thread_pool_deque_t *deque) {
+	wi_free(deque->tasks);
+	
+	pthread_mutex_destroy(&deque->mutex);
+}
+
+
+
+static void _wi_thread_pool_deque_push(_wi_thread_pool_deque_t *deque, _wi_thread_pool_task_t *task) {
+	_wi_thread_pool_task_t		**tasks;
+	wi_uinteger_t				i;
+	
+	_WI_THREAD_POOL_LOCK(&deque->mutex);
+	
+	if(deque->count == deque->capacity) {
+		tasks = wi_malloc(deque->capacity * 2 * sizeof(_wi_thread_pool_task_t *));
+		
+		for(i = 0; i < deque->count; i++)
+			tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+		
+		wi_free(deque->tasks);
+		
+		deque->tasks		= tasks;
+		deque->capacity		*= 2;
+		deque->head			= 0;
+	}
+	
+	deque->tasks[(deque->head + deque->count) % deque->capacity] = task;
+	deque->count++;
+	
+	_WI_THREAD_POOL_UNLOCK(&deque->mutex);
+}
+
+
+
+static _wi_thread_pool_task_t * _wi_thread_pool_deque_pop(_wi_thread_pool_deque_t *deque) {
+	_wi_thread_pool_task_t		*task = NULL;
+	
+	_WI_THREAD_POOL_LOCK(&deque->mutex);
+	
+	if(deque->count > 0) {
+		deque->count--;
+		
+		task = deque->tasks[(deque->head + deque->count) % deque->capacity];
+	}
+	
+	_WI_THREAD_POOL_UNLOCK(&deque->mutex);
+	
+	return task;
+}
+
+
+
+static _wi_thread_pool_task_t * _wi_thread_pool_deque_steal(_wi_thread_pool_deque_t *deque) {
+	_wi_thread_pool_task_t		*task = NULL;
+	
+	_WI_THREAD_POOL_LOCK(&deque->mutex);
+	
+	if(deque->count > 0) {
+		task = deque->tasks[deque->head];
+		
+		deque->head = (deque->head + 1) % deque->capacity;
+		deque->count--;
+	}
+	
+	_WI_THREAD_POOL_UNLOCK(&deque->mutex);
+	
+	return task;
+}
+
+
+
+#pragma mark -
+
+void wi_thread_pool_add_task(wi_thread_pool_t *pool, wi_thread_func_t *function, wi_runtime_instance_t *argument) {
+	_wi_thread_pool_task_t		*task;
+	
+	task				= wi_malloc(sizeof(_wi_thread_pool_task_t));
+	task->function		= function;
+	task->argument		= wi_retain(argument);
+	
+	_wi_thread_pool_add_task(pool, task);
+}
+
+
+
+wi_future_t * wi_thread_pool_submit_task(wi_thread_pool_t *pool, wi_thread_pool_func_t *function, wi_runtime_instance_t *argument) {
+	_wi_thread_pool_task_t		*task;
+	wi_future_t					*future;
+	
+	future					= _wi_future_init(_wi_future_alloc());
+	
+	task					= wi_malloc(sizeof(_wi_thread_pool_task_t));
+	task->future_function	= function;
+	task->argument			= wi_retain(argument);
+	task->future			= wi_retain(future);
+	
+	_wi_thread_pool_add_task(pool, task);
+	
+	return wi_autorelease(future);
+}
+
+
+
+void wi_thread_pool_wait_until_idle(wi_thread_pool_t *pool) {
+	_WI_THREAD_POOL_LOCK(&pool->mutex);
+	
+	while(pool->pending > 0 || pool->active > 0)
+		pthread_cond_wait(&pool->idle_cond, &pool->mutex);
+	
+	_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+}
+
+
+
+#pragma mark -
+
+wi_uinteger_t wi_thread_pool_workers(wi_thread_pool_t *pool) {
+	return pool->count;
+}
+
+
+
+wi_uinteger_t wi_thread_pool_steals(wi_thread_pool_t *pool) {
+	wi_uinteger_t		steals;
+	
+	_WI_THREAD_POOL_LOCK(&pool->mutex);
+	steals = pool->steals;
+	_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+	
+	return steals;
+}
+
+
+
+#pragma mark -
+
+static void _wi_thread_pool_add_task(wi_thread_pool_t *pool, _wi_thread_pool_task_t *task) {
+	_wi_thread_pool_worker_t	*worker;
+	
+	worker = pthread_getspecific(_wi_thread_pool_worker_key);
+	
+	_WI_THREAD_POOL_LOCK(&pool->mutex);
+	
+	WI_ASSERT(!pool->stopping, "task added to %@ while it is being deallocated", pool);
+	
+	/* tasks spawned by a worker stay on its own deque, everything else goes through the shared queue in order */
+	if(worker && worker->pool == pool)
+		_wi_thread_pool_deque_push(&worker->deque, task);
+	else
+		_wi_thread_pool_deque_push(&pool->injector, task);
+	
+	pool->pending++;
+	
+	if(pool->sleeping > 0)
+		pthread_cond_signal(&pool->work_cond);
+	
+	_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+}
+
+
+
+static _wi_thread_pool_task_t * _wi_thread_pool_next_task(wi_thread_pool_t *pool, _wi_thread_pool_worker_t *worker) {
+	_wi_thread_pool_task_t		*task;
+	wi_uinteger_t				i;
+	
+	task = _wi_thread_pool_deque_pop(&worker->deque);
+	
+	if(task)
+		return task;
+	
+	task = _wi_thread_pool_deque_steal(&pool->injector);
+	
+	if(task)
+		return task;
+	
+	for(i = 1; i < pool->count; i++) {
+		task = _wi_thread_pool_deque_steal(&pool->workers[(worker->index + i) % pool->count].deque);
+		
+		if(task) {
+			_WI_THREAD_POOL_LOCK(&pool->mutex);
+			pool->steals++;
+			_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+			
+			return task;
+		}
+	}
+	
+	return NULL;
+}
+
+
+
+static void _wi_thread_pool_run_task(_wi_thread_pool_task_t *task) {
+	wi_runtime_instance_t		*result;
+	
+	if(task->future) {
+		result = (*task->future_function)(task->argument);
+		
+		_wi_future_complete(task->future, result);
+		
+		wi_release(task->future);
+	} else {
+		(*task->function)(task->argument);
+	}
+	
+	wi_release(task->argument);
+	wi_free(task);
+}
+
+
+
+static void * _wi_thread_pool_worker_thread(void *argument) {
+	_wi_thread_pool_worker_t	*worker = argument;
+	_wi_thread_pool_task_t		*task;
+	wi_thread_pool_t			*pool;
+	wi_pool_t					*autorelease_pool;
+	
+	pool = worker->pool;
+	
+	wi_thread_enter_thread();
+	
+	pthread_setspecific(_wi_thread_pool_worker_key, worker);
+	
+	autorelease_pool = wi_pool_init(wi_pool_alloc());
+	
+	while(true) {
+		task = _wi_thread_pool_next_task(pool, worker);
+		
+		if(task) {
+			_WI_THREAD_POOL_LOCK(&pool->mutex);
+			pool->pending--;
+			pool->active++;
+			_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+			
+			_wi_thread_pool_run_task(task);
+			
+			wi_pool_drain(autorelease_pool);
+			
+			if(pthread_getspecific(_wi_thread_pool_worker_key) != worker)
+				break;
+			
+			_WI_THREAD_POOL_LOCK(&pool->mutex);
+			pool->active--;
+			
+			if(pool->pending == 0 && pool->active == 0)
+				pthread_cond_broadcast(&pool->idle_cond);
+			
+			_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+			
+			continue;
+		}
+		
+		_WI_THREAD_POOL_LOCK(&pool->mutex);
+		
+		while(pool->pending == 0 && !pool->stopping) {
+			pool->sleeping++;
+			pthread_cond_wait(&pool->work_cond, &pool->mutex);
+			pool->sleeping--;
+		}
+		
+		if(pool->pending == 0 && pool->stopping) {
+			_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+			
+			break;
+		}
+		
+		_WI_THREAD_POOL_UNLOCK(&pool->mutex);
+	}
+	
+	wi_release(autorelease_pool);
+	
+	pthread_setspecific(_wi_thread_pool_worker_key, NULL);
+	
+	wi_thread_exit_thread();
+	
+	return NULL;
+}
+
+
+
+#pragma mark -
+
+wi_runtime_id_t wi_future_runtime_id(void) {
+	return _wi_future_runtime_id;
+}
+
+
+
+#pragma mark -
+
+static wi_future_t * _wi_future_alloc(void) {
+	return wi_runtime_create_instance(_wi_future_runtime_id, sizeof(wi_future_t));
+}
+
+
+
+static wi_future_t * _wi_future_init(wi_future_t *future) {
+	future->lock = wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0);
+	
+	return future;
+}
+
+
+
+static void _wi_future_dealloc(wi_runtime_instance_t *instance) {
+	wi_future_t		*future = instance;
+	
+	wi_release(future->lock);
+	wi_release(future->result);
+}
+
+
+
+static void _wi_future_complete(wi_future_t *future, wi_runtime_instance_t *result) {
+	wi_condition_lock_lock(future->lock);
+	future->result = wi_retain(result);
+	wi_condition_lock_unlock_with_condition(future->lock, 1);
+}
+
+
+
+#pragma mark -
+
+wi_boolean_t wi_future_wait(wi_future_t *future, wi_time_interval_t timeout) {
+	if(!wi_condition_lock_lock_when_condition(future->lock, 1, timeout))
+		return false;
+	
+	wi_condition_lock_unlock(future->lock);
+	
+	return true;
+}
+
+
+
+wi_boolean_t wi_future_is_done(wi_future_t *future) {
+	return (wi_condition_lock_condition(future->lock) == 1);
+}
+
+
+
+wi_runtime_instance_t * wi_future_result(wi_future_t *future) {
+	wi_future_wait(future, 0.0);
+	
+	return future->result;
+}
+
+#endif
@@ -0,0 +1,62 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2003-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WI_THREAD_POOL_H
+#define WI_THREAD_POOL_H 1
+
+#include <wired/wi-base.h>
+#include <wired/wi-runtime.h>
+#include <wired/wi-thread.h>
+
+typedef struct _wi_thread_pool			wi_thread_pool_t;
+typedef struct _wi_future				wi_future_t;
+
+typedef wi_runtime_instance_t *			wi_thread_pool_func_t(wi_runtime_instance_t *);
+
+
+WI_EXPORT wi_runtime_id_t				wi_thread_pool_runtime_id(void);
+
+WI_EXPORT wi_thread_pool_t *			wi_thread_pool_alloc(void);
+WI_EXPORT wi_thread_pool_t *			wi_thread_pool_init(wi_thread_pool_t *);
+WI_EXPORT wi_thread_pool_t *			wi_thread_pool_init_with_workers(wi_thread_pool_t *, wi_uinteger_t);
+
+WI_EXPORT void							wi_thread_pool_add_task(wi_thread_pool_t *, wi_thread_func_t *, wi_runtime_instance_t *);
+WI_EXPORT wi_future_t *					wi_thread_pool_submit_task(wi_thread_pool_t *, wi_thread_pool_func_t *, wi_runtime_instance_t *);
+WI_EXPORT void							wi_thread_pool_wait_until_idle(wi_thread_pool_t *);
+
+WI_EXPORT wi_uinteger_t					wi_thread_pool_workers(wi_thread_pool_t *);
+WI_EXPORT wi_uinteger_t					wi_thread_pool_steals(wi_thread_pool_t *);
+
+
+WI_EXPORT wi_runtime_id_t				wi_future_runtime_id(void);
+
+WI_EXPORT wi_boolean_t					wi_future_wait(wi_future_t *, wi_time_interval_t);
+WI_EXPORT wi_boolean_t					wi_future_is_done(wi_future_t *);
+WI_EXPORT wi_runtime_instance_t *		wi_future_result(wi_future_t *);
+
+#endif /* WI_THREAD_POOL_H */
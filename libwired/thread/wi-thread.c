@@ -46,6 +46,10 @@
 
 #define _WI_THREAD_KEY					"_wi_thread_t"
 
+#if defined(WI_PTHREADS) && defined(__GNUC__) && (!defined(__APPLE__) || defined(__clang__))
+#define _WI_THREAD_TLS					1
+#endif
+
 
 struct _wi_thread {
 	wi_runtime_base_t					base;
@@ -55,11 +59,13 @@ struct _wi_thread {
 #endif
 	
 	void								*poolstack;
+	void								*error;
 };
 
 
 static wi_thread_t *					_wi_thread_alloc(void);
 static wi_thread_t *					_wi_thread_init(wi_thread_t *);
+static void								_wi_thread_dealloc(wi_runtime_instance_t *);
 
 #ifdef WI_PTHREADS
 static void *							_wi_thread_trampoline(void *);
@@ -75,10 +81,14 @@ static wi_dictionary_t					*_wi_thread_dictionary;
 static wi_thread_t						*_wi_thread_thread;
 #endif
 
+#ifdef _WI_THREAD_TLS
+static __thread wi_thread_t				*_wi_thread_tls_thread;
+#endif
+
 static wi_runtime_id_t					_wi_thread_runtime_id = WI_RUNTIME_ID_NULL;
 static wi_runtime_class_t				_wi_thread_runtime_class = {
 	"wi_thread_t",
-	NULL,
+	_wi_thread_dealloc,
 	NULL,
 	NULL,
 	NULL,
@@ -177,6 +187,14 @@ static wi_thread_t * _wi_thread_init(wi_thread_t *thread) {
 
 
 
+static void _wi_thread_dealloc(wi_runtime_instance_t *instance) {
+	wi_thread_t		*thread = instance;
+	
+	wi_release(thread->error);
+}
+
+
+
 #pragma mark -
 
 #ifdef WI_PTHREADS
@@ -221,6 +239,10 @@ void wi_thread_enter_thread(void) {
 #else
 	_wi_thread_thread = thread;
 #endif
+
+#ifdef _WI_THREAD_TLS
+	_wi_thread_tls_thread = thread;
+#endif
 	
 	dictionary = wi_dictionary_init(wi_mutable_dictionary_alloc());
 
@@ -236,10 +258,24 @@ void wi_thread_enter_thread(void) {
 
 
 void wi_thread_exit_thread(void) {
+	wi_thread_t		*thread;
+	
 	wi_socket_exit_thread();
 	
+	thread = wi_thread_current_thread();
+	
 	wi_release(wi_thread_dictionary());
-	wi_release(wi_thread_current_thread());
+
+#ifdef WI_PTHREADS
+	pthread_setspecific(_wi_thread_dictionary_key, NULL);
+	pthread_setspecific(_wi_thread_thread_key, NULL);
+#endif
+
+#ifdef _WI_THREAD_TLS
+	_wi_thread_tls_thread = NULL;
+#endif
+
+	wi_release(thread);
 }
 
 
@@ -247,7 +283,9 @@ void wi_thread_exit_thread(void) {
 #pragma mark -
 
 wi_thread_t * wi_thread_current_thread(void) {
-#ifdef WI_PTHREADS
+#if defined(_WI_THREAD_TLS)
+	return _wi_thread_tls_thread;
+#elif defined(WI_PTHREADS)
 	return pthread_getspecific(_wi_thread_thread_key);
 #else
 	return _wi_thread_thread;
@@ -280,6 +318,21 @@ void * wi_thread_poolstack(wi_thread_t *thread) {
 
 
 
+void wi_thread_set_error(wi_thread_t *thread, void *error) {
+	wi_retain(error);
+	wi_release(thread->error);
+	
+	thread->error = error;
+}
+
+
+
+void * wi_thread_error(wi_thread_t *thread) {
+	return thread->error;
+}
+
+
+
 #pragma mark -
 
 void wi_thread_sleep(wi_time_interval_t interval) {
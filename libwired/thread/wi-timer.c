@@ -37,16 +37,21 @@ int wi_timer_dummy = 0;
 #include <pthread.h>
 
 #include <wired/wi-date.h>
-#include <wired/wi-lock.h>
+#include <wired/wi-event-loop.h>
 #include <wired/wi-log.h>
 #include <wired/wi-macros.h>
+#include <wired/wi-pool.h>
 #include <wired/wi-private.h>
 #include <wired/wi-runtime.h>
 #include <wired/wi-string.h>
+#include <wired/wi-system.h>
 #include <wired/wi-thread.h>
+#include <wired/wi-thread-pool.h>
 #include <wired/wi-timer.h>
 
 #define _WI_TIMER_MINIMUM_INTERVAL		0.001
+#define _WI_TIMER_HEAP_ARITY			4
+#define _WI_TIMER_HEAP_INITIAL_CAPACITY	64
 
 
 struct _wi_timer {
@@ -57,28 +62,36 @@ struct _wi_timer {
 	wi_boolean_t						repeats;
 
 	wi_boolean_t						scheduled;
-	wi_boolean_t						incallback;
+	wi_boolean_t						invalidated;
+	wi_uinteger_t						index;
 	wi_time_interval_t					fire;
 	
+	wi_thread_pool_t					*thread_pool;
+	wi_event_loop_t						*event_loop;
 	void								*data;
 };
 
 
 static void								_wi_timer_dealloc(wi_runtime_instance_t *);
 static wi_string_t *					_wi_timer_description(wi_runtime_instance_t *);
-static wi_integer_t						_wi_timer_compare(wi_runtime_instance_t *, wi_runtime_instance_t *);
 
 static void								_wi_timer_create_thread(void);
 static void								_wi_timer_thread(wi_runtime_instance_t *);
-static wi_timer_t *						_wi_timer_first_timer(void);
+static void								_wi_timer_fire_scheduled(wi_runtime_instance_t *);
+
+static void								_wi_timer_heap_sift_up(wi_uinteger_t);
+static void								_wi_timer_heap_sift_down(wi_uinteger_t);
+static void								_wi_timer_heap_remove(wi_timer_t *);
 
 static void								_wi_timer_schedule(wi_timer_t *);
-static void								_wi_timer_invalidate(wi_timer_t *);
 
 
-static wi_mutable_array_t				*_wi_timers;
+static wi_timer_t						**_wi_timer_heap;
+static wi_uinteger_t					_wi_timer_heap_count;
+static wi_uinteger_t					_wi_timer_heap_capacity;
 
-static wi_condition_lock_t				*_wi_timer_lock;
+static pthread_mutex_t					_wi_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t					_wi_timer_cond = PTHREAD_COND_INITIALIZER;
 
 static pthread_once_t					_wi_timer_once_control = PTHREAD_ONCE_INIT;
 
@@ -101,8 +114,8 @@ void wi_timer_register(void) {
 
 
 void wi_timer_initialize(void) {
-	_wi_timers			= wi_array_init(wi_mutable_array_alloc());
-	_wi_timer_lock		= wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0);
+	_wi_timer_heap_capacity		= _WI_TIMER_HEAP_INITIAL_CAPACITY;
+	_wi_timer_heap				= wi_malloc(_wi_timer_heap_capacity * sizeof(wi_timer_t *));
 }
 
 
@@ -126,69 +139,91 @@ static void _wi_timer_create_thread(void) {
 
 static void _wi_timer_thread(wi_runtime_instance_t *argument) {
 	wi_pool_t			*pool;
-	wi_timer_t			*timer, *fire_timer;
-	wi_time_interval_t	interval, diff;
-	wi_boolean_t		locked;
+	wi_timer_t			*timer, **batch;
+	wi_time_interval_t	interval;
+	struct timespec		ts;
+	wi_uinteger_t		i, count, capacity;
 	
-	pool = wi_pool_init(wi_pool_alloc());
+	pool		= wi_pool_init(wi_pool_alloc());
+	capacity	= _WI_TIMER_HEAP_INITIAL_CAPACITY;
+	batch		= wi_malloc(capacity * sizeof(wi_timer_t *));
 	
 	while(true) {
-		fire_timer	= NULL;
-		locked		= true;
-		interval	= wi_time_interval();
-		timer		= _wi_timer_first_timer();
-
-		if(!timer) {
-			locked = wi_condition_lock_lock_when_condition(_wi_timer_lock, 1, 0.0);
-
-			timer = _wi_timer_first_timer();
+		pthread_mutex_lock(&_wi_timer_mutex);
+		
+		while(true) {
 			interval = wi_time_interval();
-
-			if(timer && timer->fire - interval <= _WI_TIMER_MINIMUM_INTERVAL)
-				fire_timer = timer;
-		} else {
-			diff = timer->fire - interval;
-
-			if(diff <= _WI_TIMER_MINIMUM_INTERVAL) {
-				fire_timer = timer;
-
-				locked = false;
-			} else {
-				locked = wi_condition_lock_lock_when_condition(_wi_timer_lock, 1, diff);
+			
+			if(_wi_timer_heap_count == 0) {
+				pthread_cond_wait(&_wi_timer_cond, &_wi_timer_mutex);
+			}
+			else if(_wi_timer_heap[0]->fire - interval > _WI_TIMER_MINIMUM_INTERVAL) {
+				ts = wi_dtots(_wi_timer_heap[0]->fire);
 				
-				if(!locked)
-					fire_timer = _wi_timer_first_timer();
-			} 
+				pthread_cond_timedwait(&_wi_timer_cond, &_wi_timer_mutex, &ts);
+			}
+			else {
+				break;
+			}
 		}
-
-		if(locked)
-			wi_condition_lock_unlock_with_condition(_wi_timer_lock, 0);
 		
-		if(fire_timer) {
-			_wi_timer_invalidate(fire_timer);
-				
-			wi_timer_fire(fire_timer);
-
-			if(timer->repeats)
-				_wi_timer_schedule(fire_timer);
+		count = 0;
+		
+		while(_wi_timer_heap_count > 0 && _wi_timer_heap[0]->fire - interval <= _WI_TIMER_MINIMUM_INTERVAL) {
+			if(count == capacity) {
+				capacity *= 2;
+				batch = wi_realloc(batch, capacity * sizeof(wi_timer_t *));
+			}
+			
+			batch[count++] = _wi_timer_heap[0];
+			
+			_wi_timer_heap_remove(_wi_timer_heap[0]);
+		}
+		
+		pthread_mutex_unlock(&_wi_timer_mutex);
+		
+		for(i = 0; i < count; i++) {
+			timer = batch[i];
+			
+			if(timer->thread_pool)
+				wi_thread_pool_add_task(timer->thread_pool, _wi_timer_fire_scheduled, timer);
+			else
+				_wi_timer_fire_scheduled(timer);
+			
+			wi_release(timer);
 		}
 		
 		wi_pool_drain(pool);
 	}
-
+	
+	wi_free(batch);
 	wi_release(pool);
 }
 
 
 
-static wi_timer_t * _wi_timer_first_timer(void) {
-	wi_timer_t		*timer;
+static void _wi_timer_fire_scheduled(wi_runtime_instance_t *instance) {
+	wi_timer_t		*timer = instance;
+	wi_boolean_t	invalidated;
 	
-	wi_array_rdlock(_wi_timers);
-	timer = wi_autorelease(wi_retain(wi_array_first_data(_wi_timers)));
-	wi_array_unlock(_wi_timers);
+	/* the timer may have been invalidated after it was taken off the heap */
+	pthread_mutex_lock(&_wi_timer_mutex);
+	invalidated = timer->invalidated;
+	pthread_mutex_unlock(&_wi_timer_mutex);
 	
-	return timer;
+	if(invalidated)
+		return;
+	
+	wi_timer_fire(timer);
+	
+	if(timer->repeats) {
+		pthread_mutex_lock(&_wi_timer_mutex);
+		
+		if(!timer->scheduled && !timer->invalidated)
+			_wi_timer_schedule(timer);
+		
+		pthread_mutex_unlock(&_wi_timer_mutex);
+	}
 }
 
 
@@ -205,6 +240,7 @@ wi_timer_t * wi_timer_init_with_function(wi_timer_t *timer, wi_timer_func_t *fun
 	timer->func = func;
 	timer->interval = WI_MAX(interval, _WI_TIMER_MINIMUM_INTERVAL);
 	timer->repeats = repeats;
+	timer->index = WI_NOT_FOUND;
 	
 	return timer;
 }
@@ -214,7 +250,8 @@ wi_timer_t * wi_timer_init_with_function(wi_timer_t *timer, wi_timer_func_t *fun
 static void _wi_timer_dealloc(wi_runtime_instance_t *instance) {
 	wi_timer_t		*timer = instance;
 	
-	wi_timer_invalidate(timer);
+	wi_release(timer->thread_pool);
+	wi_release(timer->event_loop);
 }
 
 
@@ -230,40 +267,107 @@ static wi_string_t * _wi_timer_description(wi_runtime_instance_t *instance) {
 
 
 
-static wi_integer_t _wi_timer_compare(wi_runtime_instance_t *instance1, wi_runtime_instance_t *instance2) {
-	wi_timer_t		*timer1 = instance1;
-	wi_timer_t		*timer2 = instance2;
+#pragma mark -
 
-	if(timer1->fire < timer2->fire)
-		return -1;
-	else if(timer1->fire < timer2->fire)
-		return 1;
+static void _wi_timer_heap_sift_up(wi_uinteger_t index) {
+	wi_timer_t		*timer;
+	wi_uinteger_t	parent;
+	
+	timer = _wi_timer_heap[index];
 	
-	return 0;
+	while(index > 0) {
+		parent = (index - 1) / _WI_TIMER_HEAP_ARITY;
+		
+		if(_wi_timer_heap[parent]->fire <= timer->fire)
+			break;
+		
+		_wi_timer_heap[index] = _wi_timer_heap[parent];
+		_wi_timer_heap[index]->index = index;
+		
+		index = parent;
+	}
+	
+	_wi_timer_heap[index] = timer;
+	timer->index = index;
 }
 
 
 
-#pragma mark -
+static void _wi_timer_heap_sift_down(wi_uinteger_t index) {
+	wi_timer_t		*timer;
+	wi_uinteger_t	child, first, last, smallest;
+	
+	timer = _wi_timer_heap[index];
+	
+	while(true) {
+		first = (index * _WI_TIMER_HEAP_ARITY) + 1;
+		
+		if(first >= _wi_timer_heap_count)
+			break;
+		
+		last = WI_MIN(first + _WI_TIMER_HEAP_ARITY, _wi_timer_heap_count);
+		smallest = first;
+		
+		for(child = first + 1; child < last; child++) {
+			if(_wi_timer_heap[child]->fire < _wi_timer_heap[smallest]->fire)
+				smallest = child;
+		}
+		
+		if(timer->fire <= _wi_timer_heap[smallest]->fire)
+			break;
+		
+		_wi_timer_heap[index] = _wi_timer_heap[smallest];
+		_wi_timer_heap[index]->index = index;
+		
+		index = smallest;
+	}
+	
+	_wi_timer_heap[index] = timer;
+	timer->index = index;
+}
 
-static void _wi_timer_schedule(wi_timer_t *timer) {
-	timer->fire = wi_time_interval() + timer->interval;
+
+
+static void _wi_timer_heap_remove(wi_timer_t *timer) {
+	wi_uinteger_t	index;
 	
-	wi_array_wrlock(_wi_timers);
-	wi_mutable_array_add_data_sorted(_wi_timers, timer, _wi_timer_compare);
-	wi_array_unlock(_wi_timers);
+	index = timer->index;
 	
-	timer->scheduled = true;
+	_wi_timer_heap_count--;
+	
+	if(index < _wi_timer_heap_count) {
+		_wi_timer_heap[index] = _wi_timer_heap[_wi_timer_heap_count];
+		_wi_timer_heap[index]->index = index;
+		
+		_wi_timer_heap_sift_down(index);
+		_wi_timer_heap_sift_up(_wi_timer_heap[index]->index);
+	}
+	
+	timer->index = WI_NOT_FOUND;
+	timer->scheduled = false;
 }
 
 
 
-static void _wi_timer_invalidate(wi_timer_t *timer) {
-	wi_array_wrlock(_wi_timers);
-	wi_mutable_array_remove_data(_wi_timers, timer);
-	wi_array_unlock(_wi_timers);
+#pragma mark -
 
-	timer->scheduled = false;
+static void _wi_timer_schedule(wi_timer_t *timer) {
+	if(_wi_timer_heap_count == _wi_timer_heap_capacity) {
+		_wi_timer_heap_capacity *= 2;
+		_wi_timer_heap = wi_realloc(_wi_timer_heap, _wi_timer_heap_capacity * sizeof(wi_timer_t *));
+	}
+	
+	timer->fire = wi_time_interval() + timer->interval;
+	timer->scheduled = true;
+	timer->invalidated = false;
+	
+	_wi_timer_heap[_wi_timer_heap_count] = wi_retain(timer);
+	_wi_timer_heap_count++;
+	
+	_wi_timer_heap_sift_up(_wi_timer_heap_count - 1);
+	
+	if(timer->index == 0)
+		pthread_cond_signal(&_wi_timer_cond);
 }
 
 
@@ -271,62 +375,143 @@ static void _wi_timer_invalidate(wi_timer_t *timer) {
 #pragma mark -
 
 void wi_timer_schedule(wi_timer_t *timer) {
-	if(!timer->scheduled) {
-		pthread_once(&_wi_timer_once_control, _wi_timer_create_thread);
-
-		if(!timer->incallback)
-			wi_condition_lock_lock(_wi_timer_lock);
-		
-		_wi_timer_schedule(timer);
+	if(timer->event_loop) {
+		wi_event_loop_schedule_timer(timer->event_loop, timer, timer->interval, timer->repeats, false);
 		
-		if(!timer->incallback)
-			wi_condition_lock_unlock_with_condition(_wi_timer_lock, 1);
+		return;
 	}
+	
+	pthread_once(&_wi_timer_once_control, _wi_timer_create_thread);
+
+	pthread_mutex_lock(&_wi_timer_mutex);
+	
+	if(!timer->scheduled)
+		_wi_timer_schedule(timer);
+	
+	pthread_mutex_unlock(&_wi_timer_mutex);
 }
 
 
 
 void wi_timer_reschedule(wi_timer_t *timer, wi_time_interval_t interval) {
-	timer->interval = WI_MAX(interval, _WI_TIMER_MINIMUM_INTERVAL);
+	wi_boolean_t	scheduled;
+	
+	if(timer->event_loop) {
+		timer->interval = WI_MAX(interval, _WI_TIMER_MINIMUM_INTERVAL);
+		
+		wi_event_loop_schedule_timer(timer->event_loop, timer, timer->interval, timer->repeats, true);
+		
+		return;
+	}
+	
+	pthread_once(&_wi_timer_once_control, _wi_timer_create_thread);
 
-	if(timer->scheduled)
-		_wi_timer_invalidate(timer);
+	pthread_mutex_lock(&_wi_timer_mutex);
+	
+	timer->interval = WI_MAX(interval, _WI_TIMER_MINIMUM_INTERVAL);
+	scheduled = timer->scheduled;
+	
+	if(scheduled)
+		_wi_timer_heap_remove(timer);
+	
+	_wi_timer_schedule(timer);
+	
+	pthread_mutex_unlock(&_wi_timer_mutex);
+	
+	if(scheduled)
+		wi_release(timer);
+}
 
-	if(!timer->incallback)
-		wi_condition_lock_lock(_wi_timer_lock);
 
-	_wi_timer_schedule(timer);
 
-	if(!timer->incallback)
-		wi_condition_lock_unlock_with_condition(_wi_timer_lock, 1);
+wi_boolean_t wi_timer_is_scheduled(wi_timer_t *timer) {
+	wi_boolean_t	scheduled;
+	
+	pthread_mutex_lock(&_wi_timer_mutex);
+	scheduled = timer->scheduled;
+	pthread_mutex_unlock(&_wi_timer_mutex);
+	
+	return scheduled;
 }
 
 
 
 void wi_timer_fire(wi_timer_t *timer) {
-	timer->incallback = true;
 	(*timer->func)(timer);
-	timer->incallback = false;
 }
 
 
 
 void wi_timer_invalidate(wi_timer_t *timer) {
-	if(timer->scheduled) {
-		if(!timer->incallback)
-			wi_condition_lock_lock(_wi_timer_lock);
-		
-		_wi_timer_invalidate(timer);
+	wi_boolean_t	scheduled;
+	
+	if(timer->event_loop) {
+		wi_event_loop_invalidate_timer(timer->event_loop, timer);
 		
-		if(!timer->incallback)
-			wi_condition_lock_unlock_with_condition(_wi_timer_lock, 1);
+		return;
 	}
+	
+	pthread_mutex_lock(&_wi_timer_mutex);
+	
+	scheduled = timer->scheduled;
+	timer->invalidated = true;
+	
+	if(scheduled)
+		_wi_timer_heap_remove(timer);
+	
+	pthread_mutex_unlock(&_wi_timer_mutex);
+	
+	if(scheduled)
+		wi_release(timer);
 }
 
 
 
 #pragma mark -
 
+void wi_timer_set_thread_pool(wi_timer_t *timer, wi_thread_pool_t *thread_pool) {
+	wi_retain(thread_pool);
+	wi_release(timer->thread_pool);
+	
+	timer->thread_pool = thread_pool;
+}
+
+
+
+wi_thread_pool_t * wi_timer_thread_pool(wi_timer_t *timer) {
+	return timer->thread_pool;
+}
+
+
+
+void wi_timer_set_event_loop(wi_timer_t *timer, wi_event_loop_t *event_loop) {
+	wi_timer_invalidate(timer);
+	
+	/* the loop retains the timer while it is scheduled, so a repeating timer keeps its loop alive until it is invalidated */
+	wi_retain(event_loop);
+	wi_release(timer->event_loop);
+	
+	timer->event_loop = event_loop;
+}
+
+
+
+wi_event_loop_t * wi_timer_event_loop(wi_timer_t *timer) {
+	return timer->event_loop;
+}
+
+
+
+#pragma mark -
+
+void wi_timer_set_scheduled(wi_timer_t *timer, wi_boolean_t scheduled) {
+	pthread_mutex_lock(&_wi_timer_mutex);
+	timer->scheduled = scheduled;
+	pthread_mutex_unlock(&_wi_timer_mutex);
+}
+
+
+
 void wi_timer_set_data(wi_timer_t *timer, void *data) {
 	timer->data = data;
 }
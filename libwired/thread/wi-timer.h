@@ -30,7 +30,9 @@
 #define WI_TIMER_H 1
 
 #include <wired/wi-base.h>
+#include <wired/wi-event-loop.h>
 #include <wired/wi-runtime.h>
+#include <wired/wi-thread-pool.h>
 
 typedef struct _wi_timer		wi_timer_t;
 
@@ -44,9 +46,14 @@ WI_EXPORT wi_timer_t *			wi_timer_init_with_function(wi_timer_t *, wi_timer_func
 
 WI_EXPORT void					wi_timer_schedule(wi_timer_t *);
 WI_EXPORT void					wi_timer_reschedule(wi_timer_t *, wi_time_interval_t);
+WI_EXPORT wi_boolean_t			wi_timer_is_scheduled(wi_timer_t *);
 WI_EXPORT void					wi_timer_fire(wi_timer_t *);
 WI_EXPORT void					wi_timer_invalidate(wi_timer_t *);
 
+WI_EXPORT void					wi_timer_set_thread_pool(wi_timer_t *, wi_thread_pool_t *);
+WI_EXPORT wi_thread_pool_t *	wi_timer_thread_pool(wi_timer_t *);
+WI_EXPORT void					wi_timer_set_event_loop(wi_timer_t *, wi_event_loop_t *);
+WI_EXPORT wi_event_loop_t *		wi_timer_event_loop(wi_timer_t *);
 WI_EXPORT void					wi_timer_set_data(wi_timer_t *, void *);
 WI_EXPORT void *				wi_timer_data(wi_timer_t *);
 
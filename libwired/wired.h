@@ -35,20 +35,24 @@
 #include <wired/wi-base.h>
 #include <wired/wi-byteorder.h>
 #include <wired/wi-cipher.h>
+#include <wired/wi-concurrent-dictionary.h>
 #include <wired/wi-config.h>
 #include <wired/wi-compat.h>
 #include <wired/wi-data.h>
+#include <wired/wi-data-chain.h>
 #include <wired/wi-date.h>
 #include <wired/wi-dictionary.h>
 #include <wired/wi-digest.h>
 #include <wired/wi-enumerator.h>
 #include <wired/wi-error.h>
+#include <wired/wi-event-loop.h>
 #include <wired/wi-file.h>
 #include <wired/wi-fs.h>
 #include <wired/wi-fsenumerator.h>
 #include <wired/wi-fsevents.h>
 #include <wired/wi-fts.h>
 #include <wired/wi-host.h>
+#include <wired/wi-integer-set.h>
 #include <wired/wi-ip.h>
 #include <wired/wi-libxml2.h>
 #include <wired/wi-lock.h>
@@ -56,9 +60,13 @@
 #include <wired/wi-macros.h>
 #include <wired/wi-null.h>
 #include <wired/wi-number.h>
+#include <wired/wi-numeric.h>
 #include <wired/wi-p7-message.h>
 #include <wired/wi-p7-socket.h>
 #include <wired/wi-p7-spec.h>
+#include <wired/wi-path.h>
+#include <wired/wi-persistent-dictionary.h>
+#include <wired/wi-persistent-set.h>
 #include <wired/wi-plist.h>
 #include <wired/wi-pool.h>
 #include <wired/wi-process.h>
@@ -77,6 +85,7 @@
 #include <wired/wi-terminal.h>
 #include <wired/wi-test.h>
 #include <wired/wi-timer.h>
+#include <wired/wi-thread-pool.h>
 #include <wired/wi-thread.h>
 #include <wired/wi-url.h>
 #include <wired/wi-uuid.h>
@@ -0,0 +1,212 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_array(void);
+WI_TEST_EXPORT void						wi_test_array_copy(void);
+WI_TEST_EXPORT void						wi_test_array_sort(void);
+WI_TEST_EXPORT void						wi_test_array_stable_sort(void);
+WI_TEST_EXPORT void						wi_test_array_parallel_sort(void);
+
+
+static wi_integer_t						_wi_test_array_length_key(void *);
+static void *							_wi_test_array_suffix_key(void *);
+
+
+void wi_test_array(void) {
+	wi_mutable_array_t		*array;
+	wi_array_t				*subarray;
+	void					*data[3];
+	wi_uinteger_t			i;
+	
+	array = wi_array_init(wi_mutable_array_alloc());
+	
+	for(i = 0; i < 1000; i++)
+		wi_mutable_array_add_data(array, wi_number_with_integer(i));
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), 1000U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_array_data_at_index(array, 500), wi_number_with_integer(500), "");
+	
+	wi_mutable_array_insert_data_at_index(array, WI_STR("foo"), 0);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_array_first_data(array), WI_STR("foo"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_array_data_at_index(array, 1), wi_number_with_integer(0), "");
+	
+	wi_mutable_array_remove_data_at_index(array, 0);
+	wi_mutable_array_remove_data_in_range(array, wi_make_range(10, 980));
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), 20U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_array_data_at_index(array, 10), wi_number_with_integer(990), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_array_last_data(array), wi_number_with_integer(999), "");
+	
+	wi_array_get_data_in_range(array, data, wi_make_range(9, 3));
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(data[0], wi_number_with_integer(9), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(data[1], wi_number_with_integer(990), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(data[2], wi_number_with_integer(991), "");
+	
+	wi_mutable_array_replace_data_at_index(array, WI_STR("bar"), 19);
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_index_of_data(array, WI_STR("bar")), 19U, "");
+	
+	subarray = wi_array_by_adding_data(array, WI_STR("baz"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_count(subarray), 21U, "");
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), 20U, "");
+	
+	wi_mutable_array_reverse(array);
+
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_array_first_data(array), WI_STR("bar"), "");
+	
+	wi_mutable_array_remove_all_data(array);
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), 0U, "");
+	
+	wi_release(array);
+}
+
+
+
+void wi_test_array_copy(void) {
+	wi_mutable_array_t		*array, *mutable_copy;
+	wi_array_t				*copy;
+	
+	array = wi_array_init_with_data(wi_mutable_array_alloc(), WI_STR("foo"), WI_STR("bar"), NULL);
+	copy = wi_copy(array);
+	
+	wi_mutable_array_add_data(array, WI_STR("baz"));
+	wi_mutable_array_remove_data(array, WI_STR("foo"));
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(copy, wi_array_with_data(WI_STR("foo"), WI_STR("bar"), NULL), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(array, wi_array_with_data(WI_STR("bar"), WI_STR("baz"), NULL), "");
+	
+	mutable_copy = wi_mutable_copy(copy);
+	
+	wi_mutable_array_reverse(mutable_copy);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(copy, wi_array_with_data(WI_STR("foo"), WI_STR("bar"), NULL), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mutable_copy, wi_array_with_data(WI_STR("bar"), WI_STR("foo"), NULL), "");
+	
+	wi_mutable_array_set_array(mutable_copy, array);
+	wi_mutable_array_remove_all_data(array);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mutable_copy, wi_array_with_data(WI_STR("bar"), WI_STR("baz"), NULL), "");
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), 0U, "");
+	
+	wi_release(mutable_copy);
+	wi_release(copy);
+	wi_release(array);
+}
+
+
+
+void wi_test_array_sort(void) {
+	wi_mutable_array_t		*array;
+	wi_uinteger_t			i;
+	
+	array = wi_array_init(wi_mutable_array_alloc());
+	
+	for(i = 0; i < 100; i++)
+		wi_mutable_array_add_data_sorted(array, wi_number_with_integer((i * 37) % 100), wi_number_compare);
+	
+	for(i = 0; i < 100; i++)
+		WI_TEST_ASSERT_EQUAL_INSTANCES(WI_ARRAY(array, i), wi_number_with_integer(i), "");
+	
+	wi_mutable_array_reverse(array);
+	wi_mutable_array_sort(array, wi_number_compare);
+
+	for(i = 0; i < 100; i++)
+		WI_TEST_ASSERT_EQUAL_INSTANCES(WI_ARRAY(array, i), wi_number_with_integer(i), "");
+	
+	wi_release(array);
+}
+
+
+
+static wi_integer_t _wi_test_array_length_key(void *data) {
+	return wi_string_length(data);
+}
+
+
+
+static void * _wi_test_array_suffix_key(void *data) {
+	return wi_string_substring_from_index(data, 1);
+}
+
+
+
+void wi_test_array_stable_sort(void) {
+	wi_mutable_array_t		*array;
+	
+	array = wi_autorelease(wi_array_init_with_data(wi_mutable_array_alloc(),
+		WI_STR("ccc"), WI_STR("b"), WI_STR("aa"), WI_STR("a"), WI_STR("bb"), WI_STR("c"), NULL));
+	
+	wi_mutable_array_sort_by_integer_key(array, _wi_test_array_length_key);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(array, wi_array_with_data(
+		WI_STR("b"), WI_STR("a"), WI_STR("c"), WI_STR("aa"), WI_STR("bb"), WI_STR("ccc"), NULL), "");
+	
+	wi_mutable_array_stable_sort(array, wi_string_compare);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(array, wi_array_with_data(
+		WI_STR("a"), WI_STR("aa"), WI_STR("b"), WI_STR("bb"), WI_STR("c"), WI_STR("ccc"), NULL), "");
+	
+	wi_mutable_array_set_array(array, wi_array_with_data(WI_STR("ab"), WI_STR("ba"), WI_STR("ca"), WI_STR("cb"), NULL));
+	wi_mutable_array_sort_by_key(array, _wi_test_array_suffix_key, wi_string_compare);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(array, wi_array_with_data(
+		WI_STR("ba"), WI_STR("ca"), WI_STR("ab"), WI_STR("cb"), NULL), "");
+}
+
+
+
+void wi_test_array_parallel_sort(void) {
+	wi_mutable_array_t		*array;
+	wi_uinteger_t			i, count;
+	
+	count = 100000;
+	array = wi_array_init_with_capacity(wi_mutable_array_alloc(), count);
+	
+	for(i = 0; i < count; i++)
+		wi_mutable_array_add_data(array, wi_number_with_integer((i * 7919) % count));
+	
+	wi_mutable_array_parallel_sort(array, wi_number_compare);
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), count, "");
+	
+	for(i = 0; i < count; i++) {
+		if(wi_number_integer(WI_ARRAY(array, i)) != (wi_integer_t) i) {
+			WI_TEST_FAIL("%@ at index %lu", WI_ARRAY(array, i), i);
+			
+			break;
+		}
+	}
+	
+	wi_release(array);
+}
@@ -0,0 +1,66 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <wired/wired.h>
+#include <wired/wi-private.h>
+
+WI_TEST_EXPORT void						wi_test_hash_seed(void);
+WI_TEST_EXPORT void						wi_test_hash_equal(void);
+
+
+void wi_test_hash_seed(void) {
+	static const char		bytes[] = "libwired hash seed";
+	uint64_t				seed;
+	
+	seed = wi_hash_seed();
+	
+	/* drawn from /dev/urandom or the clock in wi_initialize() */
+	WI_TEST_ASSERT_TRUE(seed != 0, "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_hash_cstring(bytes, sizeof(bytes) - 1), wi_hash_bytes_with_seed(bytes, sizeof(bytes) - 1, seed), "");
+	WI_TEST_ASSERT_EQUALS(wi_hash_data((const unsigned char *) bytes, sizeof(bytes) - 1), wi_hash_bytes_with_seed(bytes, sizeof(bytes) - 1, seed), "");
+	WI_TEST_ASSERT_TRUE(wi_hash_bytes_with_seed(bytes, sizeof(bytes) - 1, seed) != wi_hash_bytes_with_seed(bytes, sizeof(bytes) - 1, seed ^ 1), "");
+}
+
+
+
+void wi_test_hash_equal(void) {
+	wi_mutable_string_t		*string;
+	wi_uinteger_t			i;
+	char					bytes[64];
+	
+	string = wi_mutable_string();
+	
+	for(i = 0; i < sizeof(bytes); i++) {
+		bytes[i] = 'a' + (i % 26);
+		
+		wi_mutable_string_append_format(string, WI_STR("%c"), bytes[i]);
+		
+		WI_TEST_ASSERT_EQUALS(wi_hash(string), wi_hash(wi_string_with_bytes(bytes, i + 1)), "");
+		WI_TEST_ASSERT_EQUALS(wi_hash(wi_data_with_bytes(bytes, i + 1)), wi_hash(wi_data_with_bytes(bytes, i + 1)), "");
+	}
+}
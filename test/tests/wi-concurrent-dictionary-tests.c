@@ -0,0 +1,138 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_concurrent_dictionary(void);
+WI_TEST_EXPORT void						wi_test_concurrent_dictionary_threads(void);
+
+
+static void *							_wi_test_concurrent_dictionary_compute(void *, void *);
+
+#ifdef WI_PTHREADS
+static void								_wi_test_concurrent_dictionary_thread(wi_runtime_instance_t *);
+
+
+static wi_concurrent_dictionary_t		*_wi_test_concurrent_dictionary_dictionary;
+static wi_condition_lock_t				*_wi_test_concurrent_dictionary_lock;
+#endif
+
+
+void wi_test_concurrent_dictionary(void) {
+	wi_concurrent_dictionary_t		*dictionary;
+	wi_uinteger_t					computes;
+	
+	dictionary = wi_concurrent_dictionary();
+	
+	WI_TEST_ASSERT_NOT_NULL(dictionary, "");
+	
+	wi_concurrent_dictionary_set_data_for_key(dictionary, WI_STR("bar"), WI_STR("foo"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_concurrent_dictionary_count(dictionary), 1U, "");
+	WI_TEST_ASSERT_TRUE(wi_concurrent_dictionary_contains_key(dictionary, WI_STR("foo")), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_concurrent_dictionary_data_for_key(dictionary, WI_STR("foo")), WI_STR("bar"), "");
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_concurrent_dictionary_set_data_for_key_if_absent(dictionary, WI_STR("baz"), WI_STR("foo")), WI_STR("bar"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_concurrent_dictionary_set_data_for_key_if_absent(dictionary, WI_STR("baz"), WI_STR("qux")), WI_STR("baz"), "");
+	WI_TEST_ASSERT_EQUALS(wi_concurrent_dictionary_count(dictionary), 2U, "");
+	
+	computes = 0;
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_concurrent_dictionary_compute_data_for_key_if_absent(dictionary, WI_STR("quux"), _wi_test_concurrent_dictionary_compute, &computes), WI_STR("quux"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_concurrent_dictionary_compute_data_for_key_if_absent(dictionary, WI_STR("quux"), _wi_test_concurrent_dictionary_compute, &computes), WI_STR("quux"), "");
+	WI_TEST_ASSERT_EQUALS(computes, 1U, "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(wi_concurrent_dictionary_dictionary(dictionary)), 3U, "");
+	
+	wi_concurrent_dictionary_remove_data_for_key(dictionary, WI_STR("foo"));
+	
+	WI_TEST_ASSERT_NULL(wi_concurrent_dictionary_data_for_key(dictionary, WI_STR("foo")), "");
+	
+	wi_concurrent_dictionary_remove_all_data(dictionary);
+	
+	WI_TEST_ASSERT_EQUALS(wi_concurrent_dictionary_count(dictionary), 0U, "");
+}
+
+
+
+void wi_test_concurrent_dictionary_threads(void) {
+#ifdef WI_PTHREADS
+	wi_uinteger_t		i;
+	
+	_wi_test_concurrent_dictionary_dictionary = wi_autorelease(wi_concurrent_dictionary_init(wi_concurrent_dictionary_alloc()));
+	_wi_test_concurrent_dictionary_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	
+	for(i = 0; i < 4; i++) {
+		if(!wi_thread_create_thread(_wi_test_concurrent_dictionary_thread, NULL))
+			WI_TEST_FAIL("%m");
+	}
+	
+	if(wi_condition_lock_lock_when_condition(_wi_test_concurrent_dictionary_lock, 4, 5.0)) {
+		WI_TEST_ASSERT_EQUALS(wi_concurrent_dictionary_count(_wi_test_concurrent_dictionary_dictionary), 1000U, "");
+		
+		wi_condition_lock_unlock(_wi_test_concurrent_dictionary_lock);
+	} else {
+		WI_TEST_FAIL("Timed out waiting for threads");
+	}
+#endif
+}
+
+
+
+static void * _wi_test_concurrent_dictionary_compute(void *key, void *context) {
+	(*(wi_uinteger_t *) context)++;
+	
+	return key;
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void _wi_test_concurrent_dictionary_thread(wi_runtime_instance_t *argument) {
+	wi_pool_t		*pool;
+	wi_string_t		*key;
+	wi_uinteger_t	i;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	
+	for(i = 0; i < 1000; i++) {
+		key = wi_string_with_format(WI_STR("%u"), i);
+		
+		wi_concurrent_dictionary_set_data_for_key_if_absent(_wi_test_concurrent_dictionary_dictionary, key, key);
+		
+		if(i % 100 == 0)
+			wi_pool_drain(pool);
+	}
+	
+	wi_release(pool);
+	
+	wi_condition_lock_lock(_wi_test_concurrent_dictionary_lock);
+	wi_condition_lock_unlock_with_condition(_wi_test_concurrent_dictionary_lock, wi_condition_lock_condition(_wi_test_concurrent_dictionary_lock) + 1);
+}
+
+#endif
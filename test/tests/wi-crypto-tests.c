@@ -26,10 +26,13 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string.h>
 #include <wired/wired.h>
 
 WI_TEST_EXPORT void						wi_test_crypto_cipher(void);
 WI_TEST_EXPORT void						wi_test_crypto_rsa(void);
+WI_TEST_EXPORT void						wi_test_crypto_base64(void);
+WI_TEST_EXPORT void						wi_test_crypto_hex(void);
 
 #ifdef WI_CIPHERS
 static void								_wi_test_crypto_cipher(wi_cipher_type_t, wi_string_t *, wi_uinteger_t, wi_data_t *, wi_data_t *);
@@ -124,3 +127,87 @@ void wi_test_crypto_rsa(void) {
 	WI_TEST_ASSERT_EQUALS(wi_rsa_bits(rsa), 512U, "");
 #endif
 }
+
+
+
+void wi_test_crypto_base64(void) {
+	wi_base64_context_t		context;
+	wi_data_t				*data;
+	unsigned char			bytes[1000], decoded[1000];
+	char					encoded[WI_BASE64_ENCODED_LENGTH(1000)], streamed[WI_BASE64_ENCODED_LENGTH(1000)];
+	wi_uinteger_t			i, length, size, count, chunk;
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_base64(wi_data_with_bytes("", 0)), WI_STR(""), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_base64(wi_data_with_bytes("f", 1)), WI_STR("Zg=="), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_base64(wi_data_with_bytes("fo", 2)), WI_STR("Zm8="), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_base64(wi_data_with_bytes("foo", 3)), WI_STR("Zm9v"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_base64(wi_data_with_bytes("foobar", 6)), WI_STR("Zm9vYmFy"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_base64(WI_STR("Zm9v\nYmE=")), wi_data_with_bytes("fooba", 5), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_base64(WI_STR("Zm9vYg")), wi_data_with_bytes("foob", 4), "");
+	
+	for(i = 0; i < sizeof(bytes); i++)
+		bytes[i] = (i * 131) ^ (i >> 3);
+	
+	for(length = 0; length <= sizeof(bytes); length += 37) {
+		size = wi_base64_encode(bytes, length, encoded);
+		
+		WI_TEST_ASSERT_EQUALS(size, (wi_uinteger_t) WI_BASE64_ENCODED_LENGTH(length), "");
+		
+		data = wi_data_with_bytes(bytes, length);
+		
+		WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_base64(data), wi_string_with_bytes(encoded, size), "");
+		WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_base64(wi_data_base64(data)), data, "");
+		
+		wi_base64_context_init(&context);
+		
+		for(i = 0, size = 0; i < length; i += chunk) {
+			chunk = WI_MIN(length - i, (i % 7) + 1);
+			size += wi_base64_encode_update(&context, bytes + i, chunk, streamed + size);
+		}
+		
+		size += wi_base64_encode_final(&context, streamed + size);
+		
+		WI_TEST_ASSERT_EQUALS(size, (wi_uinteger_t) WI_BASE64_ENCODED_LENGTH(length), "");
+		WI_TEST_ASSERT_TRUE(memcmp(encoded, streamed, size) == 0, "");
+		
+		wi_base64_context_init(&context);
+		
+		for(i = 0, count = 0; i < size; i += chunk) {
+			chunk = WI_MIN(size - i, (i % 29) + 1);
+			count += wi_base64_decode_update(&context, streamed + i, chunk, decoded + count);
+		}
+		
+		count += wi_base64_decode_final(&context, decoded + count);
+		
+		WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_bytes(decoded, count), data, "");
+	}
+}
+
+
+
+void wi_test_crypto_hex(void) {
+	unsigned char		bytes[100], decoded[100];
+	char				hex[200];
+	wi_uinteger_t		i;
+	
+	for(i = 0; i < sizeof(bytes); i++)
+		bytes[i] = i * 7;
+	
+	WI_TEST_ASSERT_EQUALS(wi_hex_encode(bytes, sizeof(bytes), hex), 200U, "");
+	WI_TEST_ASSERT_TRUE(memcmp(hex, "00070e151c232a31383f464d545b626970", 34) == 0, "");
+	WI_TEST_ASSERT_TRUE(memcmp(hex + 64, "e0e7eef5fc030a11", 16) == 0, "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_hex_decode(hex, sizeof(hex), decoded), 100U, "");
+	WI_TEST_ASSERT_TRUE(memcmp(bytes, decoded, sizeof(bytes)) == 0, "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_hex_decode("DEADbeef", 8, decoded), 4U, "");
+	WI_TEST_ASSERT_TRUE(memcmp(decoded, "\xde\xad\xbe\xef", 4) == 0, "");
+	WI_TEST_ASSERT_EQUALS(wi_hex_decode("abc", 3, decoded), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_EQUALS(wi_hex_decode("0123456789abcdefg0", 18, decoded), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_EQUALS(wi_hex_decode("0123456789abcdef0123456789abcdeG", 32, decoded), WI_NOT_FOUND, "");
+	
+#ifdef WI_DIGESTS
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_md5_digest_string(wi_data_with_bytes("abc", 3)), WI_STR("900150983cd24fb0d6963f7d28e17f72"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_sha1_digest_string(wi_data_with_bytes("abc", 3)), WI_STR("a9993e364706816aba3e25717850c26c9cd0d89d"), "");
+#endif
+}
@@ -0,0 +1,209 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <string.h>
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_data_subdata(void);
+WI_TEST_EXPORT void						wi_test_data_chain(void);
+WI_TEST_EXPORT void						wi_test_data_mapped_file(void);
+
+
+void wi_test_data_subdata(void) {
+	wi_data_t			*data, *subdata;
+	wi_mutable_data_t	*mutabledata;
+	
+	data = wi_data_with_bytes("hello world", 11);
+	subdata = wi_data_subdata_with_range(data, wi_make_range(6, 5));
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_length(subdata), 5U, "");
+	WI_TEST_ASSERT_TRUE(wi_data_bytes(subdata) == (const char *) wi_data_bytes(data) + 6, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(subdata, wi_data_with_bytes("world", 5), "");
+	
+	subdata = wi_data_subdata_to_index(subdata, 3);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(subdata, wi_data_with_bytes("wor", 3), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_subdata_from_index(data, 6), wi_data_with_bytes("world", 5), "");
+	
+	mutabledata = wi_mutable_copy(data);
+	subdata = wi_data_subdata_with_range(mutabledata, wi_make_range(0, 5));
+	
+	WI_TEST_ASSERT_FALSE(wi_data_bytes(subdata) == wi_data_bytes(mutabledata), "");
+	
+	wi_mutable_data_append_data(mutabledata, subdata);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mutabledata, wi_data_with_bytes("hello worldhello", 16), "");
+	
+	wi_release(mutabledata);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_by_appending_data(subdata, data), wi_data_with_bytes("hellohello world", 16), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_by_appending_bytes(subdata, "!", 1), wi_data_with_bytes("hello!", 6), "");
+}
+
+
+
+void wi_test_data_chain(void) {
+	wi_data_chain_t		*chain, *otherchain;
+	wi_data_t			*data, *large;
+	wi_socket_t			*socket;
+	char				buffer[4096], expected[4096];
+	int					sd[2];
+	wi_uinteger_t		i, length;
+	
+	chain = wi_data_chain();
+	
+	wi_data_chain_append_bytes(chain, "foo", 3);
+	wi_data_chain_append_bytes(chain, "bar", 3);
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_count(chain), 1U, "");
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_length(chain), 6U, "");
+	
+	memset(expected, 'x', 1000);
+	
+	large = wi_data_with_bytes(expected, 1000);
+	
+	wi_data_chain_append_data(chain, large);
+	wi_data_chain_append_bytes(chain, "baz", 3);
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_count(chain), 3U, "");
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_length(chain), 1009U, "");
+	WI_TEST_ASSERT_TRUE(wi_data_chain_iovecs(chain)[1].iov_base == wi_data_bytes(large), "");
+	
+	otherchain = wi_data_chain();
+	
+	wi_data_chain_append_bytes(otherchain, "<", 1);
+	wi_data_chain_append_data_chain(otherchain, chain);
+	wi_data_chain_append_bytes(otherchain, ">", 1);
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_length(otherchain), 1011U, "");
+	
+	memcpy(expected, "<foobar", 7);
+	memset(expected + 7, 'x', 1000);
+	memcpy(expected + 1007, "baz>", 4);
+	
+	data = wi_data_chain_data(otherchain);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(data, wi_data_with_bytes(expected, 1011), "");
+	
+	wi_data_chain_remove_length(otherchain, 4);
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_length(otherchain), 1007U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_chain_data(otherchain), wi_data_with_bytes(expected + 4, 1007), "");
+	
+	wi_data_chain_remove_length(otherchain, 1004);
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_count(otherchain), 2U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_chain_data(otherchain), wi_data_with_bytes("az>", 3), "");
+	
+	wi_data_chain_remove_all_data(otherchain);
+	
+	WI_TEST_ASSERT_EQUALS(wi_data_chain_length(otherchain), 0U, "");
+	
+	data = wi_data_init_with_bytes(wi_data_alloc(), expected + 7, 1000);
+	wi_data_chain_append_data(otherchain, data);
+	wi_release(data);
+	
+	data = wi_data_chain_data(otherchain);
+	wi_data_chain_remove_all_data(otherchain);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(data, large, "");
+	
+	if(socketpair(AF_UNIX, SOCK_STREAM, 0, sd) < 0) {
+		WI_TEST_FAIL("socketpair: %s", strerror(errno));
+		
+		return;
+	}
+	
+	socket = wi_autorelease(wi_socket_init_with_descriptor(wi_socket_alloc(), sd[0]));
+	
+	WI_TEST_ASSERT_EQUALS(wi_socket_write_data_chain(socket, 0.0, chain), 1009, "");
+	
+	for(length = 0; length < 1009; length += i)
+		i = read(sd[1], buffer + length, sizeof(buffer) - length);
+	
+	WI_TEST_ASSERT_TRUE(memcmp(buffer, expected + 1, 1009) == 0, "");
+	
+	close(sd[1]);
+}
+
+
+
+void wi_test_data_mapped_file(void) {
+	wi_data_t			*data, *mappeddata;
+	wi_string_t			*path, *otherpath, *string;
+	char				bytes[100000];
+	
+	path = wi_fs_temporary_path_with_template(WI_STR("/tmp/libwired-data.XXXXXXXX"));
+	otherpath = wi_fs_temporary_path_with_template(WI_STR("/tmp/libwired-data.XXXXXXXX"));
+	
+	memset(bytes, 'x', sizeof(bytes));
+	memcpy(bytes, "hello", 5);
+	
+	data = wi_data_with_bytes(bytes, sizeof(bytes));
+	
+	WI_TEST_ASSERT_TRUE(wi_data_write_to_file(data, path), "");
+	
+	/* only mapped on request, however large the file is */
+	WI_TEST_ASSERT_FALSE(wi_data_is_mapped(wi_data_with_contents_of_file(path)), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_contents_of_file(path), data, "");
+	
+	mappeddata = wi_data_with_contents_of_mapped_file(path);
+	
+	WI_TEST_ASSERT_NOT_NULL(mappeddata, "");
+	WI_TEST_ASSERT_TRUE(wi_data_is_mapped(mappeddata), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mappeddata, data, "");
+	
+	wi_data_advise(mappeddata, WI_DATA_ADVICE_SEQUENTIAL);
+	
+	WI_TEST_ASSERT_TRUE(wi_data_is_mapped(wi_data_subdata_with_range(mappeddata, wi_make_range(0, 5))), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_subdata_to_index(mappeddata, 5), wi_data_with_bytes("hello", 5), "");
+	
+	string = wi_autorelease(wi_string_init_with_contents_of_file(wi_string_alloc(), path));
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_length(string), sizeof(bytes), "");
+	WI_TEST_ASSERT_TRUE(wi_string_has_prefix(string, WI_STR("helloxxx")), "");
+	
+	/* a separate file, rewriting the one still mapped above could truncate it under us */
+	data = wi_data_with_bytes("hello", 5);
+	
+	WI_TEST_ASSERT_TRUE(wi_data_write_to_file(data, otherpath), "");
+	
+	WI_TEST_ASSERT_FALSE(wi_data_is_mapped(wi_data_with_contents_of_file(otherpath)), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_contents_of_file(otherpath), data, "");
+	WI_TEST_ASSERT_TRUE(wi_data_is_mapped(wi_data_with_contents_of_mapped_file(otherpath)), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_data_with_contents_of_mapped_file(otherpath), data, "");
+	
+	wi_fs_delete_path(otherpath);
+	wi_fs_delete_path(path);
+	
+	WI_TEST_ASSERT_NULL(wi_data_with_contents_of_file(path), "");
+}
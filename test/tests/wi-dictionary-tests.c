@@ -0,0 +1,158 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_dictionary(void);
+WI_TEST_EXPORT void						wi_test_dictionary_resize(void);
+WI_TEST_EXPORT void						wi_test_dictionary_copy(void);
+
+
+void wi_test_dictionary(void) {
+	wi_mutable_dictionary_t		*dictionary;
+	
+	dictionary = wi_dictionary_init(wi_mutable_dictionary_alloc());
+	
+	WI_TEST_ASSERT_NOT_NULL(dictionary, "");
+	
+	wi_mutable_dictionary_set_data_for_key(dictionary, WI_STR("bar"), WI_STR("foo"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 1U, "");
+	WI_TEST_ASSERT_TRUE(wi_dictionary_contains_key(dictionary, WI_STR("foo")), "");
+	WI_TEST_ASSERT_TRUE(wi_dictionary_contains_key(dictionary, wi_string_with_cstring("foo")), "");
+	WI_TEST_ASSERT_FALSE(wi_dictionary_contains_key(dictionary, WI_STR("bar")), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_dictionary_data_for_key(dictionary, WI_STR("foo")), WI_STR("bar"), "");
+	
+	wi_mutable_dictionary_set_data_for_key(dictionary, WI_STR("baz"), wi_string_with_cstring("foo"));
+
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 1U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_dictionary_data_for_key(dictionary, WI_STR("foo")), WI_STR("baz"), "");
+	
+	wi_mutable_dictionary_remove_data_for_key(dictionary, WI_STR("foo"));
+
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 0U, "");
+	WI_TEST_ASSERT_NULL(wi_dictionary_data_for_key(dictionary, WI_STR("foo")), "");
+	
+	wi_release(dictionary);
+}
+
+
+
+void wi_test_dictionary_resize(void) {
+	wi_mutable_dictionary_t		*dictionary;
+	wi_dictionary_t				*copy;
+	wi_mutable_array_t			*keys;
+	wi_enumerator_t				*enumerator;
+	wi_number_t					*number;
+	void						*key;
+	wi_uinteger_t				i, count;
+	
+	dictionary = wi_dictionary_init(wi_mutable_dictionary_alloc());
+	
+	for(i = 0; i < 1000; i++) {
+		number = wi_number_with_integer(i);
+		
+		wi_mutable_dictionary_set_data_for_key(dictionary, number, wi_string_with_format(WI_STR("%u"), i));
+	}
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 1000U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_dictionary_data_for_key(dictionary, WI_STR("500")), wi_number_with_integer(500), "");
+	
+	for(i = 0; i < 1000; i += 2)
+		wi_mutable_dictionary_remove_data_for_key(dictionary, wi_string_with_format(WI_STR("%u"), i));
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 500U, "");
+	WI_TEST_ASSERT_NULL(wi_dictionary_data_for_key(dictionary, WI_STR("500")), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_dictionary_data_for_key(dictionary, WI_STR("501")), wi_number_with_integer(501), "");
+	
+	enumerator = wi_dictionary_key_enumerator(dictionary);
+	count = 0;
+	
+	while(wi_enumerator_next_data(enumerator))
+		count++;
+	
+	WI_TEST_ASSERT_EQUALS(count, 500U, "");
+	
+	copy = wi_copy(dictionary);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(copy, dictionary, "");
+	
+	wi_release(copy);
+	
+	keys = wi_mutable_array();
+	
+	WI_FOREACH(key, dictionary) {
+		wi_mutable_array_add_data(keys, key);
+		wi_mutable_dictionary_remove_data_for_key(dictionary, key);
+	}
+	
+	WI_TEST_ASSERT_EQUALS(wi_array_count(keys), 500U, "");
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 0U, "");
+	
+	wi_mutable_dictionary_set_data_for_key(dictionary, wi_number_with_integer(501), WI_STR("501"));
+	wi_mutable_dictionary_remove_all_data(dictionary);
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 0U, "");
+	WI_TEST_ASSERT_NULL(wi_dictionary_data_for_key(dictionary, WI_STR("501")), "");
+	
+	wi_release(dictionary);
+}
+
+
+
+void wi_test_dictionary_copy(void) {
+	wi_mutable_dictionary_t		*dictionary, *mutable_copy;
+	wi_dictionary_t				*copy;
+	
+	dictionary = wi_dictionary_init(wi_mutable_dictionary_alloc());
+	
+	wi_mutable_dictionary_set_data_for_key(dictionary, WI_STR("1"), WI_STR("foo"));
+	wi_mutable_dictionary_set_data_for_key(dictionary, WI_STR("2"), WI_STR("bar"));
+	
+	copy = wi_copy(dictionary);
+	
+	wi_mutable_dictionary_set_data_for_key(dictionary, WI_STR("3"), WI_STR("baz"));
+	wi_mutable_dictionary_remove_data_for_key(dictionary, WI_STR("foo"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(copy), 2U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_dictionary_data_for_key(copy, WI_STR("foo")), WI_STR("1"), "");
+	WI_TEST_ASSERT_NULL(wi_dictionary_data_for_key(copy, WI_STR("baz")), "");
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(dictionary), 2U, "");
+	WI_TEST_ASSERT_NULL(wi_dictionary_data_for_key(dictionary, WI_STR("foo")), "");
+	
+	mutable_copy = wi_mutable_copy(copy);
+	
+	wi_release(copy);
+	
+	wi_mutable_dictionary_remove_all_data(mutable_copy);
+	
+	WI_TEST_ASSERT_EQUALS(wi_dictionary_count(mutable_copy), 0U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_dictionary_data_for_key(dictionary, WI_STR("baz")), WI_STR("3"), "");
+	
+	wi_release(mutable_copy);
+	wi_release(dictionary);
+}
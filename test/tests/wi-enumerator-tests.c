@@ -0,0 +1,91 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_enumerator_foreach(void);
+
+
+void wi_test_enumerator_foreach(void) {
+	wi_mutable_array_t			*array;
+	wi_mutable_dictionary_t		*dictionary;
+	wi_mutable_set_t			*set;
+	wi_number_t					*number;
+	wi_integer_t				sum;
+	wi_uinteger_t				i, count;
+	
+	array		= wi_mutable_array();
+	dictionary	= wi_mutable_dictionary();
+	set			= wi_mutable_set();
+	
+	for(i = 0; i < 100; i++) {
+		number = wi_number_with_integer(i);
+		
+		wi_mutable_array_add_data(array, number);
+		wi_mutable_dictionary_set_data_for_key(dictionary, WI_STR("foo"), number);
+		wi_mutable_set_add_data(set, number);
+	}
+	
+	sum = 0;
+	count = 0;
+	
+	WI_FOREACH(number, array) {
+		WI_TEST_ASSERT_EQUALS(wi_number_integer(number), (wi_integer_t) count, "");
+
+		sum += wi_number_integer(number);
+		count++;
+	}
+	
+	WI_TEST_ASSERT_EQUALS(count, 100U, "");
+	WI_TEST_ASSERT_EQUALS(sum, 4950, "");
+	
+	sum = 0;
+	
+	WI_FOREACH(number, dictionary)
+		sum += wi_number_integer(number);
+	
+	WI_TEST_ASSERT_EQUALS(sum, 4950, "");
+	
+	sum = 0;
+	
+	WI_FOREACH(number, set)
+		sum += wi_number_integer(number);
+	
+	WI_TEST_ASSERT_EQUALS(sum, 4950, "");
+	
+	sum = 0;
+	
+	WI_FOREACH(number, wi_array_reverse_data_enumerator(array)) {
+		if(wi_number_integer(number) < 90)
+			break;
+		
+		sum += wi_number_integer(number);
+	}
+	
+	WI_TEST_ASSERT_EQUALS(sum, 945, "");
+}
@@ -0,0 +1,266 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_event_loop_socket(void);
+WI_TEST_EXPORT void						wi_test_event_loop_timer(void);
+WI_TEST_EXPORT void						wi_test_event_loop_timer_release(void);
+WI_TEST_EXPORT void						wi_test_event_loop_perform(void);
+
+
+static wi_event_loop_t *				_wi_test_event_loop_create(void);
+static void								_wi_test_event_loop_socket_function(wi_event_loop_t *, wi_socket_t *);
+
+#ifdef WI_PTHREADS
+static void								_wi_test_event_loop_timer_function(wi_timer_t *);
+static void								_wi_test_event_loop_thread(wi_runtime_instance_t *);
+static void								_wi_test_event_loop_perform_function(wi_event_loop_t *, wi_runtime_instance_t *);
+#endif
+
+
+static wi_uinteger_t					_wi_test_event_loop_hits;
+static char								_wi_test_event_loop_byte;
+
+#ifdef WI_PTHREADS
+static wi_runtime_instance_t			*_wi_test_event_loop_instance;
+#endif
+
+
+
+static wi_event_loop_t * _wi_test_event_loop_create(void) {
+	wi_event_loop_t		*loop;
+	
+	loop = wi_event_loop_init(wi_event_loop_alloc());
+	
+	if(!loop) {
+		if(wi_error_domain() != WI_ERROR_DOMAIN_LIBWIRED || wi_error_code() != WI_ERROR_EVENT_LOOP_NOTSUPP)
+			WI_TEST_ASSERT_NOT_NULL(loop, "%m");
+		
+		return NULL;
+	}
+	
+	return wi_autorelease(loop);
+}
+
+
+
+void wi_test_event_loop_socket(void) {
+	wi_event_loop_t		*loop;
+	wi_socket_t			*socket;
+	wi_time_interval_t	interval;
+	int					sds[2];
+	
+	loop = _wi_test_event_loop_create();
+	
+	if(!loop)
+		return;
+	
+	WI_TEST_ASSERT_EQUALS(socketpair(AF_UNIX, SOCK_STREAM, 0, sds), 0, "");
+	
+	socket = wi_autorelease(wi_socket_init_with_descriptor(wi_socket_alloc(), sds[0]));
+	
+	_wi_test_event_loop_hits = 0;
+	_wi_test_event_loop_byte = 0;
+	
+	WI_TEST_ASSERT_TRUE(wi_event_loop_add_socket(loop, socket, _wi_test_event_loop_socket_function), "%m");
+	WI_TEST_ASSERT_EQUALS(write(sds[1], "x", 1), (ssize_t) 1, "");
+	
+	interval = wi_time_interval();
+	
+	while(_wi_test_event_loop_hits == 0 && wi_time_interval() - interval < 2.0)
+		WI_TEST_ASSERT_TRUE(wi_event_loop_run_with_timeout(loop, 0.1), "%m");
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_event_loop_hits, 1U, "");
+	WI_TEST_ASSERT_EQUALS(_wi_test_event_loop_byte, 'x', "");
+	
+	WI_TEST_ASSERT_EQUALS(write(sds[1], "y", 1), (ssize_t) 1, "");
+	WI_TEST_ASSERT_TRUE(wi_event_loop_run_with_timeout(loop, 0.01), "%m");
+	WI_TEST_ASSERT_EQUALS(_wi_test_event_loop_hits, 1U, "");
+	
+	close(sds[1]);
+}
+
+
+
+static void _wi_test_event_loop_socket_function(wi_event_loop_t *loop, wi_socket_t *socket) {
+	if(read(wi_socket_descriptor(socket), &_wi_test_event_loop_byte, 1) == 1)
+		_wi_test_event_loop_hits++;
+	
+	wi_event_loop_remove_socket(loop, socket);
+}
+
+
+
+void wi_test_event_loop_timer(void) {
+#ifdef WI_PTHREADS
+	wi_event_loop_t		*loop;
+	wi_timer_t			*timer;
+	wi_time_interval_t	interval;
+	
+	loop = _wi_test_event_loop_create();
+	
+	if(!loop)
+		return;
+	
+	_wi_test_event_loop_hits = 0;
+	
+	timer = wi_autorelease(wi_timer_init_with_function(wi_timer_alloc(), _wi_test_event_loop_timer_function, 0.001, true));
+	wi_timer_set_event_loop(timer, loop);
+	
+	WI_TEST_ASSERT_EQUALS(wi_timer_event_loop(timer), loop, "");
+	
+	wi_timer_schedule(timer);
+	
+	interval = wi_time_interval();
+	
+	while(_wi_test_event_loop_hits < 5 && wi_time_interval() - interval < 2.0)
+		WI_TEST_ASSERT_TRUE(wi_event_loop_run_with_timeout(loop, 0.1), "%m");
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_event_loop_hits, 5U, "");
+	
+	WI_TEST_ASSERT_TRUE(wi_event_loop_run_with_timeout(loop, 0.01), "%m");
+	WI_TEST_ASSERT_EQUALS(_wi_test_event_loop_hits, 5U, "");
+	
+	wi_timer_set_event_loop(timer, NULL);
+#endif
+}
+
+
+
+void wi_test_event_loop_timer_release(void) {
+#ifdef WI_PTHREADS
+	wi_pool_t			*pool;
+	wi_event_loop_t		*loop;
+	wi_timer_t			*timer;
+	wi_time_interval_t	interval;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	loop = _wi_test_event_loop_create();
+	
+	if(!loop) {
+		wi_release(pool);
+		
+		return;
+	}
+	
+	_wi_test_event_loop_hits = 0;
+	
+	timer = wi_timer_init_with_function(wi_timer_alloc(), _wi_test_event_loop_timer_function, 0.001, false);
+	wi_timer_set_event_loop(timer, loop);
+	
+	WI_TEST_ASSERT_FALSE(wi_timer_is_scheduled(timer), "");
+	
+	wi_timer_schedule(timer);
+	
+	WI_TEST_ASSERT_TRUE(wi_timer_is_scheduled(timer), "");
+	
+	interval = wi_time_interval();
+	
+	while(_wi_test_event_loop_hits < 1 && wi_time_interval() - interval < 2.0)
+		WI_TEST_ASSERT_TRUE(wi_event_loop_run_with_timeout(loop, 0.1), "%m");
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_event_loop_hits, 1U, "");
+	WI_TEST_ASSERT_FALSE(wi_timer_is_scheduled(timer), "");
+	
+	wi_release(pool);
+	
+	/* the fired timer still owns its loop after the caller has let go of it */
+	WI_TEST_ASSERT_EQUALS(wi_timer_event_loop(timer), loop, "");
+	
+	wi_timer_reschedule(timer, 1.0);
+	
+	WI_TEST_ASSERT_TRUE(wi_timer_is_scheduled(timer), "");
+	
+	wi_timer_invalidate(timer);
+	
+	WI_TEST_ASSERT_FALSE(wi_timer_is_scheduled(timer), "");
+	
+	/* the loop lets go of invalidated timers on its next run */
+	WI_TEST_ASSERT_TRUE(wi_event_loop_run_with_timeout(loop, 0.01), "%m");
+	WI_TEST_ASSERT_EQUALS(wi_retain_count(timer), 1U, "");
+	
+	wi_release(timer);
+#endif
+}
+
+
+
+void wi_test_event_loop_perform(void) {
+#ifdef WI_PTHREADS
+	wi_event_loop_t		*loop;
+	
+	loop = _wi_test_event_loop_create();
+	
+	if(!loop)
+		return;
+	
+	_wi_test_event_loop_instance = NULL;
+	
+	WI_TEST_ASSERT_TRUE(wi_thread_create_thread(_wi_test_event_loop_thread, loop), "%m");
+	
+	wi_event_loop_run(loop);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(_wi_test_event_loop_instance, WI_STR("perform"), "");
+	
+	wi_release(_wi_test_event_loop_instance);
+#endif
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void _wi_test_event_loop_timer_function(wi_timer_t *timer) {
+	if(++_wi_test_event_loop_hits == 5)
+		wi_timer_invalidate(timer);
+}
+
+
+
+static void _wi_test_event_loop_thread(wi_runtime_instance_t *instance) {
+	wi_pool_t		*pool;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	
+	wi_event_loop_perform_function(instance, _wi_test_event_loop_perform_function, WI_STR("perform"));
+	
+	wi_release(pool);
+}
+
+
+
+static void _wi_test_event_loop_perform_function(wi_event_loop_t *loop, wi_runtime_instance_t *instance) {
+	_wi_test_event_loop_instance = wi_retain(instance);
+	
+	wi_event_loop_stop(loop);
+}
+
+#endif
@@ -0,0 +1,250 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <signal.h>
+#include <unistd.h>
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_fast_lock(void);
+WI_TEST_EXPORT void						wi_test_lock_profile(void);
+WI_TEST_EXPORT void						wi_test_lock_profile_on_signal(void);
+
+
+#ifdef WI_PTHREADS
+static void								_wi_test_fast_lock_increment(wi_runtime_instance_t *);
+static void								_wi_test_lock_profile_lock(wi_runtime_instance_t *);
+static wi_dictionary_t *				_wi_test_lock_profile_for_name(wi_string_t *);
+static void								_wi_test_lock_profile_log_callback(wi_log_level_t, wi_string_t *);
+
+
+static wi_fast_lock_t					_wi_test_fast_lock = WI_FAST_LOCK_INITIALIZER;
+static wi_uinteger_t					_wi_test_fast_lock_counter;
+static wi_condition_lock_t				*_wi_test_lock_profile_log_lock;
+#endif
+
+
+void wi_test_fast_lock(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t		*pool;
+	wi_fast_lock_t			lock;
+	wi_uinteger_t			i;
+	
+	wi_fast_lock_init(&lock);
+	
+	WI_TEST_ASSERT_TRUE(wi_fast_lock_trylock(&lock), "");
+	WI_TEST_ASSERT_FALSE(wi_fast_lock_trylock(&lock), "");
+	wi_fast_lock_unlock(&lock);
+	
+	wi_fast_lock_lock(&lock);
+	WI_TEST_ASSERT_FALSE(wi_fast_lock_trylock(&lock), "");
+	wi_fast_lock_unlock(&lock);
+	WI_TEST_ASSERT_TRUE(wi_fast_lock_trylock(&lock), "");
+	wi_fast_lock_unlock(&lock);
+	
+	pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 4));
+	
+	_wi_test_fast_lock_counter = 0;
+	
+	for(i = 0; i < 8; i++)
+		wi_thread_pool_add_task(pool, _wi_test_fast_lock_increment, NULL);
+	
+	wi_thread_pool_wait_until_idle(pool);
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_fast_lock_counter, 800000U, "");
+#endif
+}
+
+
+
+void wi_test_lock_profile(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t		*pool;
+	wi_lock_t				*lock;
+	wi_recursive_lock_t		*recursive_lock;
+	wi_rwlock_t				*rwlock;
+	wi_dictionary_t			*profile;
+	wi_uinteger_t			i, attempts;
+	int64_t					contentions;
+	
+	lock = wi_autorelease(wi_lock_init(wi_lock_alloc()));
+	wi_lock_set_name(lock, WI_STR("wi_test_lock_profile lock"));
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_lock_name(lock), WI_STR("wi_test_lock_profile lock"), "");
+	
+	recursive_lock = wi_autorelease(wi_recursive_lock_init(wi_recursive_lock_alloc()));
+	wi_recursive_lock_set_name(recursive_lock, WI_STR("wi_test_lock_profile recursive lock"));
+	
+	rwlock = wi_autorelease(wi_rwlock_init(wi_rwlock_alloc()));
+	wi_rwlock_set_name(rwlock, WI_STR("wi_test_lock_profile rwlock"));
+	
+	wi_lock_lock(lock);
+	wi_lock_unlock(lock);
+	
+	WI_TEST_ASSERT_NULL(_wi_test_lock_profile_for_name(WI_STR("wi_test_lock_profile lock")), "");
+	
+	wi_lock_set_profiling_enabled(true);
+	
+	WI_TEST_ASSERT_TRUE(wi_lock_profiling_enabled(), "");
+	
+	for(i = 0; i < 10; i++) {
+		wi_lock_lock(lock);
+		wi_lock_unlock(lock);
+	}
+	
+	wi_recursive_lock_lock(recursive_lock);
+	wi_recursive_lock_lock(recursive_lock);
+	wi_recursive_lock_unlock(recursive_lock);
+	wi_recursive_lock_unlock(recursive_lock);
+	
+	wi_rwlock_rdlock(rwlock);
+	wi_rwlock_rdlock(rwlock);
+	wi_rwlock_unlock(rwlock);
+	wi_rwlock_unlock(rwlock);
+	wi_rwlock_wrlock(rwlock);
+	wi_rwlock_unlock(rwlock);
+	
+	pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 1));
+	
+	/* the worker may not reach the lock before it is released, so retry until it has contended once */
+	contentions = 0;
+	
+	for(attempts = 0; attempts < 10 && contentions == 0; attempts++) {
+		wi_lock_lock(lock);
+		wi_thread_pool_add_task(pool, _wi_test_lock_profile_lock, lock);
+		wi_thread_sleep(0.05);
+		wi_lock_unlock(lock);
+		wi_thread_pool_wait_until_idle(pool);
+		
+		profile = _wi_test_lock_profile_for_name(WI_STR("wi_test_lock_profile lock"));
+		contentions = wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("contentions")));
+	}
+	
+	wi_lock_set_profiling_enabled(false);
+	
+	profile = _wi_test_lock_profile_for_name(WI_STR("wi_test_lock_profile lock"));
+	
+	WI_TEST_ASSERT_NOT_NULL(profile, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("acquisitions"))), (int64_t) (10 + (2 * attempts)), "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("contentions"))), 1LL, "");
+	WI_TEST_ASSERT_TRUE(wi_number_double(wi_dictionary_data_for_key(profile, WI_STR("max_wait"))) > 0.0, "");
+	WI_TEST_ASSERT_TRUE(wi_number_double(wi_dictionary_data_for_key(profile, WI_STR("max_hold"))) >= 0.04, "");
+	
+	profile = _wi_test_lock_profile_for_name(WI_STR("wi_test_lock_profile recursive lock"));
+	
+	WI_TEST_ASSERT_NOT_NULL(profile, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("acquisitions"))), 2LL, "");
+	
+	profile = _wi_test_lock_profile_for_name(WI_STR("wi_test_lock_profile rwlock"));
+	
+	WI_TEST_ASSERT_NOT_NULL(profile, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("acquisitions"))), 3LL, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("contentions"))), 0LL, "");
+	
+	wi_lock_reset_profile();
+	
+	profile = _wi_test_lock_profile_for_name(WI_STR("wi_test_lock_profile lock"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_dictionary_data_for_key(profile, WI_STR("acquisitions"))), 0LL, "");
+#endif
+}
+
+
+
+void wi_test_lock_profile_on_signal(void) {
+#ifdef WI_PTHREADS
+	wi_log_callback_func_t		*callback;
+	
+	_wi_test_lock_profile_log_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	
+	callback = wi_log_callback;
+	wi_log_callback = _wi_test_lock_profile_log_callback;
+	
+	/* other threads already exist here and do not block the signal, so any of them may take it */
+	WI_TEST_ASSERT_TRUE(wi_lock_log_profile_on_signal(SIGUSR2), "");
+	WI_TEST_ASSERT_EQUALS(kill(getpid(), SIGUSR2), 0, "");
+	
+	if(wi_condition_lock_lock_when_condition(_wi_test_lock_profile_log_lock, 1, 1.0))
+		wi_condition_lock_unlock(_wi_test_lock_profile_log_lock);
+	else
+		WI_TEST_FAIL("Timed out waiting for lock profile");
+	
+	wi_log_callback = callback;
+#endif
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void _wi_test_fast_lock_increment(wi_runtime_instance_t *instance) {
+	wi_uinteger_t		i;
+	
+	for(i = 0; i < 100000; i++) {
+		wi_fast_lock_lock(&_wi_test_fast_lock);
+		_wi_test_fast_lock_counter++;
+		wi_fast_lock_unlock(&_wi_test_fast_lock);
+	}
+}
+
+
+
+
+static void _wi_test_lock_profile_lock(wi_runtime_instance_t *instance) {
+	wi_lock_lock(instance);
+	wi_lock_unlock(instance);
+}
+
+
+
+static wi_dictionary_t * _wi_test_lock_profile_for_name(wi_string_t *name) {
+	wi_array_t			*profiles;
+	wi_dictionary_t		*profile;
+	wi_uinteger_t		i, count;
+	
+	profiles = wi_lock_profile();
+	count = wi_array_count(profiles);
+	
+	for(i = 0; i < count; i++) {
+		profile = WI_ARRAY(profiles, i);
+		
+		if(wi_is_equal(wi_dictionary_data_for_key(profile, WI_STR("name")), name))
+			return profile;
+	}
+	
+	return NULL;
+}
+
+
+
+static void _wi_test_lock_profile_log_callback(wi_log_level_t level, wi_string_t *string) {
+	if(wi_string_has_prefix(string, WI_STR("Lock profile for "))) {
+		wi_condition_lock_lock(_wi_test_lock_profile_log_lock);
+		wi_condition_lock_unlock_with_condition(_wi_test_lock_profile_log_lock, 1);
+	}
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include <wired/wired.h>
 
 WI_TEST_EXPORT void						wi_test_number(void);
+WI_TEST_EXPORT void						wi_test_number_cache(void);
 
 
 void wi_test_number(void) {
@@ -50,3 +51,33 @@ void wi_test_number(void) {
 	WI_TEST_ASSERT_EQUALS_WITH_ACCURACY(wi_number_float(wi_number_with_float(3.40282346e38)), 3.40282346e38F, 0.0001, "");
 	WI_TEST_ASSERT_EQUALS_WITH_ACCURACY(wi_number_double(wi_number_with_double(1.7976931348623155e308)), 1.7976931348623155e308, 0.0001, "");
 }
+
+
+
+void wi_test_number_cache(void) {
+	wi_number_t		*number;
+	
+	WI_TEST_ASSERT_EQUALS(wi_number_with_bool(true), wi_number_with_bool(true), "");
+	WI_TEST_ASSERT_EQUALS(wi_number_with_bool(false), wi_number_with_bool(false), "");
+	WI_TEST_ASSERT_EQUALS(wi_number_with_int32(0), wi_number_with_int32(0), "");
+	WI_TEST_ASSERT_EQUALS(wi_number_with_int32(-16), wi_number_with_int32(-16), "");
+	WI_TEST_ASSERT_EQUALS(wi_number_with_int64(255), wi_number_with_int64(255), "");
+	WI_TEST_ASSERT_TRUE(wi_number_with_int32(256) != wi_number_with_int32(256), "");
+	WI_TEST_ASSERT_TRUE(wi_number_with_int32(1) != (wi_number_t *) wi_number_with_int64(1), "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_number_type(wi_number_with_int32(1)), WI_NUMBER_INT32, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_type(wi_number_with_int64(1)), WI_NUMBER_INT64, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int32(wi_number_with_int32(-16)), -16, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int64(wi_number_with_int64(255)), 255LL, "");
+	WI_TEST_ASSERT_TRUE(wi_is_equal(wi_number_with_int32(42), wi_number_with_int64(42)), "");
+	
+	number = wi_number_with_int32(7);
+	
+	wi_retain(number);
+	wi_release(number);
+	wi_release(number);
+	
+	WI_TEST_ASSERT_EQUALS(wi_retain_count(number), 1U, "");
+	WI_TEST_ASSERT_EQUALS(wi_number_int32(number), 7, "");
+	WI_TEST_ASSERT_EQUALS(wi_copy(number), number, "");
+}
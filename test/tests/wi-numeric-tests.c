@@ -0,0 +1,161 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_numeric_format(void);
+WI_TEST_EXPORT void						wi_test_numeric_parse(void);
+WI_TEST_EXPORT void						wi_test_numeric_round_trip(void);
+
+
+
+void wi_test_numeric_format(void) {
+	char		buffer[WI_NUMERIC_DOUBLE_BUFFER_SIZE];
+	
+	WI_TEST_ASSERT_EQUALS(wi_numeric_format_int64(buffer, 0), 1U, "");
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "0"), 0, "%s", buffer);
+	WI_TEST_ASSERT_EQUALS(wi_numeric_format_int64(buffer, -42), 3U, "");
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "-42"), 0, "%s", buffer);
+	WI_TEST_ASSERT_EQUALS(wi_numeric_format_int64(buffer, INT64_MIN), 20U, "");
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "-9223372036854775808"), 0, "%s", buffer);
+	WI_TEST_ASSERT_EQUALS(wi_numeric_format_uint64(buffer, UINT64_MAX), 20U, "");
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "18446744073709551615"), 0, "%s", buffer);
+	
+	wi_numeric_format_double(buffer, 0.0);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "0"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, -0.0);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "-0"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 3.14);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "3.14"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 0.1 + 0.2);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "0.30000000000000004"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 1234567890.123456);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "1234567890.123456"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 1e21);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "1e+21"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 1e20);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "100000000000000000000"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 0.000001);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "0.000001"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, -1.5e-7);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "-1.5e-7"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 1.7976931348623157e308);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "1.7976931348623157e+308"), 0, "%s", buffer);
+	wi_numeric_format_double(buffer, 5e-324);
+	WI_TEST_ASSERT_EQUALS(strcmp(buffer, "5e-324"), 0, "%s", buffer);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_number_string(wi_number_with_double(2.5)), WI_STR("2.5"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_number_string(wi_number_with_int64(-7)), WI_STR("-7"), "");
+}
+
+
+
+void wi_test_numeric_parse(void) {
+	int64_t		i64;
+	uint64_t	u64;
+	double		d;
+	
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_int64("-9223372036854775808", 20, &i64), "");
+	WI_TEST_ASSERT_EQUALS(i64, INT64_MIN, "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_int64("9223372036854775808", 19, &i64), "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_int64(" +0x1F", 6, &i64), "");
+	WI_TEST_ASSERT_EQUALS(i64, 31LL, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_int64("017", 3, &i64), "");
+	WI_TEST_ASSERT_EQUALS(i64, 15LL, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_int64("12345", 3, &i64), "");
+	WI_TEST_ASSERT_EQUALS(i64, 123LL, "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_int64("12a", 3, &i64), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_int64("", 0, &i64), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_int64("0x", 2, &i64), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_int64("08", 2, &i64), "");
+	
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_uint64("18446744073709551615", 20, &u64), "");
+	WI_TEST_ASSERT_EQUALS(u64, UINT64_MAX, "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_uint64("18446744073709551616", 20, &u64), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_uint64("-1", 2, &u64), "");
+	
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_double("1234567890.123456", 17, &d), "");
+	WI_TEST_ASSERT_EQUALS(d, 1234567890.123456, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_double("-2.5e-3", 7, &d), "");
+	WI_TEST_ASSERT_EQUALS(d, -2.5e-3, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_double(".5", 2, &d), "");
+	WI_TEST_ASSERT_EQUALS(d, 0.5, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_double("2.2250738585072014e-308", 23, &d), "");
+	WI_TEST_ASSERT_EQUALS(d, 2.2250738585072014e-308, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_double("123456789012345678901234567890", 30, &d), "");
+	WI_TEST_ASSERT_EQUALS(d, 123456789012345678901234567890.0, "");
+	WI_TEST_ASSERT_TRUE(wi_numeric_parse_double("1.5x", 3, &d), "");
+	WI_TEST_ASSERT_EQUALS(d, 1.5, "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_double("1.5x", 4, &d), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_double("1e", 2, &d), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_double("1e999", 5, &d), "");
+	WI_TEST_ASSERT_FALSE(wi_numeric_parse_double("", 0, &d), "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_int32(WI_STR("-2147483648")), INT32_MIN, "");
+	WI_TEST_ASSERT_EQUALS_WITH_ACCURACY(wi_string_float(WI_STR("-1.5")), -1.5F, 0.0001, "");
+}
+
+
+
+void wi_test_numeric_round_trip(void) {
+	char		buffer[WI_NUMERIC_DOUBLE_BUFFER_SIZE];
+	uint64_t	bits, state;
+	double		value, parsed;
+	wi_uinteger_t	i, length;
+	
+	state = 88172645463325252ULL;
+	
+	for(i = 0; i < 100000; i++) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		
+		bits = state;
+		
+		if((bits & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL)
+			continue;
+		
+		memcpy(&value, &bits, sizeof(value));
+		
+		length = wi_numeric_format_double(buffer, value);
+		
+		if(!wi_numeric_parse_double(buffer, length, &parsed) || parsed != value) {
+			WI_TEST_FAIL("%s did not round-trip", buffer);
+			
+			break;
+		}
+		
+		if(strtod(buffer, NULL) != value) {
+			WI_TEST_FAIL("%s does not parse back with strtod", buffer);
+			
+			break;
+		}
+	}
+}
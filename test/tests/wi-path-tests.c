@@ -0,0 +1,130 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_path_iterator(void);
+WI_TEST_EXPORT void						wi_test_path_normalize(void);
+WI_TEST_EXPORT void						wi_test_path_buffers(void);
+
+
+
+void wi_test_path_iterator(void) {
+	wi_path_iterator_t		iterator;
+	wi_range_t				range;
+	const char				*path = "//usr/local//wired/";
+	
+	wi_path_iterator_init(&iterator, path, strlen(path));
+	
+	WI_TEST_ASSERT_TRUE(wi_path_iterator_next(&iterator, &range), "");
+	WI_TEST_ASSERT_EQUALS(range.location, 0U, "");
+	WI_TEST_ASSERT_EQUALS(range.length, 1U, "");
+	WI_TEST_ASSERT_TRUE(wi_path_iterator_next(&iterator, &range), "");
+	WI_TEST_ASSERT_EQUALS(range.location, 2U, "");
+	WI_TEST_ASSERT_EQUALS(range.length, 3U, "");
+	WI_TEST_ASSERT_TRUE(wi_path_iterator_next(&iterator, &range), "");
+	WI_TEST_ASSERT_EQUALS(range.location, 6U, "");
+	WI_TEST_ASSERT_EQUALS(range.length, 5U, "");
+	WI_TEST_ASSERT_TRUE(wi_path_iterator_next(&iterator, &range), "");
+	WI_TEST_ASSERT_EQUALS(range.location, 13U, "");
+	WI_TEST_ASSERT_EQUALS(range.length, 5U, "");
+	WI_TEST_ASSERT_FALSE(wi_path_iterator_next(&iterator, &range), "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_path_count_components(path, strlen(path)), 4U, "");
+	WI_TEST_ASSERT_EQUALS(wi_path_count_components("usr/local", 9), 2U, "");
+	WI_TEST_ASSERT_EQUALS(wi_path_count_components("", 0), 0U, "");
+}
+
+
+
+void wi_test_path_normalize(void) {
+	char			buffer[WI_PATH_SIZE], exact[4];
+	wi_uinteger_t	length;
+	
+	wi_strlcpy(buffer, "////usr/././local/../local/../local/wired///", sizeof(buffer));
+	length = wi_path_normalize(buffer, strlen(buffer));
+	buffer[length] = '\0';
+	WI_TEST_ASSERT_EQUALS(length, 16U, "");
+	WI_TEST_ASSERT_TRUE(strcmp(buffer, "/usr/local/wired") == 0, "%s", buffer);
+	
+	wi_strlcpy(buffer, "/../a/../../b", sizeof(buffer));
+	buffer[wi_path_normalize(buffer, strlen(buffer))] = '\0';
+	WI_TEST_ASSERT_TRUE(strcmp(buffer, "/b") == 0, "%s", buffer);
+	
+	wi_strlcpy(buffer, "a/./b/../c/", sizeof(buffer));
+	buffer[wi_path_normalize(buffer, strlen(buffer))] = '\0';
+	WI_TEST_ASSERT_TRUE(strcmp(buffer, "a/b/../c") == 0, "%s", buffer);
+	
+	wi_strlcpy(buffer, "///", sizeof(buffer));
+	length = wi_path_normalize(buffer, strlen(buffer));
+	buffer[length] = '\0';
+	WI_TEST_ASSERT_EQUALS(length, 1U, "");
+	WI_TEST_ASSERT_TRUE(strcmp(buffer, "/") == 0, "%s", buffer);
+	
+	/* nothing is written past the length that was passed in */
+	memcpy(exact, "a/bX", sizeof(exact));
+	WI_TEST_ASSERT_EQUALS(wi_path_normalize(exact, 3), 3U, "");
+	WI_TEST_ASSERT_EQUALS(exact[3], 'X', "");
+}
+
+
+
+void wi_test_path_buffers(void) {
+	char			buffer[16];
+	wi_uinteger_t	length;
+	wi_range_t		range;
+	const char		*path = "/usr/local/wired.tar.gz/";
+	
+	length = wi_path_append_component(buffer, 0, sizeof(buffer), "/usr", 4);
+	length = wi_path_append_component(buffer, length, sizeof(buffer), "local", 5);
+	WI_TEST_ASSERT_TRUE(strcmp(buffer, "/usr/local") == 0, "%s", buffer);
+	
+	length = wi_path_append_component(buffer, length, sizeof(buffer), "/", 1);
+	WI_TEST_ASSERT_EQUALS(length, 10U, "");
+	
+	length = wi_path_append_component(buffer, length, sizeof(buffer), "wired", 5);
+	WI_TEST_ASSERT_EQUALS(length, 16U, "");
+	WI_TEST_ASSERT_TRUE(strcmp(buffer, "/usr/local/wire") == 0, "%s", buffer);
+	
+	range = wi_path_last_component_range(path, strlen(path));
+	WI_TEST_ASSERT_EQUALS(range.location, 11U, "");
+	WI_TEST_ASSERT_EQUALS(range.length, 12U, "");
+	
+	range = wi_path_extension_range(path, strlen(path));
+	WI_TEST_ASSERT_EQUALS(range.location, 21U, "");
+	WI_TEST_ASSERT_EQUALS(range.length, 2U, "");
+	
+	range = wi_path_extension_range("/usr.local/wired", 16);
+	WI_TEST_ASSERT_EQUALS(range.location, WI_NOT_FOUND, "");
+	
+	WI_TEST_ASSERT_EQUALS(wi_path_parent_length(path, strlen(path)), 10U, "");
+	WI_TEST_ASSERT_EQUALS(wi_path_parent_length("/usr", 4), 1U, "");
+	WI_TEST_ASSERT_EQUALS(wi_path_parent_length("/", 1), 1U, "");
+	WI_TEST_ASSERT_EQUALS(wi_path_parent_length("wired", 5), 0U, "");
+}
@@ -0,0 +1,111 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_persistent_dictionary(void);
+WI_TEST_EXPORT void						wi_test_persistent_set(void);
+
+
+void wi_test_persistent_dictionary(void) {
+	wi_persistent_dictionary_t		*dictionary, *empty, *snapshot, *shared;
+	wi_number_t						*key;
+	wi_uinteger_t					i;
+	
+	empty = wi_persistent_dictionary();
+	dictionary = empty;
+	
+	for(i = 0; i < 5000; i++)
+		dictionary = wi_persistent_dictionary_by_setting_data_for_key(dictionary, wi_string_with_format(WI_STR("%lu"), i), wi_number_with_integer(i));
+	
+	WI_TEST_ASSERT_EQUALS(wi_persistent_dictionary_count(empty), 0U, "");
+	WI_TEST_ASSERT_EQUALS(wi_persistent_dictionary_count(dictionary), 5000U, "");
+	
+	for(i = 0; i < 5000; i++) {
+		key = wi_number_with_integer(i);
+		
+		WI_TEST_ASSERT_EQUAL_INSTANCES(wi_persistent_dictionary_data_for_key(dictionary, key),
+			wi_string_with_format(WI_STR("%lu"), i), "");
+	}
+	
+	snapshot = dictionary;
+	dictionary = wi_persistent_dictionary_by_setting_data_for_key(dictionary, WI_STR("foo"), wi_number_with_integer(42));
+	
+	WI_TEST_ASSERT_EQUALS(wi_persistent_dictionary_count(dictionary), 5000U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_persistent_dictionary_data_for_key(dictionary, wi_number_with_integer(42)), WI_STR("foo"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_persistent_dictionary_data_for_key(snapshot, wi_number_with_integer(42)), WI_STR("42"), "");
+	WI_TEST_ASSERT_FALSE(wi_is_equal(dictionary, snapshot), "");
+	
+	for(i = 0; i < 5000; i += 2)
+		dictionary = wi_persistent_dictionary_by_removing_data_for_key(dictionary, wi_number_with_integer(i));
+	
+	WI_TEST_ASSERT_EQUALS(wi_persistent_dictionary_count(dictionary), 2500U, "");
+	WI_TEST_ASSERT_EQUALS(wi_persistent_dictionary_count(snapshot), 5000U, "");
+	WI_TEST_ASSERT_NULL(wi_persistent_dictionary_data_for_key(dictionary, wi_number_with_integer(42)), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_persistent_dictionary_data_for_key(dictionary, wi_number_with_integer(43)), WI_STR("43"), "");
+	WI_TEST_ASSERT_EQUALS(wi_array_count(wi_persistent_dictionary_all_keys(dictionary)), 2500U, "");
+	
+	for(i = 1; i < 5000; i += 2)
+		dictionary = wi_persistent_dictionary_by_removing_data_for_key(dictionary, wi_number_with_integer(i));
+	
+	WI_TEST_ASSERT_EQUALS(wi_persistent_dictionary_count(dictionary), 0U, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(dictionary, empty, "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_persistent_dictionary_with_dictionary(wi_persistent_dictionary_dictionary(snapshot)), snapshot, "");
+	
+	shared = NULL;
+	
+	wi_persistent_dictionary_store(&shared, snapshot);
+	
+	WI_TEST_ASSERT_TRUE(wi_persistent_dictionary_load(&shared) == snapshot, "");
+	WI_TEST_ASSERT_FALSE(wi_persistent_dictionary_compare_and_store(&shared, empty, dictionary), "");
+	WI_TEST_ASSERT_TRUE(wi_persistent_dictionary_compare_and_store(&shared, snapshot, dictionary), "");
+	WI_TEST_ASSERT_TRUE(wi_persistent_dictionary_load(&shared) == dictionary, "");
+	
+	wi_persistent_dictionary_store(&shared, NULL);
+}
+
+
+
+void wi_test_persistent_set(void) {
+	wi_persistent_set_t		*set, *otherset;
+	
+	set = wi_persistent_set_with_array(wi_array_with_data(WI_STR("foo"), WI_STR("bar"), NULL));
+	
+	WI_TEST_ASSERT_EQUALS(wi_persistent_set_count(set), 2U, "");
+	WI_TEST_ASSERT_TRUE(wi_persistent_set_contains_data(set, WI_STR("foo")), "");
+	
+	otherset = wi_persistent_set_by_adding_data(set, WI_STR("baz"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_persistent_set_count(otherset), 3U, "");
+	WI_TEST_ASSERT_FALSE(wi_persistent_set_contains_data(set, WI_STR("baz")), "");
+	WI_TEST_ASSERT_TRUE(wi_persistent_set_by_adding_data(otherset, WI_STR("baz")) == otherset, "");
+	
+	otherset = wi_persistent_set_by_removing_data(otherset, WI_STR("baz"));
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(otherset, set, "");
+}
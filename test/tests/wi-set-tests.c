@@ -29,10 +29,12 @@
 #include <wired/wired.h>
 
 WI_TEST_EXPORT void						wi_test_set(void);
+WI_TEST_EXPORT void						wi_test_set_algebra(void);
+WI_TEST_EXPORT void						wi_test_integer_set(void);
 
 
 void wi_test_set(void) {
-	wi_mutable_set_t		*set;
+	wi_mutable_set_t		*set, *copy;
 	
 	set = wi_set_init(wi_mutable_set_alloc());
 	
@@ -56,6 +58,13 @@ void wi_test_set(void) {
 	WI_TEST_ASSERT_TRUE(wi_set_contains_data(set, WI_STR("foo")), "");
 	WI_TEST_ASSERT_FALSE(wi_set_contains_data(set, WI_STR("bar")), "");
 	WI_TEST_ASSERT_EQUALS(wi_set_count_for_data(set, WI_STR("foo")), 2U, "");
+	
+	copy = wi_set_init_with_capacity(wi_mutable_set_alloc(), 0, true);
+	wi_mutable_set_set_set(copy, set);
+	
+	WI_TEST_ASSERT_EQUALS(wi_set_count_for_data(copy, WI_STR("foo")), 2U, "");
+	
+	wi_release(copy);
 
 	wi_mutable_set_remove_data(set, WI_STR("foo"));
 
@@ -69,3 +78,128 @@ void wi_test_set(void) {
 	
 	wi_release(set);
 }
+
+
+
+void wi_test_set_algebra(void) {
+	wi_set_t				*set1, *set2, *set;
+	wi_mutable_set_t		*mutableset;
+	
+	set1 = wi_set_with_data(WI_STR("a"), WI_STR("b"), WI_STR("c"), NULL);
+	set2 = wi_set_with_data(WI_STR("b"), WI_STR("c"), WI_STR("d"), NULL);
+	
+	set = wi_set_union(set1, set2);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(set, wi_set_with_data(WI_STR("a"), WI_STR("b"), WI_STR("c"), WI_STR("d"), NULL), "");
+	
+	set = wi_set_intersection(set1, set2);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(set, wi_set_with_data(WI_STR("b"), WI_STR("c"), NULL), "");
+	
+	set = wi_set_difference(set1, set2);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(set, wi_set_with_data(WI_STR("a"), NULL), "");
+	
+	WI_TEST_ASSERT_TRUE(wi_set_is_subset_of_set(wi_set_with_data(WI_STR("b"), NULL), set1), "");
+	WI_TEST_ASSERT_FALSE(wi_set_is_subset_of_set(set2, set1), "");
+	WI_TEST_ASSERT_TRUE(wi_set_intersects_set(set1, set2), "");
+	WI_TEST_ASSERT_FALSE(wi_set_intersects_set(set, set2), "");
+	
+	mutableset = wi_mutable_copy(set1);
+	
+	wi_mutable_set_union_set(mutableset, set2);
+	
+	WI_TEST_ASSERT_EQUALS(wi_set_count(mutableset), 4U, "");
+	
+	wi_mutable_set_intersect_set(mutableset, set2);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mutableset, set2, "");
+	
+	wi_mutable_set_minus_set(mutableset, set1);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mutableset, wi_set_with_data(WI_STR("d"), NULL), "");
+	
+	wi_release(mutableset);
+}
+
+
+
+void wi_test_integer_set(void) {
+	wi_integer_set_t			*set1, *set2, *set;
+	wi_mutable_integer_set_t	*mutableset;
+	uint32_t					values[1000];
+	uint32_t					unsorted[] = { 5, 3, 9, 3, 1 };
+	wi_uinteger_t				i;
+	
+	set = wi_integer_set_with_values(unsorted, 5);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(set), 4U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_first_value(set), 1U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_last_value(set), 9U, "");
+	WI_TEST_ASSERT_TRUE(wi_integer_set_contains_value(set, 5), "");
+	WI_TEST_ASSERT_FALSE(wi_integer_set_contains_value(set, 4), "");
+	
+	for(i = 0; i < 1000; i++)
+		values[i] = i * 2;
+	
+	set1 = wi_integer_set_with_values(values, 1000);
+	
+	for(i = 0; i < 1000; i++)
+		values[i] = i * 3;
+	
+	set2 = wi_integer_set_with_values(values, 1000);
+	
+	WI_TEST_ASSERT_TRUE(wi_integer_set_contains_value(set1, 1998), "");
+	WI_TEST_ASSERT_FALSE(wi_integer_set_contains_value(set1, 1999), "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_index_of_value(set2, 300), 100U, "");
+	
+	set = wi_integer_set_union(set1, set2);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(set), 1666U, "");
+	
+	set = wi_integer_set_intersection(set1, set2);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(set), 334U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_value_at_index(set, 1), 6U, "");
+	WI_TEST_ASSERT_TRUE(wi_integer_set_is_subset_of_set(set, set1), "");
+	WI_TEST_ASSERT_TRUE(wi_integer_set_is_subset_of_set(set, set2), "");
+	WI_TEST_ASSERT_FALSE(wi_integer_set_is_subset_of_set(set1, set2), "");
+	
+	set = wi_integer_set_difference(set1, set2);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(set), 666U, "");
+	WI_TEST_ASSERT_FALSE(wi_integer_set_intersects_set(set, set2), "");
+	
+	set = wi_integer_set_intersection(wi_integer_set_with_values(unsorted, 5), set2);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(set), 2U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_first_value(set), 3U, "");
+	
+	set = wi_integer_set_difference(set2, wi_integer_set_with_values(unsorted, 5));
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(set), 998U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_first_value(set), 0U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_value_at_index(set, 1), 6U, "");
+	
+	mutableset = wi_integer_set_init(wi_mutable_integer_set_alloc());
+	
+	wi_mutable_integer_set_add_value(mutableset, 7);
+	wi_mutable_integer_set_add_value(mutableset, 2);
+	wi_mutable_integer_set_add_value(mutableset, 7);
+	wi_mutable_integer_set_add_values(mutableset, unsorted, 5);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(mutableset), 6U, "");
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_value_at_index(mutableset, 1), 2U, "");
+	
+	wi_mutable_integer_set_remove_value(mutableset, 2);
+	wi_mutable_integer_set_intersect_set(mutableset, set2);
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(mutableset, wi_integer_set_with_values(unsorted + 1, 2), "");
+	
+	wi_mutable_integer_set_union_set(mutableset, set1);
+	wi_mutable_integer_set_minus_set(mutableset, set1);
+	
+	WI_TEST_ASSERT_EQUALS(wi_integer_set_count(mutableset), 2U, "");
+	
+	wi_release(mutableset);
+}
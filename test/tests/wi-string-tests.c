@@ -26,6 +26,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string.h>
+#include <strings.h>
 #include <wired/wired.h>
 
 WI_TEST_EXPORT void						wi_test_string_case(void);
@@ -34,8 +36,12 @@ WI_TEST_EXPORT void						wi_test_string_compare(void);
 WI_TEST_EXPORT void						wi_test_string_digest(void);
 WI_TEST_EXPORT void						wi_test_string_length(void);
 WI_TEST_EXPORT void						wi_test_string_format(void);
+WI_TEST_EXPORT void						wi_test_string_format_equivalence(void);
+WI_TEST_EXPORT void						wi_test_string_growth(void);
+WI_TEST_EXPORT void						wi_test_string_intern(void);
 WI_TEST_EXPORT void						wi_test_string_numeric_conversions(void);
 WI_TEST_EXPORT void						wi_test_string_paths(void);
+WI_TEST_EXPORT void						wi_test_string_search(void);
 
 
 
@@ -78,11 +84,70 @@ void wi_test_string_digest(void) {
 
 
 void wi_test_string_format(void) {
+	wi_string_t		*string;
+	int				length;
+	
 	WI_TEST_ASSERT_EQUAL_INSTANCES(
 		wi_string_with_format(WI_STR("'%d' '%u' '%p' '%.5f' '%@' '%@' '%#@' '%s' '%s' '%#s'"),
 			-5, 5, 0xAC1DFEED, 3.1415926, WI_STR("hello world"), NULL, NULL, "hello world", NULL, NULL),
 		WI_STR("'-5' '5' '0xac1dfeed' '3.14159' 'hello world' '(null)' '' 'hello world' '(null)' ''"),
 		"");
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(
+		wi_string_with_format(WI_STR("[%5d] [%-5d] [%05d] [%+d] [%x] [%#X] [%o] [%lld] [%zu] [%hhd]"),
+			42, 42, -42, 42, 0xbeef, 0xbeef, 8, -9223372036854775807LL - 1, (size_t) 1234567, 300),
+		WI_STR("[   42] [42   ] [-0042] [+42] [beef] [0XBEEF] [10] [-9223372036854775808] [1234567] [44]"),
+		"");
+
+	WI_TEST_ASSERT_EQUAL_INSTANCES(
+		wi_string_with_format(WI_STR("[%.*s] [%*s] [%-*s] [%.3s] [%c] [%%] [%5.1f] [%Lg]"),
+			3, "hello", 4, "ab", 4, "ab", "world", 'x', 2.25, (long double) 0.5),
+		WI_STR("[hel] [  ab] [ab  ] [wor] [x] [%] [  2.2] [0.5]"),
+		"");
+
+	string = wi_string_with_format(WI_STR("%100p %d"), (void *) 0xAC1DFEED, 7);
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_length(string), 102U, "");
+	WI_TEST_ASSERT_TRUE(wi_string_has_suffix(string, WI_STR("0xac1dfeed 7")), "");
+
+	WI_TEST_ASSERT_EQUAL_INSTANCES(
+		wi_string_with_format(wi_string_with_cstring("%@ %d %@"), WI_STR("a"), 1, wi_string_with_cstring("2")),
+		WI_STR("a 1 2"),
+		"");
+	
+	string = wi_string_with_format(WI_STR("%@%n%200d"), WI_STR("hello"), &length, 1);
+
+	WI_TEST_ASSERT_EQUALS(length, 5, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_length(string), 205U, "");
+	WI_TEST_ASSERT_TRUE(wi_string_has_suffix(string, WI_STR(" 1")), "");
+
+	string = wi_string_with_format(WI_STR("%.300f"), 1.0);
+
+	WI_TEST_ASSERT_EQUALS(wi_string_length(string), 302U, "");
+	WI_TEST_ASSERT_TRUE(wi_string_has_prefix(string, WI_STR("1.000")), "");
+}
+
+
+
+void wi_test_string_format_equivalence(void) {
+	wi_pool_t			*pool;
+	char				buffer[256];
+	wi_uinteger_t		i;
+	
+	for(i = 0; i < 1000; i++) {
+		pool = wi_pool_init(wi_pool_alloc());
+		
+		snprintf(buffer, sizeof(buffer), "%u: %s sent %llu bytes to %s in %.2f seconds (%d%%)",
+			(unsigned int) i, "user", (unsigned long long) i * 1024, "localhost", i / 7.0, (int) i % 101);
+		
+		WI_TEST_ASSERT_EQUAL_INSTANCES(
+			wi_string_with_format(WI_STR("%u: %s sent %llu bytes to %@ in %.2f seconds (%d%%)"),
+				(unsigned int) i, "user", (unsigned long long) i * 1024, WI_STR("localhost"), i / 7.0, (int) i % 101),
+			wi_string_with_cstring(buffer),
+			"");
+		
+		wi_release(pool);
+	}
 }
 
 
@@ -94,6 +159,57 @@ void wi_test_string_length(void) {
 
 
 
+void wi_test_string_growth(void) {
+	wi_mutable_string_t		*string;
+	wi_uinteger_t			i;
+	
+	string = wi_mutable_string();
+	
+	for(i = 0; i < 100; i++)
+		wi_mutable_string_append_string(string, WI_STR("hello world"));
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_length(string), 1100U, "");
+	WI_TEST_ASSERT_TRUE(wi_string_has_suffix(string, WI_STR("hello worldhello world")), "");
+
+	string = wi_mutable_copy(WI_STR("hello world"));
+	wi_mutable_string_append_string(string, WI_STR(", hello another world"));
+	
+	WI_TEST_ASSERT_EQUAL_INSTANCES(string, WI_STR("hello world, hello another world"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_autorelease(wi_copy(string)), WI_STR("hello world, hello another world"), "");
+
+	wi_release(string);
+}
+
+
+
+void wi_test_string_intern(void) {
+	wi_mutable_string_t		*string;
+	wi_string_t				*immutable, *atom;
+	
+	string = wi_mutable_string_with_format(WI_STR("hello %@"), WI_STR("world"));
+	atom = wi_string_intern(string);
+	
+	WI_TEST_ASSERT_TRUE(atom != string, "");
+	WI_TEST_ASSERT_TRUE(wi_string_is_interned(atom), "");
+	WI_TEST_ASSERT_FALSE(wi_string_is_interned(string), "");
+	WI_TEST_ASSERT_EQUALS(atom, wi_string_intern_cstring("hello world"), "");
+	WI_TEST_ASSERT_EQUALS(atom, wi_string_intern(wi_string_with_cstring("hello world")), "");
+	WI_TEST_ASSERT_EQUALS(atom, WI_STR("hello world"), "");
+	WI_TEST_ASSERT_EQUALS(wi_hash(atom), wi_hash(string), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(atom, string, "");
+	WI_TEST_ASSERT_FALSE(wi_is_equal(atom, wi_string_intern_cstring("hello another world")), "");
+	
+	immutable = wi_string_with_cstring("hello interned world");
+	atom = wi_string_intern(immutable);
+	
+	/* immutable strings are copied too, the caller's instance stays an ordinary string */
+	WI_TEST_ASSERT_TRUE(atom != immutable, "");
+	WI_TEST_ASSERT_FALSE(wi_string_is_interned(immutable), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(atom, immutable, "");
+}
+
+
+
 void wi_test_string_numeric_conversions(void) {
 	WI_TEST_ASSERT_EQUALS(wi_string_bool(WI_STR("yes")), true, "");
 	WI_TEST_ASSERT_EQUALS(wi_string_bool(WI_STR("no")), false, "");
@@ -152,4 +268,77 @@ void wi_test_string_paths(void) {
 	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_path_extension(WI_STR("wired.c")), WI_STR("c"), "");
 	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_path_extension(WI_STR("wired")), WI_STR(""), "");
 	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_deleting_path_extension(WI_STR("wired")), WI_STR("wired"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_deleting_path_extension(WI_STR("/usr.local/wired.c")), WI_STR("/usr.local/wired"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_path_extension(WI_STR("/usr.local/wired")), WI_STR(""), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_deleting_last_path_component(WI_STR("/usr")), WI_STR("/"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_deleting_last_path_component(WI_STR("wired")), WI_STR(""), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_appending_path_component(WI_STR("/"), WI_STR("/wired")), WI_STR("/wired"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_appending_path_component(WI_STR(""), WI_STR("wired")), WI_STR("wired"), "");
+	WI_TEST_ASSERT_EQUAL_INSTANCES(wi_string_by_normalizing_path(WI_STR("/..")), WI_STR("/"), "");
+}
+
+
+
+void wi_test_string_search(void) {
+	wi_mutable_string_t		*string;
+	wi_string_matcher_t		*matcher;
+	wi_string_t				*needle;
+	const char				*cstring;
+	wi_uinteger_t			i, j, index, length;
+	
+	string = wi_mutable_string();
+	
+	for(i = 0; i < 200; i++)
+		wi_mutable_string_append_format(string, WI_STR("file%u.TXT/"), (unsigned int) i);
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR("file137.TXT"), 0), 1534U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR("file137.txt"), 0), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR("FILE137.txt"), WI_STRING_CASE_INSENSITIVE), 1534U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR("file137.txt"), WI_STRING_SMART_CASE_INSENSITIVE), 1534U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR("File137.txt"), WI_STRING_SMART_CASE_INSENSITIVE), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR(".TXT/"), WI_STRING_BACKWARDS), wi_string_length(string) - 5, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, WI_STR("file1."), WI_STRING_BACKWARDS | WI_STRING_CASE_INSENSITIVE), 10U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string_in_range(string, WI_STR("file2"), 0, wi_make_range(0, 25)), 20U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string_in_range(string, WI_STR("file2"), 0, wi_make_range(0, 24)), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_string_in_range(string, WI_STR("file0"), WI_STRING_BACKWARDS, wi_make_range(1, 30)), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_char(string, '/', WI_STRING_BACKWARDS), wi_string_length(string) - 1, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_char(string, 'x', WI_STRING_CASE_INSENSITIVE), 7U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_index_of_char(string, '#', 0), WI_NOT_FOUND, "");
+	WI_TEST_ASSERT_TRUE(wi_string_contains_string(string, WI_STR("199.txt/"), WI_STRING_CASE_INSENSITIVE), "");
+	WI_TEST_ASSERT_FALSE(wi_string_contains_string(string, WI_STR("200.txt/"), WI_STRING_CASE_INSENSITIVE), "");
+	
+	cstring = wi_string_cstring(string);
+	length = wi_string_length(string);
+	
+	for(i = 1; i < 40; i++) {
+		needle = wi_string_with_bytes(cstring + (i * 97) % (length - i), i);
+		
+		for(j = 0; j + i <= length; j++) {
+			if(strncmp(cstring + j, wi_string_cstring(needle), i) == 0)
+				break;
+		}
+		
+		WI_TEST_ASSERT_EQUALS(wi_string_index_of_string(string, needle, 0), j, "");
+		
+		for(j = length - i + 1; j > 0; j--) {
+			if(strncasecmp(cstring + j - 1, wi_string_cstring(needle), i) == 0)
+				break;
+		}
+		
+		index = wi_string_index_of_string(string, needle, WI_STRING_BACKWARDS | WI_STRING_CASE_INSENSITIVE);
+		
+		WI_TEST_ASSERT_EQUALS(index, j - 1, "");
+	}
+	
+	matcher = wi_string_matcher_with_string(WI_STR("file19"), WI_STRING_CASE_INSENSITIVE);
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_matcher_index_in_string(matcher, string), 199U, "");
+	WI_TEST_ASSERT_TRUE(wi_string_matcher_matches_string(matcher, WI_STR("/files/FILE190.TXT")), "");
+	WI_TEST_ASSERT_FALSE(wi_string_matcher_matches_string(matcher, WI_STR("/files/FILE180.TXT")), "");
+	WI_TEST_ASSERT_FALSE(wi_string_matcher_matches_string(matcher, WI_STR("file1")), "");
+	
+	matcher = wi_string_matcher_with_string(WI_STR("q"), WI_STRING_BACKWARDS);
+	
+	WI_TEST_ASSERT_EQUALS(wi_string_matcher_index_in_string(matcher, WI_STR("aqaqa")), 3U, "");
+	WI_TEST_ASSERT_EQUALS(wi_string_matcher_index_in_string(matcher, WI_STR("AQAQA")), WI_NOT_FOUND, "");
 }
@@ -0,0 +1,224 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <wired/wired.h>
+
+WI_TEST_EXPORT void						wi_test_thread_pool(void);
+WI_TEST_EXPORT void						wi_test_thread_pool_stealing(void);
+WI_TEST_EXPORT void						wi_test_thread_pool_release_from_worker(void);
+WI_TEST_EXPORT void						wi_test_thread_pool_order(void);
+
+
+#ifdef WI_PTHREADS
+static wi_runtime_instance_t *			_wi_test_thread_pool_square(wi_runtime_instance_t *);
+static wi_runtime_instance_t *			_wi_test_thread_pool_spawn(wi_runtime_instance_t *);
+static void								_wi_test_thread_pool_count(wi_runtime_instance_t *);
+static void								_wi_test_thread_pool_append(wi_runtime_instance_t *);
+static void								_wi_test_thread_pool_release(wi_runtime_instance_t *);
+
+
+static wi_thread_pool_t					*_wi_test_thread_pool;
+static wi_condition_lock_t				*_wi_test_thread_pool_lock;
+static wi_uinteger_t					_wi_test_thread_pool_counter;
+static wi_uinteger_t					_wi_test_thread_pool_target;
+#endif
+
+
+void wi_test_thread_pool(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t		*pool;
+	wi_mutable_array_t		*futures;
+	wi_future_t				*future;
+	wi_uinteger_t			i;
+	
+	pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 4));
+	
+	WI_TEST_ASSERT_NOT_NULL(pool, "%m");
+	WI_TEST_ASSERT_EQUALS(wi_thread_pool_workers(pool), 4U, "");
+	
+	futures = wi_mutable_array();
+	
+	for(i = 0; i < 100; i++)
+		wi_mutable_array_add_data(futures, wi_thread_pool_submit_task(pool, _wi_test_thread_pool_square, wi_number_with_integer(i)));
+	
+	for(i = 0; i < 100; i++) {
+		future = WI_ARRAY(futures, i);
+		
+		WI_TEST_ASSERT_EQUALS(wi_number_integer(wi_future_result(future)), (wi_integer_t) (i * i), "");
+		WI_TEST_ASSERT_TRUE(wi_future_is_done(future), "");
+	}
+	
+	_wi_test_thread_pool_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	_wi_test_thread_pool_counter = 0;
+	_wi_test_thread_pool_target = 1000;
+	
+	for(i = 0; i < 1000; i++)
+		wi_thread_pool_add_task(pool, _wi_test_thread_pool_count, NULL);
+	
+	wi_thread_pool_wait_until_idle(pool);
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_thread_pool_counter, 1000U, "");
+#endif
+}
+
+
+
+void wi_test_thread_pool_stealing(void) {
+#ifdef WI_PTHREADS
+	wi_future_t		*future;
+	
+	_wi_test_thread_pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 4));
+	_wi_test_thread_pool_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	_wi_test_thread_pool_counter = 0;
+	_wi_test_thread_pool_target = 400;
+	
+	future = wi_thread_pool_submit_task(_wi_test_thread_pool, _wi_test_thread_pool_spawn, NULL);
+	
+	WI_TEST_ASSERT_TRUE(wi_future_wait(future, 10.0), "");
+	WI_TEST_ASSERT_EQUALS(wi_future_result(future), wi_number_with_bool(true), "");
+	
+	wi_thread_pool_wait_until_idle(_wi_test_thread_pool);
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_thread_pool_counter, 400U, "");
+	WI_TEST_ASSERT_TRUE(wi_thread_pool_steals(_wi_test_thread_pool) > 0, "");
+	
+	_wi_test_thread_pool = NULL;
+#endif
+}
+
+
+
+void wi_test_thread_pool_release_from_worker(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t		*pool;
+	wi_mutable_array_t		*array;
+	
+	_wi_test_thread_pool_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	
+	pool = wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 2);
+	array = wi_mutable_array();
+	
+	wi_mutable_array_add_data(array, pool);
+	wi_release(pool);
+	wi_thread_pool_add_task(pool, _wi_test_thread_pool_release, array);
+	
+	/* the array holds the last reference, which the task drops on one of the pool's own workers */
+	if(wi_condition_lock_lock_when_condition(_wi_test_thread_pool_lock, 1, 10.0))
+		wi_condition_lock_unlock(_wi_test_thread_pool_lock);
+	else
+		WI_TEST_FAIL("Timed out waiting for pool to be released");
+#endif
+}
+
+
+
+void wi_test_thread_pool_order(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t		*pool;
+	wi_mutable_array_t		*array;
+	wi_uinteger_t			i;
+	
+	pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 1));
+	array = wi_mutable_array();
+	
+	for(i = 0; i < 100; i++)
+		wi_thread_pool_add_task(pool, _wi_test_thread_pool_append, wi_array_with_data(array, wi_number_with_integer(i), NULL));
+	
+	wi_thread_pool_wait_until_idle(pool);
+	
+	/* tasks added from outside the pool run in the order they were added */
+	WI_TEST_ASSERT_EQUALS(wi_array_count(array), 100U, "");
+	
+	for(i = 0; i < 100; i++)
+		WI_TEST_ASSERT_EQUALS(wi_number_integer(WI_ARRAY(array, i)), (wi_integer_t) i, "");
+#endif
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static wi_runtime_instance_t * _wi_test_thread_pool_square(wi_runtime_instance_t *argument) {
+	wi_integer_t	value;
+	
+	value = wi_number_integer(argument);
+	
+	return wi_number_with_integer(value * value);
+}
+
+
+
+static wi_runtime_instance_t * _wi_test_thread_pool_spawn(wi_runtime_instance_t *argument) {
+	wi_uinteger_t	i;
+	
+	for(i = 0; i < 400; i++)
+		wi_thread_pool_add_task(_wi_test_thread_pool, _wi_test_thread_pool_count, NULL);
+	
+	/* the tasks sit on this worker's deque, so they only finish if other workers steal them */
+	if(!wi_condition_lock_lock_when_condition(_wi_test_thread_pool_lock, 1, 10.0))
+		return wi_number_with_bool(false);
+	
+	wi_condition_lock_unlock(_wi_test_thread_pool_lock);
+	
+	return wi_number_with_bool(true);
+}
+
+
+
+static void _wi_test_thread_pool_count(wi_runtime_instance_t *argument) {
+	wi_string_t		*string;
+	
+	string = wi_string_with_format(WI_STR("%u"), 42);
+	
+	wi_condition_lock_lock(_wi_test_thread_pool_lock);
+	
+	if(wi_string_length(string) == 2)
+		_wi_test_thread_pool_counter++;
+	
+	if(_wi_test_thread_pool_counter == _wi_test_thread_pool_target)
+		wi_condition_lock_unlock_with_condition(_wi_test_thread_pool_lock, 1);
+	else
+		wi_condition_lock_unlock(_wi_test_thread_pool_lock);
+}
+
+
+
+static void _wi_test_thread_pool_append(wi_runtime_instance_t *argument) {
+	wi_mutable_array_add_data(WI_ARRAY(argument, 0), WI_ARRAY(argument, 1));
+}
+
+
+
+static void _wi_test_thread_pool_release(wi_runtime_instance_t *argument) {
+	wi_mutable_array_remove_all_data(argument);
+	
+	wi_condition_lock_lock(_wi_test_thread_pool_lock);
+	wi_condition_lock_unlock_with_condition(_wi_test_thread_pool_lock, 1);
+}
+
+#endif
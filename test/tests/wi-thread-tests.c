@@ -0,0 +1,109 @@
+/* $Id$ */
+
+/*
+ *  Copyright (c) 2008-2009 Axel Andersson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <errno.h>
+#include <wired/wired.h>
+#include <wired/wi-private.h>
+
+WI_TEST_EXPORT void						wi_test_thread_error(void);
+
+
+#ifdef WI_PTHREADS
+static void								_wi_test_thread_error_thread(wi_runtime_instance_t *);
+
+
+static wi_condition_lock_t				*_wi_test_thread_lock;
+static wi_boolean_t						_wi_test_thread_passed;
+#endif
+
+
+void wi_test_thread_error(void) {
+#ifdef WI_PTHREADS
+	_wi_test_thread_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	_wi_test_thread_passed = false;
+	
+	wi_error_set_errno(EPERM);
+	
+	WI_TEST_ASSERT_TRUE(wi_thread_create_thread(_wi_test_thread_error_thread, NULL), "%m");
+	
+	if(wi_condition_lock_lock_when_condition(_wi_test_thread_lock, 1, 10.0)) {
+		WI_TEST_ASSERT_TRUE(_wi_test_thread_passed, "");
+		wi_condition_lock_unlock(_wi_test_thread_lock);
+	} else {
+		WI_TEST_FAIL("Timed out waiting for thread");
+	}
+	
+	/* errors are per thread, the other thread's errors never show up here */
+	WI_TEST_ASSERT_EQUALS(wi_error_domain(), WI_ERROR_DOMAIN_ERRNO, "");
+	WI_TEST_ASSERT_EQUALS(wi_error_code(), (wi_integer_t) EPERM, "");
+#endif
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void _wi_test_thread_error_thread(wi_runtime_instance_t *argument) {
+	wi_pool_t				*pool;
+	wi_thread_t				*thread;
+	wi_runtime_instance_t	*error, *instance;
+	wi_boolean_t			passed;
+	
+	pool = wi_pool_init(wi_pool_alloc());
+	thread = wi_thread_current_thread();
+	
+	wi_error_set_errno(ENOENT);
+	
+	passed = (wi_error_domain() == WI_ERROR_DOMAIN_ERRNO && wi_error_code() == ENOENT);
+	
+	error = wi_retain(wi_thread_error(thread));
+	instance = wi_string_init_with_cstring(wi_string_alloc(), "error");
+	
+	/* the thread retains its error and releases the previous one when it is replaced */
+	wi_thread_set_error(thread, instance);
+	
+	passed = passed && (wi_thread_error(thread) == instance && wi_retain_count(instance) == 2 && wi_retain_count(error) == 1);
+	
+	wi_thread_set_error(thread, error);
+	
+	passed = passed && (wi_thread_error(thread) == error && wi_retain_count(instance) == 1 && wi_retain_count(error) == 2);
+	
+	wi_release(instance);
+	wi_release(error);
+	
+	wi_error_set_errno(EEXIST);
+	
+	passed = passed && (wi_error_code() == EEXIST);
+	
+	wi_release(pool);
+	
+	wi_condition_lock_lock(_wi_test_thread_lock);
+	_wi_test_thread_passed = passed;
+	wi_condition_lock_unlock_with_condition(_wi_test_thread_lock, 1);
+}
+
+#endif
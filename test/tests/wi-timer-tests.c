@@ -29,14 +29,23 @@
 #include <wired/wired.h>
 
 WI_TEST_EXPORT void						wi_test_timer(void);
+WI_TEST_EXPORT void						wi_test_timer_ordering(void);
+WI_TEST_EXPORT void						wi_test_timer_thread_pool(void);
+WI_TEST_EXPORT void						wi_test_timer_thread_pool_invalidate(void);
 
 
 #ifdef WI_PTHREADS
 static void								_wi_test_timer_function(wi_timer_t *);
+static void								_wi_test_timer_ordering_function(wi_timer_t *);
+static void								_wi_test_timer_invalidated_function(wi_timer_t *);
+static void								_wi_test_timer_block(wi_runtime_instance_t *);
 
 
 static wi_uinteger_t					_wi_test_timer_hits;
 static wi_condition_lock_t				*_wi_test_timer_lock;
+static wi_integer_t						_wi_test_timer_last_order;
+static wi_boolean_t						_wi_test_timer_out_of_order;
+static wi_uinteger_t					_wi_test_timer_invalidated_hits;
 #endif
 
 
@@ -61,7 +70,168 @@ void wi_test_timer(void) {
 
 
 
+void wi_test_timer_ordering(void) {
 #ifdef WI_PTHREADS
+	wi_mutable_array_t		*timers;
+	wi_timer_t				*timer;
+	wi_uinteger_t			i;
+	
+	_wi_test_timer_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	_wi_test_timer_hits = 0;
+	_wi_test_timer_last_order = -1;
+	_wi_test_timer_out_of_order = false;
+	
+	timers = wi_mutable_array();
+	
+	for(i = 0; i < 10000; i++) {
+		timer = wi_timer_init_with_function(wi_timer_alloc(), _wi_test_timer_ordering_function, 10.0 + (double) ((i * 7919) % 10000) / 1000.0, false);
+		wi_mutable_array_add_data(timers, timer);
+		wi_timer_schedule(timer);
+		wi_release(timer);
+	}
+	
+	for(i = 0; i < 10000; i++) {
+		timer = WI_ARRAY(timers, i);
+		
+		wi_timer_invalidate(timer);
+		
+		WI_TEST_ASSERT_FALSE(wi_timer_is_scheduled(timer), "");
+		WI_TEST_ASSERT_EQUALS(wi_retain_count(timer), 1U, "");
+	}
+	
+	wi_mutable_array_remove_all_data(timers);
+	
+	for(i = 0; i < 50; i++) {
+		timer = wi_timer_init_with_function(wi_timer_alloc(), _wi_test_timer_ordering_function, 0.01 + 0.002 * (double) ((i * 13) % 50), false);
+		wi_timer_set_data(timer, (void *) (intptr_t) ((i * 13) % 50));
+		wi_mutable_array_add_data(timers, timer);
+		wi_timer_schedule(timer);
+		wi_release(timer);
+	}
+	
+	for(i = 0; i < 50; i += 2)
+		wi_timer_invalidate(WI_ARRAY(timers, i));
+	
+	if(wi_condition_lock_lock_when_condition(_wi_test_timer_lock, 1, 2.0)) {
+		WI_TEST_ASSERT_EQUALS(_wi_test_timer_hits, 25U, "");
+		WI_TEST_ASSERT_FALSE(_wi_test_timer_out_of_order, "");
+		wi_condition_lock_unlock(_wi_test_timer_lock);
+	} else {
+		WI_TEST_FAIL("Timed out waiting for timers, currently at %u %s",
+			_wi_test_timer_hits, _wi_test_timer_hits == 1 ? "hit" : "hits");
+	}
+#endif
+}
+
+
+
+void wi_test_timer_thread_pool(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t	*pool;
+	wi_timer_t			*timer;
+	
+	_wi_test_timer_lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	_wi_test_timer_hits = 0;
+	
+	pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 2));
+	timer = wi_autorelease(wi_timer_init_with_function(wi_timer_alloc(), _wi_test_timer_function, 0.001, false));
+	wi_timer_set_thread_pool(timer, pool);
+	
+	WI_TEST_ASSERT_EQUALS(wi_timer_thread_pool(timer), pool, "");
+	
+	wi_timer_schedule(timer);
+	
+	if(wi_condition_lock_lock_when_condition(_wi_test_timer_lock, 1, 1.0)) {
+		WI_TEST_ASSERT_EQUALS(_wi_test_timer_hits, 5U, "");
+		wi_condition_lock_unlock(_wi_test_timer_lock);
+	} else {
+		WI_TEST_FAIL("Timed out waiting for timer, currently at %u %s",
+			_wi_test_timer_hits, _wi_test_timer_hits == 1 ? "hit" : "hits");
+	}
+	
+	wi_thread_pool_wait_until_idle(pool);
+#endif
+}
+
+
+
+void wi_test_timer_thread_pool_invalidate(void) {
+#ifdef WI_PTHREADS
+	wi_thread_pool_t		*pool;
+	wi_condition_lock_t		*lock;
+	wi_timer_t				*timer;
+	
+	_wi_test_timer_invalidated_hits = 0;
+	
+	lock = wi_autorelease(wi_condition_lock_init_with_condition(wi_condition_lock_alloc(), 0));
+	pool = wi_autorelease(wi_thread_pool_init_with_workers(wi_thread_pool_alloc(), 1));
+	timer = wi_autorelease(wi_timer_init_with_function(wi_timer_alloc(), _wi_test_timer_invalidated_function, 0.001, true));
+	wi_timer_set_thread_pool(timer, pool);
+	
+	/* keep the only worker busy so the expired timer waits in the pool queue */
+	wi_thread_pool_add_task(pool, _wi_test_timer_block, lock);
+	
+	if(!wi_condition_lock_lock_when_condition(lock, 1, 1.0)) {
+		WI_TEST_FAIL("Timed out waiting for worker");
+		
+		return;
+	}
+	
+	wi_condition_lock_unlock(lock);
+	
+	wi_timer_schedule(timer);
+	wi_thread_sleep(0.05);
+	wi_timer_invalidate(timer);
+	
+	wi_condition_lock_lock(lock);
+	wi_condition_lock_unlock_with_condition(lock, 2);
+	
+	wi_thread_pool_wait_until_idle(pool);
+	wi_thread_sleep(0.01);
+	
+	WI_TEST_ASSERT_EQUALS(_wi_test_timer_invalidated_hits, 0U, "");
+#endif
+}
+
+
+
+#ifdef WI_PTHREADS
+
+static void _wi_test_timer_block(wi_runtime_instance_t *instance) {
+	wi_condition_lock_lock(instance);
+	wi_condition_lock_unlock_with_condition(instance, 1);
+	
+	wi_condition_lock_lock_when_condition(instance, 2, 0.0);
+	wi_condition_lock_unlock(instance);
+}
+
+
+
+static void _wi_test_timer_ordering_function(wi_timer_t *timer) {
+	wi_integer_t		order;
+	
+	order = (wi_integer_t) (intptr_t) wi_timer_data(timer);
+	
+	wi_condition_lock_lock(_wi_test_timer_lock);
+	
+	if(order < _wi_test_timer_last_order)
+		_wi_test_timer_out_of_order = true;
+	
+	_wi_test_timer_last_order = order;
+	
+	if(++_wi_test_timer_hits == 25)
+		wi_condition_lock_unlock_with_condition(_wi_test_timer_lock, 1);
+	else
+		wi_condition_lock_unlock_with_condition(_wi_test_timer_lock, 0);
+}
+
+
+
+static void _wi_test_timer_invalidated_function(wi_timer_t *timer) {
+	_wi_test_timer_invalidated_hits++;
+}
+
+
 
 static void _wi_test_timer_function(wi_timer_t *timer) {
 	wi_condition_lock_lock(_wi_test_timer_lock);